@@ -0,0 +1,5 @@
+#include <netinet/in.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,5 @@
+#include <inttypes.h>
+
+int main() {
+	return 0;
+}
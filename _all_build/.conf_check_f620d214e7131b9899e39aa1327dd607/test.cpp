@@ -0,0 +1,5 @@
+#include <sys/socket.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,8 @@
+/* WARNING! All changes made to this file will be lost! */
+
+#ifndef _NS3_CONFIG_STORE_CONFIG_H_WAF
+#define _NS3_CONFIG_STORE_CONFIG_H_WAF
+
+#define HAVE_LIBXML2 1
+
+#endif /* _NS3_CONFIG_STORE_CONFIG_H_WAF */
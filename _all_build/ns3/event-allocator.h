@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief the memory of the EventImpl objects
+ *
+ * EventImpl routes its operator new and delete here, so that all the
+ * events created by MakeEvent are carved from arenas of 64KB instead of
+ * costing a call to the system allocator each. The events are sorted
+ * by size in classes of 16 bytes up to 256 bytes, and the freed events
+ * of a class are kept on a free list for the next event of that class.
+ * Larger events are left to the system allocator.
+ *
+ * Where the compiler supports thread local storage, each thread has
+ * its own arenas and free lists, so that the threads of the realtime
+ * and distributed simulators which schedule events do not contend for
+ * a lock. An event freed by another thread than the one which
+ * allocated it is handed back to the free lists of the latter. The
+ * arenas are kept until the end of the process. Without thread local
+ * storage, the events are left to the system allocator.
+ *
+ * The "EventPooling" GlobalValue turns the pools off; each thread
+ * reads it the first time it allocates an event.
+ */
+class EventAllocator
+{
+public:
+  /// Counters of the allocator, summed over all the threads
+  struct Stats
+  {
+    /// Events allocated
+    uint64_t allocations;
+    /// Events freed
+    uint64_t releases;
+    /// Allocations served by a free list
+    uint64_t reuses;
+    /// Calls to the system allocator, for arenas, large events and unpooled events
+    uint64_t systemAllocations;
+    /// Bytes of the arenas
+    uint64_t arenaBytes;
+    /// Threads which allocated events
+    uint32_t threads;
+  };
+
+  /**
+   * \param size the size of the event
+   * \returns memory for the event
+   */
+  static void *Allocate (std::size_t size);
+  /// \param p memory returned by Allocate
+  static void Deallocate (void *p);
+  /**
+   * \returns the counters of all the threads. Approximate while other
+   *          threads are allocating events.
+   */
+  static Stats GetStats (void);
+  /// \returns true if the events of the calling thread are pooled
+  static bool IsPooling (void);
+
+private:
+  struct Pool;
+  static Pool *GetPool (void);
+  static Pool **GetPools (void);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
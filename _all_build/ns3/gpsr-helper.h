@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Pavel Boyko <boyko@iitp.ru>, written after OlsrHelper by Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef GPSRHELPER_H_
+#define GPSRHELPER_H_
+
+#include "ns3/object-factory.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/net-device-container.h"
+#include "ns3/gpsr-event-log.h"
+
+namespace ns3 {
+/**
+ * \ingroup gpsr
+ * \brief Helper class that adds GPSR routing to nodes.
+ */
+class GpsrHelper : public Ipv4RoutingHelper
+{
+public:
+  /// How InstallRsuDirectory connects the road side units
+  enum BackhaulTopology
+  {
+    BACKHAUL_BUS,   //!< one CSMA segment shared by all the RSUs
+    BACKHAUL_CHAIN, //!< one link between each two consecutive RSUs
+  };
+
+  GpsrHelper ();
+
+  /**
+   * \internal
+   * \returns pointer to clone of this OlsrHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  GpsrHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   *
+   * TODO: support installing GPSR on the subset of all available IP interfaces
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of ns3::gpsr::RoutingProtocol
+   */
+  void Set (std::string name, const AttributeValue &value);
+
+  void Install (void) const;
+
+  /**
+   * \param filename the file the binary event log is written to
+   * \returns the log, which stays open until it is disposed of
+   *
+   * Connects a GpsrEventLog to the "Event" trace source of every
+   * ns3::gpsr::RoutingProtocol. Call after the protocols were created.
+   */
+  Ptr<gpsr::GpsrEventLog> EnableEventLog (std::string filename) const;
+
+  /**
+   * \param topology the backhaul built by InstallRsuDirectory, BACKHAUL_BUS by default
+   */
+  void SetBackhaul (BackhaulTopology topology);
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of the ns3::CsmaChannel of the backhaul links
+   */
+  void SetBackhaulAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of ns3::gpsr::RsuDirectory
+   */
+  void SetDirectoryAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param rsus the road side units, in corridor order
+   * \returns the backhaul devices
+   *
+   * Connects the road side units with a backhaul and aggregates a
+   * ns3::gpsr::RsuDirectory to each of them. Their GPSR protocol then
+   * answers the location queries from the directory instead of beaconing
+   * like a vehicle. Call after the IPv4 addresses were assigned and
+   * before the simulation starts; the address of interface 1 is the one
+   * the vehicles know the RSU by.
+   */
+  NetDeviceContainer InstallRsuDirectory (NodeContainer rsus) const;
+
+private:
+  ObjectFactory m_agentFactory;
+  ObjectFactory m_directoryFactory;
+  BackhaulTopology m_backhaul;
+  ObjectFactory m_channelFactory;
+};
+
+}
+#endif /* GPSRHELPER_H_ */
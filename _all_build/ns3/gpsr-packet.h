@@ -0,0 +1,658 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef GPSRPACKET_H
+#define GPSRPACKET_H
+
+#include <iostream>
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#include "ns3/enum.h"
+#include "ns3/ipv4-address.h"
+#include <map>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+namespace gpsr {
+
+
+enum MessageType
+{
+  GPSRTYPE_HELLO  = 1,         //!< GPSRTYPE_HELLO
+  GPSRTYPE_POS = 2,            //!< GPSRTYPE_POS
+  SLS_LOCATION_HELLO = 3,
+  SLS_LOCATION_UPDATE = 4,
+  SLS_LOCATION_QUERY = 5,
+  SLS_LOCATION_REPLY = 6,
+};
+
+/**
+ * \ingroup gpsr
+ * \brief Encodings of the GPSR and SLS headers
+ *
+ * The version is carried in the high nibble of the TypeHeader, which
+ * keeps the legacy packets byte for byte identical. In the compact
+ * encoding the coordinates are 16 bit signed offsets from the
+ * "GpsrReferencePoint", in steps of "GpsrPositionResolution" meters,
+ * saturated at the edges of the range; the timestamps are sent modulo
+ * 2^16 s and recovered against the clock of the receiver, which is
+ * exact within 9 hours; speeds saturate at 255 m/s; and a LocUpdateHeader
+ * may carry several location records.
+ *
+ * The headers are built with the encoding selected by the
+ * "GpsrWireFormat" global value. A receiver sets the version of the body
+ * header from the TypeHeader before removing it.
+ */
+enum WireFormat
+{
+  WIRE_LEGACY = 0,   //!< fixed size 64 bit fields
+  WIRE_COMPACT = 1,  //!< quantised relative coordinates
+};
+
+/// \returns the encoding selected by the "GpsrWireFormat" global value
+WireFormat GetWireFormat (void);
+
+/**
+ * \ingroup gpsr
+ * \brief GPSR types
+ */
+
+/**************************************************************************************
+ * TYPEHEADER
+ **************************************************************************************/
+
+class TypeHeader : public Header
+{
+public:
+  /// c-tor
+  TypeHeader (MessageType t);
+
+  ///\name Header serialization/deserialization
+  //\{
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+  //\}
+
+  /// Return type
+  MessageType Get () const
+  {
+    return m_type;
+  }
+  /// Check that type if valid
+  bool IsValid () const
+  {
+    return m_valid; //FIXME that way it wont work
+  }
+  /// Encoding of the headers that follow
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
+  bool operator== (TypeHeader const & o) const;
+private:
+  MessageType m_type;
+  WireFormat m_version;
+  bool m_valid;
+};
+
+std::ostream & operator<< (std::ostream & os, TypeHeader const & h);
+
+class HelloHeader : public Header
+{
+public:
+  /// c-tor
+  HelloHeader (uint64_t originPosx = 0, uint64_t originPosy = 0);
+
+  ///\name Header serialization/deserialization
+  //\{
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+  //\}
+
+  ///\name Fields
+  //\{
+  void SetOriginPosx (uint64_t posx)
+  {
+    m_originPosx = posx;
+  }
+  uint64_t GetOriginPosx () const
+  {
+    return m_originPosx;
+  }
+  void SetOriginPosy (uint64_t posy)
+  {
+    m_originPosy = posy;
+  }
+  uint64_t GetOriginPosy () const
+  {
+    return m_originPosy;
+  }
+  //\}
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
+
+
+  bool operator== (HelloHeader const & o) const;
+private:
+  WireFormat       m_version;
+  uint64_t         m_originPosx;          ///< Originator Position x
+  uint64_t         m_originPosy;          ///< Originator Position x
+};
+
+std::ostream & operator<< (std::ostream & os, HelloHeader const &);
+
+/**************************************************************************************
+ * PositionHeader
+ **************************************************************************************/
+
+class PositionHeader : public Header
+{
+public:
+  /// c-tor
+  PositionHeader (uint64_t dstPosx = 0, uint64_t dstPosy = 0, uint32_t updated = 0, uint64_t recPosx = 0, uint64_t recPosy = 0, uint8_t inRec  = 0, uint64_t lastPosx = 0, uint64_t lastPosy = 0);
+
+  ///\name Header serialization/deserialization
+  //\{
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+  //\}
+
+  ///\name Fields
+  //\{
+  void SetDstPosx (uint64_t posx)
+  {
+    m_dstPosx = posx;
+  }
+  uint64_t GetDstPosx () const
+  {
+    return m_dstPosx;
+  }
+  void SetDstPosy (uint64_t posy)
+  {
+    m_dstPosy = posy;
+  }
+  uint64_t GetDstPosy () const
+  {
+    return m_dstPosy;
+  }
+  void SetUpdated (uint32_t updated)
+  {
+    m_updated = updated;
+  }
+  uint32_t GetUpdated () const
+  {
+    return m_updated;
+  }
+  void SetRecPosx (uint64_t posx)
+  {
+    m_recPosx = posx;
+  }
+  uint64_t GetRecPosx () const
+  {
+    return m_recPosx;
+  }
+  void SetRecPosy (uint64_t posy)
+  {
+    m_recPosy = posy;
+  }
+  uint64_t GetRecPosy () const
+  {
+    return m_recPosy;
+  }
+  void SetInRec (uint8_t rec)
+  {
+    m_inRec = rec;
+  }
+  uint8_t GetInRec () const
+  {
+    return m_inRec;
+  }
+  void SetLastPosx (uint64_t posx)
+  {
+    m_lastPosx = posx;
+  }
+  uint64_t GetLastPosx () const
+  {
+    return m_lastPosx;
+  }
+  void SetLastPosy (uint64_t posy)
+  {
+    m_lastPosy = posy;
+  }
+  uint64_t GetLastPosy () const
+  {
+    return m_lastPosy;
+  }
+  //\}
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
+
+
+  bool operator== (PositionHeader const & o) const;
+
+private:
+  WireFormat       m_version;
+  uint64_t         m_dstPosx;          ///< Destination Position x
+  uint64_t         m_dstPosy;          ///< Destination Position x
+  uint32_t         m_updated;          ///< Time of last update
+  uint64_t         m_recPosx;          ///< x of position that entered Recovery-mode
+  uint64_t         m_recPosy;          ///< y of position that entered Recovery-mode
+  uint8_t          m_inRec;          ///< 1 if in Recovery-mode, 0 otherwise
+  uint64_t         m_lastPosx;          ///< x of position of previous hop
+  uint64_t         m_lastPosy;          ///< y of position of previous hop
+
+};
+
+std::ostream & operator<< (std::ostream & os, PositionHeader const &);
+
+/**
+ * \ingroup gpsr
+ * \brief TypeHeader and PositionHeader at the start of a GPSR data packet
+ *
+ * Packet::PeekHeader on a DataHeader reads both headers in one pass of a
+ * Buffer::Iterator, without removing them. Replace puts the modified
+ * headers back. The packet keeps the two headers in its metadata, so a
+ * DataHeader is never added nor removed as such.
+ */
+class DataHeader : public Header
+{
+public:
+  DataHeader ();
+
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  /// The PositionHeader is only read after a GPSRTYPE_POS type
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+
+  const TypeHeader & GetType () const
+  {
+    return m_type;
+  }
+  PositionHeader & GetPosition ()
+  {
+    return m_position;
+  }
+  /// The position is written with the encoding of the type header
+  void SetPosition (const PositionHeader &position)
+  {
+    m_position = position;
+    m_position.SetVersion (m_type.GetVersion ());
+  }
+  /**
+   * Replace the headers at the start of p by the ones held here: they are
+   * removed and added again, so p must not be shared with its sender.
+   */
+  void Replace (Ptr<Packet> p) const;
+
+private:
+  TypeHeader m_type;
+  PositionHeader m_position;
+};
+
+/**************************************************************************************
+ * LocHelloHeader
+ **************************************************************************************/
+
+class LocHelloHeader : public Header
+{
+public:
+	// NodeID - NodePosition - NodeSpeed
+	LocHelloHeader(Ipv4Address nodeid = Ipv4Address(), uint64_t nodePosx = 0, uint64_t nodePosy = 0);
+
+	static TypeId GetTypeId ();
+	TypeId GetInstanceTypeId () const;
+	uint32_t GetSerializedSize () const;
+	void Serialize (Buffer::Iterator start) const;
+	uint32_t Deserialize (Buffer::Iterator start);
+	void Print (std::ostream &os) const;
+
+	Ipv4Address GetNodeID() const
+	{
+		return m_nodeid;
+	}
+	void SetNodeID(Ipv4Address node)
+	{
+		m_nodeid = node;
+	}
+	void SetOriginPosx (uint64_t posx)
+	{
+		m_nodePosx = posx;
+	}
+	uint64_t GetOriginPosx () const
+	{
+		return m_nodePosx;
+	}
+	void SetOriginPosy (uint64_t posy)
+	{
+		m_nodePosy = posy;
+	}
+	uint64_t GetOriginPosy () const
+	{
+		return m_nodePosy;
+	}
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
+	bool operator== (LocHelloHeader const & o) const;
+
+private:
+	 WireFormat m_version;
+	 Ipv4Address m_nodeid;
+	 uint64_t         m_nodePosx;
+	 uint64_t         m_nodePosy;
+};
+
+std::ostream & operator<< (std::ostream & os, LocHelloHeader const &);
+
+/**************************************************************************************
+ * LocUpdateHeader
+ **************************************************************************************/
+
+/// Position and speed of one node, as carried by a LocUpdateHeader
+struct LocationRecord
+{
+	LocationRecord (Ipv4Address nodeid = Ipv4Address(), uint64_t posx = 0, uint64_t posy = 0, uint32_t speed = 0);
+
+	Ipv4Address nodeid;
+	uint64_t posx;
+	uint64_t posy;
+	uint32_t speed;
+
+	bool operator== (LocationRecord const & o) const;
+};
+
+/**
+ * The header holds one location record, which the node accessors refer
+ * to. In the compact encoding more records can be added and are sent in
+ * the same packet; the legacy encoding carries exactly one.
+ */
+class LocUpdateHeader : public Header
+{
+public:
+	// NodeID - NodePosition - NodeSpeed
+	LocUpdateHeader(Ipv4Address nodeid = Ipv4Address(), uint64_t originPosx = 0, uint64_t originPosy = 0, uint32_t speed = 0);
+
+	static TypeId GetTypeId ();
+	TypeId GetInstanceTypeId () const;
+	uint32_t GetSerializedSize () const;
+	void Serialize (Buffer::Iterator start) const;
+	uint32_t Deserialize (Buffer::Iterator start);
+	void Print (std::ostream &os) const;
+
+	Ipv4Address GetNodeID() const
+	{
+		return m_records[0].nodeid;
+	}
+	void SetNodeID(Ipv4Address node)
+	{
+		m_records[0].nodeid = node;
+	}
+	void SetOriginPosx (uint64_t posx)
+	{
+		m_records[0].posx = posx;
+	}
+	uint64_t GetOriginPosx () const
+	{
+		return m_records[0].posx;
+	}
+	void SetOriginPosy (uint64_t posy)
+	{
+		m_records[0].posy = posy;
+	}
+	uint64_t GetOriginPosy () const
+	{
+		return m_records[0].posy;
+	}
+	uint32_t GetSpeed() const
+	{
+		return m_records[0].speed;
+	}
+	void SetSpeed(uint32_t speed)
+	{
+		m_records[0].speed = speed;
+	}
+
+	/// Append a record, sent after the ones already held
+	void AddRecord (const LocationRecord &record)
+	{
+		m_records.push_back (record);
+	}
+	uint32_t GetNRecords () const
+	{
+		return m_records.size ();
+	}
+	const LocationRecord & GetRecord (uint32_t i) const
+	{
+		return m_records[i];
+	}
+	/// Maximum number of records of a compact header
+	static const uint32_t MAX_RECORDS = 255;
+
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
+	 bool operator== (LocUpdateHeader const & o) const;
+
+private:
+	  WireFormat m_version;
+	  std::vector<LocationRecord> m_records;
+};
+
+std::ostream & operator<< (std::ostream & os, LocUpdateHeader const &);
+
+/**************************************************************************************
+ * LocQueryHeader
+ **************************************************************************************/
+
+class LocQueryHeader : public Header
+{
+public:
+	// NodeID - NodePosition - NodeSpeed
+	LocQueryHeader(Ipv4Address nodeid = Ipv4Address(), Ipv4Address destid = Ipv4Address(),Ipv4Address queryid = Ipv4Address());
+
+	static TypeId GetTypeId ();
+	TypeId GetInstanceTypeId () const;
+	uint32_t GetSerializedSize () const;
+	void Serialize (Buffer::Iterator start) const;
+	uint32_t Deserialize (Buffer::Iterator start);
+	void Print (std::ostream &os) const;
+
+	Ipv4Address GetNodeID() const
+	{
+		return m_nodeid;
+	}
+	void SetNodeID(Ipv4Address node)
+	{
+		m_nodeid = node;
+	}
+
+	Ipv4Address GetDestID() const
+	{
+		return m_destid;
+	}
+	void SetDestID(Ipv4Address node)
+	{
+		m_destid = node;
+	}
+	Ipv4Address GetQueryID() const
+	{
+		return m_queryid;
+	}
+	void SetQueryID(Ipv4Address node)
+	{
+		m_queryid = node;
+	}
+
+
+	 bool operator== (LocQueryHeader const & o) const;
+
+private:
+	  Ipv4Address 		   m_nodeid;
+	  Ipv4Address 		   m_destid;
+	  Ipv4Address		   m_queryid;
+};
+
+std::ostream & operator<< (std::ostream & os, LocQueryHeader const &);
+
+/**************************************************************************************
+ * LocReplyHeader
+ **************************************************************************************/
+
+class LocReplyHeader : public Header
+{
+public:
+	// NodeID - NodePosition - NodeSpeed
+	LocReplyHeader(Ipv4Address nodeid = Ipv4Address(), Ipv4Address destid = Ipv4Address(),uint64_t posx = 0,
+			uint64_t posy=0);
+
+	static TypeId GetTypeId ();
+	TypeId GetInstanceTypeId () const;
+	uint32_t GetSerializedSize () const;
+	void Serialize (Buffer::Iterator start) const;
+	uint32_t Deserialize (Buffer::Iterator start);
+	void Print (std::ostream &os) const;
+
+	Ipv4Address GetNodeID() const
+	{
+		return m_nodeid;
+	}
+	void SetNodeID(Ipv4Address node)
+	{
+		m_nodeid = node;
+	}
+
+	Ipv4Address GetDestID() const
+	{
+		return m_destid;
+	}
+	void SetDestID(Ipv4Address node)
+	{
+		m_destid = node;
+	}
+	uint64_t GetPosx() const
+	{
+		return m_posx;
+	}
+	void SetPosx(uint64_t posx)
+	{
+		m_posx = posx;
+	}
+	uint64_t GetPosy() const
+	{
+		return m_posy;
+	}
+	void SetPosy(uint64_t posy)
+	{
+		m_posy = posy;
+	}
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
+
+	 bool operator== (LocReplyHeader const & o) const;
+
+private:
+	  WireFormat 		   m_version;
+	  Ipv4Address 		   m_nodeid;
+	  Ipv4Address 		   m_destid;
+	  uint64_t    		   m_posx;
+	  uint64_t			   m_posy;
+};
+
+std::ostream & operator<< (std::ostream & os, LocReplyHeader const &);
+
+/**
+ * \ingroup gpsr
+ * \brief SLS messages waiting to be sent to the same node in one packet
+ *
+ * The packet holds the updates, then the queries, then the replies, each
+ * message after its own TypeHeader. In the compact encoding the update
+ * records share LocUpdateHeaders, the legacy one sends a message per
+ * record. A new update of a node replaces the one waiting.
+ */
+class SlsBatch
+{
+public:
+  void AddUpdate (const LocationRecord &record);
+  void AddQuery (const LocQueryHeader &query);
+  void AddReply (const LocReplyHeader &reply);
+
+  const std::vector<LocationRecord> & GetUpdates () const
+  {
+    return m_updates;
+  }
+  const std::vector<LocQueryHeader> & GetQueries () const
+  {
+    return m_queries;
+  }
+  const std::vector<LocReplyHeader> & GetReplies () const
+  {
+    return m_replies;
+  }
+  bool IsEmpty () const;
+
+  /// \returns a packet holding all the messages
+  Ptr<Packet> ToPacket () const;
+  /// \returns the bytes of the update messages in the packet
+  uint32_t GetUpdateSize () const;
+
+private:
+  /// Adds the update messages in front of p
+  void AddUpdates (Ptr<Packet> p) const;
+
+  std::vector<LocationRecord> m_updates;
+  std::vector<LocQueryHeader> m_queries;
+  std::vector<LocReplyHeader> m_replies;
+};
+
+
+}
+}
+#endif /* GPSRPACKET_H */
@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GPSR_POSITION_SNAPSHOT_H
+#define GPSR_POSITION_SNAPSHOT_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include <vector>
+#include <map>
+
+namespace ns3 {
+namespace gpsr {
+
+/**
+ * \ingroup gpsr
+ * \brief Positions of the nodes at one time, shared by all the nodes
+ *
+ * With the BeaconFree attribute, the GPSR vehicles register their
+ * mobility model here instead of sending hellos, and take their
+ * neighbors from the snapshot: the nodes within a range of them at the
+ * time it was taken. The snapshot is taken again on the first query
+ * after it is older than the staleness the query allows, so that its
+ * cost, a pass over the registered nodes and a sort by x coordinate,
+ * is paid once for all the nodes. The queries then only visit the
+ * nodes whose x is within range. Cleared by Simulator::Destroy. A mutex
+ * guards the snapshot when threading is enabled, for the nodes run in
+ * parallel by ParallelSimulatorImpl; the snapshot only depends on the
+ * time it is taken at, whichever node takes it.
+ */
+class PositionSnapshot
+{
+public:
+  /// A node of the snapshot
+  struct Entry
+  {
+    Ipv4Address address;
+    Vector position;
+  };
+
+  /**
+   * \param address the address the node is known by
+   * \param mobility the mobility model of the node
+   */
+  static void Add (Ipv4Address address, Ptr<MobilityModel> mobility);
+  /// \param address the address to forget
+  static void Remove (Ipv4Address address);
+  /**
+   * \param self the address of the node asking, left out of the neighbors
+   * \param position the position of the node asking
+   * \param range the distance (m) within which the nodes are neighbors
+   * \param staleness the snapshot is taken again if it is older than this
+   * \param neighbors filled with the neighbors, at their snapshot position
+   * \returns the time the snapshot was taken at
+   */
+  static Time GetNeighbors (Ipv4Address self, Vector position, double range, Time staleness,
+                            std::vector<Entry> &neighbors);
+  /// \returns the number of snapshots taken so far
+  static uint32_t GetNSnapshots (void);
+
+private:
+  /// Orders entries by their x coordinate
+  struct CompareX
+  {
+    bool operator() (const Entry &a, double x) const { return a.position.x < x; }
+    bool operator() (double x, const Entry &a) const { return x < a.position.x; }
+    bool operator() (const Entry &a, const Entry &b) const { return a.position.x < b.position.x; }
+  };
+  struct State
+  {
+    std::map<Ipv4Address, Ptr<MobilityModel> > nodes;
+    /// Positions of the nodes, sorted by x, valid if taken
+    std::vector<Entry> entries;
+    Time time;
+    bool taken;
+    uint32_t nSnapshots;
+  };
+
+  static State *Get (void);
+  static State **DoGet (void);
+  static void Delete (void);
+  static void Take (State *state);
+};
+
+}
+}
+#endif /* GPSR_POSITION_SNAPSHOT_H */
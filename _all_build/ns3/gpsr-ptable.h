@@ -0,0 +1,206 @@
+#ifndef GPSR_PTABLE_H
+#define GPSR_PTABLE_H
+
+#include <map>
+#include <vector>
+#include <queue>
+#include <cassert>
+#include <stdint.h>
+#include "ns3/ipv4.h"
+#include "ns3/timer.h"
+#include <sys/types.h>
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/mobility-model.h"
+#include "ns3/vector.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/random-variable.h"
+
+namespace ns3 {
+namespace gpsr {
+
+/// Planar subgraph on which the perimeter mode applies the right hand rule
+enum Planarization
+{
+  PLANARIZATION_NONE,    ///< all neighbors
+  PLANARIZATION_GABRIEL, ///< Gabriel graph
+  PLANARIZATION_RNG      ///< Relative Neighborhood Graph
+};
+
+/*
+ * \ingroup gpsr
+ * \brief Position table used by GPSR
+ *
+ * Besides the per-address table, the neighbors are kept in a flat vector
+ * sorted by their x coordinate, so that the greedy next hop search only
+ * visits the neighbors whose x is closer to the destination than the best
+ * candidate found so far, and the distance based purge only has to trim
+ * both ends of the vector. The perimeter mode finds the right hand rule
+ * successor in a single pass over the planarized neighbors, and the planar subgraph
+ * is kept, then sorted by bearing, for as long as neither the node nor
+ * its neighbors have moved. Bearings are compared as pseudo-angles, which
+ * are monotonic in the angle without calling trigonometric functions.
+ * Entries expire lazily through a heap ordered by expiration time.
+ */
+class PositionTable
+{
+public:
+  /// c-tor
+  PositionTable ();
+
+  /**
+   * \brief Gets the last time the entry was updated
+   * \param id Ipv4Address to get time of update from
+   * \return Time of last update to the position
+   */
+  Time GetEntryUpdateTime (Ipv4Address id);
+
+  /**
+   * \brief Sets how long an entry lives without a new HELLO, 2 seconds by default.
+   * To be called before the first entry is added.
+   */
+  void SetEntryLifeTime (Time lifetime);
+  Time GetEntryLifeTime (void) const;
+  /**
+   * \brief Adds entry in position table
+   */
+  void AddEntry (Ipv4Address id, Vector position);
+
+  /**
+   * \brief Deletes entry in position table
+   */
+  void DeleteEntry (Ipv4Address id);
+
+  /**
+   * \brief Gets position from position table
+   * \param id Ipv4Address to get position from
+   * \return Position of that id or PositionTable::GetInvalidPosition () if not known
+   */
+  Vector GetPosition (Ipv4Address id);
+  void PrintTable(Ipv4Address id);
+  /**
+   * \brief Checks if a node is a neighbour
+   * \param id Ipv4Address of the node to check
+   * \return True if the node is neighbour, false otherwise
+   */
+  bool isNeighbour (Ipv4Address id);
+
+  /**
+   * \brief remove entries with expired lifetime
+   */
+  void Purge (Vector MM, bool function);
+
+  /**
+   * \brief clears all entries
+   */
+  void Clear ();
+
+  /**
+   * \Get Callback to ProcessTxError
+   */
+  Callback<void, WifiMacHeader const &> GetTxErrorCallback () const
+  {
+    return m_txErrorCallback;
+  }
+
+  /**
+   * \brief Gets next hop according to GPSR protocol
+   * \param position the position of the destination node
+   * \param nodePos the position of the node that has the packet
+   * \return Ipv4Address of the next hop, Ipv4Address::GetZero () if no nighbour was found in greedy mode
+   */
+  Ipv4Address BestNeighbor (Vector position, Vector nodePos);
+
+  bool IsInSearch (Ipv4Address id);
+
+  bool HasPosition (Ipv4Address id);
+
+  static Vector GetInvalidPosition ()
+  {
+    return Vector (-1, -1, 0);
+  }
+
+  /**
+   * \brief Gets next hop according to GPSR recovery-mode protocol (right hand rule)
+   * \param previousHop the position of the node that sent the packet to this node
+   * \param nodePos the position of the destination node
+   * \return Ipv4Address of the next hop, Ipv4Address::GetZero () if no nighbour was found in greedy mode
+   */
+  Ipv4Address BestAngle (Vector previousHop, Vector nodePos);
+
+  /**
+   * \brief Sets the planar subgraph used by BestAngle, PLANARIZATION_NONE by default
+   */
+  void SetPlanarization (enum Planarization planarization);
+  enum Planarization GetPlanarization (void) const;
+
+  //Gives angle between the vector CentrePos-Refpos to the vector CentrePos-node counterclockwise
+  double GetAngle (Vector centrePos, Vector refPos, Vector node);
+
+
+private:
+  /// Neighbor in the spatial index
+  struct Neighbor
+  {
+    Ipv4Address id;
+    Vector position;
+  };
+  /// Orders neighbors by their x coordinate
+  struct CompareX
+  {
+    bool operator() (const Neighbor &a, double x) const { return a.position.x < x; }
+    bool operator() (double x, const Neighbor &a) const { return x < a.position.x; }
+  };
+  /// Bearing (pseudo-angle) of a neighbor seen from m_angularCentre
+  struct Bearing
+  {
+    double angle;
+    Ipv4Address id;
+    bool operator< (const Bearing &o) const
+    {
+      return angle < o.angle || (angle == o.angle && id < o.id);
+    }
+  };
+  typedef std::pair<Time, Ipv4Address> Expiration;
+
+  /// Remove id located at x from the spatial index
+  void RemoveFromIndex (Ipv4Address id, double x);
+  /// Remove the entries of the spatial index in [begin, end) from the table
+  void Erase (std::vector<Neighbor>::iterator begin, std::vector<Neighbor>::iterator end);
+  /// Remove the entries whose lifetime expired
+  void Expire ();
+  /// \returns a value in [0, 4) increasing with the counterclockwise angle of (dx, dy)
+  static double PseudoAngle (double dx, double dy);
+  /// Compute the planar subgraph of the neighbors seen from centrePos
+  void Planarize (Vector centrePos);
+  /// Sort the planar neighbors by bearing
+  void SortBearings ();
+
+  Time m_entryLifeTime;
+  std::map<Ipv4Address, std::pair<Vector, Time> > m_table;
+  /// Neighbors sorted by x coordinate
+  std::vector<Neighbor> m_spatial;
+  /// Pending expirations, an entry updated since it was pushed is skipped
+  std::priority_queue<Expiration, std::vector<Expiration>, std::greater<Expiration> > m_expirations;
+  enum Planarization m_planarization;
+  /// Planar neighbors seen from m_angularCentre, valid if m_angularValid
+  std::vector<Neighbor> m_planar;
+  /// m_planar sorted by bearing, valid if m_bearingsSorted
+  std::vector<Bearing> m_bearings;
+  Vector m_angularCentre;
+  bool m_angularValid;
+  bool m_bearingsSorted;
+  // TX error callback
+  Callback<void, WifiMacHeader const &> m_txErrorCallback;
+  // Process layer 2 TX error notification
+  void ProcessTxError (WifiMacHeader const&);
+  Ptr<Ipv4> m_ipv4;
+
+
+
+
+};
+
+}   // gpsr
+} // ns3
+#endif /* GPSR_PTABLE_H */
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GPSR_RSU_DIRECTORY_H
+#define GPSR_RSU_DIRECTORY_H
+
+#include "ns3/object.h"
+#include "ns3/header.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include "ns3/traced-callback.h"
+#include <vector>
+#include <map>
+
+namespace ns3 {
+namespace gpsr {
+
+/// Last position a vehicle reported to the road side units
+struct DirectoryRecord
+{
+  DirectoryRecord ();
+  DirectoryRecord (Ipv4Address vehicle, Vector position, Vector velocity, Time updated);
+
+  Ipv4Address vehicle;
+  Vector position;
+  Vector velocity;
+  Time updated;
+};
+
+enum DirectoryMessageType
+{
+  DIRECTORY_UPDATE = 1,  //!< batch of records replicated to a shard owner
+  DIRECTORY_LOOKUP = 2,  //!< request for the record of one vehicle
+  DIRECTORY_ANSWER = 3,  //!< answer to a lookup, with zero or one record
+};
+
+/**
+ * \ingroup gpsr
+ * \brief Message exchanged by the RsuDirectory over the backhaul
+ *
+ * Members are identified by their index in the directory, so that the
+ * intermediate road side units of a chain backhaul can forward the
+ * messages which are not for them.
+ */
+class DirectoryHeader : public Header
+{
+public:
+  DirectoryHeader (DirectoryMessageType type = DIRECTORY_UPDATE, uint16_t source = 0,
+                   uint16_t destination = 0, uint32_t requestId = 0);
+
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+
+  DirectoryMessageType GetType () const { return m_type; }
+  uint16_t GetSource () const { return m_source; }
+  uint16_t GetDestination () const { return m_destination; }
+  uint32_t GetRequestId () const { return m_requestId; }
+  const std::vector<DirectoryRecord> & GetRecords () const { return m_records; }
+  void AddRecord (const DirectoryRecord &record) { m_records.push_back (record); }
+
+  /// Size of a serialized record
+  static const uint32_t RECORD_SIZE = 44;
+
+private:
+  DirectoryMessageType m_type;
+  uint16_t m_source;
+  uint16_t m_destination;
+  uint32_t m_requestId;
+  std::vector<DirectoryRecord> m_records;
+};
+
+/**
+ * \ingroup gpsr
+ * \brief Location directory shared by the road side units
+ *
+ * Every road side unit (RSU) runs one RsuDirectory. The vehicle address
+ * space is hashed into a fixed number of shards, and each shard is owned
+ * by Replicas consecutive RSUs. The updates an RSU receives from the
+ * vehicles in its range are batched per owner and replicated to the
+ * owners every BatchInterval over the backhaul. A location query that
+ * the RSU cannot answer from its own table turns into one lookup sent
+ * to the nearest owner of the vehicle's shard.
+ *
+ * The backhaul carries the directory messages directly over its
+ * NetDevices (protocol PROT_NUMBER), so it needs no IP configuration and
+ * does not interfere with GPSR. GpsrHelper::InstallRsuDirectory builds
+ * it.
+ */
+class RsuDirectory : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  /// Protocol number of the directory messages on the backhaul
+  static const uint16_t PROT_NUMBER;
+
+  /// Called with the requester, the vehicle, whether it was found and its record
+  typedef Callback<void, Ipv4Address, Ipv4Address, bool, const DirectoryRecord &> AnswerCallback;
+
+  RsuDirectory ();
+  virtual ~RsuDirectory ();
+
+  /**
+   * \param members the wireless addresses of all the RSUs of the directory,
+   * in corridor order
+   * \param self index of this RSU in members
+   */
+  void SetMembers (const std::vector<Ipv4Address> &members, uint32_t self);
+  /// Receive directory messages from this backhaul device
+  void AddBackhaul (Ptr<NetDevice> device);
+  /// Send the messages for member through device, to address
+  void SetRoute (uint32_t member, Ptr<NetDevice> device, Address address);
+  void SetAnswerCallback (AnswerCallback cb);
+
+  /// Record the position a vehicle just reported to this RSU
+  void NotifyUpdate (Ipv4Address vehicle, Vector position, Vector velocity);
+  /**
+   * Look the vehicle up in the directory. The answer callback is called
+   * right away if this RSU owns the shard of the vehicle, and when the
+   * answer of the owner arrives otherwise.
+   */
+  void Lookup (Ipv4Address vehicle, Ipv4Address requester);
+
+  uint32_t GetShard (Ipv4Address vehicle) const;
+  bool IsOwner (uint32_t member, uint32_t shard) const;
+  uint32_t GetSelf (void) const;
+
+  /// Number of directory packets and bytes sent on the backhaul, forwarding included
+  uint64_t GetTxPackets (void) const;
+  uint64_t GetTxBytes (void) const;
+
+  /**
+   * \returns true if address is the wireless address of a member of a
+   * directory or, when no directory is installed, one of the
+   * GpsrRsuAddresses global value
+   */
+  static bool IsRsu (Ipv4Address address);
+
+private:
+  virtual void DoDispose (void);
+
+  struct Route
+  {
+    Ptr<NetDevice> device;
+    Address address;
+  };
+  struct PendingLookup
+  {
+    Ipv4Address vehicle;
+    Ipv4Address requester;
+    Time start;
+  };
+
+  void Send (const DirectoryHeader &header);
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+  void Flush (void);
+  void Store (const DirectoryRecord &record);
+  bool Find (Ipv4Address vehicle, DirectoryRecord &record) const;
+
+  uint32_t m_nShards;
+  uint32_t m_replicas;
+  Time m_batchInterval;
+  Time m_recordLifetime;
+  uint32_t m_maxRecords;
+
+  std::vector<Ipv4Address> m_members;
+  uint32_t m_self;
+  std::vector<Route> m_routes;
+  AnswerCallback m_answer;
+
+  /// Records of the owned shards, indexed by shard
+  std::vector<std::map<Ipv4Address, DirectoryRecord> > m_shards;
+  /// Deltas waiting for the next batch, per destination member
+  std::map<uint32_t, std::map<Ipv4Address, DirectoryRecord> > m_pending;
+  EventId m_flushEvent;
+  std::map<uint32_t, PendingLookup> m_lookups;
+  uint32_t m_nextRequestId;
+
+  uint64_t m_txPackets;
+  uint64_t m_txBytes;
+  TracedCallback<Ptr<const Packet> > m_backhaulTxTrace;
+  TracedCallback<Ipv4Address, Time> m_lookupTrace;
+};
+
+}
+}
+#endif /* GPSR_RSU_DIRECTORY_H */
@@ -0,0 +1,245 @@
+#ifndef SlsLocationService_H
+#define SlsLocationService_H
+
+#include "ns3/node.h"
+#include "ns3/location-service.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "gpsr-ltable.h"
+#include "gpsr-event-log.h"
+#include "gpsr-rsu-directory.h"
+#include "gpsr-packet.h"
+#include "ns3/callback.h"
+#include <map>
+
+
+namespace ns3
+{
+namespace gpsr
+{
+/**
+ * \ingroup gpsr
+ *
+ * \brief RLS Location Service
+ */
+class SlsLocationService : public LocationService
+{
+public:
+	static const uint16_t SLS_PORT;
+	//static TypeId GetTypeId (void);
+	void SetIpv4 (Ptr<Ipv4> ipv4);
+
+	/* Função que devolve um vector inválido para quando uma posição
+	 * nao se encontram na tabela */
+	Vector GetInvalidPosition() {return Vector(-1, -1, 0); }
+	/* Função a usar pelo routing quando quiser obter uma posição
+	 * Se nao tiver a posição começa pesquisa
+	 * FIXME: Ainda nao está definida */
+	Vector GetPositionOf(Ipv4Address  adr);
+
+	/* Confirm se tem posiçao e n ta searching, mas se n tiver, n começa a procura
+	 * FIXME: Ainda n definida
+	 */
+	bool HasPosition(Ipv4Address  adr);
+
+	/* Funções que permitem aceder à tabela directamente */
+	Time GetEntryUpdateTime(Ipv4Address id){ return m_table.GetEntryUpdateTime(id); }
+
+	Vector GODPredict(Ipv4Address dst);
+	Vector Predict(Ipv4Address dst);
+
+	void RefreshPosition(Ipv4Address dst);
+
+	void AddEntry(Ipv4Address id, Vector position, int speed, bool flag = false, uint8_t seq = 0)
+	{
+		//FIXME Andre
+		if(!GetFunction())
+		{	//Sou RSU
+			m_table.AddEntry(id, position, speed, flag, seq);
+		}
+		else
+		{	//Sou OBU
+			if(id == m_ipv4->GetAddress (1, 0).GetLocal ())
+			{
+				m_table.DeleteEntry(id);
+				m_table.AddEntry(id, position, speed, flag, seq);
+			}
+			else
+			{
+				m_table.AddEntry(id, position, speed, flag, seq);
+			}
+		}
+
+		//m_table.PrintTable();
+	}
+
+	void DeleteEntry(Ipv4Address id) {
+		m_table.DeleteEntry(id);
+	}
+
+	/* Directory shared with the other RSUs, which answers the queries
+	 * this RSU has no entry for */
+	void SetDirectory(Ptr<RsuDirectory> directory);
+	/* Reads the tables of the other RSUs, for the RSUs without a
+	 * directory */
+	Vector RSUSearch(Ipv4Address id);
+
+	/*
+	 * @return true if RLS is still in search of the address, false otherwise
+	 * if in search for too long stops searching
+	 * */
+	bool IsInSearch(Ipv4Address id);
+
+	Vector GetPosition(Ipv4Address id);
+	int GetSpeed(Ipv4Address id);
+	Time GetTime(Ipv4Address id);
+
+	/* Devolve a distancia entre dois vectores */
+	double PositionsDistance(Vector from, Vector to);
+
+	void Purge() {m_table.Purge(); }
+	void Clear() {m_table.Clear(); }
+
+	Time GetMaxSearchTime(){ return m_maxSearchTime;}
+	void SetMaxSearchTime(Time t){m_maxSearchTime = t;}
+
+
+	SlsLocationService (Time tableLifeTime);
+	virtual ~SlsLocationService();
+
+	virtual void DoDispose ();
+
+	/* Serve para limpar o mapa que contem informação sobre os resquest
+	 * já enviados/recebidos
+	 * FIXME so apagar os outdated, neste momento apaga tudo
+	 */
+	void PurgePacketMap(){ m_packetSended.clear(); }
+
+	/* Função que vai ver se nao tem nada para ler no socket e posteriormente
+	 * invocao um RcvReply ou um RcvRequest para tratar do pacote recebido */
+	void RecvSls (Ptr<Socket> socket);
+	/* Envia um pedido de localização do no dst com um numero maximo de ttl*/
+
+	void SendReply(Ipv4Address dst, Ipv4Address src, Ipv4Address query, Vector position);
+
+	/* Recebendo um reply o no verifica se é o destino desse reply caso
+	 * contrário reenvia a informação */
+	void RcvReply (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src);
+	void SendLocHello(Ipv4Address dst, Ipv4Address src, Vector position);
+	void SendLocUpdate(Ptr<Packet> p, Ipv4Address dst, Ipv4Address src, Vector Position);
+	void ReceiveUpdate(Ptr<Packet> p, Ipv4Address dst, Ipv4Address src, Vector Position, int speed);
+
+	void SendQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address query);
+	void ReceiveQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address query);
+	void ReceiveReply(Ipv4Address src, Ipv4Address dst, Vector pos);
+	//Vector ReplyQuery(Ipv4Address dst, Ipv4Address src, Ipv4Address query);
+	/* Fazem coisas que nao sei bem o que mas são necessárias para ter
+	 * o meu m_ipv4 actualizado */
+	void  NotifyInterfaceDown (uint32_t i);
+	void  NotifyInterfaceUp (uint32_t i);
+	void  NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address);
+	void  NotifyAddAddress (uint32_t i, Ipv4InterfaceAddress address);
+
+	// Find socket with local interface address iface
+  	Ptr<Socket> FindSocketWithInterfaceAddress (Ipv4InterfaceAddress iface) const;
+	// Compara dois vectores
+	bool VectorComparator(Vector vec1, Vector vec2){return ((vec1.x == vec2.x) && (vec1.x == vec2.x));}
+
+	/*** Funcoes relativas a se é OBU ou RSU ***/
+	void SetFunction(bool f);
+	// Funcao que devolve function: RSU or OBU. OBU is equal to true, RSU false
+	bool GetFunction(){return m_function;}
+	Ipv4Address GetMRsu(){ return m_rsu;}
+	void SetMRsu(Ipv4Address rsu);
+
+	/* Adaptive updates: instead of waiting for the RSU to ask, the OBU
+	 * sends an update when the position its RSU predicts drifts from the
+	 * true one by more than distance metres, when its speed changes by more
+	 * than speed m/s or its heading by more than heading radians, or when
+	 * its last update is older than maxInterval */
+	void SetAdaptiveUpdates(bool enabled, double distance, double speed, double heading, Time maxInterval);
+	bool GetAdaptiveUpdates(){ return m_adaptive; }
+	/* Called by the OBU every hello interval. Returns true if an update was sent */
+	bool CheckUpdate();
+	/* True if the RSU view reported, last updated at lastUpdate, is too far
+	 * from the true position and velocity of the OBU */
+	bool NeedsUpdate(const KinematicState &reported, Time lastUpdate, Vector position, Vector velocity);
+
+	/* Bytes of location hellos and updates sent, and bytes of the updates
+	 * that adaptive updates did not send, counting one update per hello
+	 * interval as the reference. UDP payload only. */
+	uint64_t GetControlBytesSent(){ return m_controlBytesSent; }
+	uint64_t GetControlBytesSaved(){ return m_controlBytesSaved; }
+
+	/* The updates, queries and replies sent to the same node within window
+	 * of the first one are coalesced into one packet (see SlsBatch). With a
+	 * zero window each of them is sent at once */
+	void SetBatchWindow(Time window){ m_batchWindow = window; }
+	Time GetBatchWindow(){ return m_batchWindow; }
+
+	void Print();
+	Vector GetMPosRsu(){ return m_posrsu;}
+	void SetMPosRsu(Vector posrsu){m_posrsu = posrsu;}
+
+	/* Callback used to report queries and replies to the routing
+	 * protocol's binary event trace */
+	void SetEventCallback(Callback<void, const GpsrEvent &> cb){ m_eventCallback = cb; }
+	/* Callback invoked with the address of a node whose position was just
+	 * learned, so that packets waiting for it can be released */
+	void SetPositionCallback(Callback<void, Ipv4Address> cb){ m_positionCallback = cb; }
+
+private:
+  // Start protocol operation
+  void Start ();
+  /* Guarda informação numa tabela sobre os dados de um nó, a cache descrita
+   * no artigo */
+  LocationTable m_table;
+  /* Guarda um contador com o SequenceNumber do ultimo pacote enviado */
+  uint32_t m_maxNumSeqSended;
+  // Raw socket per each IP interface, map socket -> iface address (IP + mask)
+  std::map< Ptr<Socket>, Ipv4InterfaceAddress > m_socketAddresses;
+  /* Dos pacotes enviados guarda a origem do pacote e o id para evitar reenviar
+   * request ou reply que ja tenham sido enviados anteriormente */
+  std::map<Ipv4Address, uint32_t> m_packetSended;
+  /* Permite fazer um sistema de timeout para que quando envio para os vizinhos
+   * se ninguem responder ao fim do timeout manda para todos */
+  Timer m_rreqRateLimitTimer;
+  Time m_maxSearchTime;
+  Ptr<Ipv4> m_ipv4;
+  bool m_function; // Function in the context: If is RSU or OBU. RSU is equal to false, OBU true;
+  Ipv4Address m_rsu; //Se nao sei nada, foi à minha RSU. É este o valor dela
+  Vector m_posrsu; //Posicao da Rsu so para retornar logo
+  Callback<void, const GpsrEvent &> m_eventCallback;
+  Callback<void, Ipv4Address> m_positionCallback;
+  Ptr<RsuDirectory> m_directory;
+  /* Entry of this OBU in the table of its RSU, as the RSU computed it from
+   * the updates it received */
+  LocationTable m_reported;
+  Time m_lastUpdate;
+  /* RSU: time of the last update received from each OBU */
+  std::map<Ipv4Address, Time> m_updates;
+  bool m_adaptive;
+  double m_distanceThreshold;
+  double m_speedThreshold;
+  double m_headingThreshold;
+  Time m_maxUpdateInterval;
+  uint64_t m_controlBytesSent;
+  uint64_t m_controlBytesSaved;
+  /* Messages waiting for the end of the batch window, per destination */
+  struct PendingBatch
+  {
+    SlsBatch messages;
+    EventId flush;
+  };
+  std::map<Ipv4Address, PendingBatch> m_batches;
+  Time m_batchWindow;
+  // Batch of dst, whose flush is scheduled when it is started
+  SlsBatch & GetBatch (Ipv4Address dst);
+  void FlushBatch (Ipv4Address dst);
+  // Replies to a query with the predicted position of the vehicle
+  void DirectoryAnswer (Ipv4Address requester, Ipv4Address vehicle, bool found, const DirectoryRecord &record);
+};
+
+}
+}
+#endif /* SlsLocationService_H */
+
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in "Ladder
+ * Queue: An O(1) Priority Queue Structure for Large-Scale Discrete Event
+ * Simulation" by W. T. Tang, R. S. M. Goh and I. L. Thng (ACM TOMACS, 2005).
+ *
+ * Events are kept in three tiers:
+ *  - the top: an unsorted list of the far-future events,
+ *  - the ladder: up to MAX_RUNGS rungs of buckets, each rung spreading the
+ *    events of one bucket of the rung above over finer buckets,
+ *  - the bottom: a short sorted list of the next events to run.
+ *
+ * Events are only sorted once they reach the bottom, and a bucket is split
+ * on a new rung instead of being sorted when it holds more than
+ * BOTTOM_THRESHOLD events, so that insertion and removal are O(1)
+ * amortised whatever the distribution of the event timestamps.
+ *
+ * Unlike the CalendarScheduler, there is no resizing heuristic: the
+ * width of the buckets of a rung is derived from the events it is built
+ * from.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  struct Rung
+  {
+    // timestamp of the start of the first bucket
+    uint64_t start;
+    // duration of a bucket
+    uint64_t width;
+    // index of the first bucket which can hold events
+    uint32_t current;
+    // number of buckets in use in m_buckets
+    uint32_t nBuckets;
+    std::vector<Bucket> buckets;
+  };
+
+  // maximum number of events dequeued to the bottom without being split
+  static const uint32_t BOTTOM_THRESHOLD = 50;
+  static const uint32_t MAX_RUNGS = 8;
+
+  inline uint64_t RungCurrent (const Rung &rung) const;
+  void InsertBottom (const Event &ev);
+  void CreateRung (Bucket &events, uint64_t start, uint64_t end);
+  void FillBottom (void);
+  static bool RemoveFrom (Bucket &bucket, const Event &ev);
+  static bool SameTimestamps (const Bucket &events);
+
+  Bucket m_top;
+  uint64_t m_topStart;
+  uint64_t m_topMin;
+  uint64_t m_topMax;
+  // rungs are reused, only the first m_nRungs are in use
+  std::vector<Rung> m_rungs;
+  uint32_t m_nRungs;
+  // sorted by decreasing keys
+  Bucket m_bottom;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,76 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LOCATION_INDEX_H
+#define LOCATION_INDEX_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/sgi-hashmap.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup godLS
+ *
+ * \brief Global Ipv4Address to node and mobility model index
+ *
+ * Routing protocols register the addresses of their node when they are
+ * notified of them (NotifyAddAddress, NotifyInterfaceUp) and unregister
+ * them in NotifyRemoveAddress, so that the location services can find
+ * the node owning an address without walking the NodeList. An address
+ * which was never registered is searched once in the NodeList and
+ * cached, as is its absence: the addresses not found are searched again
+ * after the next call to Add. The index is cleared by
+ * Simulator::Destroy. A mutex guards it when threading is enabled, for
+ * the nodes run in parallel by ParallelSimulatorImpl.
+ */
+class LocationIndex
+{
+public:
+  /**
+   * \param address an address of node
+   * \param node the node
+   */
+  static void Add (Ipv4Address address, Ptr<Node> node);
+  /**
+   * \param address the address to forget
+   */
+  static void Remove (Ipv4Address address);
+  /**
+   * \param address an address
+   * \returns the node owning this address, or 0 if none was found.
+   */
+  static Ptr<Node> GetNode (Ipv4Address address);
+  /**
+   * \param address an address
+   * \returns the mobility model of the node owning this address, or 0
+   *          if none was found.
+   */
+  static Ptr<MobilityModel> GetMobilityModel (Ipv4Address address);
+  /// Remove all the entries of the index
+  static void Clear (void);
+
+private:
+  struct Entry
+  {
+    Ptr<Node> node;
+    Ptr<MobilityModel> mobility;
+  };
+  typedef sgi::hash_map<Ipv4Address, Entry, Ipv4AddressHash> Index;
+  struct Tables
+  {
+    Index entries;
+    // the addresses found on no node, whose entries have no node
+    Index misses;
+  };
+
+  static Tables *Get (void);
+  static Tables **DoGet (void);
+  static void Delete (void);
+  /// Walk the NodeList for address, and cache the result, found or not
+  static Entry *Find (Ipv4Address address);
+};
+
+} // namespace ns3
+
+#endif /* LOCATION_INDEX_H */
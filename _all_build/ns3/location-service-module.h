@@ -0,0 +1,14 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_LOCATION_SERVICE
+    
+
+// Module headers:
+#include "god.h"
+#include "location-index.h"
+#include "location-service.h"
+#include "position-predictor.h"
+#endif
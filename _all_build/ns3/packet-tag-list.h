@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef PACKET_TAG_LIST_H
+#define PACKET_TAG_LIST_H
+
+#include <stdint.h>
+#include <ostream>
+#include "ns3/type-id.h"
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup constants
+ * \brief Tag maximum size
+ * The maximum size (in bytes) of a Tag is stored
+ * in this constant.
+ */
+#define PACKET_TAG_MAX_SIZE 20
+
+/**
+ * \ingroup constants
+ * \brief Number of packet tags stored inline
+ * The packet tags past this number are stored on the heap.
+ */
+#define PACKET_TAG_INLINE_COUNT 4
+
+/**
+ * The packet tags are stored by value: the first
+ * PACKET_TAG_INLINE_COUNT tags within the list, and thus within the
+ * packet, the next ones in an array allocated on the heap. A copy of
+ * the list copies its tags and shares no memory with the original, so
+ * that the copies of a packet can be used by several threads at once.
+ *
+ * Each tag type maps to one of 32 slots by the uid of its TypeId, and
+ * the list keeps the mask of the slots of its tags: looking up a tag
+ * which is not in the list, the most common case, then usually returns
+ * without looking at the tags.
+ */
+class PacketTagList 
+{
+public:
+  struct TagData {
+    uint8_t data[PACKET_TAG_MAX_SIZE];
+    TypeId tid;
+  };
+
+  inline PacketTagList ();
+  inline PacketTagList (PacketTagList const &o);
+  inline PacketTagList &operator = (PacketTagList const &o);
+  inline ~PacketTagList ();
+
+  void Add (Tag const&tag) const;
+  bool Remove (Tag &tag);
+  bool Peek (Tag &tag) const;
+  inline void RemoveAll (void);
+
+  /**
+   * \returns the number of tags in the list
+   */
+  inline uint32_t GetNTags (void) const;
+  /**
+   * \param i the index of a tag, in the order in which they were added
+   * \returns the tag
+   */
+  inline const struct PacketTagList::TagData *Get (uint32_t i) const;
+
+private:
+  inline static uint32_t GetSlot (TypeId tid);
+  inline struct PacketTagList::TagData *Get (uint32_t i);
+  inline void DoCopy (PacketTagList const &o);
+  void CopyOverflow (PacketTagList const &o);
+  struct PacketTagList::TagData *Find (TypeId tid) const;
+
+  struct TagData m_inline[PACKET_TAG_INLINE_COUNT];
+  // the tags after the inline ones, and the capacity of this array
+  struct TagData *m_overflow;
+  uint32_t m_overflowSize;
+  uint32_t m_size;
+  // mask of the slots of the tags
+  uint32_t m_slots;
+};
+
+} // namespace ns3
+
+/****************************************************
+ *  Implementation of inline methods for performance
+ ****************************************************/
+
+namespace ns3 {
+
+PacketTagList::PacketTagList ()
+  : m_overflow (0),
+    m_overflowSize (0),
+    m_size (0),
+    m_slots (0)
+{
+}
+
+PacketTagList::PacketTagList (PacketTagList const &o)
+  : m_overflow (0),
+    m_overflowSize (0)
+{
+  DoCopy (o);
+}
+
+PacketTagList &
+PacketTagList::operator = (PacketTagList const &o)
+{
+  // self assignment
+  if (this == &o) 
+    {
+      return *this;
+    }
+  RemoveAll ();
+  DoCopy (o);
+  return *this;
+}
+
+PacketTagList::~PacketTagList ()
+{
+  RemoveAll ();
+}
+
+void
+PacketTagList::RemoveAll (void)
+{
+  if (m_overflow != 0)
+    {
+      delete [] m_overflow;
+      m_overflow = 0;
+      m_overflowSize = 0;
+    }
+  m_size = 0;
+  m_slots = 0;
+}
+
+uint32_t
+PacketTagList::GetNTags (void) const
+{
+  return m_size;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Get (uint32_t i) const
+{
+  return i < PACKET_TAG_INLINE_COUNT ? &m_inline[i] : &m_overflow[i - PACKET_TAG_INLINE_COUNT];
+}
+
+struct PacketTagList::TagData *
+PacketTagList::Get (uint32_t i)
+{
+  return i < PACKET_TAG_INLINE_COUNT ? &m_inline[i] : &m_overflow[i - PACKET_TAG_INLINE_COUNT];
+}
+
+uint32_t
+PacketTagList::GetSlot (TypeId tid)
+{
+  return 1U << (tid.GetUid () % 32);
+}
+
+void
+PacketTagList::DoCopy (PacketTagList const &o)
+{
+  m_size = o.m_size;
+  m_slots = o.m_slots;
+  for (uint32_t i = 0; i < m_size && i < PACKET_TAG_INLINE_COUNT; i++)
+    {
+      m_inline[i] = o.m_inline[i];
+    }
+  if (m_size > PACKET_TAG_INLINE_COUNT)
+    {
+      CopyOverflow (o);
+    }
+}
+
+} // namespace ns3
+
+#endif /* PACKET_TAG_LIST_H */
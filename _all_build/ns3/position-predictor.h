@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+#ifndef POSITION_PREDICTOR_H
+#define POSITION_PREDICTOR_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/traced-callback.h"
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup godLS
+ * \brief Last known motion of a node, as reported to a location service
+ */
+struct KinematicState
+{
+  KinematicState ();
+  KinematicState (Vector position, Vector velocity, Time time);
+
+  Vector position;
+  Vector velocity;      //!< m/s
+  Vector acceleration;  //!< m/s^2
+  Time time;            //!< when the node was at position
+};
+
+/**
+ * \ingroup godLS
+ * \brief Dead reckoning of the position of a node from its last report
+ *
+ * The location services keep the last KinematicState they heard of each
+ * node and ask their predictor for the position when it is needed, with
+ * the full precision of the simulation time.
+ *
+ * Predict (id, state, at) also compares the prediction with the true
+ * position of id, when the LocationIndex knows it, and reports the
+ * distance through the PredictionError trace source.
+ */
+class PositionPredictor : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param state the last report of the node
+   * \param at the time of the prediction
+   * \returns the predicted position of the node
+   */
+  Vector Predict (const KinematicState &state, Time at) const;
+  /// Same as above, and traces the error of the prediction for node id
+  Vector Predict (Ipv4Address id, const KinematicState &state, Time at);
+
+private:
+  /// \param dt time elapsed since state.time, in seconds
+  virtual Vector DoPredict (const KinematicState &state, double dt) const = 0;
+
+  TracedCallback<Ipv4Address, Vector, double> m_errorTrace;
+};
+
+/**
+ * \ingroup godLS
+ * \brief position + velocity * dt
+ */
+class ConstantVelocityPredictor : public PositionPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+
+private:
+  virtual Vector DoPredict (const KinematicState &state, double dt) const;
+};
+
+/**
+ * \ingroup godLS
+ * \brief position + velocity * dt + acceleration * dt^2 / 2
+ *
+ * A decelerating node stops when its speed reaches zero instead of
+ * backing up.
+ */
+class ConstantAccelerationPredictor : public PositionPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+
+private:
+  virtual Vector DoPredict (const KinematicState &state, double dt) const;
+};
+
+/**
+ * \ingroup godLS
+ * \brief Moves the node along a road at constant speed
+ *
+ * The road is a polyline. The node is projected on the nearest segment,
+ * moved by speed * dt along the road in the direction of its velocity,
+ * and keeps its lateral offset (its lane). It stops at the ends of the
+ * road. Without a road, this is a ConstantVelocityPredictor.
+ */
+class LanePredictor : public PositionPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+
+  void SetRoad (const std::vector<Vector> &points);
+  const std::vector<Vector> & GetRoad (void) const;
+
+  /**
+   * \param filename an ns-2 mobility trace, as read by Ns2MobilityHelper
+   * \param node the node whose waypoints make the road
+   * \returns the initial position of node followed by its setdest
+   * destinations, in time order
+   */
+  static std::vector<Vector> ReadNs2Road (std::string filename, uint32_t node);
+
+private:
+  virtual Vector DoPredict (const KinematicState &state, double dt) const;
+  /// \returns the index of the segment at distance s along the road
+  uint32_t GetSegment (double s) const;
+  Vector GetPoint (double s) const;
+
+  std::vector<Vector> m_road;
+  /// distance along the road of each point of m_road
+  std::vector<double> m_distance;
+};
+
+} // namespace ns3
+
+#endif /* POSITION_PREDICTOR_H */
@@ -0,0 +1,14 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_PROPAGATION
+    
+
+// Module headers:
+#include "cost231-propagation-loss-model.h"
+#include "jakes-propagation-loss-model.h"
+#include "propagation-delay-model.h"
+#include "propagation-loss-model.h"
+#endif
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <map>
+#include "ns3/ptr.h"
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * \brief Table driven front-end for another ErrorRateModel.
+ *
+ * The first time a WifiMode is used, the chunk success rate of the
+ * underlying model (by default a NistErrorRateModel) is sampled over a
+ * grid of SNR values (in dB) and of chunk lengths (powers of two, up to
+ * 2^MaxBitsExponent bits).  Later lookups interpolate in that table, which
+ * costs a log10, an exp and a handful of loads instead of the erfc/pow
+ * evaluations of the underlying model.
+ *
+ * The table stores the success rate per bit, in log scale, so models
+ * where the success of a chunk is (1 - pe)^nbits, such as the OFDM part of
+ * the Nist and Yans models, are reproduced exactly along the chunk length
+ * axis.  When the table is built, each cell is checked against the
+ * underlying model at a few points inside it; cells whose error is larger
+ * than MaxError, any SNR outside [MinSnr, MaxSnr] and any chunk longer
+ * than 2^MaxBitsExponent bits are delegated to the underlying model.
+ *
+ * The tables are shared by all the instances which sample the same kind
+ * of underlying model, with the same attribute values, over the same grid:
+ * YansWifiPhyHelper creates one error rate model per PHY, and the tables
+ * are built once per WifiMode for the whole simulation.  The shared cache
+ * is locked while a table is built, so that PHYs run by several threads
+ * may use it.
+ *
+ * The attributes, including those of the underlying model, must be set
+ * before the first call to GetChunkSuccessRate; use it with
+ * YansWifiPhyHelper::SetErrorRateModel ("ns3::TableErrorRateModel", ...).
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+  /**
+   * \returns the number of lookups that were delegated to the underlying
+   * model since the creation of this object.
+   */
+  uint64_t GetExactLookups (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  struct Table
+  {
+    /// log (success rate) / nbits, indexed by snr * m_nBuckets + bucket
+    std::vector<double> perBitLog;
+    /// cells which failed the accuracy check, same indexing
+    std::vector<bool> exact;
+  };
+
+  const Table & GetTable (WifiMode mode) const;
+  void BuildTable (WifiMode mode, Table &table) const;
+  std::string GetCacheKey (void) const;
+
+  /// the tables of all instances, by cache key and WifiMode uid
+  typedef std::map<std::string, Table> TableCache;
+  static TableCache & GetCache (void);
+  double Interpolate (const Table &table, uint32_t i, double snrFrac,
+                      uint32_t bucket, double bitsFrac, uint32_t nbits) const;
+  static void FindBucket (uint32_t nbits, uint32_t maxBucket,
+                          uint32_t *bucket, double *frac);
+
+  mutable Ptr<ErrorRateModel> m_model;
+  double m_minSnrDb;
+  double m_maxSnrDb;
+  double m_stepDb;
+  double m_maxError;
+  uint32_t m_maxBitsExponent;
+
+  mutable uint32_t m_nSnr;
+  mutable uint32_t m_nBuckets;
+  /// the shared tables used so far, indexed by WifiMode uid
+  mutable std::vector<const Table *> m_tables;
+  /// identifies the underlying model and the grid in the shared cache
+  mutable std::string m_cacheKey;
+  mutable uint64_t m_exactLookups;
+};
+
+} // namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
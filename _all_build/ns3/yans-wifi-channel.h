@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+
+namespace ns3 {
+
+class NetDevice;
+class MobilityModel;
+class PropagationLossModel;
+class PropagationDelayModel;
+class YansWifiPhy;
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ *
+ * When the MaxRange attribute is set, the channel keeps a uniform grid
+ * of the (x,y) positions of its PHYs, with cells MaxRange meters wide,
+ * and only evaluates the propagation models for the PHYs located in
+ * the cells that can be reached from the sender. PHYs further away than
+ * MaxRange from the sender do not receive the packet at all, not even
+ * as interference, so MaxRange should be chosen such that the received
+ * power beyond it is negligible. The grid is updated on every
+ * CourseChange notification of the PHYs' mobility models and fully
+ * rebuilt every GridRefreshInterval to catch up with continuous motion.
+ *
+ * When the DropBelowEdThreshold attribute is set, frames whose received
+ * power is below the energy detection threshold of the receiving PHY are
+ * not scheduled for reception. Such frames are then not
+ * accounted for as interference by the receiver. When the CacheRxPower
+ * attribute is set, the rx power computed between two mobility models
+ * is reused for as long as neither of them has moved and the tx power
+ * is the same. This is only correct with deterministic propagation loss
+ * models: the cache is not used if the chain of loss models holds a
+ * Random, Nakagami or Jakes model, but other models drawing random
+ * variables are not detected. The cache holds at most
+ * RxPowerCacheSize links, and is emptied when it is full.
+ *
+ * All the receivers of a transmission share one copy of the packet,
+ * taken when it is sent: the PHYs only copy it when they pass it up
+ * to their MAC, so that the frames dropped by a PHY, which are most of
+ * the receptions of a broadcast, cost no allocation of a packet. The
+ * packet given to the PHY traces of a receiver is then this shared
+ * copy, which the trace sinks must not tag. When the events of several
+ * contexts may run in parallel (see Simulator::IsParallel), the
+ * reference counts of a shared packet would race: each receiver then
+ * gets a deep copy of its own. The senders then also share the
+ * channel: the grid of MaxRange and the cache of CacheRxPower are not
+ * used, and the propagation models must be deterministic.
+ *
+ * When the PHYs belong to several partitions of a
+ * MultithreadedSimulatorImpl, a transmission is delivered by the sender
+ * to the PHYs of its own partition, and sent as one event to each other
+ * partition, with a copy of the packet and the position of the sender.
+ * That event computes the receptions of the PHYs of its partition,
+ * which start after their propagation delay or the lookahead of the
+ * simulator, whichever is larger. The propagation models are then
+ * shared by the threads, and must be deterministic; the grid of
+ * MaxRange and the cache of CacheRxPower are not used.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  // inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param wifiMode the tx mode associated to the packet
+   * \param preamble the preamble associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiMode wifiMode, WifiPreamble preamble) const;
+
+protected:
+  /**
+   * Find the partition of each PHY. Called by MultithreadedSimulatorImpl
+   * before it runs.
+   */
+  virtual void DoStart (void);
+
+private:
+  YansWifiChannel& operator = (const YansWifiChannel &);
+  YansWifiChannel (const YansWifiChannel &);
+
+  /// The parameters of a transmission
+  struct Transmission
+  {
+    // when the transmission started
+    Time start;
+    Vector senderPosition;
+    double txPowerDbm;
+    uint16_t channelNumber;
+    WifiMode mode;
+    WifiPreamble preamble;
+    // whether each receiver needs a packet of its own
+    bool deepCopy;
+  };
+  /// The PHYs of one partition of a multithreaded simulation
+  struct Partition
+  {
+    uint32_t systemId;
+    // the context of the transmissions received from the other partitions
+    uint32_t node;
+    std::vector<uint32_t> phys;
+    // moved to the position of the remote senders
+    Ptr<MobilityModel> senderMobility;
+  };
+
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  typedef std::pair<int32_t, int32_t> GridCell;
+  typedef std::map<GridCell, std::vector<uint32_t> > Grid;
+  typedef std::map<Ptr<const MobilityModel>, std::vector<uint32_t> > MobilityIndex;
+  struct LinkLoss
+  {
+    Vector senderPosition;
+    Vector receiverPosition;
+    double txPowerDbm;
+    double rxPowerDbm;
+  };
+  typedef std::map<std::pair<Ptr<MobilityModel>, Ptr<MobilityModel> >, LinkLoss> LossCache;
+
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
+                WifiMode txMode, WifiPreamble preamble) const;
+  /**
+   * \param j the index of the receiving PHY
+   * \param sender the sending PHY, or 0 for a remote sender
+   * \param senderMobility the mobility model of the sender
+   * \param packet the packet shared by the receivers, or copied for
+   *        each of them if tx.deepCopy is set
+   * \param tx the transmission
+   *
+   * Schedule the reception of the packet by PHY j, after the part of
+   * the propagation delay left since the transmission started.
+   */
+  void SendTo (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+               Ptr<const Packet> packet, const Transmission &tx) const;
+  /**
+   * \param i the index of the partition in m_partitions
+   * \param packet a copy of the packet owned by the partition
+   * \param tx the transmission
+   *
+   * Deliver a transmission of another partition to the PHYs of partition i.
+   */
+  void ReceiveRemote (uint32_t i, Ptr<Packet> packet, Transmission tx) const;
+
+  /**
+   * \param position a position
+   * \returns the grid cell which contains this position.
+   */
+  GridCell GetCell (const Vector &position) const;
+  /**
+   * Rebuild the whole grid from the current position of every PHY, and
+   * register for the CourseChange notifications of the PHYs that were
+   * not yet indexed.
+   */
+  void RefreshGrid (void) const;
+  /**
+   * \param i the index of the PHY to move to the cell of its current position.
+   */
+  void UpdateGrid (uint32_t i) const;
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+  /**
+   * \param txPowerDbm the tx power of the sender
+   * \param sender the mobility model of the sender
+   * \param receiver the mobility model of the receiver
+   * \returns the rx power computed by the propagation loss model, or
+   *          the cached value if neither sender nor receiver moved since
+   *          it was last computed with the same tx power.
+   */
+  double CalcRxPower (double txPowerDbm, Ptr<MobilityModel> sender, Ptr<MobilityModel> receiver) const;
+  /**
+   * \returns false if the chain of loss models holds a model known to
+   *          draw random variables, whose rx power cannot be cached.
+   */
+  bool IsLossDeterministic (void) const;
+  /**
+   * \param position the position of the sender
+   * \param candidates filled with the sorted indexes of the PHYs which
+   *        might be within MaxRange of position.
+   */
+  void GetCandidates (const Vector &position, std::vector<uint32_t> &candidates) const;
+
+  PhyList m_phyList;
+  Ptr<PropagationLossModel> m_loss;
+  Ptr<PropagationDelayModel> m_delay;
+
+  double m_maxRange;
+  Time m_gridRefreshInterval;
+  mutable Grid m_grid;
+  mutable std::vector<GridCell> m_phyCell;
+  mutable MobilityIndex m_mobilityIndex;
+  mutable Time m_lastRefresh;
+  /// largest speed seen since m_lastRefresh, bounds the drift of the indexed positions.
+  mutable double m_maxSpeed;
+  mutable bool m_gridValid;
+
+  bool m_dropBelowEdThreshold;
+  bool m_cacheRxPower;
+  uint32_t m_rxPowerCacheSize;
+  // whether m_loss was checked to be deterministic, and the result
+  mutable bool m_lossChecked;
+  mutable bool m_lossDeterministic;
+  mutable LossCache m_lossCache;
+
+  // empty unless the PHYs span several partitions
+  std::vector<Partition> m_partitions;
+};
+
+} // namespace ns3
+
+
+#endif /* YANS_WIFI_CHANNEL_H */
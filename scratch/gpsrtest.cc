@@ -911,6 +911,15 @@ GpsrExample::InstallInternetStack ()
   Ipv4AddressHelper address;
   address.SetBase ("10.0.0.0", "255.0.0.0");
   interfaces = address.Assign (devices);
+  if (comm_mode == "v2i")
+    {
+      gpsr.InstallRsuDirectory (rsu_nodes);
+    }
+  else
+    {
+      // no road side units at all
+      Config::SetGlobal ("GpsrRsuAddresses", StringValue (""));
+    }
 
   for (uint32_t n = 0; n < nodes.GetN (); n++) {
     Ptr<Node> rsu = nodes.Get (n);
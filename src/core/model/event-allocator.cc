@@ -0,0 +1,320 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "event-allocator.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "ns3/core-config.h"
+#include <new>
+#include <cstring>
+
+// __thread and the __sync builtins
+#if defined (__GNUC__) && !defined (__APPLE__)
+#define EVENT_ALLOCATOR_TLS 1
+#endif
+
+#if defined (EVENT_ALLOCATOR_TLS) && defined (HAVE_PTHREAD_H)
+#include <pthread.h>
+#endif
+
+namespace ns3 {
+
+GlobalValue g_eventPooling = GlobalValue ("EventPooling",
+                                          "Allocate the events from per-thread pools instead of the system allocator",
+                                          BooleanValue (true),
+                                          MakeBooleanChecker ());
+
+// The header in front of each event, which leaves it 16-byte aligned
+static const std::size_t HEADER_SIZE = 16;
+static const std::size_t MAX_BLOCK_SIZE = 256;
+static const uint32_t N_CLASSES = MAX_BLOCK_SIZE / 16;
+static const std::size_t ARENA_SIZE = 64 * 1024;
+
+struct EventAllocator::Pool
+{
+  struct Block
+  {
+    // 0 if the block comes from the system allocator
+    Pool *owner;
+    uint32_t sizeClass;
+    // valid while the block is free: overlaps the event
+    Block *next;
+  };
+
+  Pool ();
+  Block *Carve (std::size_t blockSize);
+  void Collect (void);
+  void Adopt (void);
+
+  Block *free[N_CLASSES];
+  // blocks freed by the other threads, pushed with a compare and swap
+  Block * volatile remote;
+  // arenas, linked through their first word
+  char *arenas;
+  char *arena;
+  std::size_t arenaLeft;
+  bool pooling;
+  // 1 while a thread allocates from this pool, 0 once it exited
+  volatile uint32_t owned;
+  uint64_t allocations;
+  uint64_t releases;
+  uint64_t reuses;
+  uint64_t systemAllocations;
+  uint64_t arenaBytes;
+  Pool *nextPool;
+};
+
+EventAllocator::Pool::Pool ()
+  : remote (0),
+    arenas (0),
+    arena (0),
+    arenaLeft (0),
+    pooling (false),
+    owned (1),
+    allocations (0),
+    releases (0),
+    reuses (0),
+    systemAllocations (0),
+    arenaBytes (0),
+    nextPool (0)
+{
+  std::memset (free, 0, sizeof (free));
+}
+
+EventAllocator::Pool::Block *
+EventAllocator::Pool::Carve (std::size_t blockSize)
+{
+  if (arenaLeft < blockSize)
+    {
+      char *chunk = static_cast<char *> (::operator new (ARENA_SIZE));
+      *reinterpret_cast<char **> (chunk) = arenas;
+      arenas = chunk;
+      arena = chunk + HEADER_SIZE;
+      arenaLeft = ARENA_SIZE - HEADER_SIZE;
+      systemAllocations++;
+      arenaBytes += ARENA_SIZE;
+    }
+  Block *block = reinterpret_cast<Block *> (arena);
+  arena += blockSize;
+  arenaLeft -= blockSize;
+  return block;
+}
+
+void
+EventAllocator::Pool::Collect (void)
+{
+#ifdef EVENT_ALLOCATOR_TLS
+  Block *block = __sync_lock_test_and_set (&remote, static_cast<Block *> (0));
+  while (block != 0)
+    {
+      Block *next = block->next;
+      block->next = free[block->sizeClass];
+      free[block->sizeClass] = block;
+      block = next;
+    }
+#endif
+}
+
+void
+EventAllocator::Pool::Adopt (void)
+{
+  BooleanValue value;
+  g_eventPooling.GetValue (value);
+  pooling = value.Get ();
+  Collect ();
+}
+
+#if defined (EVENT_ALLOCATOR_TLS) && defined (HAVE_PTHREAD_H)
+static pthread_key_t g_poolKey;
+static pthread_once_t g_poolKeyOnce = PTHREAD_ONCE_INIT;
+#endif
+
+EventAllocator::Pool *&
+EventAllocator::Current (void)
+{
+#ifdef EVENT_ALLOCATOR_TLS
+  static __thread Pool *pool = 0;
+#else
+  static Pool *pool = 0;
+#endif
+  return pool;
+}
+
+void
+EventAllocator::CreatePoolKey (void)
+{
+#if defined (EVENT_ALLOCATOR_TLS) && defined (HAVE_PTHREAD_H)
+  pthread_key_create (&g_poolKey, &EventAllocator::ReleasePool);
+#endif
+}
+
+void
+EventAllocator::ReleasePool (void *p)
+{
+  // the thread exits: its pool is left to the next thread which needs
+  // one, with its arenas and free lists
+  Pool *pool = static_cast<Pool *> (p);
+  Current () = 0;
+#ifdef EVENT_ALLOCATOR_TLS
+  __sync_lock_release (&pool->owned);
+#else
+  pool->owned = 0;
+#endif
+}
+
+EventAllocator::Pool *
+EventAllocator::GetPool (void)
+{
+#ifdef EVENT_ALLOCATOR_TLS
+  Pool *&current = Current ();
+  if (current != 0)
+    {
+      return current;
+    }
+  // adopt the pool of a thread which exited, or add one
+  Pool **pools = GetPools ();
+  for (Pool *pool = *pools; pool != 0; pool = pool->nextPool)
+    {
+      if (pool->owned == 0 && __sync_bool_compare_and_swap (&pool->owned, 0, 1))
+        {
+          current = pool;
+          break;
+        }
+    }
+  if (current == 0)
+    {
+      current = new Pool ();
+      do
+        {
+          current->nextPool = *pools;
+        }
+      while (!__sync_bool_compare_and_swap (pools, current->nextPool, current));
+    }
+  current->Adopt ();
+#ifdef HAVE_PTHREAD_H
+  pthread_once (&g_poolKeyOnce, &EventAllocator::CreatePoolKey);
+  pthread_setspecific (g_poolKey, current);
+#endif
+  return current;
+#else
+  // One pool, which only counts the events
+  Pool **pools = GetPools ();
+  if (*pools == 0)
+    {
+      *pools = new Pool ();
+    }
+  return *pools;
+#endif
+}
+
+EventAllocator::Pool **
+EventAllocator::GetPools (void)
+{
+  static Pool *pools = 0;
+  return &pools;
+}
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  Pool *pool = GetPool ();
+  pool->allocations++;
+  std::size_t blockSize = (size + HEADER_SIZE + 15) & ~static_cast<std::size_t> (15);
+  Pool::Block *block;
+  if (!pool->pooling || blockSize > MAX_BLOCK_SIZE)
+    {
+      block = static_cast<Pool::Block *> (::operator new (size + HEADER_SIZE));
+      block->owner = 0;
+      pool->systemAllocations++;
+    }
+  else
+    {
+      uint32_t sizeClass = blockSize / 16 - 1;
+      if (pool->free[sizeClass] == 0 && pool->remote != 0)
+        {
+          pool->Collect ();
+        }
+      block = pool->free[sizeClass];
+      if (block != 0)
+        {
+          pool->free[sizeClass] = block->next;
+          pool->reuses++;
+        }
+      else
+        {
+          block = pool->Carve (blockSize);
+        }
+      block->owner = pool;
+      block->sizeClass = sizeClass;
+    }
+  return reinterpret_cast<char *> (block) + HEADER_SIZE;
+}
+
+void
+EventAllocator::Deallocate (void *p)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  Pool::Block *block = reinterpret_cast<Pool::Block *> (static_cast<char *> (p) - HEADER_SIZE);
+  Pool *pool = GetPool ();
+  pool->releases++;
+  if (block->owner == 0)
+    {
+      ::operator delete (block);
+    }
+  else if (block->owner == pool)
+    {
+      block->next = pool->free[block->sizeClass];
+      pool->free[block->sizeClass] = block;
+    }
+  else
+    {
+#ifdef EVENT_ALLOCATOR_TLS
+      Pool *owner = block->owner;
+      do
+        {
+          block->next = owner->remote;
+        }
+      while (!__sync_bool_compare_and_swap (&owner->remote, block->next, block));
+#endif
+    }
+}
+
+EventAllocator::Stats
+EventAllocator::GetStats (void)
+{
+  Stats stats;
+  std::memset (&stats, 0, sizeof (stats));
+  for (Pool *pool = *GetPools (); pool != 0; pool = pool->nextPool)
+    {
+      stats.allocations += pool->allocations;
+      stats.releases += pool->releases;
+      stats.reuses += pool->reuses;
+      stats.systemAllocations += pool->systemAllocations;
+      stats.arenaBytes += pool->arenaBytes;
+      stats.threads++;
+    }
+  return stats;
+}
+
+bool
+EventAllocator::IsPooling (void)
+{
+  return GetPool ()->pooling;
+}
+
+} // namespace ns3
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 namespace ns3 {
@@ -58,6 +59,13 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * The events, and thus all the events created by MakeEvent, are
+   * allocated by the EventAllocator.
+   */
+  static void *operator new (std::size_t size);
+  static void operator delete (void *p);
+
 protected:
   virtual void Notify (void) = 0;
 
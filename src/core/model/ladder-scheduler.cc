@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include "fatal-error.h"
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (0),
+    m_topMax (0),
+    m_nRungs (0)
+{
+  NS_LOG_FUNCTION (this);
+  // CreateRung keeps references to the rungs above the new one
+  m_rungs.resize (MAX_RUNGS);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::RungCurrent (const Rung &rung) const
+{
+  return rung.start + rung.current * rung.width;
+}
+
+bool
+LadderScheduler::RemoveFrom (Bucket &bucket, const Event &ev)
+{
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (i->impl == ev.impl);
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+LadderScheduler::SameTimestamps (const Bucket &events)
+{
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      if (i->key.m_ts != events.front ().key.m_ts)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  // the bottom is sorted by decreasing keys: search it backwards
+  Bucket::reverse_iterator i = std::upper_bound (m_bottom.rbegin (), m_bottom.rend (), ev);
+  m_bottom.insert (i.base (), ev);
+}
+
+void
+LadderScheduler::CreateRung (Bucket &events, uint64_t start, uint64_t end)
+{
+  NS_ASSERT (m_nRungs < MAX_RUNGS);
+  NS_ASSERT (!events.empty () && end > start);
+  uint64_t span = end - start;
+  Rung &rung = m_rungs[m_nRungs];
+  rung.start = start;
+  rung.width = (span - 1) / events.size () + 1;
+  rung.nBuckets = (span - 1) / rung.width + 1;
+  rung.current = 0;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      NS_ASSERT (i->key.m_ts >= start && i->key.m_ts < end);
+      rung.buckets[(i->key.m_ts - start) / rung.width].push_back (*i);
+    }
+  NS_LOG_DEBUG ("rung " << m_nRungs << " start=" << start << " width=" << rung.width
+                        << " buckets=" << rung.nBuckets << " events=" << events.size ());
+  events.clear ();
+  m_nRungs++;
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          if (m_top.size () <= BOTTOM_THRESHOLD || m_topMin == m_topMax)
+            {
+              m_bottom.swap (m_top);
+              std::sort (m_bottom.rbegin (), m_bottom.rend ());
+              m_topStart = m_topMax + 1;
+            }
+          else
+            {
+              CreateRung (m_top, m_topMin, m_topMax + 1);
+              const Rung &rung = m_rungs[0];
+              m_topStart = rung.start + rung.nBuckets * rung.width;
+            }
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      rung.current++;
+      if (bucket.size () > BOTTOM_THRESHOLD && m_nRungs < MAX_RUNGS
+          && !SameTimestamps (bucket))
+        {
+          uint64_t start = bucket.front ().key.m_ts;
+          for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+            {
+              start = std::min (start, i->key.m_ts);
+            }
+          CreateRung (bucket, start, RungCurrent (rung));
+        }
+      else
+        {
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.rbegin (), m_bottom.rend ());
+        }
+    }
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      m_top.push_back (ev);
+    }
+  else
+    {
+      uint32_t k;
+      for (k = 0; k < m_nRungs; k++)
+        {
+          Rung &rung = m_rungs[k];
+          if (ts >= RungCurrent (rung))
+            {
+              uint64_t index = (ts - rung.start) / rung.width;
+              NS_ASSERT (index < rung.nBuckets);
+              rung.buckets[index].push_back (ev);
+              break;
+            }
+        }
+      if (k == m_nRungs)
+        {
+          InsertBottom (ev);
+          // many events were scheduled in the range of the bottom:
+          // spread them over a new rung rather than keep sorting them.
+          if (m_bottom.size () > 2 * BOTTOM_THRESHOLD && m_nRungs < MAX_RUNGS
+              && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+            {
+              uint64_t end = m_nRungs == 0 ? m_topStart : RungCurrent (m_rungs[m_nRungs - 1]);
+              CreateRung (m_bottom, m_bottom.back ().key.m_ts, end);
+            }
+        }
+    }
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  // FillBottom keeps the bottom non-empty as long as there are events
+  return m_bottom.empty ();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (!RemoveFrom (m_top, ev))
+        {
+          NS_FATAL_ERROR ("Event " << ev.key.m_uid << " not found");
+        }
+      return;
+    }
+  for (uint32_t k = 0; k < m_nRungs; k++)
+    {
+      Rung &rung = m_rungs[k];
+      if (ts >= RungCurrent (rung))
+        {
+          if (!RemoveFrom (rung.buckets[(ts - rung.start) / rung.width], ev))
+            {
+              NS_FATAL_ERROR ("Event " << ev.key.m_uid << " not found");
+            }
+          return;
+        }
+    }
+  Bucket::reverse_iterator i = std::lower_bound (m_bottom.rbegin (), m_bottom.rend (), ev);
+  NS_ASSERT (i != m_bottom.rend () && i->key.m_uid == ev.key.m_uid);
+  m_bottom.erase (i.base () - 1);
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+}
+
+} // namespace ns3
@@ -151,12 +151,14 @@ Object::DoGetObject (TypeId tid) const
           // the idea is that if we perform a lookup for a TypeId on this object,
           // we are likely to perform the same lookup later so, we make sure
           // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
+          // to each object. When the objects may be shared by several
+          // threads, the array is left alone.
+#ifndef NS3_ATOMIC_REFCOUNT
           // first, increment the access count
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
+#endif
           // finally, return the match
           return const_cast<Object *> (current);
         }
@@ -0,0 +1,915 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "parallel-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "simple-ref-count.h"
+#include "ns3/core-config.h"
+#include "pointer.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <unistd.h>
+
+// __thread and the __sync builtins
+#if defined (__GNUC__) && !defined (__APPLE__)
+#define PARALLEL_SIMULATOR_TLS 1
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("ParallelSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ParallelSimulatorImpl);
+
+static const uint32_t NO_CONTEXT = 0xffffffff;
+// the uid of the EventIds of the events given their uid at the end of
+// their batch
+static const uint32_t LATE_UID = 3;
+
+namespace {
+// Orders the indexes of the events of a batch by context, then uid
+struct CompareContext
+{
+  CompareContext (const std::vector<Scheduler::Event> &batch)
+    : m_batch (batch)
+  {
+  }
+  bool operator () (uint32_t a, uint32_t b) const
+  {
+    return m_batch[a].key.m_context < m_batch[b].key.m_context;
+  }
+  const std::vector<Scheduler::Event> &m_batch;
+};
+// Orders the remove calls of a batch
+struct CompareEventId
+{
+  bool operator () (const EventId &a, const EventId &b) const
+  {
+    return a.GetTs () < b.GetTs () || (a.GetTs () == b.GetTs () && a.GetUid () < b.GetUid ());
+  }
+};
+} // anonymous namespace
+
+/// The threads waiting for the batches
+struct ParallelSimulatorImpl::Pool
+{
+  pthread_mutex_t mutex;
+  // signaled when a batch is ready, and when the threads must quit
+  pthread_cond_t start;
+  // signaled when the last thread is done with a batch
+  pthread_cond_t done;
+  uint32_t generation;
+  uint32_t running;
+  uint32_t nextWorker;
+  bool quit;
+};
+
+bool
+ParallelSimulatorImpl::Pending::operator < (const Pending &o) const
+{
+  return parent < o.parent || (parent == o.parent && seq < o.seq);
+}
+
+TypeId
+ParallelSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ParallelSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<ParallelSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "Number of threads running the batches, including the one calling Simulator::Run. "
+                   "0 means one per processor. Always 1 unless configured with --enable-atomic-refcount.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_nThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EventIdsPerEvent",
+                   "Number of uids reserved for the events that an event of a batch schedules with "
+                   "Simulator::Schedule or ScheduleNow. The events beyond get their uid at the end of the batch.",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_uidsPerEvent),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinParallelEvents",
+                   "The smaller batches are run by the thread calling Simulator::Run alone.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&ParallelSimulatorImpl::m_minParallelEvents),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+ParallelSimulatorImpl::ParallelSimulatorImpl ()
+  : m_nThreads (0),
+    m_uidsPerEvent (16),
+    m_minParallelEvents (8),
+    m_batchBase (0),
+    m_nextGroup (0),
+    m_pool (0),
+    m_nBatches (0),
+    m_nParallelEvents (0),
+    m_nConflicts (0)
+{
+  m_stop = false;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  // uid 3 is the events given their uid at the end of a batch
+  m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = NO_CONTEXT;
+  m_unscheduledEvents = 0;
+}
+
+ParallelSimulatorImpl::~ParallelSimulatorImpl ()
+{
+  StopThreads ();
+}
+
+void
+ParallelSimulatorImpl::DoDispose (void)
+{
+  StopThreads ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+ParallelSimulatorImpl::Destroy ()
+{
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+uint32_t
+ParallelSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+ParallelSimulatorImpl::Worker *&
+ParallelSimulatorImpl::Current (void)
+{
+#ifdef PARALLEL_SIMULATOR_TLS
+  static __thread Worker *worker = 0;
+#else
+  static Worker *worker = 0;
+#endif
+  return worker;
+}
+
+void
+ParallelSimulatorImpl::StartThreads (void)
+{
+  if (!m_workers.empty ())
+    {
+      return;
+    }
+  uint32_t n = m_nThreads;
+  if (n == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      n = processors > 0 ? processors : 1;
+    }
+#if !defined (PARALLEL_SIMULATOR_TLS) || !defined (NS3_ATOMIC_REFCOUNT)
+  // the events of a batch share the objects of the other nodes
+  NS_LOG_LOGIC ("no atomic reference counts, " << n << " threads asked");
+  n = 1;
+#endif
+  NS_LOG_LOGIC ("start " << n << " threads");
+  m_workers.resize (n);
+  if (n == 1)
+    {
+      return;
+    }
+  m_pool = new Pool ();
+  pthread_mutex_init (&m_pool->mutex, 0);
+  pthread_cond_init (&m_pool->start, 0);
+  pthread_cond_init (&m_pool->done, 0);
+  m_pool->generation = 0;
+  m_pool->running = 0;
+  m_pool->nextWorker = 1;
+  m_pool->quit = false;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&ParallelSimulatorImpl::RunThread, this));
+      m_threads.push_back (thread);
+      thread->Start ();
+    }
+}
+
+void
+ParallelSimulatorImpl::StopThreads (void)
+{
+  if (m_pool == 0)
+    {
+      return;
+    }
+  pthread_mutex_lock (&m_pool->mutex);
+  m_pool->quit = true;
+  pthread_cond_broadcast (&m_pool->start);
+  pthread_mutex_unlock (&m_pool->mutex);
+  for (std::vector<Ptr<SystemThread> >::const_iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+  pthread_cond_destroy (&m_pool->done);
+  pthread_cond_destroy (&m_pool->start);
+  pthread_mutex_destroy (&m_pool->mutex);
+  delete m_pool;
+  m_pool = 0;
+}
+
+void
+ParallelSimulatorImpl::RunThread (void)
+{
+  pthread_mutex_lock (&m_pool->mutex);
+  Worker *worker = &m_workers[m_pool->nextWorker++];
+  pthread_mutex_unlock (&m_pool->mutex);
+  // the threads are started before the first batch
+  uint32_t seen = 0;
+  Current () = worker;
+  while (true)
+    {
+      pthread_mutex_lock (&m_pool->mutex);
+      while (m_pool->generation == seen && !m_pool->quit)
+        {
+          pthread_cond_wait (&m_pool->start, &m_pool->mutex);
+        }
+      if (m_pool->quit)
+        {
+          pthread_mutex_unlock (&m_pool->mutex);
+          break;
+        }
+      seen = m_pool->generation;
+      pthread_mutex_unlock (&m_pool->mutex);
+
+      RunGroups (worker);
+
+      pthread_mutex_lock (&m_pool->mutex);
+      if (--m_pool->running == 0)
+        {
+          pthread_cond_signal (&m_pool->done);
+        }
+      pthread_mutex_unlock (&m_pool->mutex);
+    }
+  Current () = 0;
+}
+
+void
+ParallelSimulatorImpl::RunGroups (Worker *worker)
+{
+  uint32_t nGroups = m_groups.size () - 1;
+  while (true)
+    {
+#ifdef PARALLEL_SIMULATOR_TLS
+      uint32_t group = __sync_fetch_and_add (&m_nextGroup, 1);
+#else
+      uint32_t group = m_nextGroup++;
+#endif
+      if (group >= nGroups)
+        {
+          break;
+        }
+      for (uint32_t i = m_groups[group]; i < m_groups[group + 1]; i++)
+        {
+          uint32_t index = m_order[i];
+          Scheduler::Event &next = m_batch[index];
+          worker->context = next.key.m_context;
+          worker->uid = next.key.m_uid;
+          worker->index = index;
+          worker->seq = 0;
+          worker->nextUid = m_batchBase + index * m_uidsPerEvent;
+          worker->endUid = worker->nextUid + m_uidsPerEvent;
+          worker->packetUids = 0;
+          next.impl->Invoke ();
+          next.impl->Unref ();
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::RunEvent (const Scheduler::Event &next)
+{
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  m_currentTs = next.key.m_ts;
+  m_currentContext = next.key.m_context;
+  m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+ParallelSimulatorImpl::ProcessOneEvent (void)
+{
+  Scheduler::Event next = m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= m_currentTs);
+  m_unscheduledEvents--;
+  RunEvent (next);
+}
+
+void
+ParallelSimulatorImpl::ProcessBatch (void)
+{
+  Scheduler::Event next = m_events->PeekNext ();
+  if (next.key.m_context == NO_CONTEXT)
+    {
+      ProcessOneEvent ();
+      return;
+    }
+  uint64_t ts = next.key.m_ts;
+  uint32_t context = next.key.m_context;
+  NS_ASSERT (ts >= m_currentTs);
+  if (!m_lateUids.empty ())
+    {
+      ForgetLateUids ();
+    }
+  bool contexts = false;
+  while (next.key.m_ts == ts && next.key.m_context != NO_CONTEXT)
+    {
+      m_events->RemoveNext ();
+      m_unscheduledEvents--;
+      contexts = contexts || next.key.m_context != context;
+      m_batch.push_back (next);
+      if (m_events->IsEmpty ())
+        {
+          break;
+        }
+      next = m_events->PeekNext ();
+    }
+  m_currentTs = ts;
+
+  if (!contexts)
+    {
+      // the events of one node run in turn, as with DefaultSimulatorImpl
+      for (uint32_t i = 0; i < m_batch.size (); i++)
+        {
+          RunEvent (m_batch[i]);
+        }
+      m_batch.clear ();
+      return;
+    }
+
+  uint32_t n = m_batch.size ();
+  NS_LOG_LOGIC ("batch of " << n << " events at " << ts);
+  if ((uint64_t)m_uid + (uint64_t)n * m_uidsPerEvent >= NO_CONTEXT)
+    {
+      NS_FATAL_ERROR ("ParallelSimulatorImpl ran out of event uids");
+    }
+  m_batchBase = m_uid;
+  m_uid += n * m_uidsPerEvent;
+  m_order.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_order[i] = i;
+    }
+  std::stable_sort (m_order.begin (), m_order.end (), CompareContext (m_batch));
+  m_groups.clear ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i == 0 || m_batch[m_order[i]].key.m_context != m_batch[m_order[i - 1]].key.m_context)
+        {
+          m_groups.push_back (i);
+        }
+    }
+  m_groups.push_back (n);
+  m_nBatches++;
+  m_nParallelEvents += n;
+
+  m_nextGroup = 0;
+  if (m_pool != 0 && n >= m_minParallelEvents)
+    {
+      pthread_mutex_lock (&m_pool->mutex);
+      m_pool->running = m_threads.size ();
+      m_pool->generation++;
+      pthread_cond_broadcast (&m_pool->start);
+      pthread_mutex_unlock (&m_pool->mutex);
+      Current () = &m_workers[0];
+      RunGroups (&m_workers[0]);
+      Current () = 0;
+      pthread_mutex_lock (&m_pool->mutex);
+      while (m_pool->running > 0)
+        {
+          pthread_cond_wait (&m_pool->done, &m_pool->mutex);
+        }
+      pthread_mutex_unlock (&m_pool->mutex);
+    }
+  else
+    {
+      Current () = &m_workers[0];
+      RunGroups (&m_workers[0]);
+      Current () = 0;
+    }
+  m_currentContext = NO_CONTEXT;
+  m_currentUid = m_batch.back ().key.m_uid;
+  m_batch.clear ();
+
+  // insert the events of the batch in the order of the events which
+  // scheduled them, then apply the removes
+  std::vector<Pending> pending;
+  std::vector<EventId> removes;
+  for (std::vector<Worker>::iterator w = m_workers.begin (); w != m_workers.end (); ++w)
+    {
+      pending.insert (pending.end (), w->pending.begin (), w->pending.end ());
+      removes.insert (removes.end (), w->removes.begin (), w->removes.end ());
+      m_nConflicts += w->conflicts;
+      w->pending.clear ();
+      w->removes.clear ();
+      w->conflicts = 0;
+    }
+  std::sort (pending.begin (), pending.end ());
+  for (std::vector<Pending>::iterator i = pending.begin (); i != pending.end (); ++i)
+    {
+      if (i->destroy)
+        {
+          m_destroyEvents.push_back (EventId (Ptr<EventImpl> (i->ev.impl, false), i->ev.key.m_ts, NO_CONTEXT, 2));
+          continue;
+        }
+      if (i->ev.key.m_uid == LATE_UID)
+        {
+          i->ev.key.m_uid = m_uid;
+          m_uid++;
+          m_lateUids[i->ev.impl] = i->ev.key;
+        }
+      else if (i->ev.key.m_uid == 0)
+        {
+          i->ev.key.m_uid = m_uid;
+          m_uid++;
+        }
+      Insert (i->ev);
+    }
+  std::sort (removes.begin (), removes.end (), CompareEventId ());
+  for (uint32_t i = 0; i < removes.size (); i++)
+    {
+      if (i == 0 || removes[i] != removes[i - 1])
+        {
+          DoRemove (removes[i]);
+        }
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsFinished (void) const
+{
+  return m_events->IsEmpty () || m_stop;
+}
+
+uint64_t
+ParallelSimulatorImpl::NextTs (void) const
+{
+  NS_ASSERT (!m_events->IsEmpty ());
+  Scheduler::Event ev = m_events->PeekNext ();
+  return ev.key.m_ts;
+}
+
+Time
+ParallelSimulatorImpl::Next (void) const
+{
+  return TimeStep (NextTs ());
+}
+
+void
+ParallelSimulatorImpl::Run (void)
+{
+  m_stop = false;
+  StartThreads ();
+  while (!m_events->IsEmpty () && !m_stop)
+    {
+      ProcessBatch ();
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+}
+
+void
+ParallelSimulatorImpl::RunOneEvent (void)
+{
+  ProcessOneEvent ();
+}
+
+void
+ParallelSimulatorImpl::Stop (void)
+{
+  m_stop = true;
+}
+
+void
+ParallelSimulatorImpl::Stop (Time const &time)
+{
+  Simulator::Schedule (time, &Simulator::Stop);
+}
+
+void
+ParallelSimulatorImpl::Insert (Scheduler::Event ev)
+{
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+}
+
+EventId
+ParallelSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  Time tAbsolute = time + TimeStep (m_currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (m_currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  Worker *worker = Current ();
+  if (worker != 0)
+    {
+      if (worker->nextUid < worker->endUid)
+        {
+          ev.key.m_uid = worker->nextUid++;
+        }
+      else
+        {
+          NS_LOG_LOGIC ("no uid left to the event " << worker->uid << ", given at the end of the batch");
+          ev.key.m_uid = LATE_UID;
+        }
+      Pending pending = { ev, worker->index, worker->seq++, false };
+      worker->pending.push_back (pending);
+    }
+  else
+    {
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+ParallelSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << m_currentTs << event);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = m_currentTs + time.GetTimeStep ();
+  ev.key.m_context = context;
+  Worker *worker = Current ();
+  if (worker != 0)
+    {
+      // the uid is given at the end of the batch
+      ev.key.m_uid = 0;
+      Pending pending = { ev, worker->index, worker->seq++, false };
+      worker->pending.push_back (pending);
+    }
+  else
+    {
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (ev);
+    }
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+ParallelSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), m_currentTs, NO_CONTEXT, 2);
+  Worker *worker = Current ();
+  if (worker != 0)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = m_currentTs;
+      ev.key.m_context = NO_CONTEXT;
+      ev.key.m_uid = 2;
+      Pending pending = { ev, worker->index, worker->seq++, true };
+      worker->pending.push_back (pending);
+    }
+  else
+    {
+      m_destroyEvents.push_back (id);
+      m_uid++;
+    }
+  return id;
+}
+
+Time
+ParallelSimulatorImpl::Now (void) const
+{
+  return TimeStep (m_currentTs);
+}
+
+Time
+ParallelSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - m_currentTs);
+    }
+}
+
+bool
+ParallelSimulatorImpl::InBatch (const EventId &id) const
+{
+  return !m_batch.empty () && id.GetTs () == m_currentTs &&
+         id.GetUid () >= m_batch.front ().key.m_uid && id.GetUid () <= m_batch.back ().key.m_uid;
+}
+
+EventId
+ParallelSimulatorImpl::Resolve (const EventId &id) const
+{
+  if (id.GetUid () != LATE_UID)
+    {
+      return id;
+    }
+  LateUids::const_iterator i = m_lateUids.find (id.PeekEventImpl ());
+  if (i == m_lateUids.end ())
+    {
+      // scheduled by the batch running, or run long ago
+      return id;
+    }
+  return EventId (id.PeekEventImpl (), i->second.m_ts, i->second.m_context, i->second.m_uid);
+}
+
+void
+ParallelSimulatorImpl::ForgetLateUids (void)
+{
+  // the EventIds of the events run before the current timestamp are
+  // expired whatever their uid
+  LateUids::iterator i = m_lateUids.begin ();
+  while (i != m_lateUids.end ())
+    {
+      if (i->second.m_ts < m_currentTs)
+        {
+          m_lateUids.erase (i++);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+void
+ParallelSimulatorImpl::DoRemove (const EventId &ev)
+{
+  EventId id = Resolve (ev);
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  m_unscheduledEvents--;
+}
+
+void
+ParallelSimulatorImpl::Remove (const EventId &ev)
+{
+  EventId id = Resolve (ev);
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              return;
+            }
+        }
+      // scheduled by the batch running
+      id.PeekEventImpl ()->Cancel ();
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Worker *worker = Current ();
+  if (InBatch (id))
+    {
+      if (worker != 0 && id.GetContext () != worker->context)
+        {
+          // IsExpired counted the conflict: left to the end of the batch,
+          // when the event has run
+          return;
+        }
+      // run by the batch, which unrefs it
+      id.PeekEventImpl ()->Cancel ();
+    }
+  else if (worker != 0)
+    {
+      id.PeekEventImpl ()->Cancel ();
+      worker->removes.push_back (id);
+    }
+  else
+    {
+      DoRemove (id);
+    }
+}
+
+void
+ParallelSimulatorImpl::Cancel (const EventId &ev)
+{
+  EventId id = Resolve (ev);
+  if (!IsExpired (id))
+    {
+      Worker *worker = Current ();
+      if (worker != 0 && InBatch (id) && id.GetContext () != worker->context)
+        {
+          // left to the end of the batch, when the event has run
+          return;
+        }
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+ParallelSimulatorImpl::IsExpired (const EventId &id) const
+{
+  Worker *worker = Current ();
+  EventId ev = Resolve (id);
+  if (ev.GetUid () == LATE_UID)
+    {
+      return ev.PeekEventImpl () == 0 ||
+             ev.GetTs () < m_currentTs ||
+             ev.PeekEventImpl ()->IsCancelled ();
+    }
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0 ||
+          ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      if (worker != 0)
+        {
+          for (std::vector<Pending>::const_iterator i = worker->pending.begin (); i != worker->pending.end (); ++i)
+            {
+              if (i->destroy && i->ev.impl == ev.PeekEventImpl ())
+                {
+                  return false;
+                }
+            }
+        }
+      return true;
+    }
+  if (ev.PeekEventImpl () == 0 ||
+      ev.GetTs () < m_currentTs)
+    {
+      return true;
+    }
+  if (worker != 0 && InBatch (ev))
+    {
+      if (ev.GetContext () != worker->context)
+        {
+          // whether it has run depends on the threads: seen as the
+          // batch started
+          worker->conflicts++;
+          NS_LOG_LOGIC ("conflict of context " << worker->context << " with " << ev.GetContext ());
+          return false;
+        }
+      return ev.GetUid () <= worker->uid || ev.PeekEventImpl ()->IsCancelled ();
+    }
+  if ((ev.GetTs () == m_currentTs &&
+       ev.GetUid () <= m_currentUid) ||
+      ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+ParallelSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  // XXX: I am fairly certain other compilers use other non-standard
+  // post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+ParallelSimulatorImpl::GetContext (void) const
+{
+  Worker *worker = Current ();
+  return worker != 0 ? worker->context : m_currentContext;
+}
+
+bool
+ParallelSimulatorImpl::IsParallel (void) const
+{
+  return true;
+}
+
+bool
+ParallelSimulatorImpl::AllocatePacketUid (uint64_t &uid)
+{
+  Worker *worker = Current ();
+  if (worker == 0)
+    {
+      return false;
+    }
+  // above the uids of the packets numbered by ns3::Packet, whose
+  // upper bits hold the system id 0
+  uid = static_cast<uint64_t> (worker->uid) << 32 | worker->packetUids;
+  worker->packetUids++;
+  return true;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetNBatches (void) const
+{
+  return m_nBatches;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetNParallelEvents (void) const
+{
+  return m_nParallelEvents;
+}
+
+uint64_t
+ParallelSimulatorImpl::GetNConflicts (void) const
+{
+  return m_nConflicts;
+}
+
+} // namespace ns3
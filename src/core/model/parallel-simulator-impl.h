@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_SIMULATOR_IMPL_H
+#define PARALLEL_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+
+#include "ptr.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief a simulator which runs the events of a timestamp in parallel
+ *
+ * The events due at the same time, with a node context, form a batch
+ * (a Simulator::Schedule event without context ends the batch and runs
+ * alone). If the batch spans several contexts, the events of each
+ * context run in order on one thread of a pool, and the contexts run
+ * in parallel. This fits the receptions of a broadcast, which reach
+ * many nodes at once and do not interact until their PHY.
+ *
+ * The results do not depend on the number of threads: each event of a
+ * batch owns a block of EventIdsPerEvent uids for the events it
+ * schedules with an EventId, and the events scheduled with a context
+ * are given their uids at the end of the batch, in the order of the
+ * events which scheduled them. Thus the order of the events of a later
+ * timestamp only depends on the batch. Uids run out EventIdsPerEvent
+ * times faster than with DefaultSimulatorImpl. The events scheduled
+ * with an EventId beyond the block of their parent also get their uid
+ * at the end of the batch: their EventId holds a placeholder uid, and
+ * the simulator looks their uid up until they have run. Likewise, the packets
+ * created by an event of a batch have the uid of the event in the upper
+ * 32 bits of their uid, and their number in the lower ones.
+ *
+ * An event which cancels, removes or checks an event of another
+ * context of its batch conflicts with it, since its outcome would
+ * depend on which of them runs first. Such a cancel or remove takes
+ * effect at the end of the batch, and such an event is seen as not
+ * expired; the conflicts are counted.
+ *
+ * It only runs several threads when ns-3 is configured with
+ * --enable-atomic-refcount: the reference counts of SimpleRefCount, and
+ * thus of the objects and packets, are then atomic, and
+ * Object::GetObject does not reorder the aggregated objects. The
+ * buffers shared by the copies of a packet are not: IsParallel
+ * returns true, so that the wifi and spectrum channels hand their
+ * receivers a Packet::DeepCopy of the packet sent, and the other
+ * models must not hand a packet to another context without such a
+ * copy. The tables shared by all the nodes of the location services
+ * and of GPSR, TableErrorRateModel and GpsrEventLog are guarded by a
+ * mutex, and so is the creation of the RngStream of a random variable;
+ * since the streams are handed out in the order of the first draws, the
+ * results only keep not depending on the threads if the variables first
+ * drawn in parallel are drawn before the run. The other data shared by
+ * the nodes, such as the trace sinks which are not per node, the random
+ * variables themselves or the positions which a mobility model updates
+ * when they are read, are not guarded: the models run in parallel must
+ * only change the state of their node, and only read the mobility
+ * model of their node, as the wifi channel does.
+ */
+class ParallelSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  ParallelSimulatorImpl ();
+  ~ParallelSimulatorImpl ();
+
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual Time Next (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual void RunOneEvent (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual bool IsParallel (void) const;
+  virtual bool AllocatePacketUid (uint64_t &uid);
+
+  /// \returns the number of batches run in parallel
+  uint64_t GetNBatches (void) const;
+  /// \returns the number of events of these batches
+  uint64_t GetNParallelEvents (void) const;
+  /// \returns the number of conflicts between the contexts of a batch
+  uint64_t GetNConflicts (void) const;
+
+private:
+  /// An event scheduled by a batch, inserted at its end
+  struct Pending
+  {
+    Scheduler::Event ev;
+    // index in the batch of the event which scheduled it
+    uint32_t parent;
+    // order among the events scheduled by its parent
+    uint32_t seq;
+    bool destroy;
+    bool operator < (const Pending &o) const;
+  };
+  /// A thread running the contexts of a batch
+  struct Worker
+  {
+    std::vector<Pending> pending;
+    // Remove calls, applied at the end of the batch
+    std::vector<EventId> removes;
+    // the event running: its context, uid and index in the batch
+    uint32_t context;
+    uint32_t uid;
+    uint32_t index;
+    uint32_t seq;
+    // the uids left to the event running
+    uint32_t nextUid;
+    uint32_t endUid;
+    // the packets created by the event running
+    uint32_t packetUids;
+    uint64_t conflicts;
+  };
+  struct Pool;
+
+  virtual void DoDispose (void);
+  void ProcessOneEvent (void);
+  void ProcessBatch (void);
+  void RunEvent (const Scheduler::Event &next);
+  void RunGroups (Worker *worker);
+  void RunThread (void);
+  void StartThreads (void);
+  void StopThreads (void);
+  uint64_t NextTs (void) const;
+  bool InBatch (const EventId &id) const;
+  EventId Resolve (const EventId &id) const;
+  void ForgetLateUids (void);
+  void Insert (Scheduler::Event ev);
+  void DoRemove (const EventId &id);
+  static Worker *&Current (void);
+
+  typedef std::list<EventId> DestroyEvents;
+  typedef std::map<const EventImpl *, Scheduler::EventKey> LateUids;
+
+  DestroyEvents m_destroyEvents;
+  bool m_stop;
+  Ptr<Scheduler> m_events;
+  uint32_t m_uid;
+  uint32_t m_currentUid;
+  uint64_t m_currentTs;
+  uint32_t m_currentContext;
+  // number of events that have been inserted but not yet scheduled,
+  // not counting the "destroy" events; this is used for validation
+  int m_unscheduledEvents;
+
+  uint32_t m_nThreads;
+  uint32_t m_uidsPerEvent;
+  uint32_t m_minParallelEvents;
+  // the batch, by uid, and the indexes of its events by context
+  std::vector<Scheduler::Event> m_batch;
+  std::vector<uint32_t> m_order;
+  // start of the events of each context in m_order, and their end
+  std::vector<uint32_t> m_groups;
+  uint32_t m_batchBase;
+  // the keys of the events whose EventId holds the placeholder uid
+  LateUids m_lateUids;
+  // next group to run, taken by the threads
+  volatile uint32_t m_nextGroup;
+  std::vector<Worker> m_workers;
+  std::vector<Ptr<SystemThread> > m_threads;
+  Pool *m_pool;
+  uint64_t m_nBatches;
+  uint64_t m_nParallelEvents;
+  uint64_t m_nConflicts;
+};
+
+} // namespace ns3
+
+#endif /* PARALLEL_SIMULATOR_IMPL_H */
@@ -23,6 +23,10 @@
 #include "rng-stream.h"
 #include "global-value.h"
 #include "integer.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "system-mutex.h"
+#endif
 using namespace std;
 
 namespace
@@ -334,11 +338,26 @@ double RngStream::nextSeed[6] =
   12345.0, 12345.0, 12345.0, 12345.0, 12345.0, 12345.0
 };
 
+#ifdef HAVE_PTHREAD_H
+// guards nextSeed: the random variables create their stream when they
+// are first drawn, maybe by events run in parallel. Streams may also be
+// created by static constructors, hence the function static.
+static SystemMutex &
+GetNextSeedMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+#endif
+
 //-------------------------------------------------------------------------
 // constructor
 //
 RngStream::RngStream ()
 {
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (GetNextSeedMutex ());
+#endif
   uint32_t run = EnsureGlobalInitialized ();
 
   anti = false;
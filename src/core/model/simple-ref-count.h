@@ -25,6 +25,7 @@
 #include "empty.h"
 #include "default-deleter.h"
 #include "assert.h"
+#include "ns3/core-config.h"
 #include <stdint.h>
 #include <limits>
 
@@ -58,6 +59,12 @@ namespace ns3 {
  *      it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * When ns-3 is configured with --enable-atomic-refcount, which defines
+ * NS3_ATOMIC_REFCOUNT, the count is updated with atomic operations, so
+ * that the objects shared by the threads of ParallelSimulatorImpl and
+ * MultithreadedSimulatorImpl are neither leaked nor freed twice. These
+ * simulators run with one thread otherwise.
  */
 template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
 class SimpleRefCount : public PARENT
@@ -82,7 +89,11 @@ public:
   inline void Ref (void) const
   {
     NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
+#ifdef NS3_ATOMIC_REFCOUNT
+    __sync_add_and_fetch (&m_count, 1);
+#else
     m_count++;
+#endif
   }
   /**
    * Decrement the reference count. This method should not be called
@@ -92,8 +103,12 @@ public:
    */
   inline void Unref (void) const
   {
+#ifdef NS3_ATOMIC_REFCOUNT
+    if (__sync_sub_and_fetch (&m_count, 1) == 0)
+#else
     m_count--;
     if (m_count == 0)
+#endif
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
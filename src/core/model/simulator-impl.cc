@@ -11,4 +11,16 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+bool
+SimulatorImpl::IsParallel (void) const
+{
+  return false;
+}
+
+bool
+SimulatorImpl::AllocatePacketUid (uint64_t &uid)
+{
+  return false;
+}
+
 } // namespace ns3
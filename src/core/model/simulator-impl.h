@@ -195,6 +195,17 @@ public:
    * \return the current simulation context
    */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * \return true if the events of several contexts may run at once, on
+   *         several threads. The default is false.
+   */
+  virtual bool IsParallel (void) const;
+  /**
+   * \param uid set to the uid of a packet created by the event running
+   * \return true if the simulator gave the uid, false if the packet is
+   *         numbered by the counter of ns3::Packet. The default is false.
+   */
+  virtual bool AllocatePacketUid (uint64_t &uid);
 };
 
 } // namespace ns3
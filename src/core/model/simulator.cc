@@ -336,6 +336,41 @@ Simulator::GetSystemId (void)
     }
 }
 
+bool
+Simulator::IsParallel (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  if (*PeekImpl () != 0)
+    {
+      return GetImpl ()->IsParallel ();
+    }
+  else
+    {
+      return false;
+    }
+}
+
+bool
+Simulator::AllocatePacketUid (uint64_t &uid)
+{
+  if (*PeekImpl () != 0)
+    {
+      return GetImpl ()->AllocatePacketUid (uid);
+    }
+  else
+    {
+      return false;
+    }
+}
+
+EventAllocator::Stats
+Simulator::GetEventAllocatorStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return EventAllocator::GetStats ();
+}
+
 void
 Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 {
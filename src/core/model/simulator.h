@@ -23,6 +23,7 @@
 
 #include "event-id.h"
 #include "event-impl.h"
+#include "event-allocator.h"
 #include "make-event.h"
 #include "nstime.h"
 
@@ -776,6 +777,36 @@ public:
    *          MPI or other distributed simulations
    */
   static uint32_t GetSystemId (void);
+
+  /**
+   * \returns true if the events of several contexts may run at once,
+   *          on several threads.
+   *
+   * The buffers shared by the copies of a packet are not guarded: when
+   * this returns true, the events scheduled for different contexts
+   * must not share them. They may share a packet which none of them
+   * writes to, as long as they copy it with Packet::DeepCopy.
+   */
+  static bool IsParallel (void);
+
+  /**
+   * \param uid set to the uid of a packet created by the event running
+   * \returns true if the simulator gave the uid, false if the packet
+   *          must be numbered by the caller
+   *
+   * The simulators which run events in parallel number the packets
+   * created by an event from the uid of this event, so that the uids
+   * do not depend on the threads. Used by ns3::Packet.
+   */
+  static bool AllocatePacketUid (uint64_t &uid);
+
+  /**
+   * \returns the counters of the allocator of the events, summed over
+   *          all the threads which scheduled events
+   *
+   * See ns3::EventAllocator.
+   */
+  static EventAllocator::Stats GetEventAllocatorStats (void);
 private:
   Simulator ();
   ~Simulator ();
@@ -24,6 +24,16 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/ns2-calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/parallel-simulator-impl.h"
+#include "ns3/uinteger.h"
+#endif
+#include <set>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -460,6 +470,376 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class LadderSchedulerTestCase : public TestCase
+{
+public:
+  LadderSchedulerTestCase ();
+  virtual void DoRun (void);
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase ()
+  : TestCase ("Check that the ladder scheduler orders events like the map scheduler")
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun (void)
+{
+  Ptr<Scheduler> ladder = CreateObject<LadderScheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  UniformVariable rng;
+  std::vector<Scheduler::Event> inserted;
+  std::set<uint32_t> gone;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t i = 0; i < 200000; i++)
+    {
+      double op = rng.GetValue ();
+      if (op < 0.6)
+        {
+          // mostly near-future events, some periodic timers, a few
+          // events for the current time
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          double kind = rng.GetValue ();
+          if (kind < 0.7)
+            {
+              ev.key.m_ts = now + rng.GetInteger (1, 100000);
+            }
+          else if (kind < 0.9)
+            {
+              ev.key.m_ts = now + 1000000000 + rng.GetInteger (0, 10000000);
+            }
+          else
+            {
+              ev.key.m_ts = now;
+            }
+          ladder->Insert (ev);
+          reference->Insert (ev);
+          inserted.push_back (ev);
+        }
+      else if (op < 0.65 && !reference->IsEmpty ())
+        {
+          Scheduler::Event ev = inserted[rng.GetInteger (0, inserted.size () - 1)];
+          if (gone.insert (ev.key.m_uid).second)
+            {
+              ladder->Remove (ev);
+              reference->Remove (ev);
+            }
+        }
+      else if (!reference->IsEmpty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), false, "Ladder empty at " << i);
+          Scheduler::Event expected = reference->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ladder->PeekNext ().key.m_uid, expected.key.m_uid, "Peek at " << i);
+          Scheduler::Event ev = ladder->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "RemoveNext at " << i);
+          gone.insert (ev.key.m_uid);
+          now = ev.key.m_ts;
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (ladder->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid,
+                             "Draining");
+    }
+  NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), true, "Ladder not empty");
+}
+
+class EventAllocatorTestCase : public TestCase
+{
+public:
+  EventAllocatorTestCase ();
+  virtual void DoRun (void);
+private:
+  void Count (uint32_t n);
+  void Allocate (void);
+  void Release (void);
+  std::vector<EventImpl *> m_events;
+  uint32_t m_count;
+};
+
+EventAllocatorTestCase::EventAllocatorTestCase ()
+  : TestCase ("Check that the events are counted and reused by the event allocator"),
+    m_count (0)
+{
+}
+
+void
+EventAllocatorTestCase::Count (uint32_t n)
+{
+  m_count += n;
+}
+
+void
+EventAllocatorTestCase::Allocate (void)
+{
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_events.push_back (MakeEvent (&EventAllocatorTestCase::Count, this, 1));
+    }
+}
+
+void
+EventAllocatorTestCase::Release (void)
+{
+  for (std::vector<EventImpl *>::const_iterator i = m_events.begin (); i != m_events.end (); ++i)
+    {
+      (*i)->Unref ();
+    }
+  m_events.clear ();
+}
+
+void
+EventAllocatorTestCase::DoRun (void)
+{
+  EventAllocator::Stats start = Simulator::GetEventAllocatorStats ();
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &EventAllocatorTestCase::Count, this, 1);
+    }
+  Simulator::Run ();
+  EventAllocator::Stats first = Simulator::GetEventAllocatorStats ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1000, "Events lost");
+  NS_TEST_ASSERT_MSG_EQ (first.allocations - start.allocations, 1000, "Allocations not counted");
+  NS_TEST_ASSERT_MSG_EQ (first.releases - start.releases, 1000, "Releases not counted");
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &EventAllocatorTestCase::Count, this, 1);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  EventAllocator::Stats second = Simulator::GetEventAllocatorStats ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2000, "Events lost");
+  if (!EventAllocator::IsPooling ())
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (second.reuses - first.reuses, 1000, "Freed events not reused");
+  NS_TEST_ASSERT_MSG_EQ (second.systemAllocations, first.systemAllocations, "Pooled events not reused");
+
+#ifdef HAVE_PTHREAD_H
+  // events freed by another thread come back to this one
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_events.push_back (MakeEvent (&EventAllocatorTestCase::Count, this, 1));
+    }
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&EventAllocatorTestCase::Release, this));
+  thread->Start ();
+  thread->Join ();
+  EventAllocator::Stats released = Simulator::GetEventAllocatorStats ();
+  NS_TEST_ASSERT_MSG_EQ (released.threads, second.threads + 1, "Thread pool not registered");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_events.push_back (MakeEvent (&EventAllocatorTestCase::Count, this, 1));
+    }
+  Release ();
+  EventAllocator::Stats reused = Simulator::GetEventAllocatorStats ();
+  NS_TEST_ASSERT_MSG_EQ (reused.reuses - released.reuses, 100, "Events freed by another thread not reused");
+  NS_TEST_ASSERT_MSG_EQ (reused.releases - second.releases, 200, "Releases not counted");
+
+  // the pool of a thread which exited is adopted by the next thread,
+  // with the events freed to it meanwhile
+  thread = Create<SystemThread> (MakeCallback (&EventAllocatorTestCase::Allocate, this));
+  thread->Start ();
+  thread->Join ();
+  Release ();
+  EventAllocator::Stats orphan = Simulator::GetEventAllocatorStats ();
+  thread = Create<SystemThread> (MakeCallback (&EventAllocatorTestCase::Allocate, this));
+  thread->Start ();
+  thread->Join ();
+  EventAllocator::Stats adopted = Simulator::GetEventAllocatorStats ();
+  NS_TEST_ASSERT_MSG_EQ (adopted.threads, released.threads, "Pool of an exited thread not adopted");
+  NS_TEST_ASSERT_MSG_EQ (adopted.reuses - orphan.reuses, 100, "Events freed to an exited thread not reused");
+  Release ();
+#endif
+}
+
+#ifdef HAVE_PTHREAD_H
+class ParallelSimulatorTestCase : public TestCase
+{
+public:
+  ParallelSimulatorTestCase ();
+  virtual void DoRun (void);
+private:
+  enum { N_NODES = 40 };
+  // runs the nodes with DefaultSimulatorImpl if threads is 0
+  Ptr<ParallelSimulatorImpl> RunNodes (uint32_t threads, uint32_t eventIds = 16);
+  void Tick (uint32_t node, uint32_t n);
+  void Message (uint32_t node, uint32_t from);
+  void Timeout (uint32_t node);
+  void Log (uint32_t node, uint32_t kind, uint32_t value);
+  void ArmOther (void);
+  void ArmCancel (void);
+  void CancelOther (void);
+  void Other (void);
+  std::vector<std::vector<uint64_t> > m_logs;
+  std::vector<std::vector<uint64_t> > m_packetUids;
+  std::vector<EventId> m_timers;
+  EventId m_other;
+  bool m_otherRan;
+};
+
+ParallelSimulatorTestCase::ParallelSimulatorTestCase ()
+  : TestCase ("Check that ParallelSimulatorImpl runs the same events whatever its number of threads")
+{
+}
+
+void
+ParallelSimulatorTestCase::Log (uint32_t node, uint32_t kind, uint32_t value)
+{
+  // the context is checked here rather than with NS_TEST_ASSERT, which
+  // is not thread safe
+  uint32_t context = Simulator::GetContext () == node ? 0 : 1;
+  m_logs[node].push_back ((((Simulator::Now ().GetMicroSeconds () * 4) + kind) * 100 + value) * 2 + context);
+}
+
+void
+ParallelSimulatorTestCase::Tick (uint32_t node, uint32_t n)
+{
+  Log (node, 0, n);
+  if (n < 5 + node % 7)
+    {
+      Simulator::Schedule (MilliSeconds (1), &ParallelSimulatorTestCase::Tick, this, node, n + 1);
+      Simulator::ScheduleWithContext ((node + 1) % N_NODES, MilliSeconds (1),
+                                      &ParallelSimulatorTestCase::Message, this, (node + 1) % N_NODES, node);
+    }
+  m_timers[node].Cancel ();
+  m_timers[node] = Simulator::Schedule (MicroSeconds (1500), &ParallelSimulatorTestCase::Timeout, this, node);
+}
+
+void
+ParallelSimulatorTestCase::Message (uint32_t node, uint32_t from)
+{
+  Log (node, 1, from);
+  uint64_t uid;
+  if (Simulator::AllocatePacketUid (uid))
+    {
+      m_packetUids[node].push_back (uid);
+    }
+  if (from % 3 == 0)
+    {
+      Simulator::ScheduleNow (&ParallelSimulatorTestCase::Log, this, node, 2, from);
+    }
+}
+
+void
+ParallelSimulatorTestCase::Timeout (uint32_t node)
+{
+  Log (node, 3, 0);
+}
+
+Ptr<ParallelSimulatorImpl>
+ParallelSimulatorTestCase::RunNodes (uint32_t threads, uint32_t eventIds)
+{
+  Simulator::Destroy ();
+  Ptr<ParallelSimulatorImpl> impl;
+  if (threads != 0)
+    {
+      impl = CreateObject<ParallelSimulatorImpl> ();
+      impl->SetAttribute ("Threads", UintegerValue (threads));
+      impl->SetAttribute ("MinParallelEvents", UintegerValue (2));
+      impl->SetAttribute ("EventIdsPerEvent", UintegerValue (eventIds));
+      Simulator::SetImplementation (impl);
+    }
+  m_logs.assign (N_NODES, std::vector<uint64_t> ());
+  m_packetUids.assign (N_NODES, std::vector<uint64_t> ());
+  m_timers.assign (N_NODES, EventId ());
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      Simulator::ScheduleWithContext (node, MilliSeconds (1), &ParallelSimulatorTestCase::Tick, this, node, 0);
+    }
+  Simulator::Run ();
+  return impl;
+}
+
+void
+ParallelSimulatorTestCase::Other (void)
+{
+  m_otherRan = true;
+}
+
+void
+ParallelSimulatorTestCase::ArmOther (void)
+{
+  m_other = Simulator::Schedule (Seconds (1), &ParallelSimulatorTestCase::Other, this);
+}
+
+void
+ParallelSimulatorTestCase::ArmCancel (void)
+{
+  Simulator::Schedule (Seconds (1), &ParallelSimulatorTestCase::CancelOther, this);
+}
+
+void
+ParallelSimulatorTestCase::CancelOther (void)
+{
+  Simulator::Cancel (m_other);
+}
+
+void
+ParallelSimulatorTestCase::DoRun (void)
+{
+  Ptr<ParallelSimulatorImpl> impl = RunNodes (1);
+  NS_TEST_ASSERT_MSG_GT (impl->GetNBatches (), 0, "No batch run in parallel");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetNConflicts (), 0, "Unexpected conflicts");
+  std::vector<std::vector<uint64_t> > sequential = m_logs;
+  std::vector<std::vector<uint64_t> > packetUids = m_packetUids;
+
+  RunNodes (4);
+  std::set<uint64_t> uids;
+  uint32_t nUids = 0;
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[node] == sequential[node]), true, "Events of node " << node << " differ");
+      NS_TEST_ASSERT_MSG_EQ ((m_packetUids[node] == packetUids[node]), true, "Packet uids of node " << node << " differ");
+      uids.insert (m_packetUids[node].begin (), m_packetUids[node].end ());
+      nUids += m_packetUids[node].size ();
+    }
+  NS_TEST_ASSERT_MSG_GT (nUids, 0, "No packet uid given by the batches");
+  NS_TEST_ASSERT_MSG_EQ (uids.size (), nUids, "Packet uids given twice");
+
+  // the same events as DefaultSimulatorImpl, maybe in another order
+  // within a timestamp
+  RunNodes (0);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      std::sort (m_logs[node].begin (), m_logs[node].end ());
+      std::sort (sequential[node].begin (), sequential[node].end ());
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[node] == sequential[node]), true, "Events of node " << node << " differ");
+      for (uint32_t i = 0; i < m_logs[node].size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_logs[node][i] % 2, 0, "Wrong context for node " << node);
+        }
+    }
+
+  // a Tick schedules two events with an EventId: the timer, which the
+  // next Tick cancels, gets its uid at the end of the batch
+  RunNodes (4, 1);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      std::sort (m_logs[node].begin (), m_logs[node].end ());
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[node] == sequential[node]), true, "Events of node " << node << " differ");
+    }
+  Simulator::Destroy ();
+
+  // a cancel of an event of another context of the batch has no effect
+  impl = CreateObject<ParallelSimulatorImpl> ();
+  impl->SetAttribute ("Threads", UintegerValue (1));
+  Simulator::SetImplementation (impl);
+  m_otherRan = false;
+  Simulator::ScheduleWithContext (1, Seconds (1), &ParallelSimulatorTestCase::ArmCancel, this);
+  Simulator::ScheduleWithContext (2, Seconds (1), &ParallelSimulatorTestCase::ArmOther, this);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_otherRan, true, "Event cancelled by another context of its batch");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetNConflicts (), 1, "Conflict not counted");
+  Simulator::Destroy ();
+}
+#endif
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -478,6 +858,13 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory));
     factory.SetTypeId (Ns2CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory));
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory));
+    AddTestCase (new LadderSchedulerTestCase ());
+    AddTestCase (new EventAllocatorTestCase ());
+#ifdef HAVE_PTHREAD_H
+    AddTestCase (new ParallelSimulatorTestCase ());
+#endif
   }
 } g_simulatorTestSuite;
 
@@ -0,0 +1,489 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Parameter sweep of the GPSR trace scenarios.
+ *
+ * Runs every combination of communication mode, traffic density, test id
+ * and run number, as scratch/gpsr.cc does one at a time, and prints one
+ * table with the packet delivery ratio and the mean delay of each run:
+ *
+ *   ./waf --run "gpsr-sweep --commMode=v2i --traffDensity=low,high
+ *                --testId=1.1,3.1 --runs=1-5 --time=60"
+ *
+ * With --beaconFree, the nodes take their neighbors from a shared position
+ * snapshot instead of exchanging hellos, to compare with beaconing.
+ *
+ * In the v2v mode there is no road side unit: the vehicles only reach
+ * the destinations they hear. A run that fails is reported as failed in
+ * the table.
+ *
+ * The simulator is a process wide singleton, so the runs are forked
+ * processes, at most --jobs at a time (by default one per core). Every
+ * trace is parsed once, before forking, and the runs read it from the
+ * memory they share with the sweep. A run only depends on its parameters
+ * and its run number, which selects its random number substream, so the
+ * table does not depend on the number of jobs.
+ */
+
+#include "ns3/gpsr-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/seq-ts-header.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("GpsrSweep");
+
+/// One point of the parameter grid
+struct SweepPoint
+{
+  std::string commMode;
+  std::string traffDensity;
+  std::string testId;
+  uint32_t runId;
+  std::string traceFile;
+};
+
+/// What a run reports back to the sweep
+struct SweepResult
+{
+  uint32_t sent;
+  uint32_t received;
+  double delaySum;    // seconds
+};
+
+/// Splits a comma separated list
+static std::vector<std::string>
+SplitList (std::string list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/// Parses a list of run numbers, such as 1,2,5 or 1-5
+static std::vector<uint32_t>
+ParseRuns (std::string list)
+{
+  std::vector<uint32_t> runs;
+  std::vector<std::string> items = SplitList (list);
+  for (std::vector<std::string>::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      uint32_t first, last;
+      std::string::size_type dash = i->find ('-');
+      first = std::atoi (i->substr (0, dash).c_str ());
+      last = dash == std::string::npos ? first : std::atoi (i->substr (dash + 1).c_str ());
+      for (uint32_t r = first; r <= last; r++)
+        {
+          runs.push_back (r);
+        }
+    }
+  return runs;
+}
+
+/**
+ * \brief One GPSR trace scenario
+ *
+ * The vehicles move along a ns2 trace. In the v2i mode the nodes 1 to 3
+ * are road side units, with their own antennas, sharing a location
+ * directory. The source sends a constant bit rate UDP flow to the sink.
+ */
+class GpsrScenario
+{
+public:
+  GpsrScenario (const SweepPoint &point, uint32_t size);
+
+  void SetTraffic (uint32_t source, uint32_t sink, uint32_t packetSize, Time interval);
+  SweepResult Run (double totalTime);
+
+private:
+  void CreateNodes ();
+  void CreateDevices ();
+  void InstallInternetStack ();
+  void InstallApplications (double totalTime);
+  void Send (Ptr<Socket> socket);
+  void Receive (Ptr<Socket> socket);
+
+  SweepPoint m_point;
+  uint32_t m_size;
+  uint32_t m_source;
+  uint32_t m_sink;
+  uint32_t m_packetSize;
+  Time m_interval;
+  Time m_stop;
+  SweepResult m_result;
+
+  NodeContainer m_nodes;
+  NodeContainer m_rsuNodes;
+  NodeContainer m_obuNodes;
+  NetDeviceContainer m_devices;
+  Ipv4InterfaceContainer m_interfaces;
+};
+
+GpsrScenario::GpsrScenario (const SweepPoint &point, uint32_t size)
+  : m_point (point),
+    m_size (size),
+    m_source (0),
+    m_sink (4),
+    m_packetSize (512),
+    m_interval (Seconds (0.1))
+{
+  m_result.sent = 0;
+  m_result.received = 0;
+  m_result.delaySum = 0;
+}
+
+void
+GpsrScenario::SetTraffic (uint32_t source, uint32_t sink, uint32_t packetSize, Time interval)
+{
+  m_source = source;
+  m_sink = sink;
+  m_packetSize = packetSize;
+  m_interval = interval;
+}
+
+SweepResult
+GpsrScenario::Run (double totalTime)
+{
+  SeedManager::SetSeed (12345);
+  SeedManager::SetRun (m_point.runId);
+
+  CreateNodes ();
+  CreateDevices ();
+  InstallInternetStack ();
+  InstallApplications (totalTime);
+
+  GpsrHelper gpsr;
+  gpsr.Install ();
+
+  Simulator::Stop (Seconds (totalTime));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_result;
+}
+
+void
+GpsrScenario::CreateNodes ()
+{
+  m_nodes.Create (m_size);
+  // configure movements for each node, from the preloaded trace
+  Ns2MobilityHelper mobility = Ns2MobilityHelper (m_point.traceFile);
+  mobility.Install ();
+
+  for (uint32_t i = 0; i < m_size; ++i)
+    {
+      Ptr<Node> node = m_nodes.Get (i);
+      if (m_point.commMode == "v2i" && i >= 1 && i <= 3)
+        {
+          m_rsuNodes.Add (node);
+        }
+      else
+        {
+          m_obuNodes.Add (node);
+        }
+    }
+}
+
+void
+GpsrScenario::CreateDevices ()
+{
+  NqosWifiMacHelper wifiMac = NqosWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6MbpsBW10MHz"), "ControlMode", StringValue ("OfdmRate6MbpsBW10MHz"));
+
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<TwoRayGroundPropagationLossModel> determPropLoss = CreateObject<TwoRayGroundPropagationLossModel> ();
+  determPropLoss->SetLambda (5.900e9, 300000000.0);
+  Ptr<NakagamiPropagationLossModel> probabPropLoss = CreateObject<NakagamiPropagationLossModel> ();
+  probabPropLoss->SetAttribute ("Distance1", DoubleValue (80));
+  probabPropLoss->SetAttribute ("Distance2", DoubleValue (250));
+  probabPropLoss->SetAttribute ("m0", DoubleValue (1.5));
+  probabPropLoss->SetAttribute ("m1", DoubleValue (0.75));
+  probabPropLoss->SetAttribute ("m2", DoubleValue (0.5));
+  determPropLoss->SetNext (probabPropLoss);
+  determPropLoss->SetHeightAboveZ (1.7);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (determPropLoss);
+  wifiPhy.SetChannel (channel);
+
+  /* OBU Settings: 5 dBm + 2 dBi, about 300 m range */
+  wifiPhy.Set ("TxPowerStart", DoubleValue (5));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (5));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("TxGain", DoubleValue (2));
+  wifiPhy.Set ("RxGain", DoubleValue (2));
+  NetDeviceContainer obuDevices = wifi.Install (wifiPhy, wifiMac, m_obuNodes);
+
+  /* RSU Settings */
+  wifiPhy.Set ("TxPowerStart", DoubleValue (18));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (18));
+  wifiPhy.Set ("TxGain", DoubleValue (9));
+  wifiPhy.Set ("RxGain", DoubleValue (9));
+  NetDeviceContainer rsuDevices = wifi.Install (wifiPhy, wifiMac, m_rsuNodes);
+
+  // devices in node order, so that node i gets the address 10.0.0.i+1
+  for (uint32_t i = 0; i < m_size; ++i)
+    {
+      m_devices.Add (m_nodes.Get (i)->GetDevice (0));
+    }
+}
+
+void
+GpsrScenario::InstallInternetStack ()
+{
+  GpsrHelper gpsr;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (gpsr);
+  stack.Install (m_nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  m_interfaces = address.Assign (m_devices);
+  if (m_rsuNodes.GetN () > 0)
+    {
+      gpsr.InstallRsuDirectory (m_rsuNodes);
+    }
+  else
+    {
+      // not even the default road side units
+      Config::SetGlobal ("GpsrRsuAddresses", StringValue (""));
+    }
+}
+
+void
+GpsrScenario::InstallApplications (double totalTime)
+{
+  uint16_t port = 9;
+  TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+
+  Ptr<Socket> sink = Socket::CreateSocket (m_nodes.Get (m_sink), tid);
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  sink->SetRecvCallback (MakeCallback (&GpsrScenario::Receive, this));
+
+  Ptr<Socket> source = Socket::CreateSocket (m_nodes.Get (m_source), tid);
+  source->Connect (InetSocketAddress (m_interfaces.GetAddress (m_sink), port));
+  m_stop = Seconds (totalTime - 0.1);
+  Simulator::Schedule (Seconds (2.0), &GpsrScenario::Send, this, source);
+}
+
+void
+GpsrScenario::Send (Ptr<Socket> socket)
+{
+  SeqTsHeader seqTs;
+  seqTs.SetSeq (m_result.sent);
+  Ptr<Packet> p = Create<Packet> (m_packetSize - 12); // minus the SeqTsHeader
+  p->AddHeader (seqTs);
+  socket->Send (p);
+  m_result.sent++;
+  if (Simulator::Now () + m_interval < m_stop)
+    {
+      Simulator::Schedule (m_interval, &GpsrScenario::Send, this, socket);
+    }
+}
+
+void
+GpsrScenario::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      SeqTsHeader seqTs;
+      p->RemoveHeader (seqTs);
+      m_result.received++;
+      m_result.delaySum += (Simulator::Now () - seqTs.GetTs ()).GetSeconds ();
+    }
+}
+
+/// Runs a point in a child process, which writes its result to fd
+static pid_t
+Launch (const SweepPoint &point, uint32_t size, uint32_t source, uint32_t sink,
+        uint32_t packetSize, Time interval, double totalTime, int &fd)
+{
+  int pipefd[2];
+  if (pipe (pipefd) != 0)
+    {
+      NS_FATAL_ERROR ("pipe failed: " << std::strerror (errno));
+    }
+  pid_t pid = ::fork ();
+  if (pid == -1)
+    {
+      NS_FATAL_ERROR ("fork failed: " << std::strerror (errno));
+    }
+  if (pid == 0)
+    {
+      close (pipefd[0]);
+      // the progress messages of the models would garble the table
+      if (std::freopen ("/dev/null", "w", stdout) == 0)
+        {
+          _exit (1);
+        }
+      GpsrScenario scenario (point, size);
+      scenario.SetTraffic (source, sink, packetSize, interval);
+      SweepResult result = scenario.Run (totalTime);
+      ssize_t written = write (pipefd[1], &result, sizeof (result));
+      _exit (written == sizeof (result) ? 0 : 1);
+    }
+  close (pipefd[1]);
+  fd = pipefd[0];
+  return pid;
+}
+
+int
+main (int argc, char **argv)
+{
+  std::string commModes = "v2i";
+  std::string traffDensities = "low,high";
+  std::string testIds = "1.1,3.1";
+  std::string runList = "1";
+  std::string traceDir = ".";
+  std::string traceSuffix = "-out.tcl";
+  std::string output;
+  uint32_t jobs = sysconf (_SC_NPROCESSORS_ONLN);
+  double totalTime = 100;
+  uint32_t source = 0;
+  uint32_t sink = 4;
+  uint32_t packetSize = 512;
+  double interval = 0.1;
+  bool beaconFree = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("commMode", "Communication modes, comma separated (v2v; v2i).", commModes);
+  cmd.AddValue ("traffDensity", "Traffic densities, comma separated (low; high).", traffDensities);
+  cmd.AddValue ("testId", "Test ids, comma separated (1.1; 1.2; 2.1; 2.2; 3.1).", testIds);
+  cmd.AddValue ("runs", "Run numbers, comma separated, or a range such as 1-10.", runList);
+  cmd.AddValue ("traceDir", "Directory holding <commMode>/<traffDensity>-<testId><traceSuffix>.", traceDir);
+  cmd.AddValue ("traceSuffix", "Trace file suffix, such as -out.bin for binary traces.", traceSuffix);
+  cmd.AddValue ("jobs", "Number of runs at a time.", jobs);
+  cmd.AddValue ("time", "Simulation time, s.", totalTime);
+  cmd.AddValue ("source", "Node sending the traffic.", source);
+  cmd.AddValue ("sink", "Node receiving the traffic.", sink);
+  cmd.AddValue ("packetSize", "Packet size, bytes.", packetSize);
+  cmd.AddValue ("interval", "Time between packets, s.", interval);
+  cmd.AddValue ("output", "Table file, standard output if empty.", output);
+  cmd.AddValue ("beaconFree", "Take the GPSR neighbors from position snapshots instead of hellos.", beaconFree);
+  cmd.Parse (argc, argv);
+  jobs = std::max<uint32_t> (jobs, 1);
+  Config::SetDefault ("ns3::gpsr::RoutingProtocol::BeaconFree", BooleanValue (beaconFree));
+
+  // the grid, in table order, and the size of each trace
+  std::vector<SweepPoint> points;
+  std::map<std::string, uint32_t> sizes;
+  std::vector<std::string> modes = SplitList (commModes);
+  std::vector<std::string> densities = SplitList (traffDensities);
+  std::vector<std::string> tests = SplitList (testIds);
+  std::vector<uint32_t> runs = ParseRuns (runList);
+  for (uint32_t m = 0; m < modes.size (); m++)
+    {
+      for (uint32_t d = 0; d < densities.size (); d++)
+        {
+          for (uint32_t t = 0; t < tests.size (); t++)
+            {
+              SweepPoint point;
+              point.commMode = modes[m];
+              point.traffDensity = densities[d];
+              point.testId = tests[t];
+              point.traceFile = traceDir + "/" + modes[m] + "/" + densities[d] + "-" + tests[t] + traceSuffix;
+              uint32_t size = Ns2MobilityHelper::Preload (point.traceFile);
+              if (size <= std::max (source, sink))
+                {
+                  NS_FATAL_ERROR ("Trace " << point.traceFile << " has " << size << " nodes");
+                }
+              sizes[point.traceFile] = size;
+              for (uint32_t r = 0; r < runs.size (); r++)
+                {
+                  point.runId = runs[r];
+                  points.push_back (point);
+                }
+            }
+        }
+    }
+
+  // run them, at most jobs at a time
+  std::vector<SweepResult> results (points.size ());
+  std::vector<bool> failed (points.size (), false);
+  std::map<pid_t, std::pair<uint32_t, int> > running; // pid -> point, pipe
+  std::cout.flush ();
+  std::cerr.flush ();
+  uint32_t next = 0;
+  while (next < points.size () || !running.empty ())
+    {
+      if (next < points.size () && running.size () < jobs)
+        {
+          int fd;
+          pid_t pid = Launch (points[next], sizes[points[next].traceFile], source, sink,
+                              packetSize, Seconds (interval), totalTime, fd);
+          running[pid] = std::make_pair (next, fd);
+          next++;
+          continue;
+        }
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid == -1)
+        {
+          NS_FATAL_ERROR ("waitpid failed: " << std::strerror (errno));
+        }
+      std::map<pid_t, std::pair<uint32_t, int> >::iterator i = running.find (pid);
+      if (i == running.end ())
+        {
+          continue;
+        }
+      uint32_t index = i->second.first;
+      int fd = i->second.second;
+      // the result fits in the pipe buffer, so it is there once the run exited
+      failed[index] = !WIFEXITED (status) || WEXITSTATUS (status) != 0
+        || read (fd, &results[index], sizeof (SweepResult)) != sizeof (SweepResult);
+      close (fd);
+      running.erase (i);
+      NS_LOG_INFO ("Run " << index + 1 << "/" << points.size () << (failed[index] ? " failed, status " : " done, status ") << status);
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+  os << "commMode traffDensity testId runId sent received pdr delay(ms)\n";
+  for (uint32_t i = 0; i < points.size (); i++)
+    {
+      const SweepPoint &point = points[i];
+      const SweepResult &result = results[i];
+      os << point.commMode << " " << point.traffDensity << " " << point.testId << " " << point.runId;
+      if (failed[i])
+        {
+          os << " failed\n";
+          continue;
+        }
+      os << " " << result.sent << " " << result.received << std::fixed << std::setprecision (4)
+         << " " << (result.sent ? double (result.received) / result.sent : 0.0)
+         << " " << (result.received ? result.delaySum / result.received * 1000 : 0.0) << "\n";
+      os.unsetf (std::ios::floatfield);
+    }
+  return 0;
+}
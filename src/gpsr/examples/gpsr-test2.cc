@@ -178,6 +178,13 @@ GpsrExample::InstallInternetStack ()
   Ipv4AddressHelper address;
   address.SetBase ("10.0.0.0", "255.255.0.0");
   interfaces = address.Assign (devices);
+  // the first three nodes are the road side units
+  NodeContainer rsus;
+  for (uint32_t i = 0; i < size && i < 3; ++i)
+    {
+      rsus.Add (nodes.Get (i));
+    }
+  gpsr.InstallRsuDirectory (rsus);
 }
 
 void
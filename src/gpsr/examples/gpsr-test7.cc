@@ -61,6 +61,15 @@ private:
   double totalTime;
   /// Write per-device PCAP traces if true
   bool pcap;
+  /// Send hellos and location updates only when positions are out of date
+  bool adaptive;
+  //\}
+
+  ///\name results
+  //\{
+  /// GPSR and SLS control bytes sent and saved by the adaptive updates
+  uint64_t controlBytesSent;
+  uint64_t controlBytesSaved;
   //\}
 
   ///\name network
@@ -99,7 +108,10 @@ GpsrExample::GpsrExample () :
   // Simulation time
   totalTime (30),
   // Generate capture files for each node
-  pcap (true)
+  pcap (true),
+  adaptive (false),
+  controlBytesSent (0),
+  controlBytesSaved (0)
 {
 }
 
@@ -116,6 +128,7 @@ GpsrExample::Configure (int argc, char **argv)
   cmd.AddValue ("size", "Number of nodes.", size);
   cmd.AddValue ("time", "Simulation time, s.", totalTime);
   cmd.AddValue ("step", "Grid step, m", step);
+  cmd.AddValue ("adaptive", "Adaptive hellos and location updates.", adaptive);
 
   cmd.Parse (argc, argv);
   return true;
@@ -137,12 +150,21 @@ GpsrExample::Run ()
 
   Simulator::Stop (Seconds (totalTime));
   Simulator::Run ();
+
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      Ptr<gpsr::RoutingProtocol> routing = DynamicCast<gpsr::RoutingProtocol>
+          (nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      controlBytesSent += routing->GetControlBytesSent ();
+      controlBytesSaved += routing->GetControlBytesSaved ();
+    }
   Simulator::Destroy ();
 }
 
 void
-GpsrExample::Report (std::ostream &)
+GpsrExample::Report (std::ostream & os)
 {
+  os << "Control bytes sent " << controlBytesSent << ", saved " << controlBytesSaved << "\n";
 }
 
 void
@@ -197,12 +219,20 @@ GpsrExample::InstallInternetStack ()
 {
   GpsrHelper gpsr;
   // you can configure GPSR attributes here using gpsr.Set(name, value)
+  gpsr.Set ("AdaptiveUpdates", BooleanValue (adaptive));
   InternetStackHelper stack;
   stack.SetRoutingHelper (gpsr);
   stack.Install (nodes);
   Ipv4AddressHelper address;
   address.SetBase ("10.0.0.0", "255.255.0.0");
   interfaces = address.Assign (devices);
+  // the first three nodes are the road side units
+  NodeContainer rsus;
+  for (uint32_t i = 0; i < size && i < 3; ++i)
+    {
+      rsus.Add (nodes.Get (i));
+    }
+  gpsr.InstallRsuDirectory (rsus);
 }
 
 void
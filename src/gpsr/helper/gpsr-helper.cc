@@ -25,13 +25,21 @@
 #include "ns3/node-container.h"
 #include "ns3/callback.h"
 #include "ns3/udp-l4-protocol.h"
+#include "ns3/config.h"
+#include "ns3/ipv4.h"
+#include "ns3/gpsr-rsu-directory.h"
+#include "ns3/csma-helper.h"
+#include "ns3/csma-channel.h"
 
 namespace ns3 {
 
 GpsrHelper::GpsrHelper ()
-  : Ipv4RoutingHelper ()
+  : Ipv4RoutingHelper (),
+    m_backhaul (BACKHAUL_BUS)
 {
   m_agentFactory.SetTypeId ("ns3::gpsr::RoutingProtocol");
+  m_directoryFactory.SetTypeId ("ns3::gpsr::RsuDirectory");
+  m_channelFactory.SetTypeId ("ns3::CsmaChannel");
 }
 
 GpsrHelper*
@@ -73,4 +81,90 @@ GpsrHelper::Install (void) const
 }
 
 
+Ptr<gpsr::GpsrEventLog>
+GpsrHelper::EnableEventLog (std::string filename) const
+{
+  Ptr<gpsr::GpsrEventLog> log = CreateObject<gpsr::GpsrEventLog> ();
+  log->Open (filename);
+  Config::Connect ("/NodeList/*/$ns3::gpsr::RoutingProtocol/Event",
+                   MakeCallback (&gpsr::GpsrEventLog::WriteWithContext, log));
+  return log;
+}
+
+void
+GpsrHelper::SetBackhaul (BackhaulTopology topology)
+{
+  m_backhaul = topology;
+}
+
+void
+GpsrHelper::SetBackhaulAttribute (std::string name, const AttributeValue &value)
+{
+  m_channelFactory.Set (name, value);
+}
+
+void
+GpsrHelper::SetDirectoryAttribute (std::string name, const AttributeValue &value)
+{
+  m_directoryFactory.Set (name, value);
+}
+
+NetDeviceContainer
+GpsrHelper::InstallRsuDirectory (NodeContainer rsus) const
+{
+  std::vector<Ipv4Address> members;
+  std::vector<Ptr<gpsr::RsuDirectory> > directories;
+  for (uint32_t k = 0; k < rsus.GetN (); k++)
+    {
+      members.push_back (rsus.Get (k)->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ());
+      Ptr<gpsr::RsuDirectory> directory = m_directoryFactory.Create<gpsr::RsuDirectory> ();
+      rsus.Get (k)->AggregateObject (directory);
+      directories.push_back (directory);
+    }
+  for (uint32_t k = 0; k < rsus.GetN (); k++)
+    {
+      directories[k]->SetMembers (members, k);
+    }
+
+  CsmaHelper csma;
+  NetDeviceContainer devices;
+  if (m_backhaul == BACKHAUL_BUS)
+    {
+      devices = csma.Install (rsus, m_channelFactory.Create<CsmaChannel> ());
+      for (uint32_t k = 0; k < rsus.GetN (); k++)
+        {
+          directories[k]->AddBackhaul (devices.Get (k));
+          for (uint32_t m = 0; m < rsus.GetN (); m++)
+            {
+              directories[k]->SetRoute (m, devices.Get (k), devices.Get (m)->GetAddress ());
+            }
+        }
+      return devices;
+    }
+
+  // devices of link k: 2k on RSU k, 2k+1 on RSU k+1
+  for (uint32_t k = 0; k + 1 < rsus.GetN (); k++)
+    {
+      devices.Add (csma.Install (NodeContainer (rsus.Get (k), rsus.Get (k + 1)),
+                                 m_channelFactory.Create<CsmaChannel> ()));
+      directories[k]->AddBackhaul (devices.Get (2 * k));
+      directories[k + 1]->AddBackhaul (devices.Get (2 * k + 1));
+    }
+  for (uint32_t k = 0; k < rsus.GetN (); k++)
+    {
+      for (uint32_t m = 0; m < rsus.GetN (); m++)
+        {
+          if (m > k)
+            {
+              directories[k]->SetRoute (m, devices.Get (2 * k), devices.Get (2 * k + 1)->GetAddress ());
+            }
+          else if (m < k)
+            {
+              directories[k]->SetRoute (m, devices.Get (2 * k - 1), devices.Get (2 * k - 2)->GetAddress ());
+            }
+        }
+    }
+  return devices;
+}
+
 }
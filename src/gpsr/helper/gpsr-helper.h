@@ -24,6 +24,8 @@
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/ipv4-routing-helper.h"
+#include "ns3/net-device-container.h"
+#include "ns3/gpsr-event-log.h"
 
 namespace ns3 {
 /**
@@ -33,6 +35,13 @@ namespace ns3 {
 class GpsrHelper : public Ipv4RoutingHelper
 {
 public:
+  /// How InstallRsuDirectory connects the road side units
+  enum BackhaulTopology
+  {
+    BACKHAUL_BUS,   //!< one CSMA segment shared by all the RSUs
+    BACKHAUL_CHAIN, //!< one link between each two consecutive RSUs
+  };
+
   GpsrHelper ();
 
   /**
@@ -63,8 +72,51 @@ public:
 
   void Install (void) const;
 
+  /**
+   * \param filename the file the binary event log is written to
+   * \returns the log, which stays open until it is disposed of
+   *
+   * Connects a GpsrEventLog to the "Event" trace source of every
+   * ns3::gpsr::RoutingProtocol. Call after the protocols were created.
+   */
+  Ptr<gpsr::GpsrEventLog> EnableEventLog (std::string filename) const;
+
+  /**
+   * \param topology the backhaul built by InstallRsuDirectory, BACKHAUL_BUS by default
+   */
+  void SetBackhaul (BackhaulTopology topology);
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of the ns3::CsmaChannel of the backhaul links
+   */
+  void SetBackhaulAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of ns3::gpsr::RsuDirectory
+   */
+  void SetDirectoryAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param rsus the road side units, in corridor order
+   * \returns the backhaul devices
+   *
+   * Connects the road side units with a backhaul and aggregates a
+   * ns3::gpsr::RsuDirectory to each of them. Their GPSR protocol then
+   * answers the location queries from the directory instead of beaconing
+   * like a vehicle. Call after the IPv4 addresses were assigned and
+   * before the simulation starts; the address of interface 1 is the one
+   * the vehicles know the RSU by.
+   */
+  NetDeviceContainer InstallRsuDirectory (NodeContainer rsus) const;
+
 private:
   ObjectFactory m_agentFactory;
+  ObjectFactory m_directoryFactory;
+  BackhaulTopology m_backhaul;
+  ObjectFactory m_channelFactory;
 };
 
 }
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gpsr-event-log.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <cstring>
+#include <cstdlib>
+
+NS_LOG_COMPONENT_DEFINE ("GpsrEventLog");
+
+namespace ns3 {
+namespace gpsr {
+
+static const char GPSR_EVENT_LOG_MAGIC[8] = { 'G', 'P', 'S', 'R', 'E', 'V', 'T', '1' };
+
+GpsrEvent::GpsrEvent ()
+  : type (0),
+    uid (0),
+    value (0)
+{
+}
+
+GpsrEvent::GpsrEvent (uint8_t type, uint32_t uid, Ipv4Address src, Ipv4Address dst,
+                      Vector position, double value)
+  : type (type),
+    uid (uid),
+    src (src),
+    dst (dst),
+    position (position),
+    value (value)
+{
+}
+
+static uint8_t *
+WriteLe (uint8_t *buffer, uint64_t data, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      buffer[i] = (data >> (8 * i)) & 0xff;
+    }
+  return buffer + size;
+}
+
+static uint8_t *
+WriteDouble (uint8_t *buffer, double data)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &data, sizeof (bits));
+  return WriteLe (buffer, bits, 8);
+}
+
+static const uint8_t *
+ReadLe (const uint8_t *buffer, uint64_t &data, uint32_t size)
+{
+  data = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data |= static_cast<uint64_t> (buffer[i]) << (8 * i);
+    }
+  return buffer + size;
+}
+
+static const uint8_t *
+ReadDouble (const uint8_t *buffer, double &data)
+{
+  uint64_t bits;
+  buffer = ReadLe (buffer, bits, 8);
+  std::memcpy (&data, &bits, sizeof (data));
+  return buffer;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (GpsrEventLog);
+
+TypeId
+GpsrEventLog::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::gpsr::GpsrEventLog")
+    .SetParent<Object> ()
+    .AddConstructor<GpsrEventLog> ()
+  ;
+  return tid;
+}
+
+GpsrEventLog::GpsrEventLog ()
+{
+}
+
+GpsrEventLog::~GpsrEventLog ()
+{
+  Close ();
+}
+
+void
+GpsrEventLog::DoDispose (void)
+{
+  Close ();
+  Object::DoDispose ();
+}
+
+void
+GpsrEventLog::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_os.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_UNLESS (m_os.is_open (), "Could not open " << filename);
+  m_os.write (GPSR_EVENT_LOG_MAGIC, sizeof (GPSR_EVENT_LOG_MAGIC));
+}
+
+void
+GpsrEventLog::Close (void)
+{
+  if (m_os.is_open ())
+    {
+      m_os.close ();
+    }
+}
+
+void
+GpsrEventLog::Write (uint32_t node, const GpsrEvent &event)
+{
+  if (!m_os.is_open ())
+    {
+      return;
+    }
+  uint8_t buffer[RECORD_SIZE];
+  uint8_t *i = buffer;
+  i = WriteLe (i, Simulator::Now ().GetNanoSeconds (), 8);
+  i = WriteLe (i, node, 4);
+  i = WriteLe (i, event.type, 1);
+  i = WriteLe (i, event.uid, 4);
+  i = WriteLe (i, event.src.Get (), 4);
+  i = WriteLe (i, event.dst.Get (), 4);
+  i = WriteDouble (i, event.position.x);
+  i = WriteDouble (i, event.position.y);
+  i = WriteDouble (i, event.value);
+  NS_ASSERT (i == buffer + RECORD_SIZE);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (m_mutex);
+#endif
+  m_os.write (reinterpret_cast<const char *> (buffer), RECORD_SIZE);
+}
+
+void
+GpsrEventLog::WriteWithContext (std::string context, const GpsrEvent &event)
+{
+  // context is "/NodeList/<id>/..."
+  std::string::size_type start = context.find ("/NodeList/");
+  uint32_t node = 0xffffffff;
+  if (start != std::string::npos)
+    {
+      node = std::atoi (context.c_str () + start + 10);
+    }
+  Write (node, event);
+}
+
+bool
+GpsrEventLog::ReadMagic (std::istream &is)
+{
+  char magic[sizeof (GPSR_EVENT_LOG_MAGIC)];
+  is.read (magic, sizeof (magic));
+  return is.gcount () == sizeof (magic)
+         && std::memcmp (magic, GPSR_EVENT_LOG_MAGIC, sizeof (magic)) == 0;
+}
+
+bool
+GpsrEventLog::Read (std::istream &is, Time &time, uint32_t &node, GpsrEvent &event)
+{
+  uint8_t buffer[RECORD_SIZE];
+  is.read (reinterpret_cast<char *> (buffer), RECORD_SIZE);
+  if (is.gcount () != RECORD_SIZE)
+    {
+      return false;
+    }
+  const uint8_t *i = buffer;
+  uint64_t data;
+  i = ReadLe (i, data, 8);
+  time = NanoSeconds (static_cast<int64_t> (data));
+  i = ReadLe (i, data, 4);
+  node = data;
+  i = ReadLe (i, data, 1);
+  event.type = data;
+  i = ReadLe (i, data, 4);
+  event.uid = data;
+  i = ReadLe (i, data, 4);
+  event.src = Ipv4Address (static_cast<uint32_t> (data));
+  i = ReadLe (i, data, 4);
+  event.dst = Ipv4Address (static_cast<uint32_t> (data));
+  i = ReadDouble (i, event.position.x);
+  i = ReadDouble (i, event.position.y);
+  i = ReadDouble (i, event.value);
+  return true;
+}
+
+} // namespace gpsr
+} // namespace ns3
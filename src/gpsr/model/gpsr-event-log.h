@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef GPSR_EVENT_LOG_H
+#define GPSR_EVENT_LOG_H
+
+#include <fstream>
+#include <string>
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+
+namespace ns3 {
+namespace gpsr {
+
+/**
+ * \ingroup gpsr
+ * \brief Events reported through the "Event" trace source of gpsr::RoutingProtocol
+ */
+enum GpsrEventType
+{
+  GPSR_EVENT_TX = 0,        ///< data packet originated, value = size
+  GPSR_EVENT_RX = 1,        ///< data packet delivered to its destination, value = size
+  GPSR_EVENT_FORWARD = 2,   ///< greedy forward, value = distance left to the destination
+  GPSR_EVENT_RECOVERY = 3,  ///< packet entered recovery mode, value = distance left to the destination
+  GPSR_EVENT_DROP = 4,      ///< queued packets dropped, the destination was not found
+  GPSR_EVENT_QUERY = 5,     ///< SLS location query sent
+  GPSR_EVENT_REPLY = 6      ///< SLS location reply received, position = reported position,
+                            ///< value = distance to the actual position
+};
+
+/**
+ * \ingroup gpsr
+ * \brief A GPSR or SLS event
+ */
+struct GpsrEvent
+{
+  GpsrEvent ();
+  GpsrEvent (uint8_t type, uint32_t uid, Ipv4Address src, Ipv4Address dst,
+             Vector position = Vector (), double value = 0);
+
+  uint8_t type;         ///< a GpsrEventType
+  uint32_t uid;         ///< packet uid, or query id
+  Ipv4Address src;
+  Ipv4Address dst;
+  Vector position;      ///< position of the reporting node, unless noted otherwise
+  double value;
+};
+
+/**
+ * \ingroup gpsr
+ * \brief Binary log of GpsrEvent, for post-hoc analysis
+ *
+ * The file starts with the 8 bytes magic "GPSREVT1", followed by fixed
+ * size records of RECORD_SIZE bytes, all fields little endian:
+ * time (int64, ns), node id (uint32), type (uint8), uid (uint32),
+ * src (uint32), dst (uint32), x, y, value (IEEE 754 doubles).
+ *
+ * A mutex guards the file when threading is enabled, since all the
+ * nodes write to it: the records of one timestamp are then in the
+ * order the nodes run in, which ParallelSimulatorImpl does not fix.
+ */
+class GpsrEventLog : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  static const uint32_t RECORD_SIZE = 49;
+
+  GpsrEventLog ();
+  virtual ~GpsrEventLog ();
+
+  /**
+   * \param filename the file to write the records to, truncated.
+   */
+  void Open (std::string filename);
+  void Close (void);
+  /**
+   * \param node the id of the node reporting the event
+   * \param event the event, logged with the current simulation time
+   */
+  void Write (uint32_t node, const GpsrEvent &event);
+  /**
+   * Suitable for Config::Connect on "/NodeList/[i]/$ns3::gpsr::RoutingProtocol/Event",
+   * the node id is taken from the context.
+   */
+  void WriteWithContext (std::string context, const GpsrEvent &event);
+
+  /**
+   * \param is a stream positioned after the magic, or on the next record
+   * \param time filled with the time of the event
+   * \param node filled with the id of the node reporting the event
+   * \param event filled with the event
+   * \returns false at the end of the stream
+   */
+  static bool Read (std::istream &is, Time &time, uint32_t &node, GpsrEvent &event);
+  /**
+   * \param is a stream at the start of a log
+   * \returns true if the magic matches
+   */
+  static bool ReadMagic (std::istream &is);
+
+private:
+  virtual void DoDispose (void);
+
+  std::ofstream m_os;
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;
+#endif
+};
+
+} // namespace gpsr
+} // namespace ns3
+
+#endif /* GPSR_EVENT_LOG_H */
@@ -0,0 +1,25 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gpsr-log.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+
+namespace ns3 {
+namespace gpsr {
+
+static GlobalValue g_analysisOutput = GlobalValue ("GpsrAnalysisOutput",
+                                                   "Write the AEED, QSR and Precision lines of the analysis "
+                                                   "scripts to std::clog, whatever the logging level",
+                                                   BooleanValue (true),
+                                                   MakeBooleanChecker ());
+
+bool
+IsAnalysisOutputEnabled (void)
+{
+  BooleanValue value;
+  g_analysisOutput.GetValue (value);
+  return value.Get ();
+}
+
+} // namespace gpsr
+} // namespace ns3
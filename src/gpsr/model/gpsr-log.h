@@ -0,0 +1,56 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef GPSR_LOG_H
+#define GPSR_LOG_H
+
+#include <iostream>
+#include "ns3/log.h"
+
+/*
+ * Logging of the GPSR and SLS sources, not installed.
+ *
+ * GPSR_LOG_DEBUG, GPSR_LOG_LOGIC and GPSR_PRINT_TABLE are the per packet
+ * traces and table dumps, level-gated like NS_LOG_DEBUG and NS_LOG_LOGIC.
+ * Configuring with --disable-gpsr-log defines NS3_GPSR_NO_LOG and removes
+ * them from the module, arguments included, whatever NS3_LOG_ENABLE says.
+ *
+ * GPSR_ANALYSIS is the output of the analysis scripts (AEED, QSR,
+ * Precision, the queries and replies sent and received). It is written
+ * to std::clog whatever the logging level and the build, unless the
+ * GpsrAnalysisOutput global value is false.
+ */
+
+#ifdef NS3_GPSR_NO_LOG
+
+#define GPSR_LOG_DEBUG(msg)
+#define GPSR_LOG_LOGIC(msg)
+#define GPSR_PRINT_TABLE(table, id)
+
+#else /* NS3_GPSR_NO_LOG */
+
+#define GPSR_LOG_DEBUG(msg) NS_LOG_DEBUG (msg)
+#define GPSR_LOG_LOGIC(msg) NS_LOG_LOGIC (msg)
+#define GPSR_PRINT_TABLE(table, id) (table).PrintTable (id)
+
+#endif /* NS3_GPSR_NO_LOG */
+
+#define GPSR_ANALYSIS(msg)                              \
+  do                                                    \
+    {                                                   \
+      if (ns3::gpsr::IsAnalysisOutputEnabled ())        \
+        {                                               \
+          std::clog << msg << std::endl;                \
+        }                                               \
+    }                                                   \
+  while (false)
+
+namespace ns3 {
+namespace gpsr {
+
+/// \returns the value of the GpsrAnalysisOutput global value
+bool IsAnalysisOutputEnabled (void);
+
+} // namespace gpsr
+} // namespace ns3
+
+#endif /* GPSR_LOG_H */
@@ -1,7 +1,10 @@
 
 #include "gpsr-ltable.h"
+#include "gpsr-log.h"
 #include "ns3/log.h"
 
+NS_LOG_COMPONENT_DEFINE ("GpsrLocationTable");
+
 namespace ns3{
 
 	Time LocationTable::GetEntryUpdateTime(Ipv4Address id){
@@ -24,33 +27,20 @@ namespace ns3{
 			return invVec;
 		}
 
-//		Ipv4Address ip = i->first;
-		Vector position = i->second.GetPosition();
-		Time time = i->second.GetTime();
-		int speed = i->second.GetSpeed();
-//		bool flag = i->second.GetResearchFlag();
-//		uint8_t seq = i->second.GetSeqNumber();
+		return i->second.GetPosition();
+	}
 
-		//Isto é o Predict!
-		if(Simulator::Now().GetSeconds() > time.GetSeconds())
+	bool LocationTable::GetState(Ipv4Address id, KinematicState &state){
+		std::map<Ipv4Address, MapEntry >::iterator i = m_table.find(id);
+		if(i == m_table.end ())
 		{
-			int time2 = (Simulator::Now().GetSeconds() - time.GetSeconds());
-			int speed2 = (time2 * speed);
-
-			NS_LOG_UNCOND("Time2 " << time2);
-			NS_LOG_UNCOND("Speed2 " << speed2);
-
-			//Tenho de pensar neste valor, pode ser algo adaptativo
-			int compensation = 200;
-
-			Vector3D position2 = Vector3D(position.x+speed2+compensation, position.y+speed2+compensation, position.z);
-
-			NS_LOG_UNCOND("Position2 " << position2);
-
-			return position2;
+			return false;
 		}
-
-		return position;
+		state.position = i->second.GetPosition();
+		state.velocity = i->second.GetVelocity();
+		state.acceleration = i->second.GetAcceleration();
+		state.time = i->second.GetTime();
+		return true;
 	}
 
 	void LocationTable::SetTime(Ipv4Address id,Time time){
@@ -123,51 +113,55 @@ namespace ns3{
 
 	void LocationTable::AddEntry(Ipv4Address id, Vector position, int speed, bool flag, uint8_t seq){
 		std::map<Ipv4Address, MapEntry >::iterator i = m_table.find(id);
-		if(i != m_table.end () || id.IsEqual(i->first))
+		MapEntry entry (position, Simulator::Now(), speed, flag, seq);
+		// without a previous position, assume the vehicle heads along x
+		Vector heading (1, 0, 0);
+		if(i != m_table.end ())
 		{
 			//FIXME [AC] Nao pode ser por speed - Isto existe para ele nao inserir depois de ja ter speed fixe
-			if(speed != 0)
+			if(speed == 0)
 			{
-				m_table.erase(id);
-				m_table.insert(std::make_pair(id, MapEntry(position, Simulator::Now(),speed, flag, seq)));
+				return;
 			}
-			else
+			Vector old = i->second.GetPosition();
+			Vector oldVelocity = i->second.GetVelocity();
+			double distance = CalculateDistance(old, position);
+			double dt = (Simulator::Now() - i->second.GetTime()).GetSeconds();
+			double oldSpeed = CalculateDistance(oldVelocity, Vector());
+			// searched entries hold an invalid position
+			if(distance > 0 && dt > 0 && !i->second.GetResearchFlag())
 			{
-				m_table.insert(std::make_pair(id, MapEntry(position, Simulator::Now(),speed, flag, seq)));
+				heading = Vector((position.x - old.x) / distance, (position.y - old.y) / distance, (position.z - old.z) / distance);
 			}
-
-			//PrintTable();
+			else if(oldSpeed > 0)
+			{
+				heading = Vector(oldVelocity.x / oldSpeed, oldVelocity.y / oldSpeed, oldVelocity.z / oldSpeed);
+			}
+			Vector velocity (heading.x * speed, heading.y * speed, heading.z * speed);
+			if(dt > 0 && oldSpeed > 0)
+			{
+				entry.SetAcceleration(Vector((velocity.x - oldVelocity.x) / dt, (velocity.y - oldVelocity.y) / dt,
+						(velocity.z - oldVelocity.z) / dt));
+			}
+			entry.SetVelocity(velocity);
+			m_table.erase(i);
+			m_table.insert(std::make_pair(id, entry));
 			return;
 		}
 
-		NS_LOG_UNCOND("AddEntry_table new: " << id << " " << position << " flag " << flag);
-		m_table.insert(std::make_pair(id, MapEntry(position, Simulator::Now(), speed, flag, seq)));
-		//PrintTable();
+		GPSR_LOG_DEBUG ("AddEntry_table new: " << id << " " << position << " flag " << flag);
+		entry.SetVelocity(Vector(heading.x * speed, heading.y * speed, heading.z * speed));
+		m_table.insert(std::make_pair(id, entry));
 	}
 
-	void LocationTable::Refresh()
-	{
-		for(std::map<Ipv4Address, MapEntry>::iterator i=m_table.begin();i!=m_table.end(); ++i)
-		{
-			Ipv4Address ip = (*i).first;
-			Vector position = (*i).second.GetPosition();
-			Time time = (*i).second.GetTime();
-			int speed = (*i).second.GetSpeed();
-			bool flag = (*i).second.GetResearchFlag();
-			uint8_t seq = (*i).second.GetSeqNumber();
-
-			int time2 = (Simulator::Now().GetSeconds() - time.GetSeconds());
-			int speed2 = (time2 * speed);
-
-			//DeleteEntry(ip);
-			AddEntry(ip, position, speed2, flag, seq);
-		}
-	}
-
-
 	void LocationTable::PrintTable(Ipv4Address id)
 	{
-		NS_LOG_UNCOND("== LOCATION_TABLE " << id << " ====================================================");
+		// Walking the table is wasted work unless the dump is visible
+		if (!g_log.IsEnabled (LOG_DEBUG))
+			{
+				return;
+			}
+		GPSR_LOG_DEBUG ("== LOCATION_TABLE " << id << " ====================================================");
 		
 		//[AC] Iterate map to print all entries in the table
 		for(std::map<Ipv4Address, MapEntry>::iterator i=m_table.begin();i!=m_table.end(); ++i)
@@ -175,20 +169,19 @@ namespace ns3{
 
 			//int time = (Simulator::Now().GetSeconds() - (*i).second.GetTime().GetSeconds());
 
-			int speed = (*i).second.GetSpeed();
 			//int speed = (time * (*i).second.GetSpeed());
 
-			NS_LOG_UNCOND(" Nó " << (*i).first << " Position " << (*i).second.GetPosition()
-					<< " Time " << (*i).second.GetTime() << " Speed " << speed << " ResearchFlag "<< (*i).second.GetResearchFlag() << " SeqNumber " <<
+			GPSR_LOG_DEBUG (" Nó " << (*i).first << " Position " << (*i).second.GetPosition()
+					<< " Time " << (*i).second.GetTime() << " Speed " << (*i).second.GetSpeed() << " ResearchFlag "<< (*i).second.GetResearchFlag() << " SeqNumber " <<
 					(*i).second.GetSeqNumber());
 		}
 
-		NS_LOG_UNCOND("======================================================================");
+		GPSR_LOG_DEBUG ("======================================================================");
 	}
 
 	void LocationTable::DeleteEntry(Ipv4Address id){
 		m_table.erase(id);
-		NS_LOG_UNCOND("Deleted entry " << id << " in m_table");
+		GPSR_LOG_DEBUG ("Deleted entry " << id << " in m_table");
 	}
 
 	void LocationTable::Purge(){
@@ -196,19 +189,18 @@ namespace ns3{
 //			NS_LOG_UNCOND("Purge da LTABLE");//apparently not being called
 //			return;
 //		}
-		NS_LOG_UNCOND("Purge na location table");
+		GPSR_LOG_DEBUG ("Purge na location table");
 		std::map<Ipv4Address, MapEntry >::iterator i;
-		for(i = m_table.begin(); !(i == m_table.end()); i++)
+		for(i = m_table.begin(); !(i == m_table.end());)
 		{
 			if(m_entryLifeTime + GetEntryUpdateTime(i->first) <= Simulator::Now())
 			{
-				m_table.erase(i->first); //FIXME cannot erase on list being iterated
-			}	
-		}
-		/* last element is not used in for cicle*/
-		if(m_entryLifeTime + GetEntryUpdateTime(i->first) <= Simulator::Now())
-		{
-			m_table.erase(i->first);
+				m_table.erase(i++);
+			}
+			else
+			{
+				i++;
+			}
 		}
 	}
 
@@ -4,6 +4,7 @@
 #include "ns3/timer.h"
 #include "ns3/vector.h"
 #include "ns3/ipv4.h"
+#include "ns3/position-predictor.h"
 #include <map>
 
 namespace ns3{
@@ -25,6 +26,10 @@ public:
 	bool GetResearchFlag() { return m_researchFlag; }
 	int GetSeqNumber(){ return m_seqNumber;}
 	int GetSpeed(){return m_speed;}
+	void SetVelocity(Vector velocity){m_velocity = velocity;}
+	void SetAcceleration(Vector acceleration){m_acceleration = acceleration;}
+	Vector GetVelocity(){return m_velocity;}
+	Vector GetAcceleration(){return m_acceleration;}
 
 
 private:
@@ -32,6 +37,8 @@ private:
 	Vector m_position;
 	Time m_time;
 	int m_speed;
+	Vector m_velocity; // speed along the heading derived from the successive positions
+	Vector m_acceleration;
 	bool m_researchFlag;//When m_researchFlag true this is the time when the research starts
 	uint8_t m_seqNumber;
 
@@ -55,7 +62,12 @@ public:
 	void SetSpeed(Ipv4Address id, int speed);
 
 
+	/* Posicao reportada, sem extrapolacao: ver GetState */
 	Vector GetPosition(Ipv4Address id, Vector invVec);
+	/* Last report of id, for the PositionPredictor. The heading is the
+	 * direction between the two last positions, and the acceleration the
+	 * change of velocity between them. Returns false if id is unknown. */
+	bool GetState(Ipv4Address id, KinematicState &state);
 	void SetPosition(Ipv4Address id, Vector position);
 
 	void SetTime(Ipv4Address id,Time time);
@@ -75,7 +87,6 @@ public:
 	void AddEntry(Ipv4Address id, Vector position, int speed, bool flag = false, uint8_t seq = 0);
 	void DeleteEntry(Ipv4Address id);
 
-	void Refresh();
 	void Purge();
 	void Clear();
 
@@ -4,16 +4,118 @@
 #include "ns3/address-utils.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("GpsrPacket");
 
 namespace ns3 {
 namespace gpsr {
 
+static GlobalValue g_wireFormat = GlobalValue ("GpsrWireFormat",
+                                               "The encoding of the GPSR and SLS headers that are sent",
+                                               EnumValue (WIRE_LEGACY),
+                                               MakeEnumChecker (WIRE_LEGACY, "Legacy",
+                                                                WIRE_COMPACT, "Compact"));
+static GlobalValue g_referencePoint = GlobalValue ("GpsrReferencePoint",
+                                                   "The origin of the coordinates of the compact GPSR encoding",
+                                                   VectorValue (Vector (0, 0, 0)),
+                                                   MakeVectorChecker ());
+static GlobalValue g_positionResolution = GlobalValue ("GpsrPositionResolution",
+                                                       "The step of the coordinates of the compact GPSR encoding (m)",
+                                                       DoubleValue (1.0),
+                                                       MakeDoubleChecker<double> (0.001));
+
+WireFormat
+GetWireFormat (void)
+{
+  EnumValue value;
+  g_wireFormat.GetValue (value);
+  return (WireFormat) value.Get ();
+}
+
+namespace {
+
+/// Coordinates of the compact encoding, read once per header
+class CoordinateCodec
+{
+public:
+  CoordinateCodec ()
+  {
+    VectorValue reference;
+    g_referencePoint.GetValue (reference);
+    m_reference = reference.Get ();
+    DoubleValue resolution;
+    g_positionResolution.GetValue (resolution);
+    m_resolution = resolution.Get ();
+  }
+  void WriteX (Buffer::Iterator &i, uint64_t x) const
+  {
+    Write (i, x, m_reference.x);
+  }
+  void WriteY (Buffer::Iterator &i, uint64_t y) const
+  {
+    Write (i, y, m_reference.y);
+  }
+  uint64_t ReadX (Buffer::Iterator &i) const
+  {
+    return Read (i, m_reference.x);
+  }
+  uint64_t ReadY (Buffer::Iterator &i) const
+  {
+    return Read (i, m_reference.y);
+  }
+
+private:
+  // the uint64_t fields hold the signed integer coordinates
+  void Write (Buffer::Iterator &i, uint64_t value, double reference) const
+  {
+    double q = std::floor (((int64_t) value - reference) / m_resolution + 0.5);
+    q = std::max (-32768.0, std::min (32767.0, q));
+    i.WriteHtonU16 ((uint16_t) (int16_t) q);
+  }
+  uint64_t Read (Buffer::Iterator &i, double reference) const
+  {
+    int16_t q = (int16_t) i.ReadNtohU16 ();
+    return (uint64_t) (int64_t) std::floor (reference + q * m_resolution + 0.5);
+  }
+
+  Vector m_reference;
+  double m_resolution;
+};
+
+/// Low 16 bits of a timestamp in seconds
+void
+WriteTimestamp (Buffer::Iterator &i, uint32_t seconds)
+{
+  i.WriteHtonU16 ((uint16_t) seconds);
+}
+
+/// Timestamp within 2^15 s of the current time whose low 16 bits were sent
+uint32_t
+ReadTimestamp (Buffer::Iterator &i)
+{
+  uint32_t now = (uint32_t) Simulator::Now ().GetSeconds ();
+  int16_t delta = (int16_t) (i.ReadNtohU16 () - (uint16_t) now);
+  return now + delta;
+}
+
+void
+WriteSpeed (Buffer::Iterator &i, uint32_t speed)
+{
+  i.WriteU8 ((uint8_t) std::min<uint32_t> (speed, 255));
+}
+
+} // anonymous namespace
+
 NS_OBJECT_ENSURE_REGISTERED (TypeHeader);
 
 TypeHeader::TypeHeader (MessageType t = GPSRTYPE_HELLO)
   : m_type (t),
+    m_version (GetWireFormat ()),
     m_valid (true)
 {
 }
@@ -43,7 +145,7 @@ TypeHeader::GetSerializedSize () const
 void
 TypeHeader::Serialize (Buffer::Iterator i) const
 {
-  i.WriteU8 ((uint8_t) m_type);
+  i.WriteU8 ((uint8_t) ((m_version << 4) | m_type));
 }
 
 uint32_t
@@ -51,8 +153,11 @@ TypeHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
   uint8_t type = i.ReadU8 ();
+  uint8_t version = type >> 4;
+  type &= 0x0f;
 
-  m_valid = true;
+  m_valid = version <= WIRE_COMPACT;
+  m_version = (WireFormat) version;
   switch (type)
   {
   case GPSRTYPE_HELLO:
@@ -118,7 +223,7 @@ TypeHeader::Print (std::ostream &os) const
 bool
 TypeHeader::operator== (TypeHeader const & o) const
 {
-  return (m_type == o.m_type && m_valid == o.m_valid);
+  return (m_type == o.m_type && m_version == o.m_version && m_valid == o.m_valid);
 }
 
 std::ostream &
@@ -132,7 +237,8 @@ operator<< (std::ostream & os, TypeHeader const & h)
 // HELLO
 //-----------------------------------------------------------------------------
 HelloHeader::HelloHeader (uint64_t originPosx, uint64_t originPosy)
-  : m_originPosx (originPosx),
+  : m_version (GetWireFormat ()),
+    m_originPosx (originPosx),
     m_originPosy (originPosy)
 {
 }
@@ -158,7 +264,7 @@ HelloHeader::GetInstanceTypeId () const
 uint32_t
 HelloHeader::GetSerializedSize () const
 {
-  return 16;
+  return m_version == WIRE_COMPACT ? 4 : 16;
 }
 
 void
@@ -166,6 +272,13 @@ HelloHeader::Serialize (Buffer::Iterator i) const
 {
   //NS_LOG_UNCOND ("Serialize X " << m_originPosx << " Y " << m_originPosy);
 
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      codec.WriteX (i, m_originPosx);
+      codec.WriteY (i, m_originPosy);
+      return;
+    }
   i.WriteHtonU64 (m_originPosx);
   i.WriteHtonU64 (m_originPosy);
 
@@ -177,8 +290,17 @@ HelloHeader::Deserialize (Buffer::Iterator start)
   Buffer::Iterator i = start;
 
   //NS_LOG_UNCOND("Origin1 " << i.ReadNtohU64 ());
-  m_originPosx = i.ReadNtohU64 ();
-  m_originPosy = i.ReadNtohU64 ();
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      m_originPosx = codec.ReadX (i);
+      m_originPosy = codec.ReadY (i);
+    }
+  else
+    {
+      m_originPosx = i.ReadNtohU64 ();
+      m_originPosy = i.ReadNtohU64 ();
+    }
 
   uint32_t dist = i.GetDistanceFrom (start);
 
@@ -205,14 +327,15 @@ operator<< (std::ostream & os, HelloHeader const & h)
 bool
 HelloHeader::operator== (HelloHeader const & o) const
 {
-  return (m_originPosx == o.m_originPosx && m_originPosy == m_originPosy);
+  return (m_originPosx == o.m_originPosx && m_originPosy == o.m_originPosy);
 }
 
 //-----------------------------------------------------------------------------
 // Position
 //-----------------------------------------------------------------------------
 PositionHeader::PositionHeader (uint64_t dstPosx, uint64_t dstPosy, uint32_t updated, uint64_t recPosx, uint64_t recPosy, uint8_t inRec, uint64_t lastPosx, uint64_t lastPosy)
-  : m_dstPosx (dstPosx),
+  : m_version (GetWireFormat ()),
+    m_dstPosx (dstPosx),
     m_dstPosy (dstPosy),
     m_updated (updated),
     m_recPosx (recPosx),
@@ -244,12 +367,25 @@ PositionHeader::GetInstanceTypeId () const
 uint32_t
 PositionHeader::GetSerializedSize () const
 {
-  return 53;
+  return m_version == WIRE_COMPACT ? 15 : 53;
 }
 
 void
 PositionHeader::Serialize (Buffer::Iterator i) const
 {
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      codec.WriteX (i, m_dstPosx);
+      codec.WriteY (i, m_dstPosy);
+      WriteTimestamp (i, m_updated);
+      codec.WriteX (i, m_recPosx);
+      codec.WriteY (i, m_recPosy);
+      i.WriteU8 (m_inRec);
+      codec.WriteX (i, m_lastPosx);
+      codec.WriteY (i, m_lastPosy);
+      return;
+    }
 
   i.WriteU64 (m_dstPosx);
   i.WriteU64 (m_dstPosy);
@@ -266,14 +402,29 @@ PositionHeader::Deserialize (Buffer::Iterator start)
 {
 
   Buffer::Iterator i = start;
-  m_dstPosx = i.ReadU64 ();
-  m_dstPosy = i.ReadU64 ();
-  m_updated = i.ReadU32 ();
-  m_recPosx = i.ReadU64 ();
-  m_recPosy = i.ReadU64 ();
-  m_inRec = i.ReadU8 ();
-  m_lastPosx = i.ReadU64 ();
-  m_lastPosy = i.ReadU64 ();
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      m_dstPosx = codec.ReadX (i);
+      m_dstPosy = codec.ReadY (i);
+      m_updated = ReadTimestamp (i);
+      m_recPosx = codec.ReadX (i);
+      m_recPosy = codec.ReadY (i);
+      m_inRec = i.ReadU8 ();
+      m_lastPosx = codec.ReadX (i);
+      m_lastPosy = codec.ReadY (i);
+    }
+  else
+    {
+      m_dstPosx = i.ReadU64 ();
+      m_dstPosy = i.ReadU64 ();
+      m_updated = i.ReadU32 ();
+      m_recPosx = i.ReadU64 ();
+      m_recPosy = i.ReadU64 ();
+      m_inRec = i.ReadU8 ();
+      m_lastPosx = i.ReadU64 ();
+      m_lastPosy = i.ReadU64 ();
+    }
 
   uint32_t dist = i.GetDistanceFrom (start);
   NS_ASSERT (dist == GetSerializedSize ());
@@ -305,15 +456,100 @@ operator<< (std::ostream & os, PositionHeader const & h)
 bool
 PositionHeader::operator== (PositionHeader const & o) const
 {
-  return (m_dstPosx == o.m_dstPosx && m_dstPosy == m_dstPosy && m_updated == o.m_updated && m_recPosx == o.m_recPosx && m_recPosy == o.m_recPosy && m_inRec == o.m_inRec && m_lastPosx == o.m_lastPosx && m_lastPosy == o.m_lastPosy);
+  return (m_dstPosx == o.m_dstPosx && m_dstPosy == o.m_dstPosy && m_updated == o.m_updated && m_recPosx == o.m_recPosx && m_recPosy == o.m_recPosy && m_inRec == o.m_inRec && m_lastPosx == o.m_lastPosx && m_lastPosy == o.m_lastPosy);
+}
+
+
+//-----------------------------------------------------------------------------
+// DATA
+//-----------------------------------------------------------------------------
+DataHeader::DataHeader ()
+  : m_type (GPSRTYPE_POS)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (DataHeader);
+
+TypeId
+DataHeader::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::gpsr::DataHeader")
+    .SetParent<Header> ()
+    .AddConstructor<DataHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+DataHeader::GetInstanceTypeId () const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+DataHeader::GetSerializedSize () const
+{
+  uint32_t size = m_type.GetSerializedSize ();
+  if (m_type.IsValid () && m_type.Get () == GPSRTYPE_POS)
+    {
+      size += m_position.GetSerializedSize ();
+    }
+  return size;
+}
+
+void
+DataHeader::Serialize (Buffer::Iterator i) const
+{
+  m_type.Serialize (i);
+  i.Next (m_type.GetSerializedSize ());
+  if (m_type.IsValid () && m_type.Get () == GPSRTYPE_POS)
+    {
+      m_position.Serialize (i);
+    }
+}
+
+uint32_t
+DataHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  i.Next (m_type.Deserialize (i));
+  if (m_type.IsValid () && m_type.Get () == GPSRTYPE_POS)
+    {
+      m_position.SetVersion (m_type.GetVersion ());
+      i.Next (m_position.Deserialize (i));
+    }
+  return i.GetDistanceFrom (start);
 }
 
+void
+DataHeader::Print (std::ostream &os) const
+{
+  m_type.Print (os);
+  if (m_type.IsValid () && m_type.Get () == GPSRTYPE_POS)
+    {
+      m_position.Print (os);
+    }
+}
+
+void
+DataHeader::Replace (Ptr<Packet> p) const
+{
+  NS_ASSERT (m_type.IsValid () && m_type.Get () == GPSRTYPE_POS);
+  TypeHeader type (GPSRTYPE_POS);
+  PositionHeader position;
+  position.SetVersion (m_type.GetVersion ());
+  p->RemoveHeader (type);
+  p->RemoveHeader (position);
+  p->AddHeader (m_position);
+  p->AddHeader (m_type);
+}
 
 //-----------------------------------------------------------------------------
 // LOCATION Hello
 //-----------------------------------------------------------------------------
 
 LocHelloHeader::LocHelloHeader(Ipv4Address nodeid, uint64_t nodePosx, uint64_t nodePosy):
+	m_version (GetWireFormat ()),
 	m_nodeid (nodeid),
 	m_nodePosx(nodePosx),
 	m_nodePosy(nodePosy)
@@ -340,13 +576,20 @@ LocHelloHeader::GetInstanceTypeId () const
 uint32_t
 LocHelloHeader::GetSerializedSize () const
 {
-  return 20;
+  return m_version == WIRE_COMPACT ? 8 : 20;
 }
 
 void
 LocHelloHeader::Serialize (Buffer::Iterator i) const
 {
   WriteTo(i, m_nodeid);
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      codec.WriteX (i, m_nodePosx);
+      codec.WriteY (i, m_nodePosy);
+      return;
+    }
   i.WriteHtonU64(m_nodePosx);
   i.WriteHtonU64(m_nodePosy);
 }
@@ -356,8 +599,17 @@ LocHelloHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
   ReadFrom(i, m_nodeid);
-  m_nodePosx = i.ReadNtohU64();
-  m_nodePosy = i.ReadNtohU64();
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      m_nodePosx = codec.ReadX (i);
+      m_nodePosy = codec.ReadY (i);
+    }
+  else
+    {
+      m_nodePosx = i.ReadNtohU64();
+      m_nodePosy = i.ReadNtohU64();
+    }
 
   uint32_t dist = i.GetDistanceFrom (start);
 
@@ -387,11 +639,23 @@ operator<< (std::ostream & os, LocHelloHeader const & h)
 //-----------------------------------------------------------------------------
 // LOCATION Update
 //-----------------------------------------------------------------------------
+LocationRecord::LocationRecord (Ipv4Address nodeid, uint64_t posx, uint64_t posy, uint32_t speed)
+  : nodeid (nodeid),
+    posx (posx),
+    posy (posy),
+    speed (speed)
+{
+}
+
+bool
+LocationRecord::operator== (LocationRecord const & o) const
+{
+  return (nodeid == o.nodeid && posx == o.posx && posy == o.posy && speed == o.speed);
+}
+
 LocUpdateHeader::LocUpdateHeader(Ipv4Address nodeid, uint64_t originPosx, uint64_t originPosy, uint32_t speed):
-	m_nodeid (nodeid),
-	m_originPosx (originPosx),
-	m_originPosy (originPosy),
-	m_speed (speed)
+	m_version (GetWireFormat ()),
+	m_records (1, LocationRecord (nodeid, originPosx, originPosy, speed))
 	{}
 
 NS_OBJECT_ENSURE_REGISTERED (LocUpdateHeader);
@@ -415,26 +679,58 @@ LocUpdateHeader::GetInstanceTypeId () const
 uint32_t
 LocUpdateHeader::GetSerializedSize () const
 {
-  return 24;
+  // count, then address, coordinates and speed of each record
+  return m_version == WIRE_COMPACT ? 1 + 9 * m_records.size () : 24;
 }
 
 void
 LocUpdateHeader::Serialize (Buffer::Iterator i) const
 {
-  WriteTo (i, m_nodeid);
-  i.WriteHtonU64((uint64_t) m_originPosx);
-  i.WriteHtonU64((uint64_t) m_originPosy);
-  i.WriteHtonU32 (m_speed);
+  if (m_version == WIRE_COMPACT)
+    {
+      NS_ASSERT (m_records.size () <= MAX_RECORDS);
+      CoordinateCodec codec;
+      i.WriteU8 (m_records.size ());
+      for (std::vector<LocationRecord>::const_iterator r = m_records.begin (); r != m_records.end (); ++r)
+        {
+          WriteTo (i, r->nodeid);
+          codec.WriteX (i, r->posx);
+          codec.WriteY (i, r->posy);
+          WriteSpeed (i, r->speed);
+        }
+      return;
+    }
+  NS_ASSERT_MSG (m_records.size () == 1, "The legacy encoding carries a single location record");
+  WriteTo (i, m_records[0].nodeid);
+  i.WriteHtonU64((uint64_t) m_records[0].posx);
+  i.WriteHtonU64((uint64_t) m_records[0].posy);
+  i.WriteHtonU32 (m_records[0].speed);
 }
 
 uint32_t
 LocUpdateHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  ReadFrom(i, m_nodeid);
-  m_originPosx = i.ReadNtohU64();
-  m_originPosy = i.ReadNtohU64();
-  m_speed = i.ReadNtohU32();
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      m_records.resize (i.ReadU8 ());
+      for (std::vector<LocationRecord>::iterator r = m_records.begin (); r != m_records.end (); ++r)
+        {
+          ReadFrom (i, r->nodeid);
+          r->posx = codec.ReadX (i);
+          r->posy = codec.ReadY (i);
+          r->speed = i.ReadU8 ();
+        }
+    }
+  else
+    {
+      m_records.resize (1);
+      ReadFrom(i, m_records[0].nodeid);
+      m_records[0].posx = i.ReadNtohU64();
+      m_records[0].posy = i.ReadNtohU64();
+      m_records[0].speed = i.ReadNtohU32();
+    }
 
   uint32_t dist = i.GetDistanceFrom (start);
   NS_ASSERT (dist == GetSerializedSize ());
@@ -444,15 +740,17 @@ LocUpdateHeader::Deserialize (Buffer::Iterator start)
 void
 LocUpdateHeader::Print (std::ostream &os) const
 {
-  os << " Nodeid " << m_nodeid << " PositionX " << m_originPosx << " PositionY " << m_originPosy << " speed "
-		  << m_speed;
+  for (std::vector<LocationRecord>::const_iterator r = m_records.begin (); r != m_records.end (); ++r)
+    {
+      os << " Nodeid " << r->nodeid << " PositionX " << r->posx << " PositionY " << r->posy << " speed "
+         << r->speed;
+    }
 }
 
 bool
 LocUpdateHeader::operator== (LocUpdateHeader const & o) const
 {
-  return (m_nodeid == o.m_nodeid && m_originPosx == o.m_originPosx && m_originPosy == o.m_originPosy &&
-          m_speed == o.m_speed);
+  return (m_records == o.m_records);
 }
 
 std::ostream &
@@ -478,7 +776,7 @@ LocQueryHeader::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::gpsr::LocQueryHeader")
       .SetParent<Header> ()
-      .AddConstructor<LocUpdateHeader> ()
+      .AddConstructor<LocQueryHeader> ()
       ;
   return tid;
 }
@@ -539,6 +837,7 @@ operator<< (std::ostream & os, LocQueryHeader const & h)
 // LOCATION Reply
 //-----------------------------------------------------------------------------
 LocReplyHeader::LocReplyHeader(Ipv4Address nodeid, Ipv4Address destid, uint64_t posx, uint64_t posy):
+	m_version (GetWireFormat ()),
 	m_nodeid (nodeid),
 	m_destid(destid),
 	m_posx(posx),
@@ -552,7 +851,7 @@ LocReplyHeader::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::gpsr::LocReplyHeader")
       .SetParent<Header> ()
-      .AddConstructor<LocUpdateHeader> ()
+      .AddConstructor<LocReplyHeader> ()
       ;
   return tid;
 }
@@ -566,7 +865,7 @@ LocReplyHeader::GetInstanceTypeId () const
 uint32_t
 LocReplyHeader::GetSerializedSize () const
 {
-  return 24;
+  return m_version == WIRE_COMPACT ? 12 : 24;
 }
 
 void
@@ -574,6 +873,13 @@ LocReplyHeader::Serialize (Buffer::Iterator i) const
 {
   WriteTo (i, m_nodeid);
   WriteTo (i, m_destid);
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      codec.WriteX (i, m_posx);
+      codec.WriteY (i, m_posy);
+      return;
+    }
   i.WriteHtonU64((uint64_t) m_posx);
   i.WriteHtonU64((uint64_t) m_posy);
 
@@ -585,8 +891,17 @@ LocReplyHeader::Deserialize (Buffer::Iterator start)
   Buffer::Iterator i = start;
   ReadFrom(i, m_nodeid);
   ReadFrom(i, m_destid);
-  m_posx = i.ReadNtohU64();
-  m_posy = i.ReadNtohU64();
+  if (m_version == WIRE_COMPACT)
+    {
+      CoordinateCodec codec;
+      m_posx = codec.ReadX (i);
+      m_posy = codec.ReadY (i);
+    }
+  else
+    {
+      m_posx = i.ReadNtohU64();
+      m_posy = i.ReadNtohU64();
+    }
 
   uint32_t dist = i.GetDistanceFrom (start);
   NS_ASSERT (dist == GetSerializedSize ());
@@ -612,6 +927,89 @@ operator<< (std::ostream & os, LocReplyHeader const & h)
   return os;
 }
 
+//-----------------------------------------------------------------------------
+// SLS batch
+//-----------------------------------------------------------------------------
+void
+SlsBatch::AddUpdate (const LocationRecord &record)
+{
+  for (std::vector<LocationRecord>::iterator i = m_updates.begin (); i != m_updates.end (); ++i)
+    {
+      if (i->nodeid == record.nodeid)
+        {
+          *i = record;
+          return;
+        }
+    }
+  m_updates.push_back (record);
+}
+
+void
+SlsBatch::AddQuery (const LocQueryHeader &query)
+{
+  m_queries.push_back (query);
+}
+
+void
+SlsBatch::AddReply (const LocReplyHeader &reply)
+{
+  m_replies.push_back (reply);
+}
+
+bool
+SlsBatch::IsEmpty () const
+{
+  return m_updates.empty () && m_queries.empty () && m_replies.empty ();
+}
+
+void
+SlsBatch::AddUpdates (Ptr<Packet> p) const
+{
+  TypeHeader type (SLS_LOCATION_UPDATE);
+  // headers are added in front, walk the records backwards
+  uint32_t perHeader = type.GetVersion () == WIRE_COMPACT ? LocUpdateHeader::MAX_RECORDS : 1;
+  uint32_t end = m_updates.size ();
+  while (end > 0)
+    {
+      uint32_t begin = end > perHeader ? end - perHeader : 0;
+      LocUpdateHeader update (m_updates[begin].nodeid, m_updates[begin].posx, m_updates[begin].posy,
+                              m_updates[begin].speed);
+      for (uint32_t i = begin + 1; i < end; i++)
+        {
+          update.AddRecord (m_updates[i]);
+        }
+      p->AddHeader (update);
+      p->AddHeader (type);
+      end = begin;
+    }
+}
+
+Ptr<Packet>
+SlsBatch::ToPacket () const
+{
+  Ptr<Packet> p = Create<Packet> ();
+  for (std::vector<LocReplyHeader>::const_reverse_iterator i = m_replies.rbegin (); i != m_replies.rend (); ++i)
+    {
+      p->AddHeader (*i);
+      p->AddHeader (TypeHeader (SLS_LOCATION_REPLY));
+    }
+  for (std::vector<LocQueryHeader>::const_reverse_iterator i = m_queries.rbegin (); i != m_queries.rend (); ++i)
+    {
+      p->AddHeader (*i);
+      p->AddHeader (TypeHeader (SLS_LOCATION_QUERY));
+    }
+  AddUpdates (p);
+  return p;
+}
+
+uint32_t
+SlsBatch::GetUpdateSize () const
+{
+  Ptr<Packet> p = Create<Packet> ();
+  AddUpdates (p);
+  return p->GetSize ();
+}
+
 
 }
 }
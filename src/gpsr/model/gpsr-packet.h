@@ -5,9 +5,11 @@
 
 #include <iostream>
 #include "ns3/header.h"
+#include "ns3/packet.h"
 #include "ns3/enum.h"
 #include "ns3/ipv4-address.h"
 #include <map>
+#include <vector>
 #include "ns3/nstime.h"
 #include "ns3/vector.h"
 
@@ -25,6 +27,32 @@ enum MessageType
   SLS_LOCATION_REPLY = 6,
 };
 
+/**
+ * \ingroup gpsr
+ * \brief Encodings of the GPSR and SLS headers
+ *
+ * The version is carried in the high nibble of the TypeHeader, which
+ * keeps the legacy packets byte for byte identical. In the compact
+ * encoding the coordinates are 16 bit signed offsets from the
+ * "GpsrReferencePoint", in steps of "GpsrPositionResolution" meters,
+ * saturated at the edges of the range; the timestamps are sent modulo
+ * 2^16 s and recovered against the clock of the receiver, which is
+ * exact within 9 hours; speeds saturate at 255 m/s; and a LocUpdateHeader
+ * may carry several location records.
+ *
+ * The headers are built with the encoding selected by the
+ * "GpsrWireFormat" global value. A receiver sets the version of the body
+ * header from the TypeHeader before removing it.
+ */
+enum WireFormat
+{
+  WIRE_LEGACY = 0,   //!< fixed size 64 bit fields
+  WIRE_COMPACT = 1,  //!< quantised relative coordinates
+};
+
+/// \returns the encoding selected by the "GpsrWireFormat" global value
+WireFormat GetWireFormat (void);
+
 /**
  * \ingroup gpsr
  * \brief GPSR types
@@ -60,9 +88,19 @@ public:
   {
     return m_valid; //FIXME that way it wont work
   }
+  /// Encoding of the headers that follow
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
   bool operator== (TypeHeader const & o) const;
 private:
   MessageType m_type;
+  WireFormat m_version;
   bool m_valid;
 };
 
@@ -103,10 +141,19 @@ public:
     return m_originPosy;
   }
   //\}
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
 
 
   bool operator== (HelloHeader const & o) const;
 private:
+  WireFormat       m_version;
   uint64_t         m_originPosx;          ///< Originator Position x
   uint64_t         m_originPosy;          ///< Originator Position x
 };
@@ -199,11 +246,21 @@ public:
   {
     return m_lastPosy;
   }
+  //\}
+  WireFormat GetVersion () const
+  {
+    return m_version;
+  }
+  void SetVersion (WireFormat version)
+  {
+    m_version = version;
+  }
 
 
   bool operator== (PositionHeader const & o) const;
 
 private:
+  WireFormat       m_version;
   uint64_t         m_dstPosx;          ///< Destination Position x
   uint64_t         m_dstPosy;          ///< Destination Position x
   uint32_t         m_updated;          ///< Time of last update
@@ -217,6 +274,53 @@ private:
 
 std::ostream & operator<< (std::ostream & os, PositionHeader const &);
 
+/**
+ * \ingroup gpsr
+ * \brief TypeHeader and PositionHeader at the start of a GPSR data packet
+ *
+ * Packet::PeekHeader on a DataHeader reads both headers in one pass of a
+ * Buffer::Iterator, without removing them. Replace puts the modified
+ * headers back. The packet keeps the two headers in its metadata, so a
+ * DataHeader is never added nor removed as such.
+ */
+class DataHeader : public Header
+{
+public:
+  DataHeader ();
+
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  /// The PositionHeader is only read after a GPSRTYPE_POS type
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+
+  const TypeHeader & GetType () const
+  {
+    return m_type;
+  }
+  PositionHeader & GetPosition ()
+  {
+    return m_position;
+  }
+  /// The position is written with the encoding of the type header
+  void SetPosition (const PositionHeader &position)
+  {
+    m_position = position;
+    m_position.SetVersion (m_type.GetVersion ());
+  }
+  /**
+   * Replace the headers at the start of p by the ones held here: they are
+   * removed and added again, so p must not be shared with its sender.
+   */
+  void Replace (Ptr<Packet> p) const;
+
+private:
+  TypeHeader m_type;
+  PositionHeader m_position;
+};
+
 /**************************************************************************************
  * LocHelloHeader
  **************************************************************************************/
@@ -258,9 +362,18 @@ public:
 	{
 		return m_nodePosy;
 	}
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
 	bool operator== (LocHelloHeader const & o) const;
 
 private:
+	 WireFormat m_version;
 	 Ipv4Address m_nodeid;
 	 uint64_t         m_nodePosx;
 	 uint64_t         m_nodePosy;
@@ -272,6 +385,24 @@ std::ostream & operator<< (std::ostream & os, LocHelloHeader const &);
  * LocUpdateHeader
  **************************************************************************************/
 
+/// Position and speed of one node, as carried by a LocUpdateHeader
+struct LocationRecord
+{
+	LocationRecord (Ipv4Address nodeid = Ipv4Address(), uint64_t posx = 0, uint64_t posy = 0, uint32_t speed = 0);
+
+	Ipv4Address nodeid;
+	uint64_t posx;
+	uint64_t posy;
+	uint32_t speed;
+
+	bool operator== (LocationRecord const & o) const;
+};
+
+/**
+ * The header holds one location record, which the node accessors refer
+ * to. In the compact encoding more records can be added and are sent in
+ * the same packet; the legacy encoding carries exactly one.
+ */
 class LocUpdateHeader : public Header
 {
 public:
@@ -287,44 +418,66 @@ public:
 
 	Ipv4Address GetNodeID() const
 	{
-		return m_nodeid;
+		return m_records[0].nodeid;
 	}
 	void SetNodeID(Ipv4Address node)
 	{
-		m_nodeid = node;
+		m_records[0].nodeid = node;
 	}
 	void SetOriginPosx (uint64_t posx)
 	{
-		m_originPosx = posx;
+		m_records[0].posx = posx;
 	}
 	uint64_t GetOriginPosx () const
 	{
-		return m_originPosx;
+		return m_records[0].posx;
 	}
 	void SetOriginPosy (uint64_t posy)
 	{
-		m_originPosy = posy;
+		m_records[0].posy = posy;
 	}
 	uint64_t GetOriginPosy () const
 	{
-		return m_originPosy;
+		return m_records[0].posy;
 	}
 	uint32_t GetSpeed() const
 	{
-		return m_speed;
+		return m_records[0].speed;
 	}
 	void SetSpeed(uint32_t speed)
 	{
-		m_speed = speed;
+		m_records[0].speed = speed;
 	}
 
+	/// Append a record, sent after the ones already held
+	void AddRecord (const LocationRecord &record)
+	{
+		m_records.push_back (record);
+	}
+	uint32_t GetNRecords () const
+	{
+		return m_records.size ();
+	}
+	const LocationRecord & GetRecord (uint32_t i) const
+	{
+		return m_records[i];
+	}
+	/// Maximum number of records of a compact header
+	static const uint32_t MAX_RECORDS = 255;
+
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
 	 bool operator== (LocUpdateHeader const & o) const;
 
 private:
-	  Ipv4Address 		   m_nodeid;
-	  uint64_t         m_originPosx;          ///< Originator Position x
-	  uint64_t         m_originPosy;          ///< Originator Position Y
-	  uint32_t 		   m_speed;
+	  WireFormat m_version;
+	  std::vector<LocationRecord> m_records;
 };
 
 std::ostream & operator<< (std::ostream & os, LocUpdateHeader const &);
@@ -434,11 +587,19 @@ public:
 	{
 		m_posy = posy;
 	}
-
+	WireFormat GetVersion () const
+	{
+		return m_version;
+	}
+	void SetVersion (WireFormat version)
+	{
+		m_version = version;
+	}
 
 	 bool operator== (LocReplyHeader const & o) const;
 
 private:
+	  WireFormat 		   m_version;
 	  Ipv4Address 		   m_nodeid;
 	  Ipv4Address 		   m_destid;
 	  uint64_t    		   m_posx;
@@ -447,6 +608,50 @@ private:
 
 std::ostream & operator<< (std::ostream & os, LocReplyHeader const &);
 
+/**
+ * \ingroup gpsr
+ * \brief SLS messages waiting to be sent to the same node in one packet
+ *
+ * The packet holds the updates, then the queries, then the replies, each
+ * message after its own TypeHeader. In the compact encoding the update
+ * records share LocUpdateHeaders, the legacy one sends a message per
+ * record. A new update of a node replaces the one waiting.
+ */
+class SlsBatch
+{
+public:
+  void AddUpdate (const LocationRecord &record);
+  void AddQuery (const LocQueryHeader &query);
+  void AddReply (const LocReplyHeader &reply);
+
+  const std::vector<LocationRecord> & GetUpdates () const
+  {
+    return m_updates;
+  }
+  const std::vector<LocQueryHeader> & GetQueries () const
+  {
+    return m_queries;
+  }
+  const std::vector<LocReplyHeader> & GetReplies () const
+  {
+    return m_replies;
+  }
+  bool IsEmpty () const;
+
+  /// \returns a packet holding all the messages
+  Ptr<Packet> ToPacket () const;
+  /// \returns the bytes of the update messages in the packet
+  uint32_t GetUpdateSize () const;
+
+private:
+  /// Adds the update messages in front of p
+  void AddUpdates (Ptr<Packet> p) const;
+
+  std::vector<LocationRecord> m_updates;
+  std::vector<LocQueryHeader> m_queries;
+  std::vector<LocReplyHeader> m_replies;
+};
+
 
 }
 }
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "gpsr-position-snapshot.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("GpsrPositionSnapshot");
+
+namespace ns3 {
+namespace gpsr {
+
+#ifdef HAVE_PTHREAD_H
+/// guards the state, used by the nodes run in parallel
+static SystemMutex g_snapshotMutex;
+#endif
+
+PositionSnapshot::State *
+PositionSnapshot::Get (void)
+{
+  return *DoGet ();
+}
+
+PositionSnapshot::State **
+PositionSnapshot::DoGet (void)
+{
+  static State *state = 0;
+  if (state == 0)
+    {
+      state = new State ();
+      state->taken = false;
+      state->nSnapshots = 0;
+      Simulator::ScheduleDestroy (&PositionSnapshot::Delete);
+    }
+  return &state;
+}
+
+void
+PositionSnapshot::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  State **state = DoGet ();
+  delete *state;
+  *state = 0;
+}
+
+void
+PositionSnapshot::Add (Ipv4Address address, Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (address << mobility);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_snapshotMutex);
+#endif
+  State *state = Get ();
+  state->nodes[address] = mobility;
+  state->taken = false;
+}
+
+void
+PositionSnapshot::Remove (Ipv4Address address)
+{
+  NS_LOG_FUNCTION (address);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_snapshotMutex);
+#endif
+  State *state = Get ();
+  if (state->nodes.erase (address))
+    {
+      state->taken = false;
+    }
+}
+
+void
+PositionSnapshot::Take (State *state)
+{
+  state->entries.clear ();
+  state->entries.reserve (state->nodes.size ());
+  for (std::map<Ipv4Address, Ptr<MobilityModel> >::const_iterator i = state->nodes.begin ();
+       i != state->nodes.end (); ++i)
+    {
+      Entry entry;
+      entry.address = i->first;
+      entry.position = i->second->GetPosition ();
+      state->entries.push_back (entry);
+    }
+  std::sort (state->entries.begin (), state->entries.end (), CompareX ());
+  state->time = Simulator::Now ();
+  state->taken = true;
+  state->nSnapshots++;
+  NS_LOG_LOGIC ("Snapshot of " << state->entries.size () << " nodes at " << state->time.GetSeconds ());
+}
+
+Time
+PositionSnapshot::GetNeighbors (Ipv4Address self, Vector position, double range, Time staleness,
+                                std::vector<Entry> &neighbors)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_snapshotMutex);
+#endif
+  State *state = Get ();
+  if (!state->taken || Simulator::Now () - state->time > staleness)
+    {
+      Take (state);
+    }
+  neighbors.clear ();
+  const std::vector<Entry> &entries = state->entries;
+  std::vector<Entry>::const_iterator end = std::upper_bound (entries.begin (), entries.end (),
+                                                             position.x + range, CompareX ());
+  for (std::vector<Entry>::const_iterator i = std::lower_bound (entries.begin (), end, position.x - range, CompareX ());
+       i != end; ++i)
+    {
+      if (i->address != self && CalculateDistance (i->position, position) <= range)
+        {
+          neighbors.push_back (*i);
+        }
+    }
+  return state->time;
+}
+
+uint32_t
+PositionSnapshot::GetNSnapshots (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_snapshotMutex);
+#endif
+  return Get ()->nSnapshots;
+}
+
+}
+}
@@ -1,7 +1,9 @@
 #include "gpsr-ptable.h"
+#include "gpsr-log.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("GpsrTable");
 
@@ -14,12 +16,27 @@ namespace gpsr {
 */
 
 PositionTable::PositionTable ()
+  : m_planarization (PLANARIZATION_NONE),
+    m_angularValid (false),
+    m_bearingsSorted (false)
 {
   m_txErrorCallback = MakeCallback (&PositionTable::ProcessTxError, this);
   m_entryLifeTime = Seconds (2); //FIXME fazer isto parametrizavel de acordo com tempo de hello
 
 }
 
+void
+PositionTable::SetEntryLifeTime (Time lifetime)
+{
+  m_entryLifeTime = lifetime;
+}
+
+Time
+PositionTable::GetEntryLifeTime (void) const
+{
+  return m_entryLifeTime;
+}
+
 Time 
 PositionTable::GetEntryUpdateTime (Ipv4Address id)
 {
@@ -28,6 +45,10 @@ PositionTable::GetEntryUpdateTime (Ipv4Address id)
       return Time (Seconds (0));
     }
   std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
+  if (i == m_table.end ())
+    {
+      return Time (Seconds (0));
+    }
   return i->second.second;
 }
 
@@ -38,15 +59,22 @@ void
 PositionTable::AddEntry (Ipv4Address id, Vector position)
 {
   std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
-  if (i != m_table.end () || id.IsEqual (i->first))
+  if (i != m_table.end ())
+    {
+      RemoveFromIndex (id, i->second.first.x);
+      i->second = std::make_pair (position, Simulator::Now ());
+    }
+  else
     {
-      m_table.erase (id);
       m_table.insert (std::make_pair (id, std::make_pair (position, Simulator::Now ())));
-      return;
     }
-  
 
-  m_table.insert (std::make_pair (id, std::make_pair (position, Simulator::Now ())));
+  Neighbor neighbor;
+  neighbor.id = id;
+  neighbor.position = position;
+  m_spatial.insert (std::upper_bound (m_spatial.begin (), m_spatial.end (), position.x, CompareX ()), neighbor);
+  m_expirations.push (std::make_pair (Simulator::Now () + m_entryLifeTime, id));
+  m_angularValid = false;
 }
 
 /**
@@ -54,7 +82,61 @@ PositionTable::AddEntry (Ipv4Address id, Vector position)
  */
 void PositionTable::DeleteEntry (Ipv4Address id)
 {
-  m_table.erase (id);
+  std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
+  if (i == m_table.end ())
+    {
+      return;
+    }
+  RemoveFromIndex (id, i->second.first.x);
+  m_table.erase (i);
+  m_angularValid = false;
+}
+
+void
+PositionTable::RemoveFromIndex (Ipv4Address id, double x)
+{
+  std::vector<Neighbor>::iterator i = std::lower_bound (m_spatial.begin (), m_spatial.end (), x, CompareX ());
+  for (; i != m_spatial.end () && i->position.x == x; i++)
+    {
+      if (i->id == id)
+        {
+          m_spatial.erase (i);
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "Neighbor " << id << " missing from the spatial index");
+}
+
+void
+PositionTable::Erase (std::vector<Neighbor>::iterator begin, std::vector<Neighbor>::iterator end)
+{
+  if (begin == end)
+    {
+      return;
+    }
+  for (std::vector<Neighbor>::iterator i = begin; i != end; i++)
+    {
+      m_table.erase (i->id);
+    }
+  m_spatial.erase (begin, end);
+  m_angularValid = false;
+}
+
+void
+PositionTable::Expire ()
+{
+  while (!m_expirations.empty () && m_expirations.top ().first <= Simulator::Now ())
+    {
+      Ipv4Address id = m_expirations.top ().second;
+      m_expirations.pop ();
+      std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
+      if (i != m_table.end () && i->second.second + m_entryLifeTime <= Simulator::Now ())
+        {
+          RemoveFromIndex (id, i->second.first.x);
+          m_table.erase (i);
+          m_angularValid = false;
+        }
+    }
 }
 
 /**
@@ -65,9 +147,9 @@ void PositionTable::DeleteEntry (Ipv4Address id)
 Vector 
 PositionTable::GetPosition (Ipv4Address id)
 {
-
- std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
-  if (i != m_table.end () || id.IsEqual (i->first))
+  Expire ();
+  std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
+  if (i != m_table.end ())
     {
       return i->second.first;
     }
@@ -84,9 +166,9 @@ PositionTable::GetPosition (Ipv4Address id)
 bool
 PositionTable::isNeighbour (Ipv4Address id)
 {
-
- std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
-  if (i != m_table.end () || id.IsEqual (i->first))
+  Expire ();
+  std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.find (id);
+  if (i != m_table.end ())
     {
       return true;
     }
@@ -96,16 +178,20 @@ PositionTable::isNeighbour (Ipv4Address id)
 
 void PositionTable::PrintTable(Ipv4Address id)
 	{
-		NS_LOG_UNCOND("== M_NEIGHBORS " << id << " ===================================================");
+		// Walking the table is wasted work unless the dump is visible
+		if (!g_log.IsEnabled (LOG_DEBUG))
+			{
+				return;
+			}
+		GPSR_LOG_DEBUG ("== M_NEIGHBORS " << id << " ===================================================");
 
 		//[AC] Iterate map to print all entries in the table
 		for(std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i=m_table.begin();i!=m_table.end(); ++i)
 		{
-			Time time = i->second.second;
-			NS_LOG_UNCOND("Neighbor " << i->first << " Position " << i->second.first << " Time " << time);
+			GPSR_LOG_DEBUG ("Neighbor " << i->first << " Position " << i->second.first << " Time " << i->second.second);
 		}
 
-		NS_LOG_UNCOND("==============================================================================");
+		GPSR_LOG_DEBUG ("==============================================================================");
 	}
 /**
  * \brief remove entries with expired lifetime
@@ -114,66 +200,24 @@ void PositionTable::PrintTable(Ipv4Address id)
 void 
 PositionTable::Purge (Vector MM, bool function)
 {
-	NS_LOG_UNCOND("Purge : My Position: " << MM.x << ":" << MM.y << "    I'm OBU? " << function);
+	GPSR_LOG_DEBUG ("Purge : My Position: " << MM.x << ":" << MM.y << "    I'm OBU? " << function);
+	Expire ();
 	if(m_table.empty ())
 	{
 		return;
 	}
 
-	std::list<Ipv4Address> toErase;
-
-	std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i = m_table.begin ();
-	std::map<Ipv4Address, std::pair<Vector, Time> >::iterator listEnd = m_table.end ();
-
-	for (; !(i == listEnd); i++)
+	//Se for OBU pequeno truque: purge por distancia
+	if (function == true)
 	{
-
-      if ((m_entryLifeTime + GetEntryUpdateTime (i->first) <= Simulator::Now ()))
-        {
-          toErase.insert (toErase.begin (), i->first);
-        }
-
-      //Se for OBU pequeno truque: purge por distancia
-      if (function == true)
-      {
-    	  if((MM.x)>(i->second.first.x))
-    	  {
-    		  if((MM.x) - (i->second.first.x) > 290)
-    		  {
-    			  toErase.insert (toErase.begin (), i->first);
-    		  }
-    	  }
-    	  else
-    	  {
-    		  if((i->second.first.x) - (MM.x) > 290)
-    		  {
-    			  toErase.insert (toErase.begin (), i->first);
-    		  }
-    	  }
-
-
-      }
-
-      //Se for RSU o purge tem de ter uma distancia maior
-      else
-      {
-    	  if((MM.x) - (i->second.first.x) > 1000)
-    	  {
-    		  toErase.insert (toErase.begin (), i->first);
-    	  }
-      }
-    }
-
-  toErase.unique ();
-
-  std::list<Ipv4Address>::iterator end = toErase.end ();
-
-  for (std::list<Ipv4Address>::iterator it = toErase.begin (); it != end; ++it)
-    {
-
-      m_table.erase (*it);
-
-    }
+		Erase (std::upper_bound (m_spatial.begin (), m_spatial.end (), MM.x + 290, CompareX ()), m_spatial.end ());
+		Erase (m_spatial.begin (), std::lower_bound (m_spatial.begin (), m_spatial.end (), MM.x - 290, CompareX ()));
+	}
+	//Se for RSU o purge tem de ter uma distancia maior
+	else
+	{
+		Erase (m_spatial.begin (), std::lower_bound (m_spatial.begin (), m_spatial.end (), MM.x - 1000, CompareX ()));
+	}
 }
 
 /**
@@ -183,6 +227,11 @@ void
 PositionTable::Clear ()
 {
   m_table.clear ();
+  m_spatial.clear ();
+  m_expirations = std::priority_queue<Expiration, std::vector<Expiration>, std::greater<Expiration> > ();
+  m_planar.clear ();
+  m_bearings.clear ();
+  m_angularValid = false;
 }
 
 /**
@@ -194,42 +243,41 @@ PositionTable::Clear ()
 Ipv4Address 
 PositionTable::BestNeighbor (Vector position, Vector nodePos)
 {
-	//NS_LOG_UNCOND("Entrou no Best Neighbor Position " << position << " nodePos " << nodePos);
-	double initialDistance = CalculateDistance (nodePos, position);
-	//NS_LOG_UNCOND("Initial distance " << initialDistance);
-
-	if (m_table.empty ())
+	Expire ();
+	if (m_spatial.empty ())
 	{
 		return Ipv4Address::GetZero ();
 	}     //if table is empty (no neighbours)
 
-	Ipv4Address bestFoundID = m_table.begin ()->first;
-	//NS_LOG_UNCOND("BestFoundID " << bestFoundID);
-
-	double bestFoundDistance = CalculateDistance (m_table.begin ()->second.first, position);
-	//NS_LOG_UNCOND("BestFoundDistance " << bestFoundDistance);
-
-	std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i;
-	for (i = m_table.begin (); !(i == m_table.end ()); i++)
+	// Walk away from the x of the destination on both sides, a neighbor
+	// whose x is further than the best distance found cannot be closer.
+	double bestFoundDistance = CalculateDistance (nodePos, position);
+	Ipv4Address bestFoundID = Ipv4Address::GetZero ();
+	std::vector<Neighbor>::const_iterator start = std::lower_bound (m_spatial.begin (), m_spatial.end (), position.x, CompareX ());
+	std::vector<Neighbor>::const_iterator i;
+	for (i = start; i != m_spatial.end () && i->position.x - position.x <= bestFoundDistance; i++)
 	{
-		//NS_LOG_UNCOND("Ciclo " << bestFoundDistance << " CalculateDistance " << CalculateDistance (i->second.first, position));
-		if (bestFoundDistance > CalculateDistance (i->second.first, position))
+		double distance = CalculateDistance (i->position, position);
+		if (distance < bestFoundDistance || (distance == bestFoundDistance && !bestFoundID.IsEqual (Ipv4Address::GetZero ()) && i->id < bestFoundID))
 		{
-			bestFoundID = i->first;
-			bestFoundDistance = CalculateDistance (i->second.first, position);
-
-			//NS_LOG_UNCOND("BestFoundid " << bestFoundID << " BestFoundDistance " << bestFoundDistance);
+			bestFoundID = i->id;
+			bestFoundDistance = distance;
+		}
+	}
+	for (i = start; i != m_spatial.begin () && position.x - (i - 1)->position.x <= bestFoundDistance; i--)
+	{
+		double distance = CalculateDistance ((i - 1)->position, position);
+		if (distance < bestFoundDistance || (distance == bestFoundDistance && !bestFoundID.IsEqual (Ipv4Address::GetZero ()) && (i - 1)->id < bestFoundID))
+		{
+			bestFoundID = (i - 1)->id;
+			bestFoundDistance = distance;
 		}
 	}
 
-	if(initialDistance > bestFoundDistance)
-		return bestFoundID;
-	else
-		return Ipv4Address::GetZero (); //so it enters Recovery-mode
-
+	//Ipv4Address::GetZero () so it enters Recovery-mode
+	return bestFoundID;
 }
 
-
 /**
  * \brief Gets next hop according to GPSR recovery-mode protocol (right hand rule)
  * \param previousHop the position of the node that sent the packet to this node
@@ -239,28 +287,68 @@ PositionTable::BestNeighbor (Vector position, Vector nodePos)
 Ipv4Address
 PositionTable::BestAngle (Vector previousHop, Vector nodePos)
 {
-  //Purge ();
-
+  Expire ();
   if (m_table.empty ())
     {
-      NS_LOG_DEBUG ("BestNeighbor table is empty; Position: " << nodePos);
+      GPSR_LOG_DEBUG ("BestNeighbor table is empty; Position: " << nodePos);
       return Ipv4Address::GetZero ();
     }     //if table is empty (no neighbours)
 
-  double tmpAngle;
+  double reference = PseudoAngle (previousHop.x - nodePos.x, previousHop.y - nodePos.y);
   Ipv4Address bestFoundID = Ipv4Address::GetZero ();
-  double bestFoundAngle = 360;
-  std::map<Ipv4Address, std::pair<Vector, Time> >::iterator i;
 
-  for (i = m_table.begin (); !(i == m_table.end ()); i++)
-  {
-	  tmpAngle = GetAngle(nodePos, previousHop, i->second.first);
-	  if (bestFoundAngle > tmpAngle && tmpAngle != 0)
-	  {
-		  bestFoundID = i->first;
-		  bestFoundAngle = tmpAngle;
-	  }
-  }
+  if (!m_angularValid || m_angularCentre.x != nodePos.x || m_angularCentre.y != nodePos.y)
+    {
+      // first query from this position: the planar subgraph is kept for the
+      // next queries and the successor is found in a single pass over it.
+      Planarize (nodePos);
+      double bestFoundAngle = 4;
+      for (std::vector<Neighbor>::const_iterator i = m_planar.begin (); i != m_planar.end (); i++)
+        {
+          double dx = i->position.x - nodePos.x;
+          double dy = i->position.y - nodePos.y;
+          if (dx == 0 && dy == 0)
+            {
+              continue;
+            }
+          double angle = reference - PseudoAngle (dx, dy);
+          if (angle == 0)
+            {
+              continue;
+            }
+          if (angle < 0)
+            {
+              angle += 4;
+            }
+          if (angle < bestFoundAngle || (angle == bestFoundAngle && i->id < bestFoundID))
+            {
+              bestFoundID = i->id;
+              bestFoundAngle = angle;
+            }
+        }
+    }
+  else
+    {
+      // same position again: sort the neighbors by bearing once and
+      // binary search the neighbor with the largest bearing below the
+      // bearing of the previous hop, wrapping around to the largest one.
+      SortBearings ();
+      Bearing key;
+      key.angle = reference;
+      key.id = Ipv4Address::GetZero ();
+      std::vector<Bearing>::const_iterator i = std::lower_bound (m_bearings.begin (), m_bearings.end (), key);
+      if (i == m_bearings.begin ())
+        {
+          i = m_bearings.end ();
+        }
+      if (i != m_bearings.begin () && (i - 1)->angle != reference)
+        {
+          // first neighbor in address order with that bearing
+          key.angle = (i - 1)->angle;
+          bestFoundID = std::lower_bound (m_bearings.begin (), m_bearings.end (), key)->id;
+        }
+    }
+
   if(bestFoundID == Ipv4Address::GetZero ()) //only if the only neighbour is who sent the packet
   {
 	  bestFoundID = m_table.begin ()->first;
@@ -268,38 +356,125 @@ PositionTable::BestAngle (Vector previousHop, Vector nodePos)
   return bestFoundID;
 }
 
+void
+PositionTable::SetPlanarization (enum Planarization planarization)
+{
+  m_planarization = planarization;
+  m_angularValid = false;
+}
 
-//Gives angle between the vector CentrePos-Refpos to the vector CentrePos-node counterclockwise
-double 
-PositionTable::GetAngle (Vector centrePos, Vector refPos, Vector node){
-  double const PI = 4*atan(1);
-
-  std::complex<double> A = std::complex<double>(centrePos.x,centrePos.y);
-  std::complex<double> B = std::complex<double>(node.x,node.y);
-  std::complex<double> C = std::complex<double>(refPos.x,refPos.y);   //Change B with C if you want angles clockwise
-
-  std::complex<double> AB; //reference edge
-  std::complex<double> AC;
-  std::complex<double> tmp;
-  std::complex<double> tmpCplx;
+enum Planarization
+PositionTable::GetPlanarization (void) const
+{
+  return m_planarization;
+}
 
-  std::complex<double> Angle;
+double
+PositionTable::PseudoAngle (double dx, double dy)
+{
+  // monotonic in the counterclockwise angle from the x axis, in [0, 4)
+  double p = dy / (std::fabs (dx) + std::fabs (dy));
+  if (dx < 0)
+    {
+      return 2 - p;
+    }
+  if (dy < 0)
+    {
+      return 4 + p;
+    }
+  return p;
+}
 
-  AB = B - A;
-  AB = (real(AB)/norm(AB)) + (std::complex<double>(0.0,1.0)*(imag(AB)/norm(AB)));
+void
+PositionTable::Planarize (Vector centrePos)
+{
+  m_planar.clear ();
+  for (std::vector<Neighbor>::const_iterator v = m_spatial.begin (); v != m_spatial.end (); v++)
+    {
+      double uvx = v->position.x - centrePos.x;
+      double uvy = v->position.y - centrePos.y;
+      double uv2 = uvx * uvx + uvy * uvy;
+      bool keep = true;
+      if (m_planarization != PLANARIZATION_NONE)
+        {
+          for (std::vector<Neighbor>::const_iterator w = m_spatial.begin (); w != m_spatial.end () && keep; w++)
+            {
+              if (w == v)
+                {
+                  continue;
+                }
+              double uwx = w->position.x - centrePos.x;
+              double uwy = w->position.y - centrePos.y;
+              double vwx = w->position.x - v->position.x;
+              double vwy = w->position.y - v->position.y;
+              double uw2 = uwx * uwx + uwy * uwy;
+              double vw2 = vwx * vwx + vwy * vwy;
+              if (m_planarization == PLANARIZATION_GABRIEL)
+                {
+                  // w strictly inside the circle of diameter uv
+                  keep = uw2 + vw2 >= uv2;
+                }
+              else
+                {
+                  // w strictly inside the lune of uv
+                  keep = std::max (uw2, vw2) >= uv2;
+                }
+            }
+        }
+      if (keep)
+        {
+          m_planar.push_back (*v);
+        }
+    }
+  GPSR_LOG_DEBUG ("Planar subgraph keeps " << m_planar.size () << " of " << m_spatial.size () << " neighbors");
+  m_bearings.clear ();
+  m_bearingsSorted = false;
+  m_angularCentre = centrePos;
+  m_angularValid = true;
+}
 
-  AC = C - A;
-  AC = (real(AC)/norm(AC)) + (std::complex<double>(0.0,1.0)*(imag(AC)/norm(AC)));
+void
+PositionTable::SortBearings ()
+{
+  if (m_bearingsSorted)
+    {
+      return;
+    }
+  m_bearings.clear ();
+  for (std::vector<Neighbor>::const_iterator i = m_planar.begin (); i != m_planar.end (); i++)
+    {
+      double dx = i->position.x - m_angularCentre.x;
+      double dy = i->position.y - m_angularCentre.y;
+      if (dx == 0 && dy == 0)
+        {
+          // no bearing for a neighbor located at the centre
+          continue;
+        }
+      Bearing bearing;
+      bearing.angle = PseudoAngle (dx, dy);
+      bearing.id = i->id;
+      m_bearings.push_back (bearing);
+    }
+  std::sort (m_bearings.begin (), m_bearings.end ());
+  m_bearingsSorted = true;
+}
 
-  tmp = log(AC/AB);
-  tmpCplx = std::complex<double>(0.0,-1.0);
-  Angle = tmp*tmpCplx;
-  Angle *= (180/PI);
-  if (real(Angle)<0)
-    Angle = 360+real(Angle);
 
-  return real(Angle);
+//Gives angle between the vector CentrePos-Refpos to the vector CentrePos-node counterclockwise
+double 
+PositionTable::GetAngle (Vector centrePos, Vector refPos, Vector node)
+{
+  double nx = node.x - centrePos.x;
+  double ny = node.y - centrePos.y;
+  double rx = refPos.x - centrePos.x;
+  double ry = refPos.y - centrePos.y;
 
+  double angle = std::atan2 (nx * ry - ny * rx, nx * rx + ny * ry) * 180 / M_PI;
+  if (angle < 0)
+    {
+      angle += 360;
+    }
+  return angle;
 }
 
 
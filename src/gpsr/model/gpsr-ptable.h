@@ -2,6 +2,8 @@
 #define GPSR_PTABLE_H
 
 #include <map>
+#include <vector>
+#include <queue>
 #include <cassert>
 #include <stdint.h>
 #include "ns3/ipv4.h"
@@ -13,14 +15,32 @@
 #include "ns3/vector.h"
 #include "ns3/wifi-mac-header.h"
 #include "ns3/random-variable.h"
-#include <complex>
 
 namespace ns3 {
 namespace gpsr {
 
+/// Planar subgraph on which the perimeter mode applies the right hand rule
+enum Planarization
+{
+  PLANARIZATION_NONE,    ///< all neighbors
+  PLANARIZATION_GABRIEL, ///< Gabriel graph
+  PLANARIZATION_RNG      ///< Relative Neighborhood Graph
+};
+
 /*
  * \ingroup gpsr
  * \brief Position table used by GPSR
+ *
+ * Besides the per-address table, the neighbors are kept in a flat vector
+ * sorted by their x coordinate, so that the greedy next hop search only
+ * visits the neighbors whose x is closer to the destination than the best
+ * candidate found so far, and the distance based purge only has to trim
+ * both ends of the vector. The perimeter mode finds the right hand rule
+ * successor in a single pass over the planarized neighbors, and the planar subgraph
+ * is kept, then sorted by bearing, for as long as neither the node nor
+ * its neighbors have moved. Bearings are compared as pseudo-angles, which
+ * are monotonic in the angle without calling trigonometric functions.
+ * Entries expire lazily through a heap ordered by expiration time.
  */
 class PositionTable
 {
@@ -35,6 +55,12 @@ public:
    */
   Time GetEntryUpdateTime (Ipv4Address id);
 
+  /**
+   * \brief Sets how long an entry lives without a new HELLO, 2 seconds by default.
+   * To be called before the first entry is added.
+   */
+  void SetEntryLifeTime (Time lifetime);
+  Time GetEntryLifeTime (void) const;
   /**
    * \brief Adds entry in position table
    */
@@ -102,13 +128,68 @@ public:
    */
   Ipv4Address BestAngle (Vector previousHop, Vector nodePos);
 
+  /**
+   * \brief Sets the planar subgraph used by BestAngle, PLANARIZATION_NONE by default
+   */
+  void SetPlanarization (enum Planarization planarization);
+  enum Planarization GetPlanarization (void) const;
+
   //Gives angle between the vector CentrePos-Refpos to the vector CentrePos-node counterclockwise
   double GetAngle (Vector centrePos, Vector refPos, Vector node);
 
 
 private:
+  /// Neighbor in the spatial index
+  struct Neighbor
+  {
+    Ipv4Address id;
+    Vector position;
+  };
+  /// Orders neighbors by their x coordinate
+  struct CompareX
+  {
+    bool operator() (const Neighbor &a, double x) const { return a.position.x < x; }
+    bool operator() (double x, const Neighbor &a) const { return x < a.position.x; }
+  };
+  /// Bearing (pseudo-angle) of a neighbor seen from m_angularCentre
+  struct Bearing
+  {
+    double angle;
+    Ipv4Address id;
+    bool operator< (const Bearing &o) const
+    {
+      return angle < o.angle || (angle == o.angle && id < o.id);
+    }
+  };
+  typedef std::pair<Time, Ipv4Address> Expiration;
+
+  /// Remove id located at x from the spatial index
+  void RemoveFromIndex (Ipv4Address id, double x);
+  /// Remove the entries of the spatial index in [begin, end) from the table
+  void Erase (std::vector<Neighbor>::iterator begin, std::vector<Neighbor>::iterator end);
+  /// Remove the entries whose lifetime expired
+  void Expire ();
+  /// \returns a value in [0, 4) increasing with the counterclockwise angle of (dx, dy)
+  static double PseudoAngle (double dx, double dy);
+  /// Compute the planar subgraph of the neighbors seen from centrePos
+  void Planarize (Vector centrePos);
+  /// Sort the planar neighbors by bearing
+  void SortBearings ();
+
   Time m_entryLifeTime;
   std::map<Ipv4Address, std::pair<Vector, Time> > m_table;
+  /// Neighbors sorted by x coordinate
+  std::vector<Neighbor> m_spatial;
+  /// Pending expirations, an entry updated since it was pushed is skipped
+  std::priority_queue<Expiration, std::vector<Expiration>, std::greater<Expiration> > m_expirations;
+  enum Planarization m_planarization;
+  /// Planar neighbors seen from m_angularCentre, valid if m_angularValid
+  std::vector<Neighbor> m_planar;
+  /// m_planar sorted by bearing, valid if m_bearingsSorted
+  std::vector<Bearing> m_bearings;
+  Vector m_angularCentre;
+  bool m_angularValid;
+  bool m_bearingsSorted;
   // TX error callback
   Callback<void, WifiMacHeader const &> m_txErrorCallback;
   // Process layer 2 TX error notification
@@ -15,30 +15,44 @@ uint32_t
 RequestQueue::GetSize ()
 {
   Purge ();
-  return m_queue.size ();
+  return m_size;
 }
 
 bool
 RequestQueue::Enqueue (QueueEntry & entry)
 {
   Purge ();
-  for (std::vector<QueueEntry>::const_iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  Ipv4Address dst = entry.GetIpv4Header ().GetDestination ();
+  DestinationMap::iterator q = m_queue.find (dst);
+  if (q != m_queue.end ())
     {
-      if ((i->GetPacket ()->GetUid () == entry.GetPacket ()->GetUid ())
-          && (i->GetIpv4Header ().GetDestination ()
-              == entry.GetIpv4Header ().GetDestination ()))
+      for (std::deque<Slot>::const_iterator i = q->second.begin (); i != q->second.end (); ++i)
         {
-          return false;
+          if (i->entry.GetPacket ()->GetUid () == entry.GetPacket ()->GetUid ())
+            {
+              return false;
+            }
         }
     }
   entry.SetExpireTime (m_queueTimeout);
-  if (m_queue.size () == m_maxLen)
+  if (m_size == m_maxLen)
     {
-      Drop (m_queue.front (), "Drop the most aged packet");     // Drop the most aged packet
-      m_queue.erase (m_queue.begin ());
+      // Drop the most aged packet
+      while (!m_expirations.empty () && !EraseTop ("Drop the most aged packet"))
+        {
+        }
     }
-  m_queue.push_back (entry);
+  Slot slot;
+  slot.seq = m_nextSeq++;
+  slot.entry = entry;
+  m_queue[dst].push_back (slot);
+  m_size++;
+
+  Expiry expiry;
+  expiry.expire = entry.GetExpireTime () + Simulator::Now ();
+  expiry.seq = slot.seq;
+  expiry.dst = dst;
+  m_expirations.push (expiry);
   return true;
 }
 
@@ -47,71 +61,82 @@ RequestQueue::DropPacketWithDst (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
   Purge ();
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  DestinationMap::iterator q = m_queue.find (dst);
+  if (q == m_queue.end ())
     {
-      if (IsEqual (*i, dst))
-        {
-          Drop (*i, "DropPacketWithDst ");
-        }
+      return;
+    }
+  std::deque<Slot> slots;
+  slots.swap (q->second);
+  m_queue.erase (q);
+  m_size -= slots.size ();
+  for (std::deque<Slot>::iterator i = slots.begin (); i != slots.end (); ++i)
+    {
+      Drop (i->entry, "DropPacketWithDst ");
     }
-  m_queue.erase (std::remove_if (m_queue.begin (), m_queue.end (),
-                                 std::bind2nd (std::ptr_fun (RequestQueue::IsEqual), dst)), m_queue.end ());
 }
 
 bool
 RequestQueue::Dequeue (Ipv4Address dst, QueueEntry & entry)
 {
   Purge ();
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i != m_queue.end (); ++i)
+  DestinationMap::iterator q = m_queue.find (dst);
+  if (q == m_queue.end ())
     {
-      if (i->GetIpv4Header ().GetDestination () == dst)
-        {
-          entry = *i;
-          m_queue.erase (i);
-          return true;
-        }
+      return false;
     }
-  return false;
+  entry = q->second.front ().entry;
+  q->second.pop_front ();
+  if (q->second.empty ())
+    {
+      m_queue.erase (q);
+    }
+  m_size--;
+  return true;
 }
 
 bool
 RequestQueue::Find (Ipv4Address dst)
 {
-  for (std::vector<QueueEntry>::const_iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  return m_queue.find (dst) != m_queue.end ();
+}
+
+bool
+RequestQueue::EraseTop (std::string reason)
+{
+  Expiry top = m_expirations.top ();
+  m_expirations.pop ();
+  DestinationMap::iterator q = m_queue.find (top.dst);
+  if (q == m_queue.end ())
     {
-      if (i->GetIpv4Header ().GetDestination () == dst)
+      return false;
+    }
+  for (std::deque<Slot>::iterator i = q->second.begin (); i != q->second.end (); ++i)
+    {
+      if (i->seq == top.seq)
         {
+          QueueEntry entry = i->entry;
+          q->second.erase (i);
+          if (q->second.empty ())
+            {
+              m_queue.erase (q);
+            }
+          m_size--;
+          Drop (entry, reason);
           return true;
         }
     }
   return false;
 }
 
-struct IsExpired
-{
-  bool
-  operator() (QueueEntry const & e) const
-  {
-    return (e.GetExpireTime () < Seconds (0));
-  }
-};
-
 void
 RequestQueue::Purge ()
 {
-  IsExpired pred;
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  Time now = Simulator::Now ();
+  while (!m_expirations.empty () && m_expirations.top ().expire < now)
     {
-      if (pred (*i))
-        {
-          Drop (*i, "Drop outdated packet ");
-        }
+      EraseTop ("Drop outdated packet ");
     }
-  m_queue.erase (std::remove_if (m_queue.begin (), m_queue.end (), pred),
-                 m_queue.end ());
 }
 
 void
@@ -3,7 +3,11 @@
 #ifndef GPSR_RQUEUE_H
 #define GPSR_RQUEUE_H
 
+#include <map>
+#include <deque>
+#include <queue>
 #include <vector>
+#include <functional>
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/simulator.h"
 
@@ -100,13 +104,21 @@ private:
  * \brief GPSR route request queue
  *
  * Since GPSR is an on demand routing we queue requests while looking for route.
+ *
+ * Entries are kept per destination, in arrival order, so that looking up,
+ * dequeuing or dropping the packets of one destination does not touch the
+ * others. Expiration is driven by a heap ordered by expire time; entries
+ * that left the queue before expiring are skipped lazily when they reach
+ * the top of the heap.
  */
 class RequestQueue
 {
 public:
   /// Default c-tor
   RequestQueue (uint32_t maxLen, Time routeToQueueTimeout)
-    : m_maxLen (maxLen),
+    : m_size (0),
+      m_nextSeq (0),
+      m_maxLen (maxLen),
       m_queueTimeout (routeToQueueTimeout)
   {
   }
@@ -141,19 +153,40 @@ public:
   //\}
 
 private:
-  std::vector<QueueEntry> m_queue;
+  /// Queue entry tagged with its arrival order
+  struct Slot
+  {
+    uint64_t seq;
+    QueueEntry entry;
+  };
+  /// Expire time of the entry with sequence number seq, for destination dst
+  struct Expiry
+  {
+    Time expire;
+    uint64_t seq;
+    Ipv4Address dst;
+    bool operator> (Expiry const & o) const
+    {
+      return (expire > o.expire) || (expire == o.expire && seq > o.seq);
+    }
+  };
+  typedef std::map<Ipv4Address, std::deque<Slot> > DestinationMap;
+
+  DestinationMap m_queue;
+  std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry> > m_expirations;
+  /// Total number of entries in m_queue
+  uint32_t m_size;
+  uint64_t m_nextSeq;
   /// Remove all expired entries
   void Purge ();
+  /// Remove the entry of the top of the expiration heap, if still queued
+  bool EraseTop (std::string reason);
   /// Notify that packet is dropped from queue by timeout
   void Drop (QueueEntry en, std::string reason);
   /// The maximum number of packets that we allow a routing protocol to buffer.
   uint32_t m_maxLen;
   /// The maximum period of time that a routing protocol is allowed to buffer a packet for, seconds.
   Time m_queueTimeout;
-  static bool IsEqual (QueueEntry en, const Ipv4Address dst)
-  {
-    return (en.GetIpv4Header ().GetDestination () == dst);
-  }
 };
 
 
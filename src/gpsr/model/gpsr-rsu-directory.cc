@@ -0,0 +1,545 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "gpsr-rsu-directory.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("GpsrRsuDirectory");
+
+namespace ns3 {
+namespace gpsr {
+
+/// Wireless addresses of the members of all the directories
+static std::set<Ipv4Address> g_rsus;
+
+#ifdef HAVE_PTHREAD_H
+/// guards g_rsus and the fallback of IsRsu, used by the nodes run in parallel
+static SystemMutex g_rsusMutex;
+#endif
+
+static GlobalValue g_fallbackRsus = GlobalValue ("GpsrRsuAddresses",
+                                                 "The wireless addresses of the road side units, comma separated, "
+                                                 "when no RsuDirectory is installed",
+                                                 StringValue ("10.0.0.1,10.0.0.2,10.0.0.3"),
+                                                 MakeStringChecker ());
+
+DirectoryRecord::DirectoryRecord ()
+{
+}
+
+DirectoryRecord::DirectoryRecord (Ipv4Address vehicle, Vector position, Vector velocity, Time updated)
+  : vehicle (vehicle),
+    position (position),
+    velocity (velocity),
+    updated (updated)
+{
+}
+
+//-----------------------------------------------------------------------------
+// DirectoryHeader
+//-----------------------------------------------------------------------------
+
+NS_OBJECT_ENSURE_REGISTERED (DirectoryHeader);
+
+DirectoryHeader::DirectoryHeader (DirectoryMessageType type, uint16_t source,
+                                  uint16_t destination, uint32_t requestId)
+  : m_type (type),
+    m_source (source),
+    m_destination (destination),
+    m_requestId (requestId)
+{
+}
+
+TypeId
+DirectoryHeader::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::gpsr::DirectoryHeader")
+    .SetParent<Header> ()
+    .AddConstructor<DirectoryHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+DirectoryHeader::GetInstanceTypeId () const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+DirectoryHeader::GetSerializedSize () const
+{
+  return 11 + m_records.size () * RECORD_SIZE;
+}
+
+static void
+WriteDouble (Buffer::Iterator &i, double value)
+{
+  // positions are sent exactly, unlike in the integer SLS headers
+  uint64_t bits;
+  memcpy (&bits, &value, sizeof (bits));
+  i.WriteHtonU64 (bits);
+}
+
+static double
+ReadDouble (Buffer::Iterator &i)
+{
+  uint64_t bits = i.ReadNtohU64 ();
+  double value;
+  memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+void
+DirectoryHeader::Serialize (Buffer::Iterator i) const
+{
+  i.WriteU8 (m_type);
+  i.WriteHtonU16 (m_source);
+  i.WriteHtonU16 (m_destination);
+  i.WriteHtonU32 (m_requestId);
+  i.WriteHtonU16 (m_records.size ());
+  for (std::vector<DirectoryRecord>::const_iterator r = m_records.begin (); r != m_records.end (); ++r)
+    {
+      i.WriteHtonU32 (r->vehicle.Get ());
+      WriteDouble (i, r->position.x);
+      WriteDouble (i, r->position.y);
+      WriteDouble (i, r->velocity.x);
+      WriteDouble (i, r->velocity.y);
+      i.WriteHtonU64 (r->updated.GetNanoSeconds ());
+    }
+}
+
+uint32_t
+DirectoryHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_type = (DirectoryMessageType) i.ReadU8 ();
+  m_source = i.ReadNtohU16 ();
+  m_destination = i.ReadNtohU16 ();
+  m_requestId = i.ReadNtohU32 ();
+  uint16_t count = i.ReadNtohU16 ();
+  m_records.clear ();
+  for (uint16_t k = 0; k < count; k++)
+    {
+      DirectoryRecord r;
+      r.vehicle = Ipv4Address (i.ReadNtohU32 ());
+      r.position.x = ReadDouble (i);
+      r.position.y = ReadDouble (i);
+      r.velocity.x = ReadDouble (i);
+      r.velocity.y = ReadDouble (i);
+      r.updated = NanoSeconds (i.ReadNtohU64 ());
+      m_records.push_back (r);
+    }
+  uint32_t dist = i.GetDistanceFrom (start);
+  NS_ASSERT (dist == GetSerializedSize ());
+  return dist;
+}
+
+void
+DirectoryHeader::Print (std::ostream &os) const
+{
+  os << "type " << (uint32_t) m_type << " from " << m_source << " to " << m_destination
+     << " request " << m_requestId << " records " << m_records.size ();
+}
+
+//-----------------------------------------------------------------------------
+// RsuDirectory
+//-----------------------------------------------------------------------------
+
+NS_OBJECT_ENSURE_REGISTERED (RsuDirectory);
+
+// IEEE 802 local experimental ethertype
+const uint16_t RsuDirectory::PROT_NUMBER = 0x88B5;
+
+TypeId
+RsuDirectory::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::gpsr::RsuDirectory")
+    .SetParent<Object> ()
+    .AddConstructor<RsuDirectory> ()
+    .AddAttribute ("Shards", "Number of shards the vehicle addresses are hashed into.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&RsuDirectory::m_nShards),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Replicas", "Number of RSUs which own each shard.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&RsuDirectory::m_replicas),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BatchInterval", "Delay between two batches of updates sent to the shard owners.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&RsuDirectory::m_batchInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("RecordLifetime", "Age after which a record is no longer returned by a lookup.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&RsuDirectory::m_recordLifetime),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxRecords", "Maximum number of records in an update packet.",
+                   UintegerValue (40),
+                   MakeUintegerAccessor (&RsuDirectory::m_maxRecords),
+                   MakeUintegerChecker<uint32_t> (1, 2000))
+    .AddTraceSource ("BackhaulTx", "A directory packet is sent on the backhaul.",
+                     MakeTraceSourceAccessor (&RsuDirectory::m_backhaulTxTrace))
+    .AddTraceSource ("Lookup", "The answer of a remote lookup arrived: vehicle, latency.",
+                     MakeTraceSourceAccessor (&RsuDirectory::m_lookupTrace))
+  ;
+  return tid;
+}
+
+RsuDirectory::RsuDirectory ()
+  : m_self (0),
+    m_nextRequestId (0),
+    m_txPackets (0),
+    m_txBytes (0)
+{
+}
+
+RsuDirectory::~RsuDirectory ()
+{
+}
+
+void
+RsuDirectory::DoDispose (void)
+{
+  m_flushEvent.Cancel ();
+  if (m_self < m_members.size ())
+    {
+#ifdef HAVE_PTHREAD_H
+      CriticalSection lock (g_rsusMutex);
+#endif
+      g_rsus.erase (m_members[m_self]);
+    }
+  m_routes.clear ();
+  m_shards.clear ();
+  m_pending.clear ();
+  m_lookups.clear ();
+  m_answer = AnswerCallback ();
+  Object::DoDispose ();
+}
+
+void
+RsuDirectory::SetMembers (const std::vector<Ipv4Address> &members, uint32_t self)
+{
+  NS_ASSERT (self < members.size ());
+  m_members = members;
+  m_self = self;
+  m_routes.resize (members.size ());
+  m_shards.resize (m_nShards);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_rsusMutex);
+#endif
+  g_rsus.insert (members[self]);
+}
+
+void
+RsuDirectory::AddBackhaul (Ptr<NetDevice> device)
+{
+  device->GetNode ()->RegisterProtocolHandler (MakeCallback (&RsuDirectory::Receive, this),
+                                               PROT_NUMBER, device);
+}
+
+void
+RsuDirectory::SetRoute (uint32_t member, Ptr<NetDevice> device, Address address)
+{
+  NS_ASSERT (member < m_routes.size ());
+  m_routes[member].device = device;
+  m_routes[member].address = address;
+}
+
+void
+RsuDirectory::SetAnswerCallback (AnswerCallback cb)
+{
+  m_answer = cb;
+}
+
+uint32_t
+RsuDirectory::GetShard (Ipv4Address vehicle) const
+{
+  // Knuth's multiplicative hash spreads consecutive addresses
+  return (vehicle.Get () * 2654435761U) % m_nShards;
+}
+
+bool
+RsuDirectory::IsOwner (uint32_t member, uint32_t shard) const
+{
+  uint32_t n = m_members.size ();
+  uint32_t primary = shard % n;
+  return (member + n - primary) % n < std::min (m_replicas, n);
+}
+
+uint32_t
+RsuDirectory::GetSelf (void) const
+{
+  return m_self;
+}
+
+uint64_t
+RsuDirectory::GetTxPackets (void) const
+{
+  return m_txPackets;
+}
+
+uint64_t
+RsuDirectory::GetTxBytes (void) const
+{
+  return m_txBytes;
+}
+
+/**
+ * \returns the addresses of GpsrRsuAddresses, parsed again only when the
+ * global value changes; to be called with g_rsusMutex held
+ */
+static const std::set<Ipv4Address> &
+GetFallbackRsus (void)
+{
+  static std::string parsed;
+  static std::set<Ipv4Address> fallback;
+  StringValue value;
+  g_fallbackRsus.GetValue (value);
+  if (value.Get () != parsed)
+    {
+      parsed = value.Get ();
+      fallback.clear ();
+      std::istringstream iss (parsed);
+      std::string item;
+      while (std::getline (iss, item, ','))
+        {
+          if (!item.empty ())
+            {
+              fallback.insert (Ipv4Address (item.c_str ()));
+            }
+        }
+    }
+  return fallback;
+}
+
+bool
+RsuDirectory::IsRsu (Ipv4Address address)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_rsusMutex);
+#endif
+  const std::set<Ipv4Address> &rsus = g_rsus.empty () ? GetFallbackRsus () : g_rsus;
+  return rsus.find (address) != rsus.end ();
+}
+
+std::vector<Ipv4Address>
+RsuDirectory::GetRsus (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_rsusMutex);
+#endif
+  const std::set<Ipv4Address> &rsus = g_rsus.empty () ? GetFallbackRsus () : g_rsus;
+  return std::vector<Ipv4Address> (rsus.begin (), rsus.end ());
+}
+
+void
+RsuDirectory::NotifyUpdate (Ipv4Address vehicle, Vector position, Vector velocity)
+{
+  NS_LOG_FUNCTION (this << vehicle << position << velocity);
+  DirectoryRecord record (vehicle, position, velocity, Simulator::Now ());
+  uint32_t shard = GetShard (vehicle);
+  for (uint32_t member = 0; member < m_members.size (); member++)
+    {
+      if (!IsOwner (member, shard))
+        {
+          continue;
+        }
+      if (member == m_self)
+        {
+          Store (record);
+        }
+      else
+        {
+          // only the last position of a vehicle is sent in a batch
+          m_pending[member][vehicle] = record;
+        }
+    }
+  if (!m_pending.empty () && !m_flushEvent.IsRunning ())
+    {
+      m_flushEvent = Simulator::Schedule (m_batchInterval, &RsuDirectory::Flush, this);
+    }
+}
+
+void
+RsuDirectory::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<uint32_t, std::map<Ipv4Address, DirectoryRecord> >::const_iterator i = m_pending.begin ();
+       i != m_pending.end (); ++i)
+    {
+      DirectoryHeader header (DIRECTORY_UPDATE, m_self, i->first);
+      for (std::map<Ipv4Address, DirectoryRecord>::const_iterator r = i->second.begin ();
+           r != i->second.end (); ++r)
+        {
+          if (header.GetRecords ().size () == m_maxRecords)
+            {
+              Send (header);
+              header = DirectoryHeader (DIRECTORY_UPDATE, m_self, i->first);
+            }
+          header.AddRecord (r->second);
+        }
+      Send (header);
+    }
+  m_pending.clear ();
+}
+
+void
+RsuDirectory::Lookup (Ipv4Address vehicle, Ipv4Address requester)
+{
+  NS_LOG_FUNCTION (this << vehicle << requester);
+  uint32_t shard = GetShard (vehicle);
+  if (IsOwner (m_self, shard))
+    {
+      DirectoryRecord record;
+      bool found = Find (vehicle, record);
+      m_answer (requester, vehicle, found, record);
+      return;
+    }
+  // the nearest owner along the corridor
+  uint32_t owner = 0;
+  uint32_t distance = std::numeric_limits<uint32_t>::max ();
+  for (uint32_t member = 0; member < m_members.size (); member++)
+    {
+      uint32_t d = member > m_self ? member - m_self : m_self - member;
+      if (IsOwner (member, shard) && d < distance)
+        {
+          owner = member;
+          distance = d;
+        }
+    }
+  PendingLookup pending;
+  pending.vehicle = vehicle;
+  pending.requester = requester;
+  pending.start = Simulator::Now ();
+  uint32_t id = m_nextRequestId++;
+  m_lookups[id] = pending;
+  DirectoryHeader header (DIRECTORY_LOOKUP, m_self, owner, id);
+  header.AddRecord (DirectoryRecord (vehicle, Vector (), Vector (), Time ()));
+  Send (header);
+}
+
+void
+RsuDirectory::Send (const DirectoryHeader &header)
+{
+  const Route &route = m_routes[header.GetDestination ()];
+  NS_ASSERT_MSG (route.device != 0, "No backhaul route to RSU " << header.GetDestination ());
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  NS_LOG_LOGIC ("Sending " << header);
+  m_txPackets++;
+  m_txBytes += packet->GetSize ();
+  m_backhaulTxTrace (packet);
+  route.device->Send (packet, route.address, PROT_NUMBER);
+}
+
+void
+RsuDirectory::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                       const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  Ptr<Packet> packet = p->Copy ();
+  DirectoryHeader header;
+  packet->RemoveHeader (header);
+  NS_LOG_LOGIC ("Received " << header);
+  if (header.GetDestination () != m_self)
+    {
+      // chain backhaul: pass it on towards its destination
+      if (packetType != NetDevice::PACKET_OTHERHOST)
+        {
+          Send (header);
+        }
+      return;
+    }
+  switch (header.GetType ())
+    {
+    case DIRECTORY_UPDATE:
+      for (std::vector<DirectoryRecord>::const_iterator r = header.GetRecords ().begin ();
+           r != header.GetRecords ().end (); ++r)
+        {
+          Store (*r);
+        }
+      break;
+    case DIRECTORY_LOOKUP:
+      {
+        NS_ASSERT (header.GetRecords ().size () == 1);
+        DirectoryHeader answer (DIRECTORY_ANSWER, m_self, header.GetSource (), header.GetRequestId ());
+        DirectoryRecord record;
+        if (Find (header.GetRecords ()[0].vehicle, record))
+          {
+            answer.AddRecord (record);
+          }
+        Send (answer);
+        break;
+      }
+    case DIRECTORY_ANSWER:
+      {
+        std::map<uint32_t, PendingLookup>::iterator i = m_lookups.find (header.GetRequestId ());
+        if (i == m_lookups.end ())
+          {
+            NS_LOG_WARN ("Answer to an unknown lookup " << header.GetRequestId ());
+            break;
+          }
+        PendingLookup pending = i->second;
+        m_lookups.erase (i);
+        m_lookupTrace (pending.vehicle, Simulator::Now () - pending.start);
+        bool found = !header.GetRecords ().empty ();
+        DirectoryRecord record = found ? header.GetRecords ()[0] : DirectoryRecord ();
+        m_answer (pending.requester, pending.vehicle, found, record);
+        break;
+      }
+    default:
+      NS_LOG_WARN ("Unknown directory message " << header);
+      break;
+    }
+}
+
+void
+RsuDirectory::Store (const DirectoryRecord &record)
+{
+  uint32_t shard = GetShard (record.vehicle);
+  if (!IsOwner (m_self, shard))
+    {
+      NS_LOG_WARN ("Record of " << record.vehicle << " for shard " << shard << " not owned");
+      return;
+    }
+  std::map<Ipv4Address, DirectoryRecord> &records = m_shards[shard];
+  std::map<Ipv4Address, DirectoryRecord>::iterator i = records.find (record.vehicle);
+  if (i == records.end ())
+    {
+      records.insert (std::make_pair (record.vehicle, record));
+    }
+  else if (i->second.updated <= record.updated)
+    {
+      i->second = record;
+    }
+}
+
+bool
+RsuDirectory::Find (Ipv4Address vehicle, DirectoryRecord &record) const
+{
+  const std::map<Ipv4Address, DirectoryRecord> &records = m_shards[GetShard (vehicle)];
+  std::map<Ipv4Address, DirectoryRecord>::const_iterator i = records.find (vehicle);
+  if (i == records.end () || i->second.updated + m_recordLifetime < Simulator::Now ())
+    {
+      return false;
+    }
+  record = i->second;
+  return true;
+}
+
+}
+}
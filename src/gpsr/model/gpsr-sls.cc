@@ -2,6 +2,7 @@
   if (m_ipv4) { std::clog << "[node " << m_ipv4->GetObject<Node> ()->GetId () << "] "; }
 
 #include "gpsr-sls.h"
+#include "gpsr-log.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/random-variable.h"
@@ -9,8 +10,10 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/wifi-net-device.h"
+#include "ns3/location-index.h"
 #include <algorithm>
 #include <limits>
+#include <cmath>
 #include "gpsr-packet.h"
 #include "ns3/mobility-model.h"
 #include "ns3/uinteger.h"
@@ -29,7 +32,15 @@ LocationTable lt(Time("10s"));
 
 //-----------------------------------------------------------------------------
 SlsLocationService::SlsLocationService (Time tableLifeTime = Time("10s"))
-: m_table (tableLifeTime)
+: m_table (tableLifeTime),
+  m_reported (tableLifeTime),
+  m_adaptive (false),
+  m_distanceThreshold (0),
+  m_speedThreshold (0),
+  m_headingThreshold (0),
+  m_controlBytesSent (0),
+  m_controlBytesSaved (0),
+  m_batchWindow (Seconds (0))
 {
 	m_maxSearchTime = tableLifeTime;
 }
@@ -50,7 +61,13 @@ SlsLocationService::~SlsLocationService ()
 void
 SlsLocationService::DoDispose ()
 {
-  return;
+  m_directory = 0;
+  for (std::map<Ipv4Address, PendingBatch>::iterator i = m_batches.begin (); i != m_batches.end (); ++i)
+    {
+      i->second.flush.Cancel ();
+    }
+  m_batches.clear ();
+  LocationService::DoDispose ();
 }
 
 
@@ -61,16 +78,15 @@ SlsLocationService::RecvSls (Ptr<Socket> socket)
 
   Address sourceAddress;
   Ptr<Packet> packet = socket->RecvFrom (sourceAddress);
-  InetSocketAddress inetSourceAddr = InetSocketAddress::ConvertFrom (sourceAddress);
-  Ipv4Address sender = inetSourceAddr.GetIpv4 ();
-  Ipv4Address receiver = m_ipv4->GetAddress (1, 0).GetLocal (); //FIXME so funciona com uma interface
-  NS_LOG_DEBUG ("RLS node " << this << " received a RLS packet from " << sender << " to " << receiver);
+  //FIXME so funciona com uma interface
+  GPSR_LOG_DEBUG ("RLS node " << this << " received a RLS packet from " << InetSocketAddress::ConvertFrom (sourceAddress).GetIpv4 ()
+                  << " to " << m_ipv4->GetAddress (1, 0).GetLocal ());
 
   TypeHeader tHeader (SLS_LOCATION_QUERY);
   packet->RemoveHeader (tHeader);
   if (!tHeader.IsValid ())
     {
-      NS_LOG_DEBUG ("SLS message " << packet->GetUid() << " with unknown type received: " << tHeader.Get() << ". Drop");
+      GPSR_LOG_DEBUG ("SLS message " << packet->GetUid() << " with unknown type received: " << tHeader.Get() << ". Drop");
       return; // drop
     }
   switch (tHeader.Get ())
@@ -103,60 +119,37 @@ SlsLocationService::RecvSls (Ptr<Socket> socket)
 Vector
 SlsLocationService::GODPredict(Ipv4Address dst)
 {
-	uint32_t n = NodeList().GetNNodes ();
-	uint32_t i;
-	Ptr<Node> node;
-
-	NS_LOG_UNCOND("::GOD PREDICT:: Obtaining position of " << dst);
+	GPSR_LOG_DEBUG ("::GOD PREDICT:: Obtaining position of " << dst);
 
-	for(i = 0; i < n; i++)
+	Ptr<MobilityModel> mobility = LocationIndex::GetMobilityModel (dst);
+	if (mobility != 0)
 	{
-		node = NodeList().GetNode (i);
-		Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-
-		//NS_LOG_UNCOND("Have " << ipv4->GetAddress (1, 0).GetLocal ());
-		if(ipv4->GetAddress (1, 0).GetLocal () == dst)
-		{
-			return (*node->GetObject<MobilityModel>()).GetPosition ();
-		}
+		return mobility->GetPosition ();
 	}
 	Vector v;
-	NS_LOG_UNCOND("::GOD PREDICT:: Position: <" << v.x << "," << v.y << ">");
+	GPSR_LOG_DEBUG ("::GOD PREDICT:: Position: <" << v.x << "," << v.y << ">");
 	return v;
 }
 
 Vector
 SlsLocationService::Predict(Ipv4Address dst)
 {
-	NS_LOG_UNCOND("Predict called to " << dst);
-
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_LOG_DEBUG ("Predict called to " << dst);
 
-	Vector pos = m_table.GetPosition(dst, GetInvalidPosition());
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
 
-	if (VectorComparator(pos, GetInvalidPosition()))
+	KinematicState state;
+	if (!m_table.GetState(dst, state) || VectorComparator(state.position, GetInvalidPosition()))
 	{
-		NS_LOG_UNCOND("Predict deu posicao invalida");
+		GPSR_LOG_DEBUG ("Predict deu posicao invalida");
 		return GetInvalidPosition();
 	}
 
-	int64_t timeOld = m_table.GetTime(dst).GetNanoSeconds();
-	int64_t timeNow = Simulator::Now().GetNanoSeconds();
-	int speed = m_table.GetSpeed(dst);
-
-	int64_t dif = (timeNow)-(timeOld);
-	int64_t dif1 = dif / 1000000000;
+	Vector newpos = m_predictor->Predict(dst, state, Simulator::Now());
 
-	int meters = speed * dif1;
-
-	//NS_LOG_UNCOND("dif " << dif << " dif1 " << dif1 << " meters " << meters << " speed " << speed << " timeOld " << timeOld
-	//		<< " timeNow " << timeNow);
-
-	Vector newpos (pos.x + meters, pos.y,pos.z);
-
-	NS_LOG_UNCOND("Pos Antiga " << pos);
-	NS_LOG_UNCOND("Predicted Pos " << newpos);
-	NS_LOG_UNCOND("GOD Predition " << GODPredict(dst));
+	GPSR_LOG_DEBUG ("Pos Antiga " << state.position);
+	GPSR_LOG_DEBUG ("Predicted Pos " << newpos);
+	GPSR_LOG_DEBUG ("GOD Predition " << GODPredict(dst));
 
 	return newpos;
 
@@ -166,7 +159,7 @@ SlsLocationService::Predict(Ipv4Address dst)
 void
 SlsLocationService::RefreshPosition(Ipv4Address dst)
 {
-	NS_LOG_UNCOND("Refresh position from " << dst);
+	GPSR_LOG_DEBUG ("Refresh position from " << dst);
 	//Vector pos = m_table.GetPosition(dst, GetInvalidPosition());
 	//Time time = m_table.GetTime(dst);
 	int seq = m_table.GetSeqNumber(dst);
@@ -177,7 +170,7 @@ SlsLocationService::RefreshPosition(Ipv4Address dst)
 
 	Vector newPos = Predict(dst);
 
-	NS_LOG_UNCOND("NewPos by Predict " << newPos);
+	GPSR_LOG_DEBUG ("NewPos by Predict " << newPos);
 
 	m_table.AddEntry(dst, newPos, speed, flag, seq);
 }
@@ -190,13 +183,20 @@ SlsLocationService::SendLocHello(Ipv4Address dst, Ipv4Address src, Vector positi
 {
 	if(m_table.GetSpeed(dst)!=0)
 	{
-		NS_LOG_UNCOND("HELLOSLS duplicado, nao vai mandar lochello");
+		GPSR_LOG_DEBUG ("HELLOSLS duplicado, nao vai mandar lochello");
+		return;
+	}
+	// with adaptive updates the OBU tells when its entry is out of date
+	else if(m_adaptive && m_updates.find(dst) != m_updates.end()
+			&& m_updates[dst] + m_maxUpdateInterval > Simulator::Now())
+	{
+		GPSR_LOG_DEBUG ("HELLOSLS " << dst << " mandou update em " << m_updates[dst] << ", nao vai mandar lochello");
 		return;
 	}
 	else{
 
 		Vector newPosition = m_ipv4->GetObject<MobilityModel>()->GetPosition();
-		NS_LOG_UNCOND ("Chamado SendLocHello por " << src << " to " << dst << " with pos:" << newPosition);
+		GPSR_LOG_DEBUG ("Chamado SendLocHello por " << src << " to " << dst << " with pos:" << newPosition);
 
 		for (std::map<Ptr<Socket> , Ipv4InterfaceAddress>::const_iterator j =
 				m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -209,8 +209,9 @@ SlsLocationService::SendLocHello(Ipv4Address dst, Ipv4Address src, Vector positi
 			TypeHeader tHeader (SLS_LOCATION_HELLO);
 			packet->AddHeader (tHeader);
 			uint16_t port = SLS_PORT;
+			m_controlBytesSent += packet->GetSize ();
 			socket->SendTo (packet, 0, InetSocketAddress (dst, port)); //Vai chamar o RouteOutput
-			NS_LOG_UNCOND("SendLocHello sent message");
+			GPSR_LOG_DEBUG ("SendLocHello sent message");
 		}
 	}
 }
@@ -219,7 +220,19 @@ SlsLocationService::SendLocHello(Ipv4Address dst, Ipv4Address src, Vector positi
 void
 SlsLocationService::SendLocUpdate(Ptr<Packet> p, Ipv4Address dst, Ipv4Address src, Vector Position)
 {
-	NS_LOG_UNCOND("SendLocUpdate called " << src << " to " << dst);
+	GPSR_LOG_DEBUG ("SendLocUpdate called " << src << " to " << dst);
+
+	if(m_batchWindow > Seconds (0))
+	{
+		Vector pos = m_ipv4->GetObject<MobilityModel>()->GetPosition();
+		int c1 = m_ipv4->GetObject<MobilityModel >()->GetVelocity().x;
+		int c2 = m_ipv4->GetObject<MobilityModel >()->GetVelocity().y;
+		int speed = sqrt((c1*c1) + (c2*c2));
+		GetBatch(dst).AddUpdate(LocationRecord(src, pos.x, pos.y, speed));
+		m_reported.AddEntry(src, pos, speed, false, 1);
+		m_lastUpdate = Simulator::Now();
+		return;
+	}
 
 	for (std::map<Ptr<Socket> , Ipv4InterfaceAddress>::const_iterator j =
 			m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -238,19 +251,101 @@ SlsLocationService::SendLocUpdate(Ptr<Packet> p, Ipv4Address dst, Ipv4Address sr
 		TypeHeader tHeader (SLS_LOCATION_UPDATE);
 		packet->AddHeader (tHeader);
 		uint16_t port = SLS_PORT;
+		m_controlBytesSent += packet->GetSize ();
 		socket->SendTo (packet, 0, InetSocketAddress (dst, port));
+
+		// the RSU derives the velocity of its entry the same way
+		m_reported.AddEntry(src, pos, speed, false, 1);
+		m_lastUpdate = Simulator::Now();
 	}
 }
 
+void
+SlsLocationService::SetAdaptiveUpdates(bool enabled, double distance, double speed, double heading, Time maxInterval)
+{
+	m_adaptive = enabled;
+	m_distanceThreshold = distance;
+	m_speedThreshold = speed;
+	m_headingThreshold = heading;
+	m_maxUpdateInterval = maxInterval;
+}
+
+bool
+SlsLocationService::NeedsUpdate(const KinematicState &reported, Time lastUpdate, Vector position, Vector velocity)
+{
+	if(lastUpdate + m_maxUpdateInterval <= Simulator::Now())
+	{
+		GPSR_LOG_DEBUG ("Update: last one at " << lastUpdate);
+		return true;
+	}
+	double drift = CalculateDistance(m_predictor->Predict(reported, Simulator::Now()), position);
+	if(drift > m_distanceThreshold)
+	{
+		GPSR_LOG_DEBUG ("Update: position drifted " << drift << "m");
+		return true;
+	}
+	double speed = CalculateDistance(velocity, Vector());
+	double reportedSpeed = CalculateDistance(reported.velocity, Vector());
+	if(std::abs(speed - reportedSpeed) > m_speedThreshold)
+	{
+		GPSR_LOG_DEBUG ("Update: speed " << speed << " reported " << reportedSpeed);
+		return true;
+	}
+	if(speed > 0 && reportedSpeed > 0)
+	{
+		double cosine = (velocity.x * reported.velocity.x + velocity.y * reported.velocity.y + velocity.z * reported.velocity.z)
+				/ (speed * reportedSpeed);
+		double turn = std::acos(std::max(-1.0, std::min(1.0, cosine)));
+		if(turn > m_headingThreshold)
+		{
+			GPSR_LOG_DEBUG ("Update: heading changed by " << turn << "rad");
+			return true;
+		}
+	}
+	return false;
+}
+
+bool
+SlsLocationService::CheckUpdate()
+{
+	// only OBUs which already know their RSU
+	if(!m_adaptive || !GetFunction() || m_rsu == Ipv4Address())
+	{
+		return false;
+	}
+	Ipv4Address self = m_ipv4->GetAddress (1, 0).GetLocal ();
+	Ptr<MobilityModel> mobility = m_ipv4->GetObject<MobilityModel>();
+	KinematicState reported;
+	if(m_reported.GetState(self, reported)
+			&& !NeedsUpdate(reported, m_lastUpdate, mobility->GetPosition(), mobility->GetVelocity()))
+	{
+		m_controlBytesSaved += TypeHeader (SLS_LOCATION_UPDATE).GetSerializedSize () + LocUpdateHeader ().GetSerializedSize ();
+		return false;
+	}
+	SendLocUpdate(0, m_rsu, self, mobility->GetPosition());
+	return true;
+}
+
 void
 SlsLocationService::ReceiveUpdate(Ptr<Packet> p, Ipv4Address dst, Ipv4Address src, Vector Position, int speed)
 {
-	NS_LOG_UNCOND("ReceiveUpdate from " << src << " to " << dst << " speed = " << speed );
+	GPSR_LOG_DEBUG ("ReceiveUpdate from " << src << " to " << dst << " speed = " << speed );
 
 	//FIXME Olhar para a Speed vectorial
 	m_table.AddEntry(dst, Position, speed, false, 1);
+	m_updates[dst] = Simulator::Now();
+	if(m_directory)
+	{
+		KinematicState state;
+		m_table.GetState(dst, state);
+		m_directory->NotifyUpdate(dst, state.position, state.velocity);
+	}
 	//lt.AddEntry(dst, Position, speed, false, 1);
-	NS_LOG_UNCOND("ReceiveUpdate: Adicionada entrada na m_table");
+	GPSR_LOG_DEBUG ("ReceiveUpdate: Adicionada entrada na m_table");
+	if (!m_positionCallback.IsNull ())
+	{
+		m_positionCallback (dst);
+	}
 
 }
 
@@ -258,6 +353,11 @@ void
 SlsLocationService::SendQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address query)
 {
 	//NS_LOG_UNCOND ("Chamado SendQuery " << src << " to " << dst << " with query:" << query);
+	if(m_batchWindow > Seconds (0))
+	{
+		GetBatch(dst).AddQuery(LocQueryHeader(src, dst, query));
+		return;
+	}
 
 	for (std::map<Ptr<Socket> , Ipv4InterfaceAddress>::const_iterator j =
 			m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -268,7 +368,7 @@ SlsLocationService::SendQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address quer
 		Ptr<Packet> packet = Create<Packet> ();
 		packet->AddHeader (locqueryHeader);
 		TypeHeader tHeader (SLS_LOCATION_QUERY);
-		NS_LOG_UNCOND("QUERY PACKET " << src << " " << dst << " " << query << " " << SLS_LOCATION_QUERY);
+		GPSR_LOG_DEBUG ("QUERY PACKET " << src << " " << dst << " " << query << " " << SLS_LOCATION_QUERY);
 		packet->AddHeader (tHeader);
 		uint16_t port = SLS_PORT;
 		if(socket->SendTo (packet, 0, InetSocketAddress (dst, port)) != -1) //Vai chamar o RouteOutput
@@ -276,95 +376,157 @@ SlsLocationService::SendQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address quer
 			TypeHeader tHeader (SLS_LOCATION_QUERY);
 			packet->RemoveHeader (tHeader);
 
-			NS_LOG_UNCOND("QSR PEDIDO " << src << " " << query << " Time " << Simulator::Now());
-			NS_LOG_UNCOND("Foi mandado um sls_location_query " << tHeader.Get());
-			NS_LOG_UNCOND("SendQuery " << src << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
+			GPSR_ANALYSIS ("QSR PEDIDO " << src << " " << query << " Time " << Simulator::Now());
+			GPSR_LOG_DEBUG ("Foi mandado um sls_location_query " << tHeader.Get());
+			GPSR_ANALYSIS ("SendQuery " << src << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
+			if (!m_eventCallback.IsNull ())
+			{
+				m_eventCallback (GpsrEvent (GPSR_EVENT_QUERY, packet->GetUid (), src, query, Vector (), 0));
+			}
 		}
 		else
-		{ NS_LOG_UNCOND("Error Sendquery");}
+		{ NS_LOG_WARN("Error Sendquery");}
 	}
 
 }
 
-Vector
-SlsLocationService::RSUSearch(Ipv4Address adr)
+SlsBatch &
+SlsLocationService::GetBatch(Ipv4Address dst)
 {
-	uint32_t n = NodeList().GetNNodes ();
-	uint32_t i;
-	Ptr<Node> node;
-	Vector position;
-	int speed;
-	Time timeOld;
-	//Vector inVec = GetInvalidPosition();
-
-	NS_LOG_UNCOND("::RSUSEARCH:: Obtaining position of " << adr);
-
-	for(i = 0; i < n; i++)
+	PendingBatch &pending = m_batches[dst];
+	if(!pending.flush.IsRunning())
 	{
-		node = NodeList().GetNode (i);
-		Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+		pending.flush = Simulator::Schedule(m_batchWindow, &SlsLocationService::FlushBatch, this, dst);
+	}
+	return pending.messages;
+}
 
-		//NS_LOG_UNCOND("Have " << ipv4->GetAddress (1, 0).GetLocal ());
-		if(ipv4->GetAddress (1, 0).GetLocal ().IsEqual("10.0.0.1") || ipv4->GetAddress (1, 0).GetLocal ().IsEqual("10.0.0.2")
-				|| ipv4->GetAddress (1, 0).GetLocal ().IsEqual("10.0.0.3"))
+void
+SlsLocationService::FlushBatch(Ipv4Address dst)
+{
+	std::map<Ipv4Address, PendingBatch>::iterator i = m_batches.find(dst);
+	NS_ASSERT(i != m_batches.end());
+	SlsBatch batch = i->second.messages;
+	m_batches.erase(i);
+
+	Ptr<Packet> packet = batch.ToPacket();
+	GPSR_LOG_DEBUG ("FlushBatch to " << dst << ": " << batch.GetUpdates().size() << " updates, "
+			<< batch.GetQueries().size() << " queries, " << batch.GetReplies().size() << " replies");
+	for (std::map<Ptr<Socket> , Ipv4InterfaceAddress>::const_iterator j =
+			m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
+	{
+		Ptr<Socket> socket = j->first;
+		m_controlBytesSent += batch.GetUpdateSize ();
+		if(socket->SendTo (packet->Copy (), 0, InetSocketAddress (dst, SLS_PORT)) == -1)
 		{
-			//pos = (*node->GetObject<SlsLocationService>()).GetPosition(adr);
-			Ptr<SlsLocationService> LS = (*node->GetObject<RoutingProtocol>()).GetLS();
-			position = LS->GetPosition(adr);
-
-			if(!VectorComparator(position, GetInvalidPosition()))
+			NS_LOG_WARN("Error FlushBatch");
+			continue;
+		}
+		// each query and reply is reported as if it had its own packet
+		for (std::vector<LocQueryHeader>::const_iterator q = batch.GetQueries().begin(); q != batch.GetQueries().end(); ++q)
+		{
+			GPSR_ANALYSIS ("SendQuery " << q->GetNodeID() << " " << q->GetQueryID() << " " << Simulator::Now() << " " << packet->GetUid());
+			if (!m_eventCallback.IsNull ())
 			{
-				NS_LOG_UNCOND("::RSUSEARCH:: Position find is " << position << " from RSU "
-						<< ipv4->GetAddress (1, 0).GetLocal ());
+				m_eventCallback (GpsrEvent (GPSR_EVENT_QUERY, packet->GetUid (), q->GetNodeID (), q->GetQueryID (), Vector (), 0));
+			}
+		}
+		for (std::vector<LocReplyHeader>::const_iterator r = batch.GetReplies().begin(); r != batch.GetReplies().end(); ++r)
+		{
+			GPSR_ANALYSIS ("SendReply " << dst << " " << r->GetDestID() << " " << Simulator::Now() << " " << packet->GetUid());
+		}
+	}
+}
 
-				//Predict Phase
-				speed = LS->GetSpeed(adr);
-				timeOld = LS->GetTime(adr);
-				Time timeNow = Simulator::Now();
+void
+SlsLocationService::SetFunction(bool f)
+{
+	m_function = f;
+	GPSR_LOG_DEBUG ("Node " << m_ipv4 << " is " << f );
+}
 
-				int dif = (timeNow.GetInteger()/1000000000)-(timeOld.GetInteger()/1000000000);
-				int meters = speed * dif;
+void
+SlsLocationService::SetMRsu(Ipv4Address rsu)
+{
+	if(rsu != m_rsu)
+	{
+		// the new RSU knows nothing of this OBU
+		m_reported.Clear();
+	}
+	m_rsu = rsu;
+}
 
-				NS_LOG_UNCOND("dif " << dif << " meters " << meters << " speed " << speed << " timeOld " << timeOld
-						<< " timeNow " << timeNow);
+Vector
+SlsLocationService::RSUSearch(Ipv4Address adr)
+{
+	GPSR_LOG_DEBUG ("::RSUSEARCH:: Obtaining position of " << adr);
 
-				Vector newpos (position.x + meters, position.y,position.z);
+	std::vector<Ipv4Address> rsus = RsuDirectory::GetRsus();
+	for(std::vector<Ipv4Address>::const_iterator i = rsus.begin(); i != rsus.end(); ++i)
+	{
+		Ptr<Node> node = LocationIndex::GetNode(*i);
+		Ptr<RoutingProtocol> routing = node == 0 ? 0 : node->GetObject<RoutingProtocol> ();
+		if(routing == 0)
+		{
+			continue;
+		}
+		// already predicted to now by the RSU's table
+		Vector position = routing->GetLS()->GetPosition(adr);
+		if(!VectorComparator(position, GetInvalidPosition()))
+		{
+			GPSR_LOG_DEBUG ("::RSUSEARCH:: Position find is " << position << " from RSU " << *i);
+			return position;
+		}
+	}
+	return GetInvalidPosition();
+}
 
-				NS_LOG_UNCOND("::RSUSEARCH:: Position predicted is " << newpos);
+void
+SlsLocationService::SetDirectory(Ptr<RsuDirectory> directory)
+{
+	m_directory = directory;
+	m_directory->SetAnswerCallback (MakeCallback (&SlsLocationService::DirectoryAnswer, this));
+}
 
-				return newpos;
-			}
-		}
+void
+SlsLocationService::DirectoryAnswer(Ipv4Address requester, Ipv4Address vehicle, bool found, const DirectoryRecord &record)
+{
+	Vector position = GetInvalidPosition();
+	if(found)
+	{
+		KinematicState state (record.position, record.velocity, record.updated);
+		position = m_predictor->Predict(vehicle, state, Simulator::Now());
+		GPSR_LOG_DEBUG ("Directory position of " << vehicle << " is " << record.position << " predicted " << position);
 	}
-	return position;
+	SendReply(m_ipv4->GetAddress (1, 0).GetLocal (), requester, vehicle, position);
 }
 
 
 void
 SlsLocationService::ReceiveQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address query)
 {
-	NS_LOG_UNCOND ("Chamado ReceiveQuery " << src << " to " << dst << " with query:" << query << " time " << Simulator::Now());
+	GPSR_LOG_DEBUG ("Chamado ReceiveQuery " << src << " to " << dst << " with query:" << query << " time " << Simulator::Now());
 
 	m_table.Purge();
 
 	Vector pos = m_table.GetPosition(query, GetInvalidPosition());
-	NS_LOG_UNCOND("Pos returned " << pos);
+	GPSR_LOG_DEBUG ("Pos returned " << pos);
 
 	if(VectorComparator(pos, GetInvalidPosition()))
 	{
-		NS_LOG_UNCOND("RSU nao sabe posicao e vai consultar outras");
-
+		GPSR_LOG_DEBUG ("RSU nao sabe posicao e vai consultar outras");
+		if(m_directory)
+		{
+			m_directory->Lookup(query, src);
+			return;
+		}
 		pos = RSUSearch(query);
-		NS_LOG_UNCOND("RSU já sabe posição " << pos);
-		Vector posGOD = GODPredict(query);
-		NS_LOG_UNCOND("Com o GODPredict dava " << posGOD);
+		GPSR_LOG_DEBUG ("RSU já sabe posição " << pos);
 	}
 	else
 	{
-		Vector posGOD = GODPredict(query);
-		Vector pos = Predict(query);
-		NS_LOG_UNCOND("ReceiveQuery vai fazer um SendReply com pos by predict = " << pos);
-		NS_LOG_UNCOND("Com o GODPredict dava " << posGOD);
+		pos = Predict(query);
+		NS_LOG_INFO("ReceiveQuery vai fazer um SendReply com pos by predict = " << pos);
 	}
 
 	SendReply(dst, src,query, pos);
@@ -376,24 +538,37 @@ SlsLocationService::ReceiveQuery(Ipv4Address src, Ipv4Address dst, Ipv4Address q
 void
 SlsLocationService::ReceiveReply(Ipv4Address src, Ipv4Address dst, Vector position)
 {
-	NS_LOG_UNCOND("RECEIVEREPLY " << src << " " << dst << " " << position);
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_LOG_DEBUG ("RECEIVEREPLY " << src << " " << dst << " " << position);
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
 
 	m_table.DeleteEntry(dst);
 	m_table.AddEntry(dst, position, 0, false, 0);
-	NS_LOG_UNCOND("QSR RESPOSTA " << dst << " " << src << " Time " << Simulator::Now());
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
-	Vector posGOD = GODPredict(dst);
-	NS_LOG_UNCOND("Precision " << dst << " SLSPOS " << position << " " << " GODPOS " << posGOD);
-	NS_LOG_UNCOND("ReceiveReply " << " dst " << dst << " RSU " << src << " position " << position << " Time " << Simulator::Now());
+	GPSR_ANALYSIS ("QSR RESPOSTA " << dst << " " << src << " Time " << Simulator::Now());
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_ANALYSIS ("Precision " << dst << " SLSPOS " << position << " " << " GODPOS " << GODPredict(dst));
+	if (!m_eventCallback.IsNull ())
+	{
+		double error = CalculateDistance (position, GODPredict(dst));
+		m_eventCallback (GpsrEvent (GPSR_EVENT_REPLY, 0, src, dst, position, error));
+	}
+	GPSR_ANALYSIS ("ReceiveReply " << " dst " << dst << " RSU " << src << " position " << position << " Time " << Simulator::Now());
+	if (!m_positionCallback.IsNull ())
+	{
+		m_positionCallback (dst);
+	}
 
 }
 
 void
 SlsLocationService::SendReply(Ipv4Address src, Ipv4Address dst, Ipv4Address query, Vector position)
 {
-	NS_LOG_UNCOND("SENDREPLY");
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_LOG_LOGIC ("SENDREPLY");
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
+	if(m_batchWindow > Seconds (0))
+	{
+		GetBatch(dst).AddReply(LocReplyHeader(src, query, position.x, position.y));
+		return;
+	}
 
 	for (std::map<Ptr<Socket> , Ipv4InterfaceAddress>::const_iterator j =
 				m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -411,12 +586,12 @@ SlsLocationService::SendReply(Ipv4Address src, Ipv4Address dst, Ipv4Address quer
 			TypeHeader tHeader (SLS_LOCATION_REPLY);
 			packet->RemoveHeader (tHeader);
 
-			NS_LOG_UNCOND("Foi mandado um sls_location_reply " << tHeader.Get());
-			NS_LOG_UNCOND("SendReply " << dst << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
+			GPSR_LOG_DEBUG ("Foi mandado um sls_location_reply " << tHeader.Get());
+			GPSR_ANALYSIS ("SendReply " << dst << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
 
 		}
 		else
-		{ NS_LOG_UNCOND("Error Sendreply");}
+		{ NS_LOG_WARN("Error Sendreply");}
 	}
 
 }
@@ -424,7 +599,7 @@ SlsLocationService::SendReply(Ipv4Address src, Ipv4Address dst, Ipv4Address quer
 void
 SlsLocationService::Print()
 {
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
 }
 
 void
@@ -468,7 +643,7 @@ SlsLocationService::NotifyAddAddress (uint32_t i, Ipv4InterfaceAddress address)
     }
   else
     {
-      NS_LOG_LOGIC ("RLS does not work with more then one address per each interface. Ignore added address");
+      GPSR_LOG_LOGIC ("RLS does not work with more then one address per each interface. Ignore added address");
     }
 }
 
@@ -497,13 +672,13 @@ SlsLocationService::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress addres
         }
       if (m_socketAddresses.empty ())
         {
-          NS_LOG_LOGIC ("No RLS interfaces");
+          GPSR_LOG_LOGIC ("No RLS interfaces");
           return;
         }
     }
   else
     {
-      NS_LOG_LOGIC ("Remove address not participating in RLS operation");
+      GPSR_LOG_LOGIC ("Remove address not participating in RLS operation");
     }
 }
 
@@ -542,20 +717,20 @@ SlsLocationService::NotifyInterfaceDown (uint32_t i)
   m_socketAddresses.erase (socket);
   if (m_socketAddresses.empty ())
     {
-      NS_LOG_LOGIC ("No  interfaces (RLS)");
+      GPSR_LOG_LOGIC ("No  interfaces (RLS)");
     }
 }
 
 bool
 SlsLocationService::IsInSearch(Ipv4Address id) {
 	//NS_LOG_UNCOND("ISINSEARCH: " << id << " pos " << m_table.GetPosition(id, Vector(-1, -1, 0)) << " flag " << m_table.GetResearchFlag(id));
-	NS_LOG_UNCOND("IsinSearch");
-	m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
-	NS_LOG_UNCOND("ISINSEARCH updateTime " << m_table.GetEntryUpdateTime(id) << " maxTime " << m_maxSearchTime << " timeNOW " << Simulator::Now());
+	GPSR_LOG_LOGIC ("IsinSearch");
+	GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_LOG_DEBUG ("ISINSEARCH updateTime " << m_table.GetEntryUpdateTime(id) << " maxTime " << m_maxSearchTime << " timeNOW " << Simulator::Now());
 
 	if((m_table.GetEntryUpdateTime(id) + m_maxSearchTime) < Simulator::Now())
 	{
-		NS_LOG_UNCOND("ISINSEARCH ERASED");
+		GPSR_LOG_DEBUG ("ISINSEARCH ERASED");
 		m_table.DeleteEntry(id);
 		return false;
 	}
@@ -563,11 +738,11 @@ SlsLocationService::IsInSearch(Ipv4Address id) {
 
 	if(m_table.GetResearchFlag(id))
 	{
-		NS_LOG_UNCOND("Está a procura do " << id);
+		GPSR_LOG_DEBUG ("Está a procura do " << id);
 	}
 	else
 	{
-		NS_LOG_UNCOND("Já não esta a procura do " << id);
+		GPSR_LOG_DEBUG ("Já não esta a procura do " << id);
 	}
 	return m_table.GetResearchFlag(id); }
 
@@ -602,12 +777,12 @@ SlsLocationService::GetPosition(Ipv4Address id)
 	//if((m_table.GetEntryUpdateTime(id) + m_maxSearchTime) < Simulator::Now())
 	if((m_table.GetEntryUpdateTime(id)!=0) && (m_table.GetEntryUpdateTime(id) + Time("10s")) < Simulator::Now())
 	{
-		m_table.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
-		NS_LOG_UNCOND("GetEntryUpdateTime " << m_table.GetEntryUpdateTime(id));
-		NS_LOG_UNCOND("m_maxSearchTime " << m_maxSearchTime);
-		NS_LOG_UNCOND("SimulatorNow " << Simulator::Now());
+		GPSR_PRINT_TABLE (m_table, m_ipv4->GetAddress (1, 0).GetLocal());
+		GPSR_LOG_DEBUG ("GetEntryUpdateTime " << m_table.GetEntryUpdateTime(id));
+		GPSR_LOG_DEBUG ("m_maxSearchTime " << m_maxSearchTime);
+		GPSR_LOG_DEBUG ("SimulatorNow " << Simulator::Now());
 
-		if(id!="10.0.0.1" && id!="10.0.0.2" && id!="10.0.0.3")
+		if(!RsuDirectory::IsRsu(id))
 		{
 			m_table.DeleteEntry(id);
 		}
@@ -615,7 +790,7 @@ SlsLocationService::GetPosition(Ipv4Address id)
 	}
 
 	Ipv4Address sender = m_ipv4->GetAddress (1, 0).GetLocal ();
-	NS_LOG_UNCOND("GetPosition SENDER " << sender << " query to " << id << " e obu? " << GetFunction());
+	GPSR_LOG_DEBUG ("GetPosition SENDER " << sender << " query to " << id << " e obu? " << GetFunction());
 	Vector pos;
 
 	if(GetFunction())
@@ -630,22 +805,29 @@ SlsLocationService::GetPosition(Ipv4Address id)
 
 		if(VectorComparator(pos, GetInvalidPosition()))
 		{
-			m_table.AddEntry(id, pos, 0, true, 1);
-			SendQuery(sender, m_rsu, id);
-			//FIXME TODO SendQuery(sender,m_ipv4->GetAddress(1,0).GetBroadcast(), id);
-			Vector posi = GODPredict(id);
-			NS_LOG_UNCOND("Com o GodPredicti posição dava " << posi);
-			m_table.AddEntry(id, pos, 0, true, 1);
-			pos=m_posrsu;
+			// the entry of a pending query holds the invalid position too
+			if(m_rsu == Ipv4Address())
+			{
+				GPSR_LOG_DEBUG ("No RSU to ask for the position of " << id);
+				return pos;
+			}
+			if(!m_table.GetResearchFlag(id))
+			{
+				m_table.DeleteEntry(id);
+				m_table.AddEntry(id, pos, 0, true, 1);
+				SendQuery(sender, m_rsu, id);
+				//FIXME TODO SendQuery(sender,m_ipv4->GetAddress(1,0).GetBroadcast(), id);
+			}
+			return m_posrsu;
 
 		}
 
-		return pos;
+		return Predict(id);
 	}
 	else
 	{
 		//Sou RSU e vou procurar id
-		pos = m_table.GetPosition(id, GetInvalidPosition());
+		pos = Predict(id);
 	}
 
 	return pos;
@@ -678,12 +860,12 @@ return Vector (-1, -1, 0);
 bool
 SlsLocationService::HasPosition(Ipv4Address  adr){
 
-	NS_LOG_UNCOND("HasPosition " << adr);
+	GPSR_LOG_DEBUG ("HasPosition " << adr);
 
 	if((m_table.GetEntryUpdateTime(adr) + m_maxSearchTime) < Simulator::Now())
 	{
 		m_table.DeleteEntry(adr);
-		NS_LOG_UNCOND("Delete Entry no Hasposition");
+		GPSR_LOG_DEBUG ("Delete Entry no Hasposition");
 		return false;
 	}
 
@@ -691,7 +873,7 @@ SlsLocationService::HasPosition(Ipv4Address  adr){
 
 	//if(VectorComparator(GetPosition(adr, GetInvalidPosition()),GetInvalidPosition())){
 	if(!VectorComparator(pos,GetInvalidPosition())){
-		NS_LOG_UNCOND("Já tem a posicao do " << adr);
+		GPSR_LOG_DEBUG ("Já tem a posicao do " << adr);
 		return true;
 	}
 	return false;
@@ -5,6 +5,10 @@
 #include "ns3/location-service.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "gpsr-ltable.h"
+#include "gpsr-event-log.h"
+#include "gpsr-rsu-directory.h"
+#include "gpsr-packet.h"
+#include "ns3/callback.h"
 #include <map>
 
 
@@ -72,6 +76,11 @@ public:
 		m_table.DeleteEntry(id);
 	}
 
+	/* Directory shared with the other RSUs, which answers the queries
+	 * this RSU has no entry for */
+	void SetDirectory(Ptr<RsuDirectory> directory);
+	/* Reads the tables of the other RSUs, for the RSUs without a
+	 * directory */
 	Vector RSUSearch(Ipv4Address id);
 
 	/*
@@ -136,19 +145,48 @@ public:
 	bool VectorComparator(Vector vec1, Vector vec2){return ((vec1.x == vec2.x) && (vec1.x == vec2.x));}
 
 	/*** Funcoes relativas a se é OBU ou RSU ***/
-	void SetFunction(bool f){
-		m_function = f;
-		NS_LOG_UNCOND("Node " << m_ipv4 << " is " << f );
-	}
+	void SetFunction(bool f);
 	// Funcao que devolve function: RSU or OBU. OBU is equal to true, RSU false
 	bool GetFunction(){return m_function;}
 	Ipv4Address GetMRsu(){ return m_rsu;}
-	void SetMRsu(Ipv4Address rsu){m_rsu = rsu;}
+	void SetMRsu(Ipv4Address rsu);
+
+	/* Adaptive updates: instead of waiting for the RSU to ask, the OBU
+	 * sends an update when the position its RSU predicts drifts from the
+	 * true one by more than distance metres, when its speed changes by more
+	 * than speed m/s or its heading by more than heading radians, or when
+	 * its last update is older than maxInterval */
+	void SetAdaptiveUpdates(bool enabled, double distance, double speed, double heading, Time maxInterval);
+	bool GetAdaptiveUpdates(){ return m_adaptive; }
+	/* Called by the OBU every hello interval. Returns true if an update was sent */
+	bool CheckUpdate();
+	/* True if the RSU view reported, last updated at lastUpdate, is too far
+	 * from the true position and velocity of the OBU */
+	bool NeedsUpdate(const KinematicState &reported, Time lastUpdate, Vector position, Vector velocity);
+
+	/* Bytes of location hellos and updates sent, and bytes of the updates
+	 * that adaptive updates did not send, counting one update per hello
+	 * interval as the reference. UDP payload only. */
+	uint64_t GetControlBytesSent(){ return m_controlBytesSent; }
+	uint64_t GetControlBytesSaved(){ return m_controlBytesSaved; }
+
+	/* The updates, queries and replies sent to the same node within window
+	 * of the first one are coalesced into one packet (see SlsBatch). With a
+	 * zero window each of them is sent at once */
+	void SetBatchWindow(Time window){ m_batchWindow = window; }
+	Time GetBatchWindow(){ return m_batchWindow; }
 
 	void Print();
 	Vector GetMPosRsu(){ return m_posrsu;}
 	void SetMPosRsu(Vector posrsu){m_posrsu = posrsu;}
 
+	/* Callback used to report queries and replies to the routing
+	 * protocol's binary event trace */
+	void SetEventCallback(Callback<void, const GpsrEvent &> cb){ m_eventCallback = cb; }
+	/* Callback invoked with the address of a node whose position was just
+	 * learned, so that packets waiting for it can be released */
+	void SetPositionCallback(Callback<void, Ipv4Address> cb){ m_positionCallback = cb; }
+
 private:
   // Start protocol operation
   void Start ();
@@ -170,6 +208,35 @@ private:
   bool m_function; // Function in the context: If is RSU or OBU. RSU is equal to false, OBU true;
   Ipv4Address m_rsu; //Se nao sei nada, foi à minha RSU. É este o valor dela
   Vector m_posrsu; //Posicao da Rsu so para retornar logo
+  Callback<void, const GpsrEvent &> m_eventCallback;
+  Callback<void, Ipv4Address> m_positionCallback;
+  Ptr<RsuDirectory> m_directory;
+  /* Entry of this OBU in the table of its RSU, as the RSU computed it from
+   * the updates it received */
+  LocationTable m_reported;
+  Time m_lastUpdate;
+  /* RSU: time of the last update received from each OBU */
+  std::map<Ipv4Address, Time> m_updates;
+  bool m_adaptive;
+  double m_distanceThreshold;
+  double m_speedThreshold;
+  double m_headingThreshold;
+  Time m_maxUpdateInterval;
+  uint64_t m_controlBytesSent;
+  uint64_t m_controlBytesSaved;
+  /* Messages waiting for the end of the batch window, per destination */
+  struct PendingBatch
+  {
+    SlsBatch messages;
+    EventId flush;
+  };
+  std::map<Ipv4Address, PendingBatch> m_batches;
+  Time m_batchWindow;
+  // Batch of dst, whose flush is scheduled when it is started
+  SlsBatch & GetBatch (Ipv4Address dst);
+  void FlushBatch (Ipv4Address dst);
+  // Replies to a query with the predicted position of the vehicle
+  void DirectoryAnswer (Ipv4Address requester, Ipv4Address vehicle, bool found, const DirectoryRecord &record);
 };
 
 }
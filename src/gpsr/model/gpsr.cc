@@ -7,8 +7,13 @@
   if (m_ipv4) { std::clog << "[node " << m_ipv4->GetObject<Node> ()->GetId () << "] "; }
 
 #include "gpsr.h"
+#include "gpsr-log.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/location-index.h"
 #include "ns3/random-variable.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/trace-source-accessor.h"
@@ -94,7 +99,19 @@ RoutingProtocol::RoutingProtocol ()
     MaxQueueTime (Seconds (30)),
     m_queue (MaxQueueLen, MaxQueueTime),
     HelloIntervalTimer (Timer::CANCEL_ON_DESTROY),
-    PerimeterMode (false)
+    PerimeterMode (false),
+    m_adaptiveUpdates (false),
+    m_positionThreshold (10),
+    m_speedThreshold (2),
+    m_headingThreshold (0.35),
+    m_maxUpdateInterval (Seconds (4)),
+    m_slsBatchWindow (Seconds (0)),
+    m_beaconFree (false),
+    m_snapshotStaleness (Seconds (1)),
+    m_snapshotRange (250),
+    m_lastSnapshot (Seconds (-1)),
+    m_helloBytesSent (0),
+    m_helloBytesSaved (0)
 {
 
   m_neighbors = PositionTable ();
@@ -120,6 +137,63 @@ RoutingProtocol::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&RoutingProtocol::PerimeterMode),
                    MakeBooleanChecker ())
+    .AddAttribute ("Planarization", "Planar subgraph of the neighbors used in recovery mode",
+                   EnumValue (PLANARIZATION_NONE),
+                   MakeEnumAccessor (&RoutingProtocol::SetPlanarization,
+                                     &RoutingProtocol::GetPlanarization),
+                   MakeEnumChecker (PLANARIZATION_NONE, "None",
+                                    PLANARIZATION_GABRIEL, "Gabriel",
+                                    PLANARIZATION_RNG, "RNG"))
+    .AddAttribute ("Predictor", "Dead reckoning of the positions known to the location service. "
+                   "A predictor given through GpsrHelper::Set is shared by all the nodes.",
+                   PointerValue (),
+                   MakePointerAccessor (&RoutingProtocol::m_predictor),
+                   MakePointerChecker<PositionPredictor> ())
+    .AddAttribute ("AdaptiveUpdates", "Send hellos and SLS location updates only when the position "
+                   "the neighbors and the RSU hold is out of date, instead of every HelloInterval.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_adaptiveUpdates),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PositionThreshold", "With AdaptiveUpdates, distance (m) between the true and the "
+                   "known position of the node that triggers a hello or an SLS update.",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&RoutingProtocol::m_positionThreshold),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("SpeedThreshold", "With AdaptiveUpdates, change of speed (m/s) that triggers an SLS update.",
+                   DoubleValue (2),
+                   MakeDoubleAccessor (&RoutingProtocol::m_speedThreshold),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("HeadingThreshold", "With AdaptiveUpdates, change of heading (rad) that triggers an SLS update.",
+                   DoubleValue (0.35),
+                   MakeDoubleAccessor (&RoutingProtocol::m_headingThreshold),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MaxUpdateInterval", "With AdaptiveUpdates, longest time between two hellos or two SLS updates. "
+                   "Neighbors are kept for MaxUpdateInterval + HelloInterval.",
+                   TimeValue (Seconds (4)),
+                   MakeTimeAccessor (&RoutingProtocol::m_maxUpdateInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("SlsBatchWindow", "SLS updates, queries and replies sent to the same node within this time "
+                   "of the first one travel in one packet. Zero sends each of them at once.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_slsBatchWindow),
+                   MakeTimeChecker ())
+    .AddAttribute ("BeaconFree", "Take the neighbors from a snapshot of the positions of all the vehicles "
+                   "(see PositionSnapshot) instead of exchanging hellos. RSUs send their location hellos "
+                   "to the vehicles of the snapshot instead of the vehicles they hear.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_beaconFree),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SnapshotStaleness", "With BeaconFree, age after which the position snapshot is taken again. "
+                   "Neighbors are kept for twice this time.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&RoutingProtocol::m_snapshotStaleness),
+                   MakeTimeChecker ())
+    .AddAttribute ("SnapshotRange", "With BeaconFree, distance (m) within which the vehicles of the snapshot are neighbors.",
+                   DoubleValue (250),
+                   MakeDoubleAccessor (&RoutingProtocol::m_snapshotRange),
+                   MakeDoubleChecker<double> (0))
+    .AddTraceSource ("Event", "Compact record of a transmission, reception, forwarding decision or location query.",
+                     MakeTraceSourceAccessor (&RoutingProtocol::m_eventTrace))
   ;
   return tid;
 }
@@ -132,6 +206,12 @@ void
 RoutingProtocol::DoDispose ()
 {
   m_ipv4 = 0;
+  for (std::map<Ipv4Address, EventId>::iterator i = m_queueTimeouts.begin (); i != m_queueTimeouts.end (); ++i)
+    {
+      i->second.Cancel ();
+    }
+  m_queueTimeouts.clear ();
+  m_predictor = 0;
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -147,32 +227,47 @@ RoutingProtocol::SetLS (Ptr<SlsLocationService> locationService)
   m_locationService = locationService;
 }
 
+void
+RoutingProtocol::SetPlanarization (enum Planarization planarization)
+{
+  m_neighbors.SetPlanarization (planarization);
+}
+
+enum Planarization
+RoutingProtocol::GetPlanarization (void) const
+{
+  return m_neighbors.GetPlanarization ();
+}
+
 
 bool RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
                                   UnicastForwardCallback ucb, MulticastForwardCallback mcb,
                                   LocalDeliverCallback lcb, ErrorCallback ecb)
 {
-	NS_LOG_UNCOND("RouteInput from " << m_ipv4->GetAddress(1,0).GetLocal() << " do "
+	GPSR_LOG_DEBUG ("RouteInput from " << m_ipv4->GetAddress(1,0).GetLocal() << " do "
 			<< header.GetSource () << " do pacote " << p->GetUid());
 //	Ptr<Packet>  packet = p->Copy();
 //	TypeHeader tHeader (GPSRTYPE_HELLO);
 //	packet->RemoveHeader (tHeader);
 
-	m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
 //
 //	NS_LOG_UNCOND("RouteInput " << tHeader.Get());
 
 	NS_LOG_FUNCTION (this << p->GetUid () << header.GetDestination () << idev->GetAddress ());
 
-	NS_LOG_UNCOND("Adicionada entrada da RSU " << m_locationService->GetMRsu());
-	m_neighbors.AddEntry(m_locationService->GetMRsu(), m_locationService->GetMPosRsu());
-	m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	// no RSU is known until the first location hello
+	if(m_locationService->GetMRsu() != Ipv4Address())
+	{
+		GPSR_LOG_DEBUG ("Adicionada entrada da RSU " << m_locationService->GetMRsu());
+		m_neighbors.AddEntry(m_locationService->GetMRsu(), m_locationService->GetMPosRsu());
+	}
+	UpdateNeighbors ();
 	m_neighbors.Purge((m_ipv4->GetObject<MobilityModel>())->GetPosition(), m_locationService->GetFunction());
-	m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
 
 	if (m_socketAddresses.empty ())
 	{
-		NS_LOG_LOGIC ("No gpsr interfaces");
+		GPSR_LOG_LOGIC ("No gpsr interfaces");
 		return false;
 	}
 	NS_ASSERT (m_ipv4 != 0);
@@ -188,7 +283,7 @@ bool RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
   DeferredRouteOutputTag tag; //FIXME since I have to check if it's in origin for it to work it means I'm not taking some tag out...
   if (p->PeekPacketTag (tag) && IsMyOwnAddress (origin))
     {
-	  NS_LOG_UNCOND("tag no routeinput");
+	  GPSR_LOG_DEBUG ("tag no routeinput");
       Ptr<Packet> packet = p->Copy (); //FIXME ja estou a abusar de tirar tags
       packet->RemovePacketTag(tag);
       DeferredRouteOutput (packet, header, ucb, ecb);
@@ -203,26 +298,29 @@ bool RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
       packet->RemoveHeader (tHeader);
       if (!tHeader.IsValid ())
         {
-          NS_LOG_DEBUG ("GPSR message " << packet->GetUid () << " with unknown type received: " << tHeader.Get () << ". Ignored");
+          GPSR_LOG_DEBUG ("GPSR message " << packet->GetUid () << " with unknown type received: " << tHeader.Get () << ". Ignored");
           return false;
         }
       
       if (tHeader.Get () == GPSRTYPE_POS)
         {
           PositionHeader phdr;
+          phdr.SetVersion (tHeader.GetVersion ());
           packet->RemoveHeader (phdr);
         }
 
 
       if (dst != m_ipv4->GetAddress (1, 0).GetBroadcast ())
         {
-          NS_LOG_LOGIC ("Unicast local delivery to " << dst << " from " << origin);
-      	NS_LOG_UNCOND("AEED: " << origin << " " << dst << " " << "RX Packet " << p->GetUid() << " " << p->GetSize() << " Time " << Simulator::Now());
+          GPSR_LOG_LOGIC ("Unicast local delivery to " << dst << " from " << origin);
+      	GPSR_ANALYSIS ("AEED: " << origin << " " << dst << " " << "RX Packet " << p->GetUid() << " " << p->GetSize() << " Time " << Simulator::Now());
+          NotifyEvent (GpsrEvent (GPSR_EVENT_RX, p->GetUid (), origin, dst,
+                                  m_ipv4->GetObject<MobilityModel> ()->GetPosition (), p->GetSize ()));
 
         }
       else
         {
-          NS_LOG_LOGIC ("Broadcast local delivery to " << dst);
+          GPSR_LOG_LOGIC ("Broadcast local delivery to " << dst);
         }
 
       lcb (packet, header, iif);
@@ -241,62 +339,56 @@ RoutingProtocol::DeferredRouteOutput (Ptr<const Packet> p, const Ipv4Header & he
   NS_LOG_FUNCTION (this << p << header);
   NS_ASSERT (p != 0 && p != Ptr<Packet> ());
 
-  if (m_queue.GetSize () == 0)
-    {
-      CheckQueueTimer.Cancel ();
-      CheckQueueTimer.Schedule (Time ("500ms"));
-    }
-
   QueueEntry newEntry (p, header, ucb, ecb);
   bool result = m_queue.Enqueue (newEntry);
 
-  m_queuedAddresses.insert (m_queuedAddresses.begin (), header.GetDestination ());
-  m_queuedAddresses.unique ();
+  // The reply may have arrived while the packet was looping back, so check
+  // the destination once now; after that the queue is released by the
+  // location service callback or by the search timeout.
+  Ipv4Address dst = header.GetDestination ();
+  if (result && !m_queueTimeouts[dst].IsRunning ())
+    {
+      m_queueTimeouts[dst] = Simulator::ScheduleNow (&RoutingProtocol::ReleaseQueue, this, dst);
+    }
 
   if (result)
     {
-      NS_LOG_LOGIC ("Add packet " << p->GetUid () << " to queue. Protocol " << (uint16_t) header.GetProtocol ());
+      GPSR_LOG_LOGIC ("Add packet " << p->GetUid () << " to queue. Protocol " << (uint16_t) header.GetProtocol ());
 
     }
 
 }
 
 void
-RoutingProtocol::CheckQueue ()
+RoutingProtocol::ReleaseQueue (Ipv4Address dst)
 {
-	NS_LOG_UNCOND("CheckQueue");
-
-  CheckQueueTimer.Cancel ();
-
-  std::list<Ipv4Address> toRemove;
-
-  for (std::list<Ipv4Address>::iterator i = m_queuedAddresses.begin (); i != m_queuedAddresses.end (); ++i)
+  NS_LOG_FUNCTION (this << dst);
+  std::map<Ipv4Address, EventId>::iterator timeout = m_queueTimeouts.find (dst);
+  if (timeout != m_queueTimeouts.end ())
     {
-
-      if (SendPacketFromQueue (*i))
-        {
-          //Insert in a list to remove later
-          toRemove.insert (toRemove.begin (), *i);
-        }
+      timeout->second.Cancel ();
     }
 
-  //remove all that are on the list
-  for (std::list<Ipv4Address>::iterator i = toRemove.begin (); i != toRemove.end (); ++i)
+  if (!m_queue.Find (dst) || SendPacketFromQueue (dst))
     {
-      m_queuedAddresses.remove (*i);
+      if (timeout != m_queueTimeouts.end ())
+        {
+          m_queueTimeouts.erase (timeout);
+        }
+      return;
     }
 
-  if (!m_queuedAddresses.empty ()) //Only need to schedule if the queue is not empty
-    {
-      CheckQueueTimer.Schedule (Time ("500ms"));
-    }
+  // Still searching, check again once the search is due to time out
+  m_queueTimeouts[dst] = Simulator::Schedule (m_locationService->GetMaxSearchTime () + NanoSeconds (1),
+                                              &RoutingProtocol::ReleaseQueue, this, dst);
 }
 
 bool
 RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
 {
-  NS_LOG_UNCOND(this << "SendPacketFromQueue");
+  GPSR_LOG_LOGIC (this << "SendPacketFromQueue");
   NS_LOG_FUNCTION (this);
+  UpdateNeighbors ();
   bool recovery = false;
   QueueEntry queueEntry;
 
@@ -318,25 +410,27 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
 	  return true;
   }
 
-  NS_LOG_UNCOND("FROM QUEUE ");
+  GPSR_LOG_LOGIC ("FROM QUEUE ");
 
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
 
   if (m_locationService->IsInSearch (dst))
   {
-	  NS_LOG_UNCOND("ISINSEARCH freom queue");
+	  GPSR_LOG_DEBUG ("ISINSEARCH freom queue");
 	  return false;
   }
 
   if (!m_locationService->HasPosition (dst)) // Location-service stoped looking for the dst
   {
       m_queue.DropPacketWithDst (dst);
-      NS_LOG_UNCOND("DROPING Packet from QUEUE");
-      NS_LOG_UNCOND ("Location Service did not find dst. Drop packet to " << dst);
+      NS_LOG_WARN("DROPING Packet from QUEUE");
+      NotifyEvent (GpsrEvent (GPSR_EVENT_DROP, 0, m_ipv4->GetAddress (1, 0).GetLocal (), dst,
+                              m_ipv4->GetObject<MobilityModel> ()->GetPosition (), 0));
+      NS_LOG_WARN ("Location Service did not find dst. Drop packet to " << dst);
       return true;
     }
 
-  NS_LOG_UNCOND("I'm Sending");
+  GPSR_LOG_LOGIC ("I'm Sending");
   Vector myPos;
   
   Ptr<MobilityModel> MM = m_ipv4->GetObject<MobilityModel> ();
@@ -353,7 +447,7 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
 	  nextHop = m_neighbors.BestNeighbor (dstPos, myPos);
 	  if (nextHop == Ipv4Address::GetZero ())
 	  {
-		  NS_LOG_LOGIC ("Fallback to recovery-mode. Packets to " << dst);
+		  GPSR_LOG_LOGIC ("Fallback to recovery-mode. Packets to " << dst);
 		  recovery = true;
 	  }
 	  if(recovery)
@@ -369,27 +463,25 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
 			  UnicastForwardCallback ucb = queueEntry.GetUnicastForwardCallback ();
 			  Ipv4Header header = queueEntry.GetIpv4Header ();
 
-			  TypeHeader tHeader (GPSRTYPE_POS);
-			  p->RemoveHeader (tHeader);
-			  if (!tHeader.IsValid ())
+			  DataHeader data;
+			  p->PeekHeader (data);
+			  if (!data.GetType ().IsValid ())
 			  {
-				  NS_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << tHeader.Get () << ". Drop");
+				  GPSR_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << data.GetType ().Get () << ". Drop");
 				  return false;     // drop
 			  }
-			  if (tHeader.Get () == GPSRTYPE_POS)
+			  if (data.GetType ().Get () == GPSRTYPE_POS)
 			  {
-				  PositionHeader hdr;
-				  p->RemoveHeader (hdr);
-				  Position.x = hdr.GetDstPosx ();
-				  Position.y = hdr.GetDstPosy ();
-				  updated = hdr.GetUpdated ();
+				  Position.x = data.GetPosition ().GetDstPosx ();
+				  Position.y = data.GetPosition ().GetDstPosy ();
+				  updated = data.GetPosition ().GetUpdated ();
 			  }
 
-			  PositionHeader posHeader (Position.x, Position.y,  updated, myPos.x, myPos.y, (uint8_t) 1, Position.x, Position.y);
-			  p->AddHeader (posHeader); //enters in recovery with last edge from Dst
-			  p->AddHeader (tHeader);
+			  //enters in recovery with last edge from Dst
+			  data.SetPosition (PositionHeader (Position.x, Position.y,  updated, myPos.x, myPos.y, (uint8_t) 1, Position.x, Position.y));
+			  data.Replace (p);
 
-			  NS_LOG_UNCOND("FROM QUEUE  Recovery pacote " << p->GetUid ());
+			  GPSR_LOG_DEBUG ("FROM QUEUE  Recovery pacote " << p->GetUid ());
 			  RecoveryMode(dst, p, ucb, header);
 		  }
 		  return true;
@@ -400,7 +492,7 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
   route->SetDestination (dst);
   route->SetGateway (nextHop);
 
-  NS_LOG_UNCOND("NextHop is " << nextHop);
+  GPSR_LOG_DEBUG ("NextHop is " << nextHop);
   // FIXME: Does not work for multiple interfaces
   route->SetOutputDevice (m_ipv4->GetNetDevice (1));
 
@@ -420,25 +512,31 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst)
 	  else
 	  {
 		  route->SetSource (header.GetSource ());
-		  NS_LOG_UNCOND("headerdestination " << header.GetDestination());
+		  GPSR_LOG_DEBUG ("headerdestination " << header.GetDestination());
 
 	  }
 
-	  NS_LOG_UNCOND("Chega ao fim do SendPacketFromQueue, ja tendo mandado para ucb, pacote " << p->GetUid ());
+	  GPSR_LOG_DEBUG ("Chega ao fim do SendPacketFromQueue, ja tendo mandado para ucb, pacote " << p->GetUid ());
 
 	  ucb (route, p, header);
 
-	  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+	  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
   }
 
   return true;
 }
 
 
+void
+RoutingProtocol::NotifyEvent (const GpsrEvent &event)
+{
+  m_eventTrace (event);
+}
+
 void 
 RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCallback ucb, Ipv4Header header){
 
-  NS_LOG_UNCOND(this << "RecoveryMode");
+  GPSR_LOG_LOGIC (this << "RecoveryMode");
   Vector Position;
   Vector previousHop;
   uint32_t updated;
@@ -454,18 +552,17 @@ RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCall
   myPos.x = positionX;
   myPos.y = positionY;  
 
-  TypeHeader tHeader (GPSRTYPE_POS);
-  p->RemoveHeader (tHeader);
-  if (!tHeader.IsValid ())
+  DataHeader data;
+  p->PeekHeader (data);
+  if (!data.GetType ().IsValid ())
     {
-      NS_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << tHeader.Get () << ". Drop");
+      GPSR_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << data.GetType ().Get () << ". Drop");
       return;     // drop
     }
-  if (tHeader.Get () == GPSRTYPE_POS)
+  if (data.GetType ().Get () == GPSRTYPE_POS)
     {
-	  NS_LOG_UNCOND("Aqui 4");
-      PositionHeader hdr;
-      p->RemoveHeader (hdr);
+	  GPSR_LOG_LOGIC ("Aqui 4");
+      const PositionHeader &hdr = data.GetPosition ();
       Position.x = hdr.GetDstPosx ();
       Position.y = hdr.GetDstPosy ();
       updated = hdr.GetUpdated (); 
@@ -475,17 +572,16 @@ RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCall
       previousHop.y = hdr.GetLastPosy ();
    }
 
-  NS_LOG_UNCOND("Aqui 5");
-  PositionHeader posHeader (Position.x, Position.y,  updated, recPos.x, recPos.y, (uint8_t) 1, myPos.x, myPos.y); 
-  p->AddHeader (posHeader);
-  p->AddHeader (tHeader);
+  GPSR_LOG_LOGIC ("Aqui 5");
+  data.SetPosition (PositionHeader (Position.x, Position.y,  updated, recPos.x, recPos.y, (uint8_t) 1, myPos.x, myPos.y));
+  data.Replace (p);
 
 
-  NS_LOG_UNCOND("previousHop " << previousHop << " myPos " << myPos);
+  GPSR_LOG_DEBUG ("previousHop " << previousHop << " myPos " << myPos);
 
   Vector newPreviousHop =  m_locationService->GODPredict(dst);
 
-  NS_LOG_UNCOND("New PreviousHop " << newPreviousHop << " my pos " << myPos << " myposGod " << m_locationService
+  GPSR_LOG_DEBUG ("New PreviousHop " << newPreviousHop << " my pos " << myPos << " myposGod " << m_locationService
 		  ->GODPredict(m_ipv4->GetAddress(1,0).GetLocal()));
 
   Ipv4Address nextHop;
@@ -499,7 +595,7 @@ RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCall
       return;
     }
 
-  NS_LOG_UNCOND("Próximo hop " << nextHop);
+  GPSR_LOG_DEBUG ("Próximo hop " << nextHop);
   Ptr<Ipv4Route> route = Create<Ipv4Route> ();
   route->SetDestination (dst);
   route->SetGateway (nextHop);
@@ -508,11 +604,11 @@ RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCall
   route->SetOutputDevice (m_ipv4->GetNetDevice (1));
   route->SetSource (header.GetSource ());
 
-  NS_LOG_UNCOND("NextHop " << nextHop << " Dst " << dst << " src " << header.GetSource() << " " << header.GetDestination());
+  GPSR_LOG_DEBUG ("NextHop " << nextHop << " Dst " << dst << " src " << header.GetSource() << " " << header.GetDestination());
 
   ucb (route, p, header);
 
-  NS_LOG_UNCOND("Fez unicast callback");
+  GPSR_LOG_LOGIC ("Fez unicast callback");
   return;
 }
 
@@ -520,7 +616,7 @@ RoutingProtocol::RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCall
 void
 RoutingProtocol::NotifyInterfaceUp (uint32_t interface)
 {
-	NS_LOG_UNCOND(this << "NotifyInterfaceUp");
+	GPSR_LOG_LOGIC (this << "NotifyInterfaceUp");
 	m_interface = interface;
   NS_LOG_FUNCTION (this << m_ipv4->GetAddress (interface, 0).GetLocal ());
   Ptr<Ipv4L3Protocol> l3 = m_ipv4->GetObject<Ipv4L3Protocol> ();
@@ -533,6 +629,7 @@ RoutingProtocol::NotifyInterfaceUp (uint32_t interface)
     {
       return;
     }
+  LocationIndex::Add (iface.GetLocal (), m_ipv4->GetObject<Node> ());
 
   // Create a socket to listen only on this interface
   Ptr<Socket> socket = Socket::CreateSocket (GetObject<Node> (),
@@ -566,8 +663,8 @@ RoutingProtocol::NotifyInterfaceUp (uint32_t interface)
 void
 RoutingProtocol::RecvGPSR (Ptr<Socket> socket)
 {
-  NS_LOG_UNCOND("Time " << Simulator::Now());
-  NS_LOG_UNCOND(" RECVGPSR CALLED by " << m_locationService->GetFunction());
+  GPSR_LOG_DEBUG ("Time " << Simulator::Now());
+  GPSR_LOG_DEBUG (" RECVGPSR CALLED by " << m_locationService->GetFunction());
   Address sourceAddress;
   Ptr<Packet> packet = socket->RecvFrom (sourceAddress);
   InetSocketAddress inetSourceAddr = InetSocketAddress::ConvertFrom (sourceAddress);
@@ -578,20 +675,92 @@ RoutingProtocol::RecvGPSR (Ptr<Socket> socket)
   packet->RemoveHeader (tHeader);
   if (!tHeader.IsValid ())
   {
-	  NS_LOG_DEBUG ("GPSR message " << packet->GetUid () << " with unknown type received: " << tHeader.Get () << ". Ignored");
+	  GPSR_LOG_DEBUG ("GPSR message " << packet->GetUid () << " with unknown type received: " << tHeader.Get () << ". Ignored");
 	  return;
   }
 
+  if(tHeader.Get () != GPSRTYPE_HELLO && tHeader.Get () != GPSRTYPE_POS)
+  {
+	  // a batched SLS packet holds several messages, each after its type.
+	  // An SLS message never falls through to the Hello Gpsr branch: a
+	  // Location Hello at an RSU or an Update at an OBU used to be read as
+	  // a HelloHeader, whose position was then the node id and half the
+	  // position of the message, and the sender was added at that position.
+	  RecvSlsMessage (packet, tHeader, sender, receiver);
+	  while (packet->GetSize () > 0)
+	  {
+		  packet->RemoveHeader (tHeader);
+		  if (!tHeader.IsValid () || tHeader.Get () == GPSRTYPE_HELLO || tHeader.Get () == GPSRTYPE_POS)
+		  {
+			  GPSR_LOG_DEBUG ("SLS message " << packet->GetUid () << " with unexpected type " << tHeader.Get () << ". Rest ignored");
+			  return;
+		  }
+		  RecvSlsMessage (packet, tHeader, sender, receiver);
+	  }
+	  return;
+  }
+
+//  if(tHeader.Get () == GPSRTYPE_POS)
+//  {
+//	  //Se eu sou OBU
+//	  if(m_locationService->GetFunction())
+//	  {
+//		  NS_LOG_UNCOND("Sou OBU e recebi um HELLO POSITION");
+//	  }
+//	  //Se eu sou RSU
+//	  else
+//	  {
+//		  NS_LOG_UNCOND("Sou RSU e recebi um HELLO POSITION");
+//	  }
+//  }
+
+  {
+
+	  //HELLO GPSR
+	  HelloHeader hdr;
+	  hdr.SetVersion (tHeader.GetVersion ());
+	  packet->RemoveHeader (hdr);
+
+	  Vector Position;
+	  Position.x = hdr.GetOriginPosx ();
+	  Position.y = hdr.GetOriginPosy ();
+
+	  //Se eu sou OBU
+	  if(m_locationService->GetFunction())
+	  {
+		  GPSR_LOG_DEBUG ("****** Sou OBU " << receiver << " e recebi um Hello Gpsr from " << sender << " mas nao vou fazer nada");
+		  UpdateRouteToNeighbor (sender, receiver, Position, 0);
+
+		  return;
+	  }
+	  //Se eu sou RSU
+	  else
+	  {
+		  GPSR_LOG_DEBUG ("****** Sou RSU " << receiver << " e recebi um Hello Gpsr from " << sender);
+		  UpdateRouteToNeighbor (sender, receiver, Position, 0);
+		  m_locationService->SendLocHello(sender, receiver, Position);
+		  return;
+	  }
+  }
+
+}
+
+
+void
+RoutingProtocol::RecvSlsMessage (Ptr<Packet> packet, const TypeHeader &tHeader, Ipv4Address sender, Ipv4Address receiver)
+{
+  // the body is removed whatever the role, the next message follows it
   if(tHeader.Get () == SLS_LOCATION_HELLO)
   {
+	  LocHelloHeader lochello;
+	  lochello.SetVersion (tHeader.GetVersion ());
+	  packet->RemoveHeader(lochello);
+
 	  //Se eu sou OBU
 	  if(m_locationService->GetFunction())
 	  {
-		  NS_LOG_UNCOND("****** Sou OBU " << receiver << " e recebi Location Hello from " << sender);
+		  GPSR_LOG_DEBUG ("****** Sou OBU " << receiver << " e recebi Location Hello from " << sender);
 		  //Nao precisava de fazer updateroute contudo fazendo fica com posicao mais actual
-		  LocHelloHeader lochello;
-		  packet->RemoveHeader(lochello);
-
 		  Vector Position;
 		  Position.x = lochello.GetOriginPosx ();
 		  Position.y = lochello.GetOriginPosy ();
@@ -601,11 +770,11 @@ RoutingProtocol::RecvGPSR (Ptr<Socket> socket)
 
 		  if(sender==rsu)
 		  {
-			  NS_LOG_UNCOND("Continuo na minha rsu " << rsu);
+			  GPSR_LOG_DEBUG ("Continuo na minha rsu " << rsu);
 		  }
 		  else
 		  {
-			 NS_LOG_UNCOND("Sou " << m_ipv4->GetAddress(1,0).GetLocal() << " e vou actualizar m_rsu de " << rsu <<
+			 GPSR_LOG_DEBUG ("Sou " << m_ipv4->GetAddress(1,0).GetLocal() << " e vou actualizar m_rsu de " << rsu <<
 			 //Se vou actualizar RSU entao tenho de apagar entrada na RSU antiga.
 					 " para " << " " << sender << " e m_posrsu " << Position);
 			 m_locationService->DeleteEntry(m_ipv4->GetAddress(1,0).GetLocal());
@@ -614,150 +783,110 @@ RoutingProtocol::RecvGPSR (Ptr<Socket> socket)
 		  }
 
 		  m_locationService->SendLocUpdate(packet,sender, receiver, Position);
-		  return;
 	  }
 	  //Se eu sou RSU
 	  else
 	  {
-		  NS_LOG_UNCOND("****** Sou RSU" << receiver << " e recebi Location Hello");
+		  GPSR_LOG_DEBUG ("****** Sou RSU" << receiver << " e recebi Location Hello, ignorado");
 	  }
-
   }
 
-  if(tHeader.Get () == SLS_LOCATION_UPDATE)
+  else if(tHeader.Get () == SLS_LOCATION_UPDATE)
   {
+	  LocUpdateHeader locupdate;
+	  locupdate.SetVersion (tHeader.GetVersion ());
+	  packet->RemoveHeader(locupdate);
+
 	  //Se eu sou OBU
 	  if(m_locationService->GetFunction())
 	  {
-		  NS_LOG_UNCOND("****** Sou OBU " << receiver << " e recebi um SLS Update from " << sender);
+		  GPSR_LOG_DEBUG ("****** Sou OBU " << receiver << " e recebi um SLS Update from " << sender << ", ignorado");
 	  }
 	  //Se eu sou RSU
 	  else
 	  {
-		  NS_LOG_UNCOND("****** Sou RSU e recebi um SLS Update from " << sender);
-		  //Nao precisava de fazer updateroute contudo fazendo fica com posicao mais actual
-		  LocUpdateHeader locupdate;
-		  packet->RemoveHeader(locupdate);
-
-		  Vector Position;
-		  Position.x = locupdate.GetOriginPosx ();
-		  Position.y = locupdate.GetOriginPosy ();
-
-		  int speed = locupdate.GetSpeed();
-		  NS_LOG_UNCOND("SPEED " << speed);
-		  UpdateRouteToNeighbor(sender, receiver, Position, speed);
-		  m_locationService->ReceiveUpdate(packet,sender, receiver,Position, speed);
-		  return;
+		  GPSR_LOG_DEBUG ("****** Sou RSU e recebi um SLS Update from " << sender << " com " << locupdate.GetNRecords () << " registos");
+		  for (uint32_t i = 0; i < locupdate.GetNRecords (); i++)
+		  {
+			  const LocationRecord &record = locupdate.GetRecord (i);
+			  Vector Position;
+			  Position.x = record.posx;
+			  Position.y = record.posy;
+
+			  int speed = record.speed;
+			  GPSR_LOG_DEBUG ("SPEED " << speed);
+			  //Nao precisava de fazer updateroute contudo fazendo fica com posicao mais actual
+			  if (record.nodeid == sender)
+			  {
+				  UpdateRouteToNeighbor(sender, receiver, Position, speed);
+			  }
+			  m_locationService->ReceiveUpdate(packet, record.nodeid, receiver, Position, speed);
+		  }
 	  }
   }
 
-  if(tHeader.Get () == SLS_LOCATION_QUERY)
+  else if(tHeader.Get () == SLS_LOCATION_QUERY)
   {
-	  NS_LOG_UNCOND("** query");
+	  GPSR_LOG_DEBUG ("** query");
+	  LocQueryHeader locquery;
+	  packet->RemoveHeader(locquery);
+
 	  if(m_locationService->GetFunction())
 	  {
-		  NS_LOG_UNCOND("****** Sou OBU " << receiver << " e recebi um Location Query");
+		  GPSR_LOG_DEBUG ("****** Sou OBU " << receiver << " e recebi um Location Query");
 	  }
 	  //Se eu sou RSU
 	  else
 	  {
-		  NS_LOG_UNCOND("****** Sou RSU " << receiver << " e recebi um Location Query from " << sender);
+		  GPSR_LOG_DEBUG ("****** Sou RSU " << receiver << " e recebi um Location Query from " << sender);
 
-		  LocQueryHeader locquery;
-		  packet->RemoveHeader(locquery);
 		  //m_neighbors.AddEntry(query, Position);
-		  NS_LOG_UNCOND("ReceiveQuery " << sender << " " << locquery.GetQueryID() << " " << Simulator::Now() << " " << packet->GetUid());
+		  GPSR_ANALYSIS ("ReceiveQuery " << sender << " " << locquery.GetQueryID() << " " << Simulator::Now() << " " << packet->GetUid());
 		  m_locationService->ReceiveQuery(sender, receiver, locquery.GetQueryID());
 
 	  }
-
-	  return;
   }
 
-  if(tHeader.Get () == SLS_LOCATION_REPLY)
+  else if(tHeader.Get () == SLS_LOCATION_REPLY)
     {
+  	  LocReplyHeader locreply;
+  	  locreply.SetVersion (tHeader.GetVersion ());
+  	  packet->RemoveHeader(locreply);
+
   	  //Se eu sou OBU
   	  if(m_locationService->GetFunction())
   	  {
-  		  NS_LOG_UNCOND("****** Sou OBU " << receiver << " e recebi um Location Reply from " << sender);
-
-  		  LocReplyHeader locreply;
-  		  packet->RemoveHeader(locreply);
+  		  GPSR_LOG_DEBUG ("****** Sou OBU " << receiver << " e recebi um Location Reply from " << sender);
 
   		  Vector Position;
   		  Position.x = locreply.GetPosx();
   		  Position.y = locreply.GetPosy();
 
-  		  NS_LOG_UNCOND(" -> " << locreply.GetDestID()); //E este que quero
-  		  NS_LOG_UNCOND(" -> " << locreply.GetNodeID());
-  		  NS_LOG_UNCOND("Sender " << sender);
-  		  NS_LOG_UNCOND("Receiver " << receiver);
+  		  GPSR_LOG_DEBUG (" -> " << locreply.GetDestID()); //E este que quero
+  		  GPSR_LOG_DEBUG (" -> " << locreply.GetNodeID());
+  		  GPSR_LOG_DEBUG ("Sender " << sender);
+  		  GPSR_LOG_DEBUG ("Receiver " << receiver);
 
   		  Ipv4Address query = locreply.GetDestID();
   		  //m_neighbors.AddEntry(query, Position);
-  		  NS_LOG_UNCOND("ReceiveReply " << receiver << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
+  		  GPSR_ANALYSIS ("ReceiveReply " << receiver << " " << query << " " << Simulator::Now() << " " << packet->GetUid());
   		  m_locationService->ReceiveReply(sender, query, Position);
 
   	  }
   	  //Se eu sou RSU
   	  else
   	  {
-  		 NS_LOG_UNCOND("****** Sou RSU e recebi um Location Reply");
+  		 GPSR_LOG_DEBUG ("****** Sou RSU e recebi um Location Reply");
   	  }
 
     }
-
-
-//  if(tHeader.Get () == GPSRTYPE_POS)
-//  {
-//	  //Se eu sou OBU
-//	  if(m_locationService->GetFunction())
-//	  {
-//		  NS_LOG_UNCOND("Sou OBU e recebi um HELLO POSITION");
-//	  }
-//	  //Se eu sou RSU
-//	  else
-//	  {
-//		  NS_LOG_UNCOND("Sou RSU e recebi um HELLO POSITION");
-//	  }
-//  }
-
-  else{
-
-	  //HELLO GPSR
-	  HelloHeader hdr;
-	  packet->RemoveHeader (hdr);
-
-	  Vector Position;
-	  Position.x = hdr.GetOriginPosx ();
-	  Position.y = hdr.GetOriginPosy ();
-
-	  //Se eu sou OBU
-	  if(m_locationService->GetFunction())
-	  {
-		  NS_LOG_UNCOND("****** Sou OBU " << receiver << " e recebi um Hello Gpsr from " << sender << " mas nao vou fazer nada");
-		  UpdateRouteToNeighbor (sender, receiver, Position, 0);
-
-		  return;
-	  }
-	  //Se eu sou RSU
-	  else
-	  {
-		  NS_LOG_UNCOND("****** Sou RSU " << receiver << " e recebi um Hello Gpsr from " << sender);
-		  UpdateRouteToNeighbor (sender, receiver, Position, 0);
-		  m_locationService->SendLocHello(sender, receiver, Position);
-		  return;
-	  }
-  }
-
 }
 
-
 void
 RoutingProtocol::UpdateRouteToNeighbor (Ipv4Address sender, Ipv4Address receiver, Vector Pos, int speed)
 {
 	//FIXME Este update tem de levar com a speed, para que o addentry no LS esteja correcto
-	NS_LOG_UNCOND("UpdateRouteToNeighbor " << sender << " " << Pos.x << ":" << Pos.y);
+	GPSR_LOG_DEBUG ("UpdateRouteToNeighbor " << sender << " " << Pos.x << ":" << Pos.y);
 	m_neighbors.AddEntry (sender, Pos);
 
 	if(m_locationService->GetFunction())
@@ -798,7 +927,7 @@ RoutingProtocol::NotifyInterfaceDown (uint32_t interface)
   m_socketAddresses.erase (socket);
   if (m_socketAddresses.empty ())
     {
-      NS_LOG_LOGIC ("No gpsr interfaces");
+      GPSR_LOG_LOGIC ("No gpsr interfaces");
       m_neighbors.Clear ();
       m_locationService->Clear ();
       return;
@@ -809,7 +938,7 @@ RoutingProtocol::NotifyInterfaceDown (uint32_t interface)
 Ptr<Socket>
 RoutingProtocol::FindSocketWithInterfaceAddress (Ipv4InterfaceAddress addr ) const
 {
-  NS_LOG_UNCOND("FindSocketwithInterface");
+  GPSR_LOG_LOGIC ("FindSocketwithInterface");
   NS_LOG_FUNCTION (this << addr);
   for (std::map<Ptr<Socket>, Ipv4InterfaceAddress>::const_iterator j =
          m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -829,9 +958,13 @@ RoutingProtocol::FindSocketWithInterfaceAddress (Ipv4InterfaceAddress addr ) con
 
 void RoutingProtocol::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-	NS_LOG_UNCOND("NotifyAddAddress");
+	GPSR_LOG_LOGIC ("NotifyAddAddress");
 	m_address = address;
   NS_LOG_FUNCTION (this << " interface " << interface << " address " << address);
+  if (address.GetLocal () != Ipv4Address ("127.0.0.1"))
+    {
+      LocationIndex::Add (address.GetLocal (), m_ipv4->GetObject<Node> ());
+    }
   Ptr<Ipv4L3Protocol> l3 = m_ipv4->GetObject<Ipv4L3Protocol> ();
   if (!l3->IsUp (interface))
     {
@@ -863,7 +996,7 @@ void RoutingProtocol::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress
     }
   else
     {
-      NS_LOG_LOGIC ("GPSR does not work with more then one address per each interface. Ignore added address");
+      GPSR_LOG_LOGIC ("GPSR does not work with more then one address per each interface. Ignore added address");
     }
 }
 
@@ -872,6 +1005,8 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
 {
 
   NS_LOG_FUNCTION (this);
+  LocationIndex::Remove (address.GetLocal ());
+  PositionSnapshot::Remove (address.GetLocal ());
   Ptr<Socket> socket = FindSocketWithInterfaceAddress (address);
   if (socket)
     {
@@ -897,7 +1032,7 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
         }
       if (m_socketAddresses.empty ())
         {
-          NS_LOG_LOGIC ("No gpsr interfaces");
+          GPSR_LOG_LOGIC ("No gpsr interfaces");
           m_neighbors.Clear ();
           m_locationService->Clear ();
           return;
@@ -905,7 +1040,7 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
     }
   else
     {
-      NS_LOG_LOGIC ("Remove address not participating in GPSR operation");
+      GPSR_LOG_LOGIC ("Remove address not participating in GPSR operation");
     }
 }
 
@@ -920,25 +1055,112 @@ RoutingProtocol::SetIpv4 (Ptr<Ipv4> ipv4)
   HelloIntervalTimer.SetFunction (&RoutingProtocol::HelloTimerExpire, this);
   HelloIntervalTimer.Schedule (FIRST_JITTER);
 
-  //Schedule only when it has packets on queue
-  CheckQueueTimer.SetFunction (&RoutingProtocol::CheckQueue, this);
-
   Simulator::ScheduleNow (&RoutingProtocol::Start, this);
 }
 
 void
 RoutingProtocol::HelloTimerExpire ()
 {
-	//TODO - Isto podia estar mais "bonito"
-	if(m_address.GetLocal().IsEqual("10.0.0.1")||m_address.GetLocal().IsEqual("10.0.0.2")
-			|| m_address.GetLocal().IsEqual("10.0.0.3"))
-	{}
+	// RSUs do not beacon
+	if(RsuDirectory::IsRsu(m_address.GetLocal()))
+	{
+		// with no hellos to answer, they greet the vehicles of the snapshot
+		if(m_beaconFree)
+		{
+			UpdateNeighbors ();
+			HelloIntervalTimer.Schedule (HelloInterval + JITTER);
+		}
+	}
 	else{
-		SendHello ();
-		HelloIntervalTimer.Cancel ();
-		HelloIntervalTimer.Schedule (HelloInterval + JITTER);
+		if(m_beaconFree)
+		{
+			// the snapshot stands for the hellos
+		}
+		else if(!m_adaptiveUpdates || NeedsHello ())
+		{
+			SendHello ();
+		}
+		else
+		{
+			m_helloBytesSaved += m_socketAddresses.size () * (TypeHeader (GPSRTYPE_HELLO).GetSerializedSize ()
+					+ HelloHeader ().GetSerializedSize ());
+		}
+		if(m_adaptiveUpdates)
+		{
+			m_locationService->CheckUpdate ();
+		}
+		if(!m_beaconFree || m_adaptiveUpdates)
+		{
+			HelloIntervalTimer.Cancel ();
+			HelloIntervalTimer.Schedule (HelloInterval + JITTER);
+		}
 	}
 }
+bool
+RoutingProtocol::NeedsHello ()
+{
+  if (m_helloBytesSent == 0)
+    {
+      return true;
+    }
+  // the next hello would come too late
+  if (Simulator::Now () - m_lastHello + HelloInterval > m_maxUpdateInterval)
+    {
+      return true;
+    }
+  Vector position = m_ipv4->GetObject<MobilityModel> ()->GetPosition ();
+  return CalculateDistance (position, m_lastHelloPosition) > m_positionThreshold;
+}
+
+void
+RoutingProtocol::UpdateNeighbors ()
+{
+  if (!m_beaconFree)
+    {
+      return;
+    }
+  Ipv4Address self = m_ipv4->GetAddress (1, 0).GetLocal ();
+  std::vector<PositionSnapshot::Entry> neighbors;
+  Time time = PositionSnapshot::GetNeighbors (self, m_ipv4->GetObject<MobilityModel> ()->GetPosition (),
+                                              m_snapshotRange, m_snapshotStaleness, neighbors);
+  if (time == m_lastSnapshot)
+    {
+      return;
+    }
+  m_lastSnapshot = time;
+  for (std::vector<PositionSnapshot::Entry>::const_iterator i = neighbors.begin (); i != neighbors.end (); ++i)
+    {
+      // as RecvGPSR does with the hello of the neighbor
+      UpdateRouteToNeighbor (i->address, self, i->position, 0);
+      if (!m_locationService->GetFunction ())
+        {
+          m_locationService->SendLocHello (i->address, self, i->position);
+        }
+    }
+}
+
+uint64_t
+RoutingProtocol::GetControlBytesSent (void) const
+{
+  uint64_t bytes = m_helloBytesSent;
+  if (m_locationService)
+    {
+      bytes += m_locationService->GetControlBytesSent ();
+    }
+  return bytes;
+}
+
+uint64_t
+RoutingProtocol::GetControlBytesSaved (void) const
+{
+  uint64_t bytes = m_helloBytesSaved;
+  if (m_locationService)
+    {
+      bytes += m_locationService->GetControlBytesSaved ();
+    }
+  return bytes;
+}
+
 void
 RoutingProtocol::SendHello ()
 {
@@ -970,15 +1192,18 @@ RoutingProtocol::SendHello ()
         {
           destination = iface.GetBroadcast ();
         }
+      m_helloBytesSent += packet->GetSize ();
       socket->SendTo (packet, 0, InetSocketAddress (destination, GPSR_PORT));
 
     }
+  m_lastHello = Simulator::Now ();
+  m_lastHelloPosition = MM->GetPosition ();
 }
 
 bool
 RoutingProtocol::IsMyOwnAddress (Ipv4Address src)
 {
-	NS_LOG_UNCOND(this << "IsmyOwnAddress");
+	GPSR_LOG_LOGIC (this << "IsmyOwnAddress");
   NS_LOG_FUNCTION (this << src);
   for (std::map<Ptr<Socket>, Ipv4InterfaceAddress>::const_iterator j =
          m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
@@ -999,30 +1224,48 @@ void
 RoutingProtocol::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_queuedAddresses.clear ();
 
   //FIXME ajustar timer, meter valor parametrizavel
   Time tableTime ("5s");
 
   LocationServiceName = GPSR_LS_SLS;//FIXME cheat to use sls only
 
+  if (m_adaptiveUpdates)
+    {
+      // neighbors beacon at least every MaxUpdateInterval, give or take the jitter
+      m_neighbors.SetEntryLifeTime (m_maxUpdateInterval + HelloInterval);
+    }
+
   switch (LocationServiceName)
     {
     case GPSR_LS_GOD:
-      NS_LOG_DEBUG (this << "GodLS in use");
+      GPSR_LOG_DEBUG (this << "GodLS in use");
       //m_locationService = CreateObject<GodLocationService> ();
       break;
     case GPSR_LS_SLS:
-      NS_LOG_UNCOND (this << "SLS in use");
+      GPSR_LOG_DEBUG (this << "SLS in use");
       m_locationService = CreateObject<ns3::gpsr::SlsLocationService> (tableTime);
       m_locationService->SetIpv4(m_ipv4);
+      if (m_predictor)
+        {
+          m_locationService->SetPredictor (m_predictor);
+        }
+      m_locationService->SetEventCallback (MakeCallback (&RoutingProtocol::NotifyEvent, this));
+      m_locationService->SetPositionCallback (MakeCallback (&RoutingProtocol::ReleaseQueue, this));
+      m_locationService->SetAdaptiveUpdates (m_adaptiveUpdates, m_positionThreshold, m_speedThreshold,
+                                             m_headingThreshold, m_maxUpdateInterval);
+      m_locationService->SetBatchWindow (m_slsBatchWindow);
       m_locationService->NotifyInterfaceUp(m_interface);
       m_locationService->NotifyAddAddress(m_interface, m_address);
 
-      if(m_address.GetLocal().IsEqual("10.0.0.1")||m_address.GetLocal().IsEqual("10.0.0.2") || m_address.GetLocal().IsEqual("10.0.0.3"))
+      if(RsuDirectory::IsRsu(m_address.GetLocal()))
       {
     	  //RSU
     	  m_locationService->SetFunction(false);
+    	  if(m_ipv4->GetObject<RsuDirectory> ())
+    	  {
+    		  m_locationService->SetDirectory(m_ipv4->GetObject<RsuDirectory> ());
+    	  }
       }
       else
       {
@@ -1032,12 +1275,24 @@ RoutingProtocol::Start ()
 
       break;
     }
+
+  if (m_beaconFree)
+    {
+      // the vehicles are in the snapshot instead of beaconing, the RSUs never beacon
+      if (m_locationService->GetFunction ())
+        {
+          PositionSnapshot::Add (m_ipv4->GetAddress (1, 0).GetLocal (), m_ipv4->GetObject<MobilityModel> ());
+        }
+      // neighbors last two snapshots, as they last two hellos
+      m_neighbors.SetEntryLifeTime (m_snapshotStaleness + m_snapshotStaleness);
+    }
+
   Vector myPos;
     Ptr<MobilityModel> MM = m_ipv4->GetObject<MobilityModel> ();
     myPos.x = MM->GetPosition ().x;
     myPos.y = MM->GetPosition ().y;
 
-    NS_LOG_UNCOND("Initial Position: " << myPos.x << "," << myPos.y);
+    NS_LOG_INFO("Initial Position: " << myPos.x << "," << myPos.y);
 
 
 }
@@ -1045,8 +1300,8 @@ RoutingProtocol::Start ()
 Ptr<Ipv4Route>
 RoutingProtocol::LoopbackRoute (const Ipv4Header & hdr, Ptr<NetDevice> oif)
 {
-	NS_LOG_UNCOND("LoopbackRoute");
-  NS_LOG_UNCOND (this << hdr);
+	GPSR_LOG_LOGIC ("LoopbackRoute");
+  GPSR_LOG_DEBUG (this << hdr);
   m_lo = m_ipv4->GetNetDevice (0);
   NS_ASSERT (m_lo != 0);
   Ptr<Ipv4Route> rt = Create<Ipv4Route> ();
@@ -1092,13 +1347,10 @@ RoutingProtocol::AddHeaders (Ptr<Packet> p, Ipv4Address source, Ipv4Address dest
 	myPos.x = MM->GetPosition ().x;
 	myPos.y = MM->GetPosition ().y;
 
+	UpdateNeighbors ();
 	m_neighbors.Purge(myPos, m_locationService->GetFunction());
 
-	NS_LOG_UNCOND("AddHeaderssh ");
-	Ptr<Packet> packet = p->Copy ();
-	TypeHeader tHeader1 (GPSRTYPE_HELLO);
-	packet->RemoveHeader (tHeader1);
-	NS_LOG_UNCOND("AddHeaders " << " source " << source << " destination " << destination << " theader " << tHeader1.Get());
+	GPSR_LOG_DEBUG ("AddHeaders " << " source " << source << " destination " << destination);
 
   Ipv4Address nextHop;
 
@@ -1107,10 +1359,9 @@ RoutingProtocol::AddHeaders (Ptr<Packet> p, Ipv4Address source, Ipv4Address dest
   if(destination != m_ipv4->GetAddress (1, 0).GetBroadcast ())
   {
 	  //FIXME NOW
-	  Vector position3 = m_locationService->GODPredict(destination);
 	  position = m_locationService->GetPosition(destination);
 	  //Vector position3 = m_locationService->GetPosition (destination);
-	  NS_LOG_UNCOND("GodPredict " << position3);
+	  GPSR_LOG_DEBUG ("GodPredict " << m_locationService->GODPredict(destination));
   }
   else
   {
@@ -1129,7 +1380,7 @@ RoutingProtocol::AddHeaders (Ptr<Packet> p, Ipv4Address source, Ipv4Address dest
 
     }
 
-  NS_LOG_UNCOND("ADDHEADERS NEXT HOP CHOSEN WAS " << nextHop);
+  GPSR_LOG_DEBUG ("ADDHEADERS NEXT HOP CHOSEN WAS " << nextHop);
 
   uint16_t positionX = 0;
   uint16_t positionY = 0;
@@ -1139,27 +1390,27 @@ RoutingProtocol::AddHeaders (Ptr<Packet> p, Ipv4Address source, Ipv4Address dest
     {
       positionX = position.x;
       positionY = position.y;
-      NS_LOG_UNCOND("Fez GetEntryUpdateTime");
+      GPSR_LOG_LOGIC ("Fez GetEntryUpdateTime");
       hdrTime = (uint32_t) m_locationService->GetEntryUpdateTime (destination).GetSeconds ();
     }
 
   PositionHeader posHeader (positionX, positionY,  hdrTime, (uint64_t) 0,(uint64_t) 0, (uint8_t) 0, myPos.x, myPos.y);
-  NS_LOG_UNCOND("Source " << source << " Dest " << destination << " "
+  GPSR_LOG_DEBUG ("Source " << source << " Dest " << destination << " "
 		  << positionX << " " << positionY << " " << myPos.x << " " << myPos.y);
 
   p->AddHeader (posHeader);
   TypeHeader tHeader (GPSRTYPE_POS);
   p->AddHeader (tHeader);
-  NS_LOG_UNCOND("Adicionou header de posicao");
+  GPSR_LOG_LOGIC ("Adicionou header de posicao");
 
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
 
   m_downTarget (p, source, destination, protocol, route);
-  NS_LOG_UNCOND("Message Sended from " << source << " to " << destination <<
+  GPSR_LOG_DEBUG ("Message Sended from " << source << " to " << destination <<
 		  "nexthop " <<  nextHop << " !!" << " I'm " << m_ipv4->GetAddress (1, 0).GetLocal()
 		  << " myPosition " << myPos);
 
-  NS_LOG_UNCOND("Real position from dst " << m_locationService->GODPredict(destination));
+  GPSR_LOG_DEBUG ("Real position from dst " << m_locationService->GODPredict(destination));
 
   m_locationService->Print();
 }
@@ -1173,10 +1424,11 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
   NS_LOG_FUNCTION (this);
   Ipv4Address dst = header.GetDestination ();
   Ipv4Address origin = header.GetSource ();
-  NS_LOG_UNCOND(this << "Forwarding : Origin " << origin << " destination " << dst);
+  GPSR_LOG_DEBUG (this << "Forwarding : Origin " << origin << " destination " << dst);
 
+  UpdateNeighbors ();
   m_neighbors.Purge ((m_ipv4->GetObject<MobilityModel>())->GetPosition(), m_locationService->GetFunction());
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
   
   m_locationService->Print();
 
@@ -1185,25 +1437,23 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
   Vector RecPosition;
   uint8_t inRec = 0;
 
-  TypeHeader tHeader (GPSRTYPE_POS);
-  PositionHeader hdr;
-  p->RemoveHeader (tHeader);
-  if (!tHeader.IsValid ())
+  DataHeader data;
+  p->PeekHeader (data);
+  PositionHeader &hdr = data.GetPosition ();
+  if (!data.GetType ().IsValid ())
     {
-      NS_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << tHeader.Get () << ". Drop");
+      GPSR_LOG_DEBUG ("GPSR message " << p->GetUid () << " with unknown type received: " << data.GetType ().Get () << ". Drop");
       return false;     // drop
     }
-  if (tHeader.Get () == GPSRTYPE_POS)
+  if (data.GetType ().Get () == GPSRTYPE_POS)
     {
-
-      p->RemoveHeader (hdr);
       Position.x = hdr.GetDstPosx ();
       Position.y = hdr.GetDstPosy ();
       updated = hdr.GetUpdated ();
       RecPosition.x = hdr.GetRecPosx ();
       RecPosition.y = hdr.GetRecPosy ();
       inRec = hdr.GetInRec ();
-      NS_LOG_UNCOND("INREC " << inRec);
+      GPSR_LOG_DEBUG ("INREC " << inRec);
     }
 
   Vector myPos;
@@ -1214,15 +1464,14 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
   if(inRec == 1 && CalculateDistance (myPos, Position) < CalculateDistance (RecPosition, Position)){
     inRec = 0;
     hdr.SetInRec(0);
-  NS_LOG_UNCOND ("No longer in Recovery to " << dst << " in " << myPos);
+  GPSR_LOG_DEBUG ("No longer in Recovery to " << dst << " in " << myPos);
   }
 
-  NS_LOG_UNCOND("INREC " << inRec);
+  GPSR_LOG_DEBUG ("INREC " << inRec);
 
   if(inRec){
-	  NS_LOG_UNCOND("Entra aqui1");
-    p->AddHeader (hdr);
-    p->AddHeader (tHeader); //put headers back so that the RecoveryMode is compatible with Forwarding and SendFromQueue
+	  GPSR_LOG_LOGIC ("Entra aqui1");
+    // the headers are still in the packet, as RecoveryMode expects them
     RecoveryMode (dst, p, ucb, header);
     return true;
   }
@@ -1234,18 +1483,18 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
 	  Position.x = m_locationService->GetPosition (dst).x;
       Position.y = m_locationService->GetPosition (dst).y;
       updated = myUpdated;
-      NS_LOG_UNCOND("Update");
+      GPSR_LOG_LOGIC ("Update");
     }
-  NS_LOG_UNCOND("Entra aqui2");
+  GPSR_LOG_LOGIC ("Entra aqui2");
 
   Ipv4Address nextHop;
 
-  NS_LOG_UNCOND("Forwarding vai chamar bestNeighbor com destino " << Position);
+  GPSR_LOG_DEBUG ("Forwarding vai chamar bestNeighbor com destino " << Position);
 
   if(m_neighbors.isNeighbour (dst))
   {
 	  nextHop = dst;
-	  NS_LOG_UNCOND("Tem de estar aqui");
+	  GPSR_LOG_LOGIC ("Tem de estar aqui");
   }
   else
   {
@@ -1254,9 +1503,8 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
 
   if (nextHop != Ipv4Address::GetZero ())
   {
-	  PositionHeader posHeader (Position.x, Position.y,  updated, (uint64_t) 0, (uint64_t) 0, (uint8_t) 0, myPos.x, myPos.y);
-	  p->AddHeader (posHeader);
-	  p->AddHeader (tHeader);
+	  data.SetPosition (PositionHeader (Position.x, Position.y,  updated, (uint64_t) 0, (uint64_t) 0, (uint8_t) 0, myPos.x, myPos.y));
+	  data.Replace (p);
 
 
 	  Ptr<NetDevice> oif = m_ipv4->GetObject<NetDevice> ();
@@ -1269,34 +1517,35 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
 	  route->SetOutputDevice (m_ipv4->GetNetDevice (1));
 	  route->SetDestination (header.GetDestination ());
 	  NS_ASSERT (route != 0);
-	  NS_LOG_UNCOND ("Exist route to " << route->GetDestination () << " from interface " << route->GetOutputDevice ());
+	  GPSR_LOG_DEBUG ("Exist route to " << route->GetDestination () << " from interface " << route->GetOutputDevice ());
 
 
-	  NS_LOG_UNCOND (route->GetOutputDevice () << " forwarding to " << dst << " from " << origin << " through " << route->GetGateway () << " packet " << p->GetUid ());
+	  GPSR_LOG_DEBUG (route->GetOutputDevice () << " forwarding to " << dst << " from " << origin << " through " << route->GetGateway () << " packet " << p->GetUid ());
+	  NotifyEvent (GpsrEvent (GPSR_EVENT_FORWARD, p->GetUid (), origin, dst, myPos, CalculateDistance (myPos, Position)));
 
 	  ucb (route, p, header);
 	  return true;
   }
 
+  NotifyEvent (GpsrEvent (GPSR_EVENT_RECOVERY, p->GetUid (), origin, dst, myPos, CalculateDistance (myPos, Position)));
   hdr.SetInRec(1);
   hdr.SetRecPosx (myPos.x);
   hdr.SetRecPosy (myPos.y); 
   hdr.SetLastPosx (Position.x); //when entering Recovery, the first edge is the Dst
   hdr.SetLastPosy (Position.y); 
 
-  NS_LOG_UNCOND("No forwarding esta é a posicao do dst " << dst << " Pos: " <<
+  GPSR_LOG_DEBUG ("No forwarding esta é a posicao do dst " << dst << " Pos: " <<
   			  Position.x << ":" << Position.y);
 
-  NS_LOG_UNCOND("posicao real do dst e " << m_locationService->GODPredict(dst));
+  GPSR_LOG_DEBUG ("posicao real do dst e " << m_locationService->GODPredict(dst));
 
-  p->AddHeader (hdr);
-  p->AddHeader (tHeader);
+  data.Replace (p);
   RecoveryMode (dst, p, ucb, header);
 
-  NS_LOG_UNCOND("HDR " << header.GetDestination());
+  GPSR_LOG_DEBUG ("HDR " << header.GetDestination());
 
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
-  NS_LOG_LOGIC ("Entering recovery-mode to " << dst << " in " << m_ipv4->GetAddress (1, 0).GetLocal ());
+  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
+  GPSR_LOG_LOGIC ("Entering recovery-mode to " << dst << " in " << m_ipv4->GetAddress (1, 0).GetLocal ());
   return true;
 }
 
@@ -1305,7 +1554,7 @@ RoutingProtocol::Forwarding (Ptr<const Packet> packet, const Ipv4Header & header
 void
 RoutingProtocol::SetDownTarget (Ipv4L4Protocol::DownTargetCallback callback)
 {
-	NS_LOG_UNCOND(this << "SetDownTarget");
+	GPSR_LOG_LOGIC (this << "SetDownTarget");
   m_downTarget = callback;
 }
 
@@ -1313,7 +1562,7 @@ RoutingProtocol::SetDownTarget (Ipv4L4Protocol::DownTargetCallback callback)
 Ipv4L4Protocol::DownTargetCallback
 RoutingProtocol::GetDownTarget (void) const
 {
-	NS_LOG_UNCOND(this << "GetDownTarget");
+	GPSR_LOG_LOGIC (this << "GetDownTarget");
 	return m_downTarget;
 }
 
@@ -1322,16 +1571,16 @@ Ptr<Ipv4Route>
 RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
                               Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
-  Ptr<Packet>  packet = p->Copy();
-  TypeHeader tHeader (GPSRTYPE_HELLO);
-  packet->RemoveHeader (tHeader);
-
   //Adiciono o M_rsu à tabela de vizinhos para possibilitar a Rsu ser nexthop, pode ser logo limpa depois
-  NS_LOG_UNCOND("Adicionada entrada da RSU " << m_locationService->GetMRsu());
-  m_neighbors.AddEntry(m_locationService->GetMRsu(), m_locationService->GetMPosRsu());
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+  // no RSU is known until the first location hello
+  if (m_locationService->GetMRsu () != Ipv4Address ())
+    {
+      GPSR_LOG_DEBUG ("Adicionada entrada da RSU " << m_locationService->GetMRsu());
+      m_neighbors.AddEntry(m_locationService->GetMRsu(), m_locationService->GetMPosRsu());
+    }
+  UpdateNeighbors ();
   m_neighbors.Purge((m_ipv4->GetObject<MobilityModel>())->GetPosition(), m_locationService->GetFunction());
-  m_neighbors.PrintTable(m_ipv4->GetAddress (1, 0).GetLocal());
+  GPSR_PRINT_TABLE (m_neighbors, m_ipv4->GetAddress (1, 0).GetLocal());
 
   if (!p)
   {
@@ -1340,7 +1589,7 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
   if (m_socketAddresses.empty ())
   {
 	  sockerr = Socket::ERROR_NOROUTETOHOST;
-	  NS_LOG_LOGIC ("No gpsr interfaces");
+	  GPSR_LOG_LOGIC ("No gpsr interfaces");
 	  Ptr<Ipv4Route> route;
 	  return route;
   }
@@ -1349,22 +1598,21 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
   Ptr<Ipv4Route> route = Create<Ipv4Route> ();
   Ipv4Address dst = header.GetDestination ();
 
-  NS_LOG_UNCOND("RouteOutput from " << m_ipv4->GetAddress(1,0).GetLocal() << " destination " << dst << " packet " << p->GetUid() << " Time " << Simulator::Now()) ;
+  GPSR_LOG_DEBUG ("RouteOutput from " << m_ipv4->GetAddress(1,0).GetLocal() << " destination " << dst << " packet " << p->GetUid() << " Time " << Simulator::Now()) ;
 
   Vector dstPos = m_locationService->GetInvalidPosition();
 
   if (!(dst == m_ipv4->GetAddress (1, 0).GetBroadcast ()))
     {
-	  NS_LOG_UNCOND("GetPosition: from " << m_ipv4->GetAddress (1, 0));
+	  GPSR_LOG_DEBUG ("GetPosition: from " << m_ipv4->GetAddress (1, 0));
       //dstPos = m_locationService->GetPosition (dst);
 
 	  //FIXME NOW
-      Vector dstPos1 = m_locationService->GODPredict(dst);
       dstPos = m_locationService->GetPosition(dst);
       //Vector Position3 = m_locationService->GetPosition(dst);
-      NS_LOG_UNCOND("GodPredict" << dstPos1);
+      GPSR_LOG_DEBUG ("GodPredict" << m_locationService->GODPredict(dst));
 
-      NS_LOG_UNCOND("GetPosition retornou para GPSR pos " << dstPos << " do " << dst);
+      GPSR_LOG_DEBUG ("GetPosition retornou para GPSR pos " << dstPos << " do " << dst);
     }
 
   if (CalculateDistance (dstPos, m_locationService->GetInvalidPosition ()) == 0 && dst != m_ipv4->GetAddress (1, 0).GetBroadcast () && m_locationService->IsInSearch (dst))
@@ -1373,23 +1621,33 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
 	  DeferredRouteOutputTag tag;
 	  if (!p->PeekPacketTag (tag))
 	  {
-		  NS_LOG_UNCOND("Adicionou tag");
+		  GPSR_LOG_LOGIC ("Adicionou tag");
 		  p->AddPacketTag (tag);
 	  }
 	  return LoopbackRoute (header, oif);
   }
+  else if (CalculateDistance (dstPos, m_locationService->GetInvalidPosition ()) == 0
+           && dst != m_ipv4->GetAddress (1, 0).GetBroadcast () && !m_neighbors.isNeighbour (dst)
+           && m_locationService->GetFunction () && m_locationService->GetMRsu () == Ipv4Address ())
+    {
+      // a vehicle with no RSU to ask for the position
+      GPSR_LOG_DEBUG ("No position for " << dst << ", no route");
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return Ptr<Ipv4Route> ();
+    }
   else{
-	  NS_LOG_UNCOND("GetPosition deu posicao válida e nao estava inSearch");
+	  GPSR_LOG_DEBUG ("GetPosition deu posicao válida e nao estava inSearch");
   }
 
-  NS_LOG_UNCOND("AEED: " << m_ipv4->GetAddress(1,0).GetLocal() << " " << dst << " " << "TX Packet " << p->GetUid() << " " << p->GetSize() << " Time " << Simulator::Now());
+  GPSR_ANALYSIS ("AEED: " << m_ipv4->GetAddress(1,0).GetLocal() << " " << dst << " " << "TX Packet " << p->GetUid() << " " << p->GetSize() << " Time " << Simulator::Now());
 
-  NS_LOG_UNCOND("UID do pacote " << p->GetUid() << " I'm " << m_ipv4->GetAddress(1,0).GetLocal());
+  GPSR_LOG_DEBUG ("UID do pacote " << p->GetUid() << " I'm " << m_ipv4->GetAddress(1,0).GetLocal());
 
   Vector myPos;
   Ptr<MobilityModel> MM = m_ipv4->GetObject<MobilityModel> ();
   myPos.x = MM->GetPosition ().x;
   myPos.y = MM->GetPosition ().y;  
+  NotifyEvent (GpsrEvent (GPSR_EVENT_TX, p->GetUid (), m_ipv4->GetAddress (1, 0).GetLocal (), dst, myPos, p->GetSize ()));
 
   Ipv4Address nextHop;
 
@@ -1402,11 +1660,11 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
 	  nextHop = m_neighbors.BestNeighbor (dstPos, myPos);
   }
 
-  NS_LOG_UNCOND("BestNeighbor retornou " << nextHop);
+  GPSR_LOG_DEBUG ("BestNeighbor retornou " << nextHop);
 
   if (nextHop != Ipv4Address::GetZero ())
     {
-      NS_LOG_DEBUG ("Destination: " << dst);
+      GPSR_LOG_DEBUG ("Destination: " << dst);
 
       route->SetDestination (dst);
       if (header.GetSource () == Ipv4Address ("102.102.102.102"))
@@ -1421,10 +1679,10 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
       route->SetOutputDevice (m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (route->GetSource ())));
       route->SetDestination (header.GetDestination ());
       NS_ASSERT (route != 0);
-      NS_LOG_DEBUG ("Exist route to " << route->GetDestination () << " from interface " << route->GetSource ());
+      GPSR_LOG_DEBUG ("Exist route to " << route->GetDestination () << " from interface " << route->GetSource ());
       if (oif != 0 && route->GetOutputDevice () != oif)
         {
-          NS_LOG_DEBUG ("Output device doesn't match. Dropped.");
+          GPSR_LOG_DEBUG ("Output device doesn't match. Dropped.");
           sockerr = Socket::ERROR_NOROUTETOHOST;
           return Ptr<Ipv4Route> ();
         }
@@ -21,6 +21,9 @@
 #include "ns3/location-service.h"
 #include "ns3/god.h"
 #include "gpsr-sls.h"
+#include "gpsr-event-log.h"
+#include "gpsr-position-snapshot.h"
+#include "ns3/traced-callback.h"
 
 #include <map>
 #include <complex>
@@ -59,6 +62,8 @@ public:
   virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
   virtual void SetIpv4 (Ptr<Ipv4> ipv4);
   virtual void RecvGPSR (Ptr<Socket> socket);
+  /// Handle one SLS message of a packet and remove its body
+  void RecvSlsMessage (Ptr<Packet> packet, const TypeHeader &tHeader, Ipv4Address sender, Ipv4Address receiver);
   virtual void UpdateRouteToNeighbor (Ipv4Address sender, Ipv4Address receiver, Vector Pos, int speed);
   virtual void SendHello ();
   virtual bool IsMyOwnAddress (Ipv4Address src);
@@ -73,6 +78,9 @@ public:
   Ptr<SlsLocationService> GetLS ();
   void SetLS (Ptr<SlsLocationService> locationService);
 
+  void SetPlanarization (enum Planarization planarization);
+  enum Planarization GetPlanarization (void) const;
+
   /// Broadcast ID
   uint32_t m_requestId;
   /// Request sequence number
@@ -85,6 +93,14 @@ public:
   uint16_t m_rreqCount;
   Time HelloInterval;
 
+  /// Bytes of GPSR hellos, SLS location hellos and SLS updates sent by this node (UDP payload)
+  uint64_t GetControlBytesSent (void) const;
+  /**
+   * Bytes of the hellos and SLS updates that AdaptiveUpdates did not send,
+   * counting one hello and one update per HelloInterval as the reference
+   */
+  uint64_t GetControlBytesSaved (void) const;
+
   void SetDownTarget (Ipv4L4Protocol::DownTargetCallback callback);
   Ipv4L4Protocol::DownTargetCallback GetDownTarget (void) const;
 
@@ -101,6 +117,10 @@ private:
   void DeferredRouteOutput (Ptr<const Packet> p, const Ipv4Header & header, UnicastForwardCallback ucb, ErrorCallback ecb);
   /// If route exists and valid, forward packet.
   void HelloTimerExpire ();
+  /// With AdaptiveUpdates, true if the neighbors need a new hello
+  bool NeedsHello ();
+  /// With BeaconFree, handle the neighbors of a new position snapshot as their hellos would be
+  void UpdateNeighbors ();
 
   /// Queue packet and send route request
   Ptr<Ipv4Route> LoopbackRoute (const Ipv4Header & header, Ptr<NetDevice> oif);
@@ -115,25 +135,54 @@ private:
 //returns true if the IP should be erased from the list (was sent/droped)
   bool SendPacketFromQueue (Ipv4Address dst);
 
-  //Calls SendPacketFromQueue and re-schedules
-  void CheckQueue ();
+  //Calls SendPacketFromQueue for dst, called when the location service learns
+  //the position of dst and when its search times out
+  void ReleaseQueue (Ipv4Address dst);
 
   void RecoveryMode(Ipv4Address dst, Ptr<Packet> p, UnicastForwardCallback ucb, Ipv4Header header);
+
+  /// Fire the Event trace source
+  void NotifyEvent (const GpsrEvent &event);
   
   uint32_t MaxQueueLen;    ///< The maximum number of packets that we allow a routing protocol to buffer.
   Time MaxQueueTime;       ///< The maximum period of time that a routing protocol is allowed to buffer a packet for.
   RequestQueue m_queue;
 
   Timer HelloIntervalTimer;
-  Timer CheckQueueTimer;
   uint8_t LocationServiceName;
   PositionTable m_neighbors;
   bool PerimeterMode;
-  std::list<Ipv4Address> m_queuedAddresses;
+  /// Pending search timeout of each destination with queued packets
+  std::map<Ipv4Address, EventId> m_queueTimeouts;
   Ptr<SlsLocationService> m_locationService;
+  /// Predictor given to the location service, its default one if null
+  Ptr<PositionPredictor> m_predictor;
+
+  /// Send hellos and SLS updates only when the position known to the others is out of date
+  bool m_adaptiveUpdates;
+  double m_positionThreshold;
+  double m_speedThreshold;
+  double m_headingThreshold;
+  Time m_maxUpdateInterval;
+  /// Aggregation window of the SLS messages sent to the same node
+  Time m_slsBatchWindow;
+  /// Take the neighbors from the PositionSnapshot instead of hellos
+  bool m_beaconFree;
+  Time m_snapshotStaleness;
+  double m_snapshotRange;
+  /// Time of the last snapshot the neighbors were taken from
+  Time m_lastSnapshot;
+  /// Time and position of the last hello
+  Time m_lastHello;
+  Vector m_lastHelloPosition;
+  uint64_t m_helloBytesSent;
+  uint64_t m_helloBytesSaved;
 
   Ipv4L4Protocol::DownTargetCallback m_downTarget;
 
+  /// Binary per-packet events (see GpsrEventLog)
+  TracedCallback<const GpsrEvent &> m_eventTrace;
+
 
 
 };
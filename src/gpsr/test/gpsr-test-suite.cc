@@ -21,7 +21,28 @@
 #include "ns3/gpsr-packet.h"
 #include "ns3/gpsr-rqueue.h"
 #include "ns3/gpsr-ptable.h"
+#include "ns3/gpsr-event-log.h"
 #include "ns3/ipv4-route.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/random-variable.h"
+#include "ns3/location-index.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/gpsr-rsu-directory.h"
+#include "ns3/gpsr-position-snapshot.h"
+#include "ns3/gpsr-ltable.h"
+#include "ns3/gpsr-sls.h"
+#include "ns3/gpsr.h"
+#include "ns3/position-predictor.h"
+#include "ns3/gpsr-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/uinteger.h"
+#include <map>
+#include <fstream>
 
 namespace ns3
 {
@@ -76,6 +97,363 @@ NeighborTest::DoRun ()
   NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 20, 0), Vector (30, 30, 0)), Ipv4Address ("1.2.3.10"), "Found correct neighbour in recovery");
 
 }
+//-----------------------------------------------------------------------------
+/// Unit test for the spatial index and the lazy expiration of the position table
+struct NeighborIndexTest : public TestCase
+{
+  NeighborIndexTest () : TestCase ("NeighborIndex") { }
+  virtual void DoRun ();
+  void CheckExpired ();
+
+  PositionTable nb;
+};
+
+void
+NeighborIndexTest::DoRun ()
+{
+  // greedy selection must match an exhaustive search
+  UniformVariable coord (0, 1000);
+  std::map<Ipv4Address, Vector> positions;
+  for (uint32_t i = 1; i <= 50; i++)
+    {
+      Ipv4Address id = Ipv4Address (0x0a000000 + i);
+      Vector pos = Vector (coord.GetValue (), coord.GetValue (), 0);
+      nb.AddEntry (id, pos);
+      positions[id] = pos;
+    }
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      Vector dst = Vector (coord.GetValue (), coord.GetValue (), 0);
+      Vector me = Vector (coord.GetValue (), coord.GetValue (), 0);
+      Ipv4Address expected = Ipv4Address::GetZero ();
+      double best = CalculateDistance (me, dst);
+      for (std::map<Ipv4Address, Vector>::const_iterator i = positions.begin (); i != positions.end (); i++)
+        {
+          if (CalculateDistance (i->second, dst) < best)
+            {
+              best = CalculateDistance (i->second, dst);
+              expected = i->first;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (nb.BestNeighbor (dst, me), expected, "Greedy next hop matches exhaustive search");
+    }
+
+  // distance purge of an OBU keeps the neighbors within 290m on the x axis
+  nb.Clear ();
+  nb.AddEntry (Ipv4Address ("10.0.0.1"), Vector (100, 0, 0));
+  nb.AddEntry (Ipv4Address ("10.0.0.2"), Vector (500, 0, 0));
+  nb.AddEntry (Ipv4Address ("10.0.0.3"), Vector (900, 0, 0));
+  nb.Purge (Vector (500, 0, 0), true);
+  NS_TEST_EXPECT_MSG_EQ (nb.isNeighbour (Ipv4Address ("10.0.0.1")), false, "Neighbor behind purged");
+  NS_TEST_EXPECT_MSG_EQ (nb.isNeighbour (Ipv4Address ("10.0.0.2")), true, "Neighbor in range kept");
+  NS_TEST_EXPECT_MSG_EQ (nb.isNeighbour (Ipv4Address ("10.0.0.3")), false, "Neighbor ahead purged");
+
+  // entries expire 2s after their last update, refreshed ones survive
+  nb.AddEntry (Ipv4Address ("10.0.0.4"), Vector (500, 10, 0));
+  Simulator::Schedule (Seconds (1.5), &PositionTable::AddEntry, &nb, Ipv4Address ("10.0.0.4"), Vector (510, 10, 0));
+  Simulator::Schedule (Seconds (2.5), &NeighborIndexTest::CheckExpired, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+NeighborIndexTest::CheckExpired ()
+{
+  NS_TEST_EXPECT_MSG_EQ (nb.isNeighbour (Ipv4Address ("10.0.0.2")), false, "Neighbor expired");
+  NS_TEST_EXPECT_MSG_EQ (nb.isNeighbour (Ipv4Address ("10.0.0.4")), true, "Refreshed neighbor kept");
+  NS_TEST_EXPECT_MSG_EQ (nb.GetPosition (Ipv4Address ("10.0.0.4")).x, 510, "Refreshed position");
+  NS_TEST_EXPECT_MSG_EQ (nb.BestNeighbor (Vector (600, 10, 0), Vector (400, 10, 0)), Ipv4Address ("10.0.0.4"), "Expired neighbor not selected");
+}
+//-----------------------------------------------------------------------------
+/// Unit test for the perimeter mode next hop selection
+struct PerimeterTest : public TestCase
+{
+  PerimeterTest () : TestCase ("Perimeter") { }
+  virtual void DoRun ();
+};
+
+void
+PerimeterTest::DoRun ()
+{
+  // right hand rule must match the smallest angle computed by GetAngle,
+  // both on the first query from a position and on the following ones
+  PositionTable nb;
+  UniformVariable coord (0, 500);
+  for (uint32_t i = 1; i <= 30; i++)
+    {
+      nb.AddEntry (Ipv4Address (0x0a000000 + i), Vector (coord.GetValue (), coord.GetValue (), 0));
+    }
+  Vector me = Vector (250, 250, 0);
+  for (uint32_t k = 0; k < 20; k++)
+    {
+      Vector previousHop = Vector (coord.GetValue (), coord.GetValue (), 0);
+      Ipv4Address expected = Ipv4Address::GetZero ();
+      double best = 360;
+      for (uint32_t i = 1; i <= 30; i++)
+        {
+          Ipv4Address id = Ipv4Address (0x0a000000 + i);
+          double angle = nb.GetAngle (me, previousHop, nb.GetPosition (id));
+          if (angle != 0 && angle < best)
+            {
+              best = angle;
+              expected = id;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (previousHop, me), expected, "Right hand rule successor");
+      NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (previousHop, me), expected, "Right hand rule successor from sorted bearings");
+    }
+
+  // B lies inside the circle of diameter A, and inside the lune of A
+  nb.Clear ();
+  nb.AddEntry (Ipv4Address ("10.0.0.1"), Vector (10, 0, 0));
+  nb.AddEntry (Ipv4Address ("10.0.0.2"), Vector (5, 1, 0));
+  NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 1, 0), Vector (0, 0, 0)), Ipv4Address ("10.0.0.1"), "Non planar edge used");
+  nb.SetPlanarization (PLANARIZATION_GABRIEL);
+  NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 1, 0), Vector (0, 0, 0)), Ipv4Address ("10.0.0.2"), "Edge removed from the Gabriel graph");
+  nb.SetPlanarization (PLANARIZATION_RNG);
+  NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 1, 0), Vector (0, 0, 0)), Ipv4Address ("10.0.0.2"), "Edge removed from the RNG");
+
+  // C is outside the circle of diameter A but inside its lune
+  nb.Clear ();
+  nb.AddEntry (Ipv4Address ("10.0.0.1"), Vector (10, 0, 0));
+  nb.AddEntry (Ipv4Address ("10.0.0.3"), Vector (5, 6, 0));
+  nb.SetPlanarization (PLANARIZATION_GABRIEL);
+  NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 1, 0), Vector (0, 0, 0)), Ipv4Address ("10.0.0.1"), "Edge kept in the Gabriel graph");
+  nb.SetPlanarization (PLANARIZATION_RNG);
+  NS_TEST_EXPECT_MSG_EQ (nb.BestAngle (Vector (10, 1, 0), Vector (0, 0, 0)), Ipv4Address ("10.0.0.3"), "Edge removed from the RNG");
+}
+//-----------------------------------------------------------------------------
+/// Unit test for the address index of the location services
+struct LocationIndexTest : public TestCase
+{
+  LocationIndexTest () : TestCase ("LocationIndex") { }
+  virtual void DoRun ();
+};
+
+void
+LocationIndexTest::DoRun ()
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (10, 20, 0));
+  LocationIndex::Add (Ipv4Address ("10.0.0.7"), node);
+  // mobility aggregated after the address was registered
+  node->AggregateObject (mobility);
+
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetNode (Ipv4Address ("10.0.0.7")), node, "Registered node found");
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetMobilityModel (Ipv4Address ("10.0.0.7")), mobility, "Mobility of the registered node");
+
+  LocationIndex::Remove (Ipv4Address ("10.0.0.7"));
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetNode (Ipv4Address ("10.0.0.7")), 0, "Removed node not found");
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetMobilityModel (Ipv4Address ("10.0.0.7")), 0, "No mobility for an unknown address");
+  // the miss is cached until the next Add
+  LocationIndex::Add (Ipv4Address ("10.0.0.7"), node);
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetNode (Ipv4Address ("10.0.0.7")), node, "Node registered again found");
+
+  // the miss is also forgotten when an address is assigned without Add
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetNode (Ipv4Address ("10.2.0.1")), 0, "Unassigned address not found");
+  NodeContainer nodes;
+  nodes.Create (1);
+  CsmaHelper csma;
+  NetDeviceContainer devices = csma.Install (nodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.2.0.0", "255.255.0.0");
+  address.Assign (devices);
+  NS_TEST_EXPECT_MSG_EQ (LocationIndex::GetNode (Ipv4Address ("10.2.0.1")), nodes.Get (0), "Address assigned after the miss found");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+// Position snapshot
+//-----------------------------------------------------------------------------
+struct PositionSnapshotTest : public TestCase
+{
+  PositionSnapshotTest () : TestCase ("PositionSnapshot") { }
+  virtual void DoRun ();
+  void CheckNeighbors (Ipv4Address self, Vector position, uint32_t n, std::string msg);
+};
+
+void
+PositionSnapshotTest::CheckNeighbors (Ipv4Address self, Vector position, uint32_t n, std::string msg)
+{
+  std::vector<PositionSnapshot::Entry> neighbors;
+  PositionSnapshot::GetNeighbors (self, position, 250, Seconds (1), neighbors);
+  NS_TEST_EXPECT_MSG_EQ (neighbors.size (), n, msg << " at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+PositionSnapshotTest::DoRun ()
+{
+  Vector positions[] = { Vector (0, 0, 0), Vector (100, 0, 0), Vector (300, 0, 0), Vector (50, 200, 0) };
+  std::vector<Ptr<ConstantPositionMobilityModel> > mobility;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+      mobility[i]->SetPosition (positions[i]);
+      PositionSnapshot::Add (Ipv4Address (0x0a000001 + i), mobility[i]);
+    }
+
+  std::vector<PositionSnapshot::Entry> neighbors;
+  Time time = PositionSnapshot::GetNeighbors (Ipv4Address ("10.0.0.1"), positions[0], 250, Seconds (1), neighbors);
+  NS_TEST_EXPECT_MSG_EQ (time, Seconds (0), "Snapshot taken on the first query");
+  NS_TEST_ASSERT_MSG_EQ (neighbors.size (), 2, "The node at 300 m is out of range, the one at 206 m is not");
+  NS_TEST_EXPECT_MSG_EQ (neighbors[0].address, Ipv4Address ("10.0.0.4"), "Sorted by x");
+  NS_TEST_EXPECT_MSG_EQ (neighbors[1].address, Ipv4Address ("10.0.0.2"), "Sorted by x");
+  NS_TEST_EXPECT_MSG_EQ (PositionSnapshot::GetNSnapshots (), 1, "One snapshot");
+
+  // the node at 100 m leaves, which the snapshot only sees once it is stale
+  mobility[1]->SetPosition (Vector (600, 0, 0));
+  CheckNeighbors (Ipv4Address ("10.0.0.1"), positions[0], 2, "Snapshot still fresh");
+  Simulator::Schedule (Seconds (1), &PositionSnapshotTest::CheckNeighbors, this,
+                       Ipv4Address ("10.0.0.1"), positions[0], 2, "Snapshot one second old");
+  Simulator::Schedule (Seconds (1.5), &PositionSnapshotTest::CheckNeighbors, this,
+                       Ipv4Address ("10.0.0.1"), positions[0], 1, "Snapshot taken again");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (PositionSnapshot::GetNSnapshots (), 2, "Snapshots shared by the queries");
+
+  // removing a node takes the snapshot again
+  PositionSnapshot::Remove (Ipv4Address ("10.0.0.4"));
+  CheckNeighbors (Ipv4Address ("10.0.0.1"), positions[0], 0, "Removed node");
+  NS_TEST_EXPECT_MSG_EQ (PositionSnapshot::GetNSnapshots (), 3, "Snapshot taken after a removal");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+// Position predictors
+//-----------------------------------------------------------------------------
+struct PositionPredictorTest : public TestCase
+{
+  PositionPredictorTest () : TestCase ("PositionPredictor") { }
+  virtual void DoRun ();
+  void Error (Ipv4Address id, Vector predicted, double error);
+  void Report (LocationTable *table, Vector position, int speed);
+
+  double m_error;
+};
+
+void
+PositionPredictorTest::Error (Ipv4Address id, Vector predicted, double error)
+{
+  NS_TEST_EXPECT_MSG_EQ (id, Ipv4Address ("10.0.0.7"), "Traced node");
+  m_error = error;
+}
+
+void
+PositionPredictorTest::Report (LocationTable *table, Vector position, int speed)
+{
+  table->AddEntry (Ipv4Address ("10.0.0.8"), position, speed);
+}
+
+void
+PositionPredictorTest::DoRun ()
+{
+  KinematicState state (Vector (10, 20, 0), Vector (4, -2, 0), Seconds (1));
+  Ptr<PositionPredictor> cv = CreateObject<ConstantVelocityPredictor> ();
+  Vector p = cv->Predict (state, MilliSeconds (3500));
+  NS_TEST_EXPECT_MSG_EQ_TOL (p.x, 20, 1e-9, "Fractions of seconds are not truncated");
+  NS_TEST_EXPECT_MSG_EQ_TOL (p.y, 15, 1e-9, "Velocity along y");
+
+  // braking at 2 m/s^2 from 4 m/s: stops after 2 s and 4 m
+  state.velocity = Vector (4, 0, 0);
+  state.acceleration = Vector (-2, 0, 0);
+  Ptr<PositionPredictor> ca = CreateObject<ConstantAccelerationPredictor> ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (ca->Predict (state, Seconds (2)).x, 13, 1e-9, "Constant acceleration");
+  NS_TEST_EXPECT_MSG_EQ_TOL (ca->Predict (state, Seconds (10)).x, 14, 1e-9, "Stopped");
+
+  // an L shaped road: east for 100 m, then north for 100 m
+  std::string filename = CreateTempDirFilename ("road.ns_movements");
+  std::ofstream trace (filename.c_str ());
+  trace << "$node_(1) set X_ 0.0\n"
+        << "$node_(1) set Y_ 0.0\n"
+        << "$node_(10) set X_ 500.0\n"
+        << "$ns_ at 20.0 \"$node_(1) setdest 100.0 100.0 10.0\"\n"
+        << "$ns_ at 1.0 \"$node_(1) setdest 100.0 0.0 10.0\"\n"
+        << "$ns_ at 1.0 \"$node_(10) setdest 0.0 0.0 10.0\"\n";
+  trace.close ();
+  Ptr<LanePredictor> lane = CreateObject<LanePredictor> ();
+  lane->SetRoad (LanePredictor::ReadNs2Road (filename, 1));
+  NS_TEST_ASSERT_MSG_EQ (lane->GetRoad ().size (), 3, "Road of node 1");
+  NS_TEST_EXPECT_MSG_EQ (lane->GetRoad ()[1].x, 100, "Waypoints in time order");
+
+  // 2 m right of the road, 10 m before the turn, at 10 m/s for 3 s
+  state = KinematicState (Vector (90, -2, 0), Vector (10, 0, 0), Seconds (0));
+  p = lane->Predict (state, Seconds (3));
+  NS_TEST_EXPECT_MSG_EQ_TOL (p.x, 102, 1e-9, "Lane kept after the turn");
+  NS_TEST_EXPECT_MSG_EQ_TOL (p.y, 20, 1e-9, "Turned north");
+  p = lane->Predict (state, Seconds (60));
+  NS_TEST_EXPECT_MSG_EQ_TOL (p.y, 100, 1e-9, "Stops at the end of the road");
+  state.velocity = Vector (-10, 0, 0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lane->Predict (state, Seconds (2)).x, 70, 1e-9, "Drives back");
+
+  // error trace against the true position
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (23, 20, 0));
+  node->AggregateObject (mobility);
+  LocationIndex::Add (Ipv4Address ("10.0.0.7"), node);
+  m_error = -1;
+  cv->TraceConnectWithoutContext ("PredictionError", MakeCallback (&PositionPredictorTest::Error, this));
+  cv->Predict (Ipv4Address ("10.0.0.7"), KinematicState (Vector (10, 20, 0), Vector (4, 0, 0), Seconds (0)), Seconds (3));
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_error, 1, 1e-9, "Prediction error");
+
+  // heading and acceleration derived by the location table
+  LocationTable table (Seconds (10));
+  Simulator::Schedule (Seconds (1), &PositionPredictorTest::Report, this, &table, Vector (0, 0, 0), 10);
+  Simulator::Schedule (Seconds (2), &PositionPredictorTest::Report, this, &table, Vector (0, -10, 0), 12);
+  Simulator::Run ();
+  KinematicState reported;
+  NS_TEST_ASSERT_MSG_EQ (table.GetState (Ipv4Address ("10.0.0.8"), reported), true, "Entry");
+  NS_TEST_EXPECT_MSG_EQ_TOL (reported.velocity.y, -12, 1e-9, "Heading from the successive positions");
+  NS_TEST_EXPECT_MSG_EQ_TOL (reported.velocity.x, 0, 1e-9, "Heading from the successive positions");
+  NS_TEST_EXPECT_MSG_EQ (reported.time, Seconds (2), "Report time");
+  NS_TEST_EXPECT_MSG_EQ (table.GetState (Ipv4Address ("10.0.0.9"), reported), false, "Unknown node");
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+// Adaptive location updates
+//-----------------------------------------------------------------------------
+struct AdaptiveUpdateTest : public TestCase
+{
+  AdaptiveUpdateTest () : TestCase ("AdaptiveUpdate") { }
+  virtual void DoRun ();
+  void Check ();
+};
+
+void
+AdaptiveUpdateTest::Check ()
+{
+  Ptr<SlsLocationService> sls = CreateObject<SlsLocationService> (Seconds (10));
+  sls->SetAdaptiveUpdates (true, 10, 2, 0.35, Seconds (4));
+  // reported at the origin 2 s ago, driving east at 10 m/s
+  KinematicState reported (Vector (0, 0, 0), Vector (10, 0, 0), Seconds (0));
+  Time last = Seconds (0);
+
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 0, 0), Vector (10, 0, 0)), false, "On track");
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (26, 5, 0), Vector (10, 0, 0)), false, "Within the threshold");
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 15, 0), Vector (10, 0, 0)), true, "Drifted");
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 0, 0), Vector (13, 0, 0)), true, "Accelerated");
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 0, 0), Vector (9.5, 3, 0)), false, "Small turn");
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 0, 0), Vector (7, 7, 0)), true, "Turned");
+
+  sls->SetAdaptiveUpdates (true, 10, 2, 0.35, Seconds (2));
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, last, Vector (20, 0, 0), Vector (10, 0, 0)), true, "Too old");
+
+  // a stopped vehicle only refreshes its entry
+  reported = KinematicState (Vector (5, 5, 0), Vector (0, 0, 0), Seconds (0));
+  NS_TEST_EXPECT_MSG_EQ (sls->NeedsUpdate (reported, Seconds (1), Vector (5, 5, 0), Vector (0, 0, 0)), false, "Stopped");
+  sls->Dispose ();
+}
+
+void
+AdaptiveUpdateTest::DoRun ()
+{
+  Simulator::Schedule (Seconds (2), &AdaptiveUpdateTest::Check, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 //-----------------------------------------------------------------------------
 struct TypeHeaderTest : public TestCase
 {
@@ -167,6 +545,286 @@ struct PositionHeaderTest : public TestCase
   }
 };
 //-----------------------------------------------------------------------------
+struct DataHeaderTest : public TestCase
+{
+  DataHeaderTest () : TestCase ("GPSR DATA") {}
+  virtual void DoRun ()
+  {
+    PositionHeader h (1, 2, 10, 0, 0, 0, 20, 15);
+    Ptr<Packet> p = Create<Packet> (100);
+    p->AddHeader (h);
+    p->AddHeader (TypeHeader (GPSRTYPE_POS));
+
+    DataHeader data;
+    uint32_t bytes = p->PeekHeader (data);
+    NS_TEST_EXPECT_MSG_EQ (bytes, 54, "Type and position peeked together");
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 154, "Peek does not remove");
+    NS_TEST_EXPECT_MSG_EQ (data.GetType ().Get (), GPSRTYPE_POS, "Type");
+    NS_TEST_EXPECT_MSG_EQ (data.GetPosition (), h, "Position");
+
+    // the copy shares the buffer of p and must not see the change
+    Ptr<Packet> copy = p->Copy ();
+    data.GetPosition ().SetInRec (1);
+    data.GetPosition ().SetLastPosx (42);
+    data.Replace (p);
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 154, "Same size");
+
+    TypeHeader type (GPSRTYPE_HELLO);
+    PositionHeader h2;
+    p->RemoveHeader (type);
+    p->RemoveHeader (h2);
+    NS_TEST_EXPECT_MSG_EQ (type.Get (), GPSRTYPE_POS, "Type kept");
+    NS_TEST_EXPECT_MSG_EQ (h2.GetInRec (), 1, "Rewritten");
+    NS_TEST_EXPECT_MSG_EQ (h2.GetLastPosx (), 42, "Rewritten");
+    NS_TEST_EXPECT_MSG_EQ (h2.GetDstPosx (), 1, "Unchanged fields");
+    copy->RemoveHeader (type);
+    copy->RemoveHeader (h2);
+    NS_TEST_EXPECT_MSG_EQ (h2, h, "Copy on write");
+
+    // other messages only have their type read
+    Ptr<Packet> hello = Create<Packet> ();
+    hello->AddHeader (HelloHeader (3, 4));
+    hello->AddHeader (TypeHeader (GPSRTYPE_HELLO));
+    NS_TEST_EXPECT_MSG_EQ (hello->PeekHeader (data), 1, "Type only");
+    NS_TEST_EXPECT_MSG_EQ (data.GetType ().Get (), GPSRTYPE_HELLO, "Hello");
+  }
+};
+//-----------------------------------------------------------------------------
+/// Round trips of the compact encoding of the headers
+struct WireFormatTest : public TestCase
+{
+  WireFormatTest () : TestCase ("GPSR wire format") {}
+  template <typename T>
+  T RoundTrip (const T &h, uint32_t size)
+  {
+    Ptr<Packet> p = Create<Packet> ();
+    p->AddHeader (h);
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), size, "Compact size");
+    T h2;
+    h2.SetVersion (WIRE_COMPACT);
+    NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (h2), size, "Whole header read");
+    return h2;
+  }
+  virtual void DoRun ()
+  {
+    Config::SetGlobal ("GpsrReferencePoint", VectorValue (Vector (1000, 2000, 0)));
+
+    // the version travels in the type byte, legacy bytes are unchanged
+    {
+      TypeHeader h (SLS_LOCATION_UPDATE);
+      h.SetVersion (WIRE_COMPACT);
+      Ptr<Packet> p = Create<Packet> ();
+      p->AddHeader (h);
+      uint8_t byte;
+      p->CopyData (&byte, 1);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) byte, 0x14, "Version in the high nibble");
+      TypeHeader h2 (GPSRTYPE_HELLO);
+      p->RemoveHeader (h2);
+      NS_TEST_EXPECT_MSG_EQ (h2.IsValid (), true, "Valid");
+      NS_TEST_EXPECT_MSG_EQ (h2, h, "Round trip");
+
+      byte = 0x21;
+      p = Create<Packet> (&byte, 1);
+      p->RemoveHeader (h2);
+      NS_TEST_EXPECT_MSG_EQ (h2.IsValid (), false, "Unknown version");
+    }
+    {
+      HelloHeader h (1234, 1990);
+      h.SetVersion (WIRE_COMPACT);
+      NS_TEST_EXPECT_MSG_EQ (RoundTrip (h, 4), h, "Hello");
+
+      // coordinates saturate at 2^15 steps from the reference point
+      h.SetOriginPosx (1000 + 40000);
+      h.SetOriginPosy ((uint64_t) -5);
+      HelloHeader h2 = RoundTrip (h, 4);
+      NS_TEST_EXPECT_MSG_EQ (h2.GetOriginPosx (), 1000 + 32767, "Saturated");
+      NS_TEST_EXPECT_MSG_EQ ((int64_t) h2.GetOriginPosy (), -5, "Negative coordinate");
+    }
+    {
+      PositionHeader h (1010, 2500, 1234, 900, 1800, 1, 1100, 2100);
+      h.SetVersion (WIRE_COMPACT);
+      NS_TEST_EXPECT_MSG_EQ (RoundTrip (h, 15), h, "Position");
+
+      // timestamps come back against the clock of the receiver
+      Simulator::Schedule (Seconds (70000), &WireFormatTest::CheckTimestamp, this);
+      Simulator::Run ();
+      Simulator::Destroy ();
+    }
+    {
+      LocHelloHeader h (Ipv4Address ("10.0.0.1"), 1500, 2500);
+      h.SetVersion (WIRE_COMPACT);
+      LocHelloHeader h2 = RoundTrip (h, 8);
+      NS_TEST_EXPECT_MSG_EQ (h2.GetNodeID (), h.GetNodeID (), "LocHello id");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetOriginPosx (), 1500, "LocHello x");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetOriginPosy (), 2500, "LocHello y");
+    }
+    {
+      LocUpdateHeader h (Ipv4Address ("10.0.0.1"), 1500, 2500, 30);
+      h.SetVersion (WIRE_COMPACT);
+      NS_TEST_EXPECT_MSG_EQ (RoundTrip (h, 10), h, "LocUpdate");
+
+      h.AddRecord (LocationRecord (Ipv4Address ("10.0.0.2"), 500, 1500, 12));
+      h.AddRecord (LocationRecord (Ipv4Address ("10.0.0.3"), 700, 2700, 300));
+      LocUpdateHeader h2 = RoundTrip (h, 28);
+      NS_TEST_EXPECT_MSG_EQ (h2.GetNRecords (), 3, "Batched records");
+      NS_TEST_EXPECT_MSG_EQ ((h2.GetRecord (1) == h.GetRecord (1)), true, "Second record");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetRecord (2).nodeid, Ipv4Address ("10.0.0.3"), "Third record");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetRecord (2).speed, 255, "Speed saturated");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetNodeID (), Ipv4Address ("10.0.0.1"), "First record");
+    }
+    {
+      LocReplyHeader h (Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"), 1500, 2500);
+      h.SetVersion (WIRE_COMPACT);
+      NS_TEST_EXPECT_MSG_EQ (RoundTrip (h, 12), h, "LocReply");
+    }
+    {
+      // coarser steps
+      Config::SetGlobal ("GpsrPositionResolution", DoubleValue (4));
+      HelloHeader h (1009, 1990);
+      h.SetVersion (WIRE_COMPACT);
+      HelloHeader h2 = RoundTrip (h, 4);
+      NS_TEST_EXPECT_MSG_EQ (h2.GetOriginPosx (), 1008, "Quantised x");
+      NS_TEST_EXPECT_MSG_EQ (h2.GetOriginPosy (), 1992, "Quantised y");
+      Config::SetGlobal ("GpsrPositionResolution", DoubleValue (1));
+    }
+    {
+      // new headers follow the global encoding
+      Config::SetGlobal ("GpsrWireFormat", StringValue ("Compact"));
+      NS_TEST_EXPECT_MSG_EQ (TypeHeader (GPSRTYPE_POS).GetVersion (), WIRE_COMPACT, "Global format");
+      NS_TEST_EXPECT_MSG_EQ (HelloHeader ().GetSerializedSize (), 4, "Global format");
+
+      // and DATA packets keep the encoding they were sent with
+      Ptr<Packet> p = Create<Packet> (100);
+      p->AddHeader (PositionHeader (1, 2, 10, 0, 0, 0, 20, 15));
+      p->AddHeader (TypeHeader (GPSRTYPE_POS));
+      Config::SetGlobal ("GpsrWireFormat", StringValue ("Legacy"));
+      DataHeader data;
+      NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (data), 16, "Compact DATA");
+      data.SetPosition (PositionHeader (3, 4, 10, 0, 0, 1, 20, 15));
+      data.Replace (p);
+      NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 116, "Rewritten compact");
+      p->PeekHeader (data);
+      NS_TEST_EXPECT_MSG_EQ (data.GetPosition ().GetDstPosx (), 3, "Rewritten");
+    }
+
+    Config::SetGlobal ("GpsrReferencePoint", VectorValue (Vector (0, 0, 0)));
+  }
+  void CheckTimestamp ()
+  {
+    PositionHeader h (0, 0, 69000, 0, 0, 0, 0, 0);
+    h.SetVersion (WIRE_COMPACT);
+    NS_TEST_EXPECT_MSG_EQ (RoundTrip (h, 15).GetUpdated (), 69000, "Timestamp past 2^16 s");
+  }
+};
+//-----------------------------------------------------------------------------
+/// SLS messages coalesced in one packet
+struct SlsBatchTest : public TestCase
+{
+  SlsBatchTest () : TestCase ("SlsBatch") {}
+  virtual void DoRun ()
+  {
+    Ipv4Address a ("10.0.0.1"), b ("10.0.0.2"), rsu ("10.0.0.100");
+    SlsBatch batch;
+    NS_TEST_EXPECT_MSG_EQ (batch.IsEmpty (), true, "Empty");
+    batch.AddUpdate (LocationRecord (a, 10, 20, 5));
+    batch.AddQuery (LocQueryHeader (a, rsu, b));
+    batch.AddUpdate (LocationRecord (b, 30, 40, 6));
+    batch.AddUpdate (LocationRecord (a, 11, 21, 7));
+    batch.AddQuery (LocQueryHeader (b, rsu, a));
+    batch.AddReply (LocReplyHeader (rsu, b, 30, 40));
+    NS_TEST_EXPECT_MSG_EQ (batch.GetUpdates ().size (), 2, "A new update replaces the waiting one");
+    NS_TEST_EXPECT_MSG_EQ (batch.GetUpdates ()[0].posx, 11, "Latest position");
+
+    // legacy: one message per record
+    Ptr<Packet> p = batch.ToPacket ();
+    NS_TEST_EXPECT_MSG_EQ (batch.GetUpdateSize (), 2 * 25, "Update bytes");
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 2 * 25 + 2 * 13 + 25, "Packet size");
+    TypeHeader type (GPSRTYPE_HELLO);
+    LocUpdateHeader update;
+    for (uint32_t i = 0; i < 2; i++)
+      {
+        p->RemoveHeader (type);
+        NS_TEST_EXPECT_MSG_EQ (type.Get (), SLS_LOCATION_UPDATE, "Updates first");
+        p->RemoveHeader (update);
+        NS_TEST_EXPECT_MSG_EQ (update.GetNodeID (), i == 0 ? a : b, "Update order");
+      }
+    LocQueryHeader query;
+    for (uint32_t i = 0; i < 2; i++)
+      {
+        p->RemoveHeader (type);
+        NS_TEST_EXPECT_MSG_EQ (type.Get (), SLS_LOCATION_QUERY, "Then the queries");
+        p->RemoveHeader (query);
+        NS_TEST_EXPECT_MSG_EQ (query.GetQueryID (), i == 0 ? b : a, "Query order");
+      }
+    LocReplyHeader reply;
+    p->RemoveHeader (type);
+    NS_TEST_EXPECT_MSG_EQ (type.Get (), SLS_LOCATION_REPLY, "Then the replies");
+    p->RemoveHeader (reply);
+    NS_TEST_EXPECT_MSG_EQ (reply.GetPosx (), 30, "Reply");
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 0, "Nothing else");
+
+    // compact: the records share a header
+    Config::SetGlobal ("GpsrWireFormat", StringValue ("Compact"));
+    p = batch.ToPacket ();
+    NS_TEST_EXPECT_MSG_EQ (batch.GetUpdateSize (), 1 + 1 + 2 * 9, "Compact update bytes");
+    p->RemoveHeader (type);
+    update.SetVersion (type.GetVersion ());
+    p->RemoveHeader (update);
+    NS_TEST_EXPECT_MSG_EQ (update.GetNRecords (), 2, "Both records");
+    NS_TEST_EXPECT_MSG_EQ (update.GetRecord (1).nodeid, b, "Second record");
+    p->RemoveHeader (type);
+    NS_TEST_EXPECT_MSG_EQ (type.Get (), SLS_LOCATION_QUERY, "Then the queries");
+    Config::SetGlobal ("GpsrWireFormat", StringValue ("Legacy"));
+  }
+};
+//-----------------------------------------------------------------------------
+/// Routing protocol counting the neighbors its SLS messages add
+struct CountingRoutingProtocol : public RoutingProtocol
+{
+  CountingRoutingProtocol () : m_updates (0) {}
+  virtual void UpdateRouteToNeighbor (Ipv4Address sender, Ipv4Address receiver, Vector Pos, int speed)
+  {
+    m_updates++;
+  }
+  uint32_t m_updates;
+};
+
+/// Unit test for the SLS messages which a node of the other role ignores
+struct SlsReceiveTest : public TestCase
+{
+  SlsReceiveTest () : TestCase ("SlsReceive") {}
+  uint32_t Receive (bool obu, Ptr<Packet> p)
+  {
+    Ptr<CountingRoutingProtocol> gpsr = CreateObject<CountingRoutingProtocol> ();
+    Ptr<SlsLocationService> ls = CreateObject<SlsLocationService> (Seconds (10));
+    ls->SetFunction (obu);
+    gpsr->SetLS (ls);
+    TypeHeader type (GPSRTYPE_HELLO);
+    p->RemoveHeader (type);
+    gpsr->RecvSlsMessage (p, type, Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"));
+    NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 0, "Message body removed");
+    return gpsr->m_updates;
+  }
+  virtual void DoRun ()
+  {
+    Ptr<Packet> p = Create<Packet> ();
+    p->AddHeader (LocHelloHeader (Ipv4Address ("10.0.0.1"), 100, 200));
+    p->AddHeader (TypeHeader (SLS_LOCATION_HELLO));
+    NS_TEST_EXPECT_MSG_EQ (Receive (false, p), 0, "Location Hello ignored by an RSU");
+
+    p = Create<Packet> ();
+    p->AddHeader (LocUpdateHeader (Ipv4Address ("10.0.0.1"), 100, 200, 5));
+    p->AddHeader (TypeHeader (SLS_LOCATION_UPDATE));
+    NS_TEST_EXPECT_MSG_EQ (Receive (true, p), 0, "Update ignored by an OBU");
+
+    p = Create<Packet> ();
+    p->AddHeader (LocUpdateHeader (Ipv4Address ("10.0.0.1"), 100, 200, 5));
+    p->AddHeader (TypeHeader (SLS_LOCATION_UPDATE));
+    NS_TEST_EXPECT_MSG_EQ (Receive (false, p), 1, "Update of the sender handled by an RSU");
+    Simulator::Destroy ();
+  }
+};
+//-----------------------------------------------------------------------------
 /// Unit test for RequestQueue
 struct GpsrRqueueTest : public TestCase
 {
@@ -263,16 +921,313 @@ GpsrRqueueTest::CheckTimeout ()
   NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 0, "Must be empty now");
 }
 //-----------------------------------------------------------------------------
+/// Per-destination order and global length limit of the request queue
+struct GpsrRqueueIndexTest : public TestCase
+{
+  GpsrRqueueIndexTest () : TestCase ("RqueueIndex"), q (3, Seconds (30)), m_drops (0) {}
+  virtual void DoRun ();
+  void Unicast (Ptr<Ipv4Route> route, Ptr<const Packet> packet, const Ipv4Header & header) {}
+  void Error (Ptr<const Packet>, const Ipv4Header &, Socket::SocketErrno) { m_drops++; }
+  void Enqueue (Ptr<const Packet> p, Ipv4Address dst, Time timeout);
+  void CheckTimeout ();
+
+  RequestQueue q;
+  uint32_t m_drops;
+};
+
+void
+GpsrRqueueIndexTest::Enqueue (Ptr<const Packet> p, Ipv4Address dst, Time timeout)
+{
+  Ipv4Header h;
+  h.SetDestination (dst);
+  q.SetQueueTimeout (timeout);
+  QueueEntry e (p, h, MakeCallback (&GpsrRqueueIndexTest::Unicast, this),
+                MakeCallback (&GpsrRqueueIndexTest::Error, this));
+  q.Enqueue (e);
+}
+
+void
+GpsrRqueueIndexTest::DoRun ()
+{
+  Ipv4Address a ("10.0.0.4"), b ("10.0.0.5"), c ("10.0.0.6");
+  Ptr<const Packet> p1 = Create<Packet> ();
+  Ptr<const Packet> p2 = Create<Packet> ();
+  Ptr<const Packet> p3 = Create<Packet> ();
+  Ptr<const Packet> p4 = Create<Packet> ();
+  Enqueue (p1, a, Seconds (30));
+  Enqueue (p2, b, Seconds (30));
+  Enqueue (p3, a, Seconds (30));
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 3, "Three destinations queued");
+
+  // Full: the most aged packet (p1) makes room for p4
+  Enqueue (p4, c, Seconds (30));
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 3, "Length limit");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 1, "p1 dropped");
+
+  QueueEntry e;
+  NS_TEST_EXPECT_MSG_EQ (q.Dequeue (a, e), true, "p3 still queued");
+  NS_TEST_EXPECT_MSG_EQ (e.GetPacket (), p3, "p3 is the only packet left to a");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (a), false, "Nothing left to a");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (b), true, "p2 still queued");
+
+  // A short lived packet expires before the older ones
+  Enqueue (p1, a, Seconds (1));
+  Simulator::Schedule (Seconds (2), &GpsrRqueueIndexTest::CheckTimeout, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+GpsrRqueueIndexTest::CheckTimeout ()
+{
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 2, "p1 expired");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 2, "p1 dropped by timeout");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (Ipv4Address ("10.0.0.4")), false, "Nothing left to a");
+  q.DropPacketWithDst (Ipv4Address ("10.0.0.5"));
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 3, "p2 dropped");
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 1, "Only p4 left");
+}
+//-----------------------------------------------------------------------------
+// EventLog
+//-----------------------------------------------------------------------------
+struct EventLogTest : public TestCase
+{
+  EventLogTest () : TestCase ("EventLog") {}
+  virtual void DoRun ();
+  void WriteRecords ();
+
+  Ptr<GpsrEventLog> m_log;
+};
+
+void
+EventLogTest::WriteRecords ()
+{
+  m_log->Write (3, GpsrEvent (GPSR_EVENT_TX, 42, Ipv4Address ("10.0.0.4"), Ipv4Address ("10.0.0.9"),
+                              Vector (12.5, -3.25, 0), 512));
+  m_log->WriteWithContext ("/NodeList/17/$ns3::gpsr::RoutingProtocol/Event",
+                           GpsrEvent (GPSR_EVENT_REPLY, 0, Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.9"),
+                                      Vector (1000, 2, 0), 0.125));
+}
+
+void
+EventLogTest::DoRun ()
+{
+  std::string filename = CreateTempDirFilename ("gpsr-events.bin");
+  m_log = CreateObject<GpsrEventLog> ();
+  m_log->Open (filename);
+  Simulator::Schedule (Seconds (2), &EventLogTest::WriteRecords, this);
+  Simulator::Run ();
+  m_log->Close ();
+  Simulator::Destroy ();
+
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_TEST_ASSERT_MSG_EQ (GpsrEventLog::ReadMagic (is), true, "Bad magic");
+
+  Time time;
+  uint32_t node;
+  GpsrEvent event;
+  NS_TEST_ASSERT_MSG_EQ (GpsrEventLog::Read (is, time, node, event), true, "First record missing");
+  NS_TEST_EXPECT_MSG_EQ (time, Seconds (2), "Time");
+  NS_TEST_EXPECT_MSG_EQ (node, 3, "Node");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) event.type, (uint32_t) GPSR_EVENT_TX, "Type");
+  NS_TEST_EXPECT_MSG_EQ (event.uid, 42, "Uid");
+  NS_TEST_EXPECT_MSG_EQ (event.src, Ipv4Address ("10.0.0.4"), "Source");
+  NS_TEST_EXPECT_MSG_EQ (event.dst, Ipv4Address ("10.0.0.9"), "Destination");
+  NS_TEST_EXPECT_MSG_EQ (event.position.x, 12.5, "Position x");
+  NS_TEST_EXPECT_MSG_EQ (event.position.y, -3.25, "Position y");
+  NS_TEST_EXPECT_MSG_EQ (event.value, 512, "Value");
+
+  NS_TEST_ASSERT_MSG_EQ (GpsrEventLog::Read (is, time, node, event), true, "Second record missing");
+  NS_TEST_EXPECT_MSG_EQ (node, 17, "Node id from the context");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) event.type, (uint32_t) GPSR_EVENT_REPLY, "Type");
+  NS_TEST_EXPECT_MSG_EQ (event.position.x, 1000, "Position x");
+  NS_TEST_EXPECT_MSG_EQ (event.value, 0.125, "Value");
+
+  NS_TEST_EXPECT_MSG_EQ (GpsrEventLog::Read (is, time, node, event), false, "Only two records");
+  m_log = 0;
+}
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// RsuDirectory
+//-----------------------------------------------------------------------------
+struct RsuDirectoryTest : public TestCase
+{
+  RsuDirectoryTest (GpsrHelper::BackhaulTopology topology, std::string name)
+    : TestCase (name), m_topology (topology) {}
+  virtual void DoRun ();
+  void Answer (Ipv4Address requester, Ipv4Address vehicle, bool found, const DirectoryRecord &record);
+  void Update ();
+  void Lookup ();
+  void Check ();
+
+  GpsrHelper::BackhaulTopology m_topology;
+  std::vector<Ptr<RsuDirectory> > m_directories;
+  std::vector<std::pair<Ipv4Address, DirectoryRecord> > m_found;
+  std::vector<Ipv4Address> m_missing;
+  uint32_t m_nonOwner;
+};
+
+void
+RsuDirectoryTest::Answer (Ipv4Address requester, Ipv4Address vehicle, bool found, const DirectoryRecord &record)
+{
+  NS_TEST_EXPECT_MSG_EQ (requester, Ipv4Address ("10.0.0.20"), "Requester");
+  if (found)
+    {
+      m_found.push_back (std::make_pair (vehicle, record));
+    }
+  else
+    {
+      m_missing.push_back (vehicle);
+    }
+}
+
+void
+RsuDirectoryTest::Update ()
+{
+  // the same vehicle reported twice in a batch: only the last one is kept
+  m_directories[0]->NotifyUpdate (Ipv4Address ("10.0.0.9"), Vector (10, 20, 0), Vector (0, 30, 0));
+  m_directories[0]->NotifyUpdate (Ipv4Address ("10.0.0.9"), Vector (40, 20, 0), Vector (0, 30, 0));
+  for (uint32_t v = 100; v < 200; v++)
+    {
+      m_directories[v % 4]->NotifyUpdate (Ipv4Address (0x0a000000 + v), Vector (v, 0, 0), Vector (20, 0, 0));
+    }
+}
+
+void
+RsuDirectoryTest::Lookup ()
+{
+  NS_TEST_EXPECT_MSG_EQ (m_found.size (), 0, "No answer before the lookups");
+  m_directories[m_nonOwner]->Lookup (Ipv4Address ("10.0.0.9"), Ipv4Address ("10.0.0.20"));
+  NS_TEST_EXPECT_MSG_EQ (m_found.size (), 0, "A non owner asks the owners over the backhaul");
+  m_directories[m_nonOwner]->Lookup (Ipv4Address ("10.0.0.10"), Ipv4Address ("10.0.0.20"));
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      m_directories[k]->Lookup (Ipv4Address (0x0a000000 + 150), Ipv4Address ("10.0.0.20"));
+    }
+}
+
+void
+RsuDirectoryTest::Check ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_found.size (), 5, "Known vehicles found by every RSU");
+  // the owners answer right away, the others when the answer arrives
+  uint32_t replicated = 0;
+  for (uint32_t k = 0; k < 5; k++)
+    {
+      if (m_found[k].first == Ipv4Address ("10.0.0.9"))
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_found[k].second.position.x, 40, "Last position");
+          NS_TEST_EXPECT_MSG_EQ (m_found[k].second.velocity.y, 30, "Velocity");
+          NS_TEST_EXPECT_MSG_EQ (m_found[k].second.updated, Seconds (1), "Update time");
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_found[k].second.position.x, 150, "Replicated position");
+          replicated++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (replicated, 4, "Lookups from every RSU");
+  NS_TEST_ASSERT_MSG_EQ (m_missing.size (), 1, "Unknown vehicle");
+  NS_TEST_EXPECT_MSG_EQ (m_missing[0], Ipv4Address ("10.0.0.10"), "Unknown vehicle");
+}
+
+void
+RsuDirectoryTest::DoRun ()
+{
+  NodeContainer rsus;
+  rsus.Create (4);
+  // stand-in for the wireless interface
+  CsmaHelper csma;
+  NetDeviceContainer devices = csma.Install (rsus);
+  InternetStackHelper stack;
+  stack.Install (rsus);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.0.0");
+  address.Assign (devices);
+
+  GpsrHelper gpsr;
+  gpsr.SetBackhaul (m_topology);
+  gpsr.SetDirectoryAttribute ("Shards", UintegerValue (16));
+  gpsr.SetDirectoryAttribute ("MaxRecords", UintegerValue (10));
+  NetDeviceContainer backhaul = gpsr.InstallRsuDirectory (rsus);
+  NS_TEST_EXPECT_MSG_EQ (backhaul.GetN (), (m_topology == GpsrHelper::BACKHAUL_BUS ? 4U : 6U), "Backhaul devices");
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::GetRsus ().size (), 4, "Members listed");
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::GetRsus ()[3], Ipv4Address ("10.1.0.4"), "Members in order");
+
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      Ptr<RsuDirectory> directory = rsus.Get (k)->GetObject<RsuDirectory> ();
+      NS_TEST_ASSERT_MSG_NE (directory, 0, "Directory aggregated");
+      NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address (0x0a010000 + k + 1)), true, "Member address");
+      directory->SetAnswerCallback (MakeCallback (&RsuDirectoryTest::Answer, this));
+      m_directories.push_back (directory);
+    }
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.0.0.9")), false, "Vehicle address");
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.0.0.2")), false, "Directory members only");
+
+  uint32_t shard = m_directories[0]->GetShard (Ipv4Address ("10.0.0.9"));
+  uint32_t owners = 0;
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      if (m_directories[0]->IsOwner (k, shard))
+        {
+          owners++;
+        }
+      else
+        {
+          m_nonOwner = k;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (owners, 2, "Two replicas");
+
+  Simulator::Schedule (Seconds (1), &RsuDirectoryTest::Update, this);
+  Simulator::Schedule (Seconds (2), &RsuDirectoryTest::Lookup, this);
+  Simulator::Schedule (Seconds (3), &RsuDirectoryTest::Check, this);
+  Simulator::Run ();
+
+  uint64_t packets = 0;
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      packets += m_directories[k]->GetTxPackets ();
+    }
+  NS_TEST_EXPECT_MSG_GT (packets, 4, "Updates and lookups sent on the backhaul");
+  m_directories.clear ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.1.0.1")), false, "Members removed on dispose");
+  // without directories, the RSUs of the global value
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.0.0.2")), true, "Default RSU");
+  Config::SetGlobal ("GpsrRsuAddresses", StringValue ("10.1.0.1"));
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.1.0.1")), true, "Configured RSU");
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.0.0.2")), false, "Configured RSUs only");
+  Config::SetGlobal ("GpsrRsuAddresses", StringValue (""));
+  NS_TEST_EXPECT_MSG_EQ (RsuDirectory::IsRsu (Ipv4Address ("10.1.0.1")), false, "No RSU");
+  Config::SetGlobal ("GpsrRsuAddresses", StringValue ("10.0.0.1,10.0.0.2,10.0.0.3"));
+}
+
 class GpsrTestSuite : public TestSuite
 {
 public:
   GpsrTestSuite () : TestSuite ("routing-gpsr", UNIT)
   {
     AddTestCase (new NeighborTest);
+    AddTestCase (new NeighborIndexTest);
+    AddTestCase (new PerimeterTest);
+    AddTestCase (new LocationIndexTest);
+    AddTestCase (new PositionSnapshotTest);
+    AddTestCase (new PositionPredictorTest);
+    AddTestCase (new AdaptiveUpdateTest);
+    AddTestCase (new EventLogTest);
     AddTestCase (new TypeHeaderTest);
     AddTestCase (new HelloHeaderTest);
     AddTestCase (new PositionHeaderTest);
+    AddTestCase (new DataHeaderTest);
+    AddTestCase (new WireFormatTest);
+    AddTestCase (new SlsBatchTest);
+    AddTestCase (new SlsReceiveTest);
     AddTestCase (new GpsrRqueueTest);
+    AddTestCase (new GpsrRqueueIndexTest);
+    AddTestCase (new RsuDirectoryTest (GpsrHelper::BACKHAUL_BUS, "RsuDirectoryBus"));
+    AddTestCase (new RsuDirectoryTest (GpsrHelper::BACKHAUL_CHAIN, "RsuDirectoryChain"));
   }
 } g_gpsrTestSuite;
 
@@ -195,6 +195,12 @@ public:
   Ipv4InterfaceAddress GetAddress (uint32_t interfaceIndex, uint32_t addressIndex) const;
   uint32_t GetNAddresses (uint32_t interface) const;
   bool RemoveAddress (uint32_t interfaceIndex, uint32_t addressIndex);
+  /**
+   * \returns a counter incremented whenever an address is added to or
+   *          removed from any Ipv4L3Protocol, so that the caches of
+   *          addresses can tell when they are stale.
+   */
+  static uint32_t GetAddressGeneration (void);
   Ipv4Address SelectSourceAddress (Ptr<const NetDevice> device,
                                    Ipv4Address dst, Ipv4InterfaceAddress::InterfaceAddressScope_e scope);
 
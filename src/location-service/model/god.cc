@@ -7,6 +7,7 @@
 #include "ns3/mobility-model.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
+#include "location-index.h"
 
 NS_LOG_COMPONENT_DEFINE ("GodLocationService");
 
@@ -28,7 +29,8 @@ GodLocationService::~GodLocationService ()
 void
 GodLocationService::DoDispose ()
 {
-  return;
+  m_ipv4 = 0;
+  LocationService::DoDispose ();
 }
 
 void
@@ -42,27 +44,17 @@ GodLocationService::Start ()
 Vector
 GodLocationService::GetPosition(Ipv4Address adr)
 {
-  uint32_t n = NodeList().GetNNodes ();
-  uint32_t i;
-  Ptr<Node> node;
-  
-  NS_LOG_UNCOND("::GODLS:: Obtaining position of " << adr);
+  NS_LOG_DEBUG("::GODLS:: Obtaining position of " << adr);
 
-  for(i = 0; i < n; i++)
+  Ptr<MobilityModel> mobility = LocationIndex::GetMobilityModel (adr);
+  if (mobility != 0)
   {
-	  node = NodeList().GetNode (i);
-	  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-
-	  //NS_LOG_UNCOND("Have " << ipv4->GetAddress (1, 0).GetLocal ());
-	  if(ipv4->GetAddress (1, 0).GetLocal () == adr)
-	  {
-		  NS_LOG_UNCOND("::GODLS:: Position: <" << (*node->GetObject<MobilityModel>()).GetPosition ().x
-				  << "," << (*node->GetObject<MobilityModel>()).GetPosition ().y << ">");
-		  return (*node->GetObject<MobilityModel>()).GetPosition ();
-	  }
+	  Vector position = mobility->GetPosition ();
+	  NS_LOG_DEBUG("::GODLS:: Position: <" << position.x << "," << position.y << ">");
+	  return position;
   }
   Vector v;
-  NS_LOG_UNCOND("::GODLS:: Position: <" << v.x << "," << v.y << ">");
+  NS_LOG_DEBUG("::GODLS:: Position: <" << v.x << "," << v.y << ">");
   return v;
 }
   
@@ -81,7 +73,7 @@ GodLocationService::GetPosition(Ipv4Address adr)
   void 
   GodLocationService::SetIpv4 (Ptr<Ipv4> ipv4)
   {
-    return;
+    m_ipv4 = ipv4;
   }
 
   Vector 
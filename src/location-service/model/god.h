@@ -43,6 +43,8 @@ public:
 private:
   /// Start protocol operation
   void Start ();
+  /// IPv4 of the node, for the log context
+  Ptr<Ipv4> m_ipv4;
 };
 }
 #endif /* GodLocationService_H */
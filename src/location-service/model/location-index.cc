@@ -0,0 +1,173 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "location-index.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("LocationIndex");
+
+namespace ns3 {
+
+#ifdef HAVE_PTHREAD_H
+/// guards the tables, used by the nodes run in parallel
+static SystemMutex g_locationIndexMutex;
+#endif
+
+LocationIndex::Tables *
+LocationIndex::Get (void)
+{
+  return *DoGet ();
+}
+
+LocationIndex::Tables **
+LocationIndex::DoGet (void)
+{
+  static Tables *index = 0;
+  if (index == 0)
+    {
+      index = new Tables ();
+      Simulator::ScheduleDestroy (&LocationIndex::Delete);
+    }
+  return &index;
+}
+
+void
+LocationIndex::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Tables **index = DoGet ();
+  delete *index;
+  *index = 0;
+}
+
+void
+LocationIndex::Add (Ipv4Address address, Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (address << node);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_locationIndexMutex);
+#endif
+  Entry entry;
+  entry.node = node;
+  Tables *tables = Get ();
+  tables->entries[address] = entry;
+  // an address may be found now
+  if (!tables->misses.empty ())
+    {
+      tables->misses.clear ();
+    }
+}
+
+void
+LocationIndex::Remove (Ipv4Address address)
+{
+  NS_LOG_FUNCTION (address);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_locationIndexMutex);
+#endif
+  Get ()->entries.erase (address);
+}
+
+void
+LocationIndex::Clear (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_locationIndexMutex);
+#endif
+  Tables *tables = Get ();
+  tables->entries.clear ();
+  tables->misses.clear ();
+}
+
+LocationIndex::Entry *
+LocationIndex::Find (Ipv4Address address)
+{
+  Tables *tables = Get ();
+  Index::iterator i = tables->entries.find (address);
+  if (i != tables->entries.end ())
+    {
+      return &i->second;
+    }
+  if (!tables->misses.empty ()
+      && (tables->nNodes != NodeList::GetNNodes ()
+          || tables->addressGeneration != Ipv4L3Protocol::GetAddressGeneration ()))
+    {
+      // a node or an address was added since the misses were searched
+      tables->misses.clear ();
+    }
+  if (tables->misses.find (address) != tables->misses.end ())
+    {
+      return 0;
+    }
+  for (NodeList::Iterator n = NodeList::Begin (); n != NodeList::End (); n++)
+    {
+      Ptr<Ipv4> ipv4 = (*n)->GetObject<Ipv4> ();
+      if (ipv4 == 0)
+        {
+          continue;
+        }
+      for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
+        {
+          for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+            {
+              if (ipv4->GetAddress (j, k).GetLocal () == address)
+                {
+                  NS_LOG_LOGIC ("address " << address << " not registered, found on node " << (*n)->GetId ());
+                  Entry &entry = tables->entries[address];
+                  entry.node = *n;
+                  return &entry;
+                }
+            }
+        }
+    }
+  NS_LOG_LOGIC ("address " << address << " not found");
+  if (tables->misses.empty ())
+    {
+      tables->nNodes = NodeList::GetNNodes ();
+      tables->addressGeneration = Ipv4L3Protocol::GetAddressGeneration ();
+    }
+  tables->misses[address] = Entry ();
+  return 0;
+}
+
+Ptr<Node>
+LocationIndex::GetNode (Ipv4Address address)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_locationIndexMutex);
+#endif
+  Entry *entry = Find (address);
+  if (entry == 0)
+    {
+      return 0;
+    }
+  return entry->node;
+}
+
+Ptr<MobilityModel>
+LocationIndex::GetMobilityModel (Ipv4Address address)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection lock (g_locationIndexMutex);
+#endif
+  Entry *entry = Find (address);
+  if (entry == 0)
+    {
+      return 0;
+    }
+  if (entry->mobility == 0)
+    {
+      // the mobility model may be aggregated after the address is assigned
+      entry->mobility = entry->node->GetObject<MobilityModel> ();
+    }
+  return entry->mobility;
+}
+
+} // namespace ns3
@@ -25,5 +25,29 @@ NS_LOG_COMPONENT_DEFINE ("LocationService");
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (LocationService);
- 
+
+LocationService::LocationService ()
+  : m_predictor (CreateObject<ConstantVelocityPredictor> ())
+{
+}
+
+void
+LocationService::DoDispose ()
+{
+  m_predictor = 0;
+  Object::DoDispose ();
+}
+
+void
+LocationService::SetPredictor (Ptr<PositionPredictor> predictor)
+{
+  m_predictor = predictor;
+}
+
+Ptr<PositionPredictor>
+LocationService::GetPredictor (void) const
+{
+  return m_predictor;
+}
+
 }
@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/location-service.h"
 #include "ns3/vector.h"
+#include "ns3/position-predictor.h"
 #include "ns3/log.h"
 #include <map>
 
@@ -49,6 +50,16 @@ public:
   virtual void Purge () = 0;
   virtual void Clear () = 0;
 
+  /// Extrapolates the last known positions, a ConstantVelocityPredictor by default
+  void SetPredictor (Ptr<PositionPredictor> predictor);
+  Ptr<PositionPredictor> GetPredictor (void) const;
+
+protected:
+  LocationService ();
+  virtual void DoDispose ();
+
+  Ptr<PositionPredictor> m_predictor;
+
 private:
   void Start ();
 };
@@ -0,0 +1,282 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+#include "position-predictor.h"
+#include "location-index.h"
+#include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/abort.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <cmath>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE ("PositionPredictor");
+
+namespace ns3 {
+
+KinematicState::KinematicState ()
+{
+}
+
+KinematicState::KinematicState (Vector position, Vector velocity, Time time)
+  : position (position),
+    velocity (velocity),
+    time (time)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (PositionPredictor);
+
+TypeId
+PositionPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PositionPredictor")
+    .SetParent<Object> ()
+    .AddTraceSource ("PredictionError",
+                     "A position was predicted for a node: address, prediction, distance to the true position (m).",
+                     MakeTraceSourceAccessor (&PositionPredictor::m_errorTrace))
+  ;
+  return tid;
+}
+
+Vector
+PositionPredictor::Predict (const KinematicState &state, Time at) const
+{
+  return DoPredict (state, (at - state.time).GetSeconds ());
+}
+
+Vector
+PositionPredictor::Predict (Ipv4Address id, const KinematicState &state, Time at)
+{
+  Vector position = Predict (state, at);
+  Ptr<MobilityModel> mobility = LocationIndex::GetMobilityModel (id);
+  if (mobility != 0)
+    {
+      double error = CalculateDistance (position, mobility->GetPosition ());
+      NS_LOG_LOGIC (id << " predicted at " << position << " error " << error);
+      m_errorTrace (id, position, error);
+    }
+  return position;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (ConstantVelocityPredictor);
+
+TypeId
+ConstantVelocityPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConstantVelocityPredictor")
+    .SetParent<PositionPredictor> ()
+    .AddConstructor<ConstantVelocityPredictor> ()
+  ;
+  return tid;
+}
+
+Vector
+ConstantVelocityPredictor::DoPredict (const KinematicState &state, double dt) const
+{
+  return Vector (state.position.x + state.velocity.x * dt,
+                 state.position.y + state.velocity.y * dt,
+                 state.position.z + state.velocity.z * dt);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (ConstantAccelerationPredictor);
+
+TypeId
+ConstantAccelerationPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConstantAccelerationPredictor")
+    .SetParent<PositionPredictor> ()
+    .AddConstructor<ConstantAccelerationPredictor> ()
+  ;
+  return tid;
+}
+
+Vector
+ConstantAccelerationPredictor::DoPredict (const KinematicState &state, double dt) const
+{
+  const Vector &v = state.velocity;
+  const Vector &a = state.acceleration;
+  double va = v.x * a.x + v.y * a.y + v.z * a.z;
+  if (va < 0)
+    {
+      // braking: the speed along v reaches zero after -va / |a|^2
+      double aa = a.x * a.x + a.y * a.y + a.z * a.z;
+      dt = std::min (dt, -va / aa);
+    }
+  double half = dt * dt / 2;
+  return Vector (state.position.x + v.x * dt + a.x * half,
+                 state.position.y + v.y * dt + a.y * half,
+                 state.position.z + v.z * dt + a.z * half);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (LanePredictor);
+
+TypeId
+LanePredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LanePredictor")
+    .SetParent<PositionPredictor> ()
+    .AddConstructor<LanePredictor> ()
+  ;
+  return tid;
+}
+
+void
+LanePredictor::SetRoad (const std::vector<Vector> &points)
+{
+  m_road.clear ();
+  m_distance.clear ();
+  for (std::vector<Vector>::const_iterator i = points.begin (); i != points.end (); ++i)
+    {
+      if (m_road.empty ())
+        {
+          m_distance.push_back (0);
+        }
+      else
+        {
+          double length = CalculateDistance (m_road.back (), *i);
+          if (length == 0)
+            {
+              continue;
+            }
+          m_distance.push_back (m_distance.back () + length);
+        }
+      m_road.push_back (*i);
+    }
+}
+
+const std::vector<Vector> &
+LanePredictor::GetRoad (void) const
+{
+  return m_road;
+}
+
+uint32_t
+LanePredictor::GetSegment (double s) const
+{
+  std::vector<double>::const_iterator i = std::upper_bound (m_distance.begin (), m_distance.end (), s);
+  uint32_t k = std::max<int> (i - m_distance.begin (), 1) - 1;
+  return std::min<uint32_t> (k, m_road.size () - 2);
+}
+
+Vector
+LanePredictor::GetPoint (double s) const
+{
+  uint32_t k = GetSegment (s);
+  double t = (s - m_distance[k]) / (m_distance[k + 1] - m_distance[k]);
+  const Vector &a = m_road[k];
+  const Vector &b = m_road[k + 1];
+  return Vector (a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+}
+
+Vector
+LanePredictor::DoPredict (const KinematicState &state, double dt) const
+{
+  const Vector &p = state.position;
+  const Vector &v = state.velocity;
+  if (m_road.size () < 2)
+    {
+      return Vector (p.x + v.x * dt, p.y + v.y * dt, p.z + v.z * dt);
+    }
+  // nearest segment, in the plane
+  uint32_t best = 0;
+  double bestT = 0;
+  double bestD = std::numeric_limits<double>::max ();
+  for (uint32_t k = 0; k + 1 < m_road.size (); k++)
+    {
+      const Vector &a = m_road[k];
+      const Vector &b = m_road[k + 1];
+      double dx = b.x - a.x, dy = b.y - a.y;
+      double t = ((p.x - a.x) * dx + (p.y - a.y) * dy) / (dx * dx + dy * dy);
+      t = std::max (0.0, std::min (1.0, t));
+      double ex = a.x + dx * t - p.x, ey = a.y + dy * t - p.y;
+      double d = ex * ex + ey * ey;
+      if (d < bestD)
+        {
+          best = k;
+          bestT = t;
+          bestD = d;
+        }
+    }
+  const Vector &a = m_road[best];
+  const Vector &b = m_road[best + 1];
+  double length = m_distance[best + 1] - m_distance[best];
+  double ux = (b.x - a.x) / length, uy = (b.y - a.y) / length;
+  // lateral offset, positive on the left of the road
+  double offset = ux * (p.y - a.y) - uy * (p.x - a.x);
+  double speed = std::sqrt (v.x * v.x + v.y * v.y);
+  if (v.x * ux + v.y * uy < 0)
+    {
+      speed = -speed;
+    }
+  double s = m_distance[best] + bestT * length + speed * dt;
+  s = std::max (0.0, std::min (m_distance.back (), s));
+
+  Vector q = GetPoint (s);
+  // the offset is applied along the normal of the segment holding s
+  uint32_t k = GetSegment (s);
+  double l = m_distance[k + 1] - m_distance[k];
+  double nx = -(m_road[k + 1].y - m_road[k].y) / l, ny = (m_road[k + 1].x - m_road[k].x) / l;
+  return Vector (q.x + nx * offset, q.y + ny * offset, p.z);
+}
+
+std::vector<Vector>
+LanePredictor::ReadNs2Road (std::string filename, uint32_t node)
+{
+  std::ifstream file (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Could not open " << filename);
+  std::ostringstream oss;
+  oss << "$node_(" << node << ")";
+  std::string tag = oss.str ();
+
+  Vector initial;
+  std::multimap<double, Vector> waypoints;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::string::size_type pos = line.find (tag);
+      if (pos == std::string::npos)
+        {
+          continue;
+        }
+      std::istringstream rest (line.substr (pos + tag.size ()));
+      std::string word;
+      rest >> word;
+      if (word == "set")
+        {
+          std::string axis;
+          double value;
+          rest >> axis >> value;
+          if (axis == "X_")
+            {
+              initial.x = value;
+            }
+          else if (axis == "Y_")
+            {
+              initial.y = value;
+            }
+        }
+      else if (word == "setdest")
+        {
+          // $ns_ at <time> "$node_(<node>) setdest <x> <y> <speed>"
+          double time = 0;
+          std::istringstream head (line.substr (0, pos));
+          std::string ns, at;
+          head >> ns >> at >> time;
+          Vector destination;
+          rest >> destination.x >> destination.y;
+          waypoints.insert (std::make_pair (time, destination));
+        }
+    }
+
+  std::vector<Vector> road;
+  road.push_back (initial);
+  for (std::multimap<double, Vector>::const_iterator i = waypoints.begin (); i != waypoints.end (); ++i)
+    {
+      road.push_back (i->second);
+    }
+  return road;
+}
+
+} // namespace ns3
@@ -282,7 +282,7 @@ LteSpectrumPhy::StartTx (Ptr<PacketBurst> pb)
       txParams->duration = Seconds (tti);
       txParams->txPhy = GetObject<SpectrumPhy> ();
       txParams->psd = m_txPsd;
-      txParams->packetBurst = pb;
+      txParams->packetBurst = pb->Copy ();
       m_channel->StartTx (txParams);
       Simulator::Schedule (Seconds (tti), &LteSpectrumPhy::EndTx, this);
       return false;
@@ -20,6 +20,8 @@
 
 #include <ns3/log.h>
 #include <ns3/packet-burst.h>
+#include <ns3/packet.h>
+#include <ns3/simulator.h>
 #include "lte-spectrum-signal-parameters.h"
 
 
@@ -36,7 +38,20 @@ LteSpectrumSignalParameters::LteSpectrumSignalParameters (const LteSpectrumSigna
   : SpectrumSignalParameters (p)
 {
   NS_LOG_FUNCTION (this << &p);
-  packetBurst = p.packetBurst->Copy ();
+  // the receivers share the burst, unless their events may run in
+  // parallel
+  if (Simulator::IsParallel ())
+    {
+      packetBurst = CreateObject<PacketBurst> ();
+      for (std::list<Ptr<Packet> >::const_iterator i = p.packetBurst->Begin (); i != p.packetBurst->End (); ++i)
+        {
+          packetBurst->AddPacket ((*i)->DeepCopy ());
+        }
+    }
+  else
+    {
+      packetBurst = p.packetBurst;
+    }
 }
 
 Ptr<SpectrumSignalParameters>
@@ -50,7 +50,9 @@ struct LteSpectrumSignalParameters : public SpectrumSignalParameters
   LteSpectrumSignalParameters (const LteSpectrumSignalParameters& p);
 
   /**
-   * The packet burst being transmitted with this signal
+   * The packet burst being transmitted with this signal. The copies of
+   * the parameters share it, unless the simulator runs events in
+   * parallel: it must be copied before being modified.
    */
   Ptr<PacketBurst> packetBurst;
 };
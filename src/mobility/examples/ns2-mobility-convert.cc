@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Converts a ns2 movement trace to the binary format that
+ * Ns2MobilityHelper maps into memory:
+ *
+ *   ./waf --run "ns2-mobility-convert --input=high-1.1-out.tcl --output=high-1.1-out.bin"
+ *
+ * With --compare, it then installs both traces on as many nodes as the
+ * trace has and prints how long each installation took.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+
+using namespace ns3;
+
+static int64_t
+InstallTrace (std::string filename, uint32_t size)
+{
+  NodeContainer nodes;
+  nodes.Create (size);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ns2MobilityHelper mobility (filename);
+  mobility.Install (nodes.Begin (), nodes.End ());
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  bool compare = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "ns2 movement trace.", input);
+  cmd.AddValue ("output", "Binary trace to write.", output);
+  cmd.AddValue ("compare", "Time the installation of both traces.", compare);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "Usage: ns2-mobility-convert --input=<trace.tcl> --output=<trace.bin>" << std::endl;
+      return 1;
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ns2MobilityHelper::Convert (input, output);
+  std::cout << "Converted " << input << " to " << output << " in " << clock.End () << " ms" << std::endl;
+
+  if (compare)
+    {
+      uint32_t size = Ns2MobilityHelper::Preload (output);
+      std::cout << "Installing " << size << " nodes: text " << InstallTrace (input, size) << " ms, binary "
+                << InstallTrace (output, size) << " ms" << std::endl;
+    }
+  return 0;
+}
@@ -35,17 +35,35 @@
  * $ns at $time $node set Y_ Y1
  * $ns at $time $node set Z_ Z1
  *
+ * The statements of a trace are turned into an array of time sorted
+ * records per node, which a cursor per node feeds to its mobility model as
+ * the simulation goes: the event queue only holds the next record time of
+ * each node. Ns2MobilityHelper::Convert writes the records into a binary
+ * trace, which the helper maps into memory instead of parsing it.
+ *
  */
 
 
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/simulator.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
 #include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
 #include "ns2-mobility-helper.h"
 
 NS_LOG_COMPONENT_DEFINE ("Ns2MobilityHelper");
@@ -77,6 +95,160 @@ struct ParseResult
 };
 
 
+// One movement statement of a trace file, in file order
+struct Ns2Statement
+{
+  enum Type
+  {
+    INITIAL_POS, // $node_(0) set X_ 123
+    SETDEST,     // $ns_ at 1 "$node_(0) setdest 2 3 4"
+    SCHED_POS,   // $ns_ at 1 "$node_(0) set X_ 2"
+  };
+  Type type;
+  int iNodeId;
+  string nodeId;
+  double at;
+  string coord;  // X_, Y_ or Z_ of the set statements
+  double x;      // coordinate value of the set statements
+  double y;
+  double speed;
+};
+
+/*
+ * Binary traces. A header is followed by one entry per node id and by the
+ * records of all the nodes; the records of a node are contiguous and sorted
+ * by time. Fields are in host byte order: a trace written on a host of the
+ * other byte order has a wrong version.
+ */
+static const char NS2_BINARY_MAGIC[8] = { 'N', 'S', '2', 'M', 'O', 'B', 'I', 'N' };
+static const uint32_t NS2_BINARY_VERSION = 1;
+
+struct Ns2BinaryHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t nNodes;
+  uint64_t nRecords;
+};
+
+struct Ns2BinaryNode
+{
+  enum Flags
+  {
+    PRESENT = 1,   // the trace has statements for the node
+    SET_X = 2,     // the model is given these initial coordinates on install
+    SET_Y = 4,
+    SET_Z = 8,
+  };
+  uint64_t first;      // index of its first record
+  uint32_t count;      // number of records
+  uint32_t flags;
+  double initial[3];   // initial position
+};
+
+// What a scheduled statement does to the node at time
+struct Ns2BinaryRecord
+{
+  enum Kind
+  {
+    SET_POSITION = 1,  // ConstantVelocityMobilityModel::SetPosition (position)
+    SET_VELOCITY = 2,  // ConstantVelocityMobilityModel::SetVelocity (velocity)
+  };
+  double time;
+  uint32_t kind;
+  uint32_t reserved;
+  double position[3];  // position of the node once it is done
+  double velocity[3];  // velocity of the node once it is done
+};
+
+// Statement effects on a node, in file order: the position the model is
+// given on install, the last position used by the setdests and the calls
+// to make, in the order the statements have them
+struct Ns2Track
+{
+  uint32_t flags;
+  Vector model;
+  Vector last;
+  vector<Ns2BinaryRecord> scheduled;
+};
+
+static bool
+EarlierNs2Record (const Ns2BinaryRecord &a, const Ns2BinaryRecord &b)
+{
+  return Seconds (a.time) < Seconds (b.time);
+}
+
+// Nodes and records built from the statements of a text trace
+struct Ns2RecordStore : public SimpleRefCount<Ns2RecordStore>
+{
+  vector<Ns2BinaryNode> nodes;
+  vector<Ns2BinaryRecord> records;
+};
+
+// The records of a trace, mapped from a binary trace or kept in the store
+// they were built in
+struct Ns2BinaryTrace
+{
+  uint32_t nNodes;
+  const Ns2BinaryNode *nodes;
+  const Ns2BinaryRecord *records;
+  Ptr<Ns2RecordStore> built;
+};
+
+/*
+ * Feeds the records of a node to its mobility model. The cursor only
+ * schedules the next record time of the node and schedules the following
+ * one when it runs, so that the event queue holds one mobility event per
+ * node instead of one per trace statement.
+ */
+class Ns2RecordCursor : public SimpleRefCount<Ns2RecordCursor>
+{
+public:
+  Ns2RecordCursor (const Ns2BinaryTrace &trace, const Ns2BinaryNode &node);
+  // Calls the model at the time of each record
+  void Start (Ptr<ConstantVelocityMobilityModel> model);
+  // Gives the model one waypoint per record time, starting at initial
+  void Start (Ptr<WaypointMobilityModel> model, Vector initial);
+private:
+  // Time of a record, relative to the time the trace was installed at
+  Time GetTime (const Ns2BinaryRecord *record) const;
+  // First record after the ones of the same time as the next record
+  const Ns2BinaryRecord * GetEndOfTime (void) const;
+  void SetRecords (void);
+  void AddWaypoint (void);
+  void FeedWaypoints (void);
+
+  Ptr<Ns2RecordStore> m_built;
+  const Ns2BinaryRecord *m_next;
+  const Ns2BinaryRecord *m_end;
+  Time m_start;
+  Ptr<ConstantVelocityMobilityModel> m_velocity;
+  Ptr<WaypointMobilityModel> m_waypoints;
+  Time m_lastWaypoint;
+};
+
+// Binary traces mapped so far, by file name. They stay mapped until exit.
+static map<string, Ns2BinaryTrace> g_mapped;
+
+// Checks if a file starts like a binary trace
+static bool IsNs2Binary (const string& filename);
+
+// Maps a binary trace, once
+static const Ns2BinaryTrace & MapNs2Binary (const string& filename);
+
+// Builds the binary nodes and records of the statements of a trace
+static void BuildNs2Binary (const vector<Ns2Statement>& statements,
+                            vector<Ns2BinaryNode>& nodes, vector<Ns2BinaryRecord>& records);
+
+// Text traces built by Ns2MobilityHelper::Preload, by file name
+static map<string, Ptr<Ns2RecordStore> > g_preloaded;
+
+// Builds the records of a text trace, unless it is preloaded
+static Ptr<Ns2RecordStore> LoadNs2Text (const string& filename);
+
+// Reads the movement statements of a trace file
+static void ParseNs2File (const string& filename, vector<Ns2Statement>& statements);
+
 // Parses a line of ns2 mobility
 static ParseResult ParseNs2Line (const string& str);
 
@@ -114,15 +286,10 @@ static bool IsSchedSetPos (ParseResult pr);
 // Check if this corresponds to a line like this: $ns_ at 1 "$node_(0) set X_ 2"
 static bool IsSchedMobilityPos (ParseResult pr);
 
-// Set waypoints and speed for movement.
-static Vector SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector lastPos, double at,
-                           double xFinalPosition, double yFinalPosition, double speed);
-
-// Set initial position for a node
-static Vector SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, string coord, double coordVal);
+// Velocity of a setdest from position, returns the time to reach its destination
+static double GetSetdestVelocity (Vector position, double xFinalPosition, double yFinalPosition,
+                                  double speed, Vector& velocity);
 
-// Schedule a set of position for a node
-static Vector SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, string coord, double coordVal);
 
 
 Ns2MobilityHelper::Ns2MobilityHelper (std::string filename)
@@ -131,12 +298,8 @@ Ns2MobilityHelper::Ns2MobilityHelper (std::string filename)
 }
 
 Ptr<ConstantVelocityMobilityModel>
-Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &store) const
+Ns2MobilityHelper::GetMobilityModel (uint32_t id, const ObjectStore &store) const
 {
-  std::istringstream iss;
-  iss.str (idString);
-  uint32_t id (0);
-  iss >> id;
   Ptr<Object> object = store.Get (id);
   if (object == 0)
     {
@@ -152,18 +315,406 @@ Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &st
 }
 
 
+uint32_t
+Ns2MobilityHelper::Preload (std::string filename)
+{
+  if (IsNs2Binary (filename))
+    {
+      return MapNs2Binary (filename).nNodes;
+    }
+  Ptr<Ns2RecordStore> built = LoadNs2Text (filename);
+  g_preloaded[filename] = built;
+  return built->nodes.size ();
+}
+
+void
+Ns2MobilityHelper::Convert (std::string input, std::string output)
+{
+  Ptr<Ns2RecordStore> built = LoadNs2Text (input);
+  const vector<Ns2BinaryNode> &nodes = built->nodes;
+  const vector<Ns2BinaryRecord> &records = built->records;
+
+  Ns2BinaryHeader header;
+  std::memcpy (header.magic, NS2_BINARY_MAGIC, sizeof (header.magic));
+  header.version = NS2_BINARY_VERSION;
+  header.nNodes = nodes.size ();
+  header.nRecords = records.size ();
+
+  std::ofstream file (output.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Could not open " << output);
+  file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!nodes.empty ())
+    {
+      file.write (reinterpret_cast<const char *> (&nodes[0]), nodes.size () * sizeof (Ns2BinaryNode));
+    }
+  if (!records.empty ())
+    {
+      file.write (reinterpret_cast<const char *> (&records[0]), records.size () * sizeof (Ns2BinaryRecord));
+    }
+  file.close ();
+  NS_ABORT_MSG_IF (file.fail (), "Could not write " << output);
+  NS_LOG_INFO ("Converted " << input << " to " << output << ": " << nodes.size () << " nodes, "
+                            << records.size () << " records");
+}
+
 void
 Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
 {
-  map<int, Vector> last_pos;    // Vector containing lasts positions for each node
+  Ns2BinaryTrace trace;
+  if (IsNs2Binary (m_filename))
+    {
+      trace = MapNs2Binary (m_filename);
+    }
+  else
+    {
+      trace.built = LoadNs2Text (m_filename);
+      trace.nNodes = trace.built->nodes.size ();
+      trace.nodes = trace.nNodes ? &trace.built->nodes[0] : 0;
+      trace.records = trace.built->records.empty () ? 0 : &trace.built->records[0];
+    }
+
+  for (uint32_t i = 0; i < trace.nNodes; i++)
+    {
+      const Ns2BinaryNode &node = trace.nodes[i];
+      if (!(node.flags & Ns2BinaryNode::PRESENT))
+        {
+          continue;
+        }
+      Ptr<Object> object = store.Get (i);
+      if (object == 0)
+        {
+          NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << i << "\n");
+          continue;
+        }
+      Ptr<Ns2RecordCursor> cursor = Create<Ns2RecordCursor> (trace, node);
+
+      Ptr<WaypointMobilityModel> waypoints = object->GetObject<WaypointMobilityModel> ();
+      if (waypoints != 0)
+        {
+          cursor->Start (waypoints, Vector (node.initial[0], node.initial[1], node.initial[2]));
+          continue;
+        }
+
+      Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (i, store);
+      if (node.flags & (Ns2BinaryNode::SET_X | Ns2BinaryNode::SET_Y | Ns2BinaryNode::SET_Z))
+        {
+          Vector position = model->GetPosition ();
+          if (node.flags & Ns2BinaryNode::SET_X)
+            {
+              position.x = node.initial[0];
+            }
+          if (node.flags & Ns2BinaryNode::SET_Y)
+            {
+              position.y = node.initial[1];
+            }
+          if (node.flags & Ns2BinaryNode::SET_Z)
+            {
+              position.z = node.initial[2];
+            }
+          model->SetPosition (position);
+        }
+      cursor->Start (model);
+
+      // Log new position
+      NS_LOG_DEBUG ("Positions after parse for node " << i << " x=" << model->GetPosition ().x
+                                                      << " y=" << model->GetPosition ().y
+                                                      << " z=" << model->GetPosition ().z);
+    }
+}
+
+
+Ns2RecordCursor::Ns2RecordCursor (const Ns2BinaryTrace &trace, const Ns2BinaryNode &node)
+  : m_built (trace.built),
+    m_next (trace.records + node.first),
+    m_end (trace.records + node.first + node.count),
+    m_start (Simulator::Now ())
+{
+}
 
-  std::ifstream file (m_filename.c_str (), std::ios::in);
+void
+Ns2RecordCursor::Start (Ptr<ConstantVelocityMobilityModel> model)
+{
+  m_velocity = model;
+  if (m_next != m_end)
+    {
+      Simulator::Schedule (GetTime (m_next) - Simulator::Now (), &Ns2RecordCursor::SetRecords,
+                           Ptr<Ns2RecordCursor> (this));
+    }
+}
+
+void
+Ns2RecordCursor::Start (Ptr<WaypointMobilityModel> model, Vector initial)
+{
+  m_waypoints = model;
+  m_waypoints->AddWaypoint (Waypoint (m_start, initial));
+  if (m_next != m_end)
+    {
+      AddWaypoint ();
+      FeedWaypoints ();
+    }
+}
+
+Time
+Ns2RecordCursor::GetTime (const Ns2BinaryRecord *record) const
+{
+  return m_start + Seconds (record->time);
+}
+
+const Ns2BinaryRecord *
+Ns2RecordCursor::GetEndOfTime (void) const
+{
+  const Ns2BinaryRecord *end = m_next + 1;
+  while (end != m_end && Seconds (end->time) == Seconds (m_next->time))
+    {
+      end++;
+    }
+  return end;
+}
+
+void
+Ns2RecordCursor::SetRecords (void)
+{
+  // the records of the same time, in the order the text trace had them scheduled
+  for (const Ns2BinaryRecord *end = GetEndOfTime (); m_next != end; m_next++)
+    {
+      if (m_next->kind == Ns2BinaryRecord::SET_POSITION)
+        {
+          m_velocity->SetPosition (Vector (m_next->position[0], m_next->position[1], m_next->position[2]));
+        }
+      else
+        {
+          m_velocity->SetVelocity (Vector (m_next->velocity[0], m_next->velocity[1], m_next->velocity[2]));
+        }
+    }
+  if (m_next != m_end)
+    {
+      Simulator::Schedule (GetTime (m_next) - Simulator::Now (), &Ns2RecordCursor::SetRecords,
+                           Ptr<Ns2RecordCursor> (this));
+    }
+}
+
+// The waypoint of a record time is where the node is once its records are
+// done. The node moves in straight lines between waypoints, so it slides to
+// the positions that a scheduled set puts it at instead of jumping there.
+void
+Ns2RecordCursor::AddWaypoint (void)
+{
+  const Ns2BinaryRecord *last = GetEndOfTime () - 1;
+  m_lastWaypoint = GetTime (last);
+  m_waypoints->AddWaypoint (Waypoint (m_lastWaypoint, Vector (last->position[0], last->position[1], last->position[2])));
+  m_next = last + 1;
+}
+
+/*
+ * Runs at the time of each waypoint but the last one added, and adds the
+ * next one. While the model moves towards the last waypoint added it has
+ * the following one queued, which it needs to go on once it gets there.
+ */
+void
+Ns2RecordCursor::FeedWaypoints (void)
+{
+  Time time = m_lastWaypoint;
+  if (m_next != m_end)
+    {
+      AddWaypoint ();
+      Simulator::Schedule (time - Simulator::Now (), &Ns2RecordCursor::FeedWaypoints,
+                           Ptr<Ns2RecordCursor> (this));
+    }
+}
+
+
+bool
+IsNs2Binary (const string& filename)
+{
+  if (g_mapped.find (filename) != g_mapped.end ())
+    {
+      return true;
+    }
+  char magic[sizeof (NS2_BINARY_MAGIC)];
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  return file.read (magic, sizeof (magic)) && std::memcmp (magic, NS2_BINARY_MAGIC, sizeof (magic)) == 0;
+}
+
+
+const Ns2BinaryTrace &
+MapNs2Binary (const string& filename)
+{
+  map<string, Ns2BinaryTrace>::const_iterator mapped = g_mapped.find (filename);
+  if (mapped != g_mapped.end ())
+    {
+      return mapped->second;
+    }
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd == -1, "Could not open " << filename << ": " << std::strerror (errno));
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) == -1, "Could not stat " << filename << ": " << std::strerror (errno));
+  uint64_t size = st.st_size;
+  NS_ABORT_MSG_IF (size < sizeof (Ns2BinaryHeader), "Truncated binary trace " << filename);
+  // read only and shared, so that all the processes mapping the trace use the same pages
+  void *data = mmap (0, size, PROT_READ, MAP_SHARED, fd, 0);
+  NS_ABORT_MSG_IF (data == MAP_FAILED, "Could not map " << filename << ": " << std::strerror (errno));
+  close (fd);
+
+  const Ns2BinaryHeader *header = static_cast<const Ns2BinaryHeader *> (data);
+  Ns2BinaryTrace trace;
+  trace.nNodes = header->nNodes;
+  trace.nodes = reinterpret_cast<const Ns2BinaryNode *> (header + 1);
+  trace.records = reinterpret_cast<const Ns2BinaryRecord *> (trace.nodes + header->nNodes);
+  NS_ABORT_MSG_UNLESS (header->version == NS2_BINARY_VERSION,
+                       "Binary trace " << filename << " has version " << header->version
+                                       << ", or was written on a host of another byte order");
+  NS_ABORT_MSG_IF (sizeof (Ns2BinaryHeader) + header->nNodes * sizeof (Ns2BinaryNode)
+                   + header->nRecords * sizeof (Ns2BinaryRecord) > size,
+                   "Truncated binary trace " << filename);
+  for (uint32_t i = 0; i < header->nNodes; i++)
+    {
+      NS_ABORT_MSG_IF (trace.nodes[i].first + trace.nodes[i].count > header->nRecords,
+                       "Corrupted binary trace " << filename << ": records of node " << i);
+    }
+  NS_LOG_INFO ("Mapped " << filename << ": " << header->nNodes << " nodes, "
+                         << header->nRecords << " records");
+  return g_mapped[filename] = trace;
+}
+
+
+void
+BuildNs2Binary (const vector<Ns2Statement>& statements,
+                vector<Ns2BinaryNode>& nodes, vector<Ns2BinaryRecord>& records)
+{
+  vector<Ns2Track> tracks;
+  for (vector<Ns2Statement>::const_iterator st = statements.begin (); st != statements.end (); ++st)
+    {
+      if (st->iNodeId >= (int) tracks.size ())
+        {
+          Ns2Track empty;
+          empty.flags = 0;
+          tracks.resize (st->iNodeId + 1, empty);
+        }
+      Ns2Track &track = tracks[st->iNodeId];
+      track.flags |= Ns2BinaryNode::PRESENT;
+
+      Ns2BinaryRecord record;
+      std::memset (&record, 0, sizeof (record));
+      record.time = st->at;
+      string coord = st->coord;
+      switch (st->type)
+        {
+        case Ns2Statement::INITIAL_POS:
+          track.model = SetOneInitialCoord (track.model, coord, st->x);
+          track.last = track.model;
+          track.flags |= coord == NS2_X_COORD ? Ns2BinaryNode::SET_X
+            : coord == NS2_Y_COORD ? Ns2BinaryNode::SET_Y : Ns2BinaryNode::SET_Z;
+          break;
+        case Ns2Statement::SETDEST:
+          record.kind = Ns2BinaryRecord::SET_VELOCITY;
+          if (st->speed == 0)
+            {
+              track.scheduled.push_back (record);
+            }
+          else if (st->speed > 0)
+            {
+              Vector velocity;
+              double time = GetSetdestVelocity (track.last, st->x, st->y, st->speed, velocity);
+              record.velocity[0] = velocity.x;
+              record.velocity[1] = velocity.y;
+              record.velocity[2] = velocity.z;
+              track.scheduled.push_back (record);
+              if (time >= 0)
+                {
+                  std::memset (record.velocity, 0, sizeof (record.velocity));
+                  record.time = st->at + time;
+                  track.scheduled.push_back (record);
+                }
+              track.last = Vector (st->x, st->y, 0);
+            }
+          break;
+        case Ns2Statement::SCHED_POS:
+          // the model takes the position right away too
+          track.model = SetOneInitialCoord (track.model, coord, st->x);
+          track.last = track.model;
+          track.flags |= coord == NS2_X_COORD ? Ns2BinaryNode::SET_X
+            : coord == NS2_Y_COORD ? Ns2BinaryNode::SET_Y : Ns2BinaryNode::SET_Z;
+          record.kind = Ns2BinaryRecord::SET_POSITION;
+          track.scheduled.push_back (record);
+          break;
+        }
+      // the scheduled position is the one of the model when it is scheduled
+      if (record.kind == Ns2BinaryRecord::SET_POSITION)
+        {
+          track.scheduled.back ().position[0] = track.model.x;
+          track.scheduled.back ().position[1] = track.model.y;
+          track.scheduled.back ().position[2] = track.model.z;
+        }
+    }
+
+  nodes.clear ();
+  records.clear ();
+  for (vector<Ns2Track>::iterator track = tracks.begin (); track != tracks.end (); ++track)
+    {
+      Ns2BinaryNode node;
+      node.first = records.size ();
+      node.flags = track->flags;
+      node.initial[0] = track->model.x;
+      node.initial[1] = track->model.y;
+      node.initial[2] = track->model.z;
+
+      // the calls of the same time are made in the order of the statements
+      std::stable_sort (track->scheduled.begin (), track->scheduled.end (), EarlierNs2Record);
+      Vector position = track->model;
+      Vector velocity;
+      Time now = Seconds (0);
+      for (vector<Ns2BinaryRecord>::iterator record = track->scheduled.begin (); record != track->scheduled.end (); ++record)
+        {
+          double dt = (Seconds (record->time) - now).GetSeconds ();
+          now = Seconds (record->time);
+          if (record->kind == Ns2BinaryRecord::SET_POSITION)
+            {
+              position = Vector (record->position[0], record->position[1], record->position[2]);
+              velocity = Vector ();
+            }
+          else
+            {
+              position.x += velocity.x * dt;
+              position.y += velocity.y * dt;
+              position.z += velocity.z * dt;
+              velocity = Vector (record->velocity[0], record->velocity[1], record->velocity[2]);
+              record->position[0] = position.x;
+              record->position[1] = position.y;
+              record->position[2] = position.z;
+            }
+          records.push_back (*record);
+        }
+      node.count = records.size () - node.first;
+      nodes.push_back (node);
+    }
+}
+
+
+Ptr<Ns2RecordStore>
+LoadNs2Text (const string& filename)
+{
+  map<string, Ptr<Ns2RecordStore> >::const_iterator preloaded = g_preloaded.find (filename);
+  if (preloaded != g_preloaded.end ())
+    {
+      return preloaded->second;
+    }
+  vector<Ns2Statement> statements;
+  ParseNs2File (filename, statements);
+  Ptr<Ns2RecordStore> built = Create<Ns2RecordStore> ();
+  BuildNs2Binary (statements, built->nodes, built->records);
+  return built;
+}
+
+
+void
+ParseNs2File (const string& filename, vector<Ns2Statement>& statements)
+{
+  std::ifstream file (filename.c_str (), std::ios::in);
   if (file.is_open ())
     {
       while (!file.eof () )
         {
-          int         iNodeId = 0;
-          std::string nodeId;
           std::string line;
 
           getline (file, line);
@@ -183,25 +734,19 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
               continue;
             }
 
+          Ns2Statement st;
           // Get the node Id
-          nodeId  = GetNodeIdString (pr);
-          iNodeId = GetNodeIdInt (pr);
-          if (iNodeId == -1)
+          st.nodeId  = GetNodeIdString (pr);
+          st.iNodeId = GetNodeIdInt (pr);
+          if (st.iNodeId == -1)
             {
               NS_LOG_ERROR ("Node number couldn't be obtained (corrupted file?): " << line << "\n");
               continue;
             }
-
-          // get mobility model of node
-          Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (nodeId,store);
-
-          // if model not exists, continue
-          if (model == 0)
-            {
-              NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << nodeId << "\n");
-              continue;
-            }
-
+          st.at = 0;
+          st.x = 0;
+          st.y = 0;
+          st.speed = 0;
 
           /*
            * In this case a initial position is being seted
@@ -209,31 +754,27 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
            */
           if (IsSetInitialPos (pr))
             {
-              //                                            coord         coord value
-              last_pos[iNodeId] = SetInitialPosition (model, pr.tokens[2], pr.dvals[3]);
-
-              // Log new position
-              NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                            " x=" << last_pos[iNodeId].x << " y=" << last_pos[iNodeId].y << " z=" << last_pos[iNodeId].z);
+              st.type = Ns2Statement::INITIAL_POS;
+              st.coord = pr.tokens[2];
+              st.x = pr.dvals[3];
+              statements.push_back (st);
             }
 
           else // NOW EVENTS TO BE SCHEDULED
             {
 
               // This is a scheduled event, so time at should be present
-              double at;
-
               if (!IsNumber (pr.tokens[2]))
                 {
                   NS_LOG_WARN ("Time is not a number: " << pr.tokens[2]);
                   continue;
                 }
 
-              at = pr.dvals[2]; // set time at
+              st.at = pr.dvals[2]; // set time at
 
-              if ( at < 0 )
+              if ( st.at < 0 )
                 {
-                  NS_LOG_WARN ("Time is less than cero: " << at);
+                  NS_LOG_WARN ("Time is less than cero: " << st.at);
                   continue;
                 }
 
@@ -245,12 +786,11 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
                */
               if (IsSchedMobilityPos (pr))
                 {
-                  //                                     last position     time  X coord     Y coord      velocity
-                  last_pos[iNodeId] = SetMovement (model, last_pos[iNodeId], at, pr.dvals[5], pr.dvals[6], pr.dvals[7]);
-
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                                " x=" << last_pos[iNodeId].x << " y=" << last_pos[iNodeId].y << " z=" << last_pos[iNodeId].z);
+                  st.type = Ns2Statement::SETDEST;
+                  st.x = pr.dvals[5];
+                  st.y = pr.dvals[6];
+                  st.speed = pr.dvals[7];
+                  statements.push_back (st);
                 }
 
 
@@ -260,12 +800,10 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
                */
               else if (IsSchedSetPos (pr))
                 {
-                  //                                         time  coordinate   coord value
-                  last_pos[iNodeId] = SetSchedPosition (model, at, pr.tokens[5], pr.dvals[6]);
-
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                                " x=" << last_pos[iNodeId].x << " y=" << last_pos[iNodeId].y << " z=" << last_pos[iNodeId].z);
+                  st.type = Ns2Statement::SCHED_POS;
+                  st.coord = pr.tokens[5];
+                  st.x = pr.dvals[6];
+                  statements.push_back (st);
                 }
               else
                 {
@@ -574,83 +1112,21 @@ IsSchedMobilityPos (ParseResult pr)
 
 }
 
-Vector
-SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double at,
-             double xFinalPosition, double yFinalPosition, double speed)
+double
+GetSetdestVelocity (Vector position, double xFinalPosition, double yFinalPosition,
+                    double speed, Vector& velocity)
 {
-  Vector position;
-  position.x = last_pos.x;
-  position.y = last_pos.y;
-  position.z = last_pos.z;
-
-  if (speed == 0)
-    {
-      // We have to maintain last position, and stop the movement
-      Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model,
-                           Vector (0, 0, 0));
-    }
-  else if (speed > 0)
-    {
-      // first calculate the time; time = distance / speed
-      double time = sqrt (pow (xFinalPosition - position.x, 2) + pow (yFinalPosition - position.y, 2)) / speed;
-      NS_LOG_DEBUG ("at=" << at << " time=" << time);
-      // now calculate the xSpeed = distance / time
-      double xSpeed = (xFinalPosition - position.x) / time;
-      double ySpeed = (yFinalPosition - position.y) / time; // & same with ySpeed
-
-      // quick and dirty set zSpeed = 0
-      double zSpeed = 0;
-
-      NS_LOG_DEBUG ("Calculated Speed: X=" << xSpeed << " Y=" << ySpeed << " Z=" << zSpeed);
-
-      // Set the Values
-      Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model,
-                           Vector (xSpeed, ySpeed, zSpeed));
-
-      if (time >= 0)
-        {
-          Simulator::Schedule (Seconds (at + time), &ConstantVelocityMobilityModel::SetVelocity,
-                               model, Vector (0, 0, 0));
-        }
-
-      position.x = xFinalPosition;
-      position.y = yFinalPosition;
-      position.z = 0;
-    }
-
-  return position;
-}
+  // first calculate the time; time = distance / speed
+  double time = sqrt (pow (xFinalPosition - position.x, 2) + pow (yFinalPosition - position.y, 2)) / speed;
+  // now calculate the xSpeed = distance / time
+  velocity.x = (xFinalPosition - position.x) / time;
+  velocity.y = (yFinalPosition - position.y) / time; // & same with ySpeed
 
+  // quick and dirty set zSpeed = 0
+  velocity.z = 0;
 
-Vector
-SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, string coord, double coordVal)
-{
-  model->SetPosition (SetOneInitialCoord (model->GetPosition (), coord, coordVal));
-
-  Vector position;
-  position.x = model->GetPosition ().x;
-  position.y = model->GetPosition ().y;
-  position.z = model->GetPosition ().z;
-
-  return position;
-}
-
-// Schedule a set of position for a node
-Vector
-SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, string coord, double coordVal)
-{
-  // update position
-  model->SetPosition (SetOneInitialCoord (model->GetPosition (), coord, coordVal));
-
-  Vector position;
-  position.x = model->GetPosition ().x;
-  position.y = model->GetPosition ().y;
-  position.z = model->GetPosition ().z;
-
-  // Chedule next positions
-  Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetPosition, model,position);
-
-  return position;
+  NS_LOG_DEBUG ("Calculated Speed: X=" << velocity.x << " Y=" << velocity.y << " Z=" << velocity.z);
+  return time;
 }
 
 void
@@ -56,6 +56,15 @@ class ConstantVelocityMobilityModel;
  *  - TraNS http://trans.epfl.ch/ 
  *
  *  See usage example in examples/mobility/ns2-mobility-trace.cc
+ *
+ * The movements are not all scheduled on install: each node has a cursor
+ * over its movements, time sorted, which schedules the next one when the
+ * previous one is done. The simulator event queue thus holds one mobility
+ * event per node whatever the length of the trace.
+ *
+ * A node which has a WaypointMobilityModel already gets the positions of
+ * the trace as waypoints, one waypoint ahead of time; the other nodes get
+ * a ConstantVelocityMobilityModel.
  */
 class Ns2MobilityHelper
 {
@@ -87,6 +96,34 @@ public:
    */
   template <typename T>
   void Install (T begin, T end) const;
+
+  /**
+   * \param filename filename of file which contains the
+   *        ns2 movement trace.
+   *
+   * Parse the trace file and keep its movements in memory. The helpers
+   * of the same file then configure the nodes from memory instead of
+   * reading the file again, in this process and in the processes it
+   * forks afterwards, which share the parsed trace read-only.
+   *
+   * \returns the number of nodes of the trace, one more than its
+   *          largest node id.
+   *
+   * A binary trace is mapped into memory instead.
+   */
+  static uint32_t Preload (std::string filename);
+
+  /**
+   * \param input filename of the ns2 movement trace.
+   * \param output filename of the binary trace to write.
+   *
+   * Convert a trace to the binary format, which holds the movements of
+   * each node as a time sorted array of records. The helpers of a binary
+   * trace map it read-only into memory and configure the nodes from it
+   * without parsing any text, and all the processes using the trace share
+   * its pages. The binary format is in host byte order.
+   */
+  static void Convert (std::string input, std::string output);
 private:
   class ObjectStore
   {
@@ -95,7 +132,7 @@ public:
     virtual Ptr<Object> Get (uint32_t i) const = 0;
   };
   void ConfigNodesMovements (const ObjectStore &store) const;
-  Ptr<ConstantVelocityMobilityModel> GetMobilityModel (std::string idString, const ObjectStore &store) const;
+  Ptr<ConstantVelocityMobilityModel> GetMobilityModel (uint32_t id, const ObjectStore &store) const;
   std::string m_filename;
 };
 
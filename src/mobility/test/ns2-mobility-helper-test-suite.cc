@@ -43,6 +43,7 @@
 #include "ns3/node-list.h"
 #include "ns3/node.h"
 #include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
 #include "ns3/test.h"
 #include "ns3/node-container.h"
 #include "ns3/names.h"
@@ -94,12 +95,14 @@ public:
    *
    * \param name        Short description
    * \param nodes       Number of nodes used in the test trace, 1 by default
+   * \param binary      Convert the trace to the binary format and install that
    */
-  Ns2MobilityHelperTest (std::string const & name, Time timeLimit, uint32_t nodes = 1)
-    : TestCase (name),
+  Ns2MobilityHelperTest (std::string const & name, Time timeLimit, uint32_t nodes = 1, bool binary = false)
+    : TestCase (binary ? name + " (binary)" : name),
       m_timeLimit (timeLimit),
       m_nodeCount (nodes),
-      m_nextRefPoint (0)
+      m_nextRefPoint (0),
+      m_binary (binary)
   {
   }
   /// Empty
@@ -135,6 +138,8 @@ private:
   size_t m_nextRefPoint;
   /// TMP trace file name
   std::string m_traceFile;
+  /// Install the binary trace
+  bool m_binary;
 
 private:
   /// Dump NS-2 trace to tmp file
@@ -211,6 +216,7 @@ private:
   {
     Names::Clear ();
     std::remove (m_traceFile.c_str ());
+    std::remove ((m_traceFile + ".bin").c_str ());
     Simulator::Destroy ();
   }
   
@@ -224,7 +230,13 @@ private:
       {
         return;
       }
-    Ns2MobilityHelper mobility (m_traceFile);
+    std::string traceFile = m_traceFile;
+    if (m_binary)
+      {
+        traceFile = m_traceFile + ".bin";
+        Ns2MobilityHelper::Convert (m_traceFile, traceFile);
+      }
+    Ns2MobilityHelper mobility (traceFile);
     mobility.Install ();
     if (CheckInitialPositions ())
       {
@@ -237,6 +249,70 @@ private:
   }
 };
 
+/**
+ * A binary trace installed on a node which has a WaypointMobilityModel
+ * gives it the positions of the trace as waypoints, no more than one
+ * waypoint ahead of the one it is moving to.
+ */
+class Ns2MobilityHelperWaypointTest : public TestCase
+{
+public:
+  Ns2MobilityHelperWaypointTest ()
+    : TestCase ("binary trace on waypoint mobility")
+  {
+  }
+
+private:
+  void CheckPosition (Ptr<WaypointMobilityModel> mob, Vector expected)
+  {
+    Vector pos = mob->GetPosition ();
+    NS_TEST_EXPECT_MSG_LT (mob->WaypointsLeft (), 2, "Waypoints queued at " << Simulator::Now ().GetSeconds () << " s");
+    NS_TEST_EXPECT_MSG_EQ_TOL (pos.x, expected.x, 1e-9, "X mismatch at " << Simulator::Now ().GetSeconds () << " s");
+    NS_TEST_EXPECT_MSG_EQ_TOL (pos.y, expected.y, 1e-9, "Y mismatch at " << Simulator::Now ().GetSeconds () << " s");
+    NS_TEST_EXPECT_MSG_EQ_TOL (pos.z, expected.z, 1e-9, "Z mismatch at " << Simulator::Now ().GetSeconds () << " s");
+  }
+
+  void DoRun ()
+  {
+    std::string traceFile = CreateTempDirFilename ("Ns2MobilityHelperWaypointTest.tcl");
+    std::ofstream of (traceFile.c_str ());
+    NS_TEST_ASSERT_MSG_EQ (of.is_open (), true, "Need to write tmp. file");
+    of << "$node_(0) set X_ 0.0\n"
+          "$node_(0) set Y_ 0.0\n"
+          "$ns_ at 1.0 \"$node_(0) setdest 5  0  5\"\n"
+          "$ns_ at 2.0 \"$node_(0) setdest 5  5  5\"\n"
+          "$ns_ at 4.0 \"$node_(0) setdest 0  5  2.5\"\n";
+    of.close ();
+    std::string binaryFile = traceFile + ".bin";
+    Ns2MobilityHelper::Convert (traceFile, binaryFile);
+
+    NodeContainer nodes;
+    nodes.Create (1);
+    Ptr<WaypointMobilityModel> mob = CreateObject<WaypointMobilityModel> ();
+    nodes.Get (0)->AggregateObject (mob);
+    Ns2MobilityHelper mobility (binaryFile);
+    mobility.Install (nodes.Begin (), nodes.End ());
+
+    //                  time  position
+    double reference[][3] = { { 0.5, 0, 0 },
+                              { 1.5, 2.5, 0 },
+                              { 2.0, 5, 0 },
+                              { 2.5, 5, 2.5 },
+                              { 3.5, 5, 5 },
+                              { 5.0, 2.5, 5 },
+                              { 7.0, 0, 5 } };
+    for (uint32_t i = 0; i < sizeof (reference) / sizeof (reference[0]); i++)
+      {
+        Simulator::Schedule (Seconds (reference[i][0]), &Ns2MobilityHelperWaypointTest::CheckPosition,
+                             this, mob, Vector (reference[i][1], reference[i][2], 0));
+      }
+    Simulator::Run ();
+    Simulator::Destroy ();
+    std::remove (traceFile.c_str ());
+    std::remove (binaryFile.c_str ());
+  }
+};
+
 /// The test suite
 class Ns2MobilityHelperTestSuite : public TestSuite
 {
@@ -245,181 +321,187 @@ public:
   {
     SetDataDir (NS_TEST_SOURCEDIR);
 
-    // to be used as temporary variable for test cases.
-    // Note that test suite takes care of deleting all test cases.
-    Ns2MobilityHelperTest * t (0);
-
-    // Initial position
-    t = new Ns2MobilityHelperTest ("initial position", Seconds (1));
-    t->SetTrace ("$node_(0) set X_ 1.0\n"
-                 "$node_(0) set Y_ 2.0\n"
-                 "$node_(0) set Z_ 3.0\n"
-                 );
-    t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Check parsing comments, empty lines and no EOF at the end of file
-    t = new Ns2MobilityHelperTest ("comments", Seconds (1));
-    t->SetTrace ("# comment\n"
-                 "\n\n" // empty lines
-                 "$node_(0) set X_ 1.0 # comment \n"
-                 "$node_(0) set Y_ 2.0 ### \n"
-                 "$node_(0) set Z_ 3.0 # $node_(0) set Z_ 3.0\n"
-                 "#$node_(0) set Z_ 100 #"
-                 );
-    t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Simple setdest. Arguments are interpreted as x, y, speed by default
-    t = new Ns2MobilityHelperTest ("simple setdest", Seconds (10));
-    t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5, 0, 0));
-    t->AddReferencePoint ("0", 6, Vector (25, 0, 0), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Several set and setdest. Arguments are interpreted as x, y, speed by default
-    t = new Ns2MobilityHelperTest ("square setdest", Seconds (6));
-    t->SetTrace ("$node_(0) set X_ 0.0\n"
-                 "$node_(0) set Y_ 0.0\n"
-                 "$ns_ at 1.0 \"$node_(0) setdest 5  0  5\"\n"
-                 "$ns_ at 2.0 \"$node_(0) setdest 5  5  5\"\n"
-                 "$ns_ at 3.0 \"$node_(0) setdest 0  5  5\"\n"
-                 "$ns_ at 4.0 \"$node_(0) setdest 0  0  5\"\n"
-                 );
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5,  0, 0));
-    t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  5, 0));
-    t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (-5, 0, 0));
-    t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, -5, 0));
-    t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
-    AddTestCase (t);
-
-    // Scheduled set position
-    t = new Ns2MobilityHelperTest ("scheduled set position", Seconds (2));
-    t->SetTrace ("$ns_ at 1.0 \"$node_(0) set X_ 10\"\n"
-                 "$ns_ at 1.0 \"$node_(0) set Z_ 10\"\n"
-                 "$ns_ at 1.0 \"$node_(0) set Y_ 10\"");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 1, Vector (10, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (10, 0, 10), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (10, 10, 10), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Malformed lines
-    t = new Ns2MobilityHelperTest ("malformed lines", Seconds (2));
-    t->SetTrace ("$node() set X_ 1 # node id is not present\n"
-                 "$node # incoplete line\"\n"
-                 "$node this line is not correct\n"
-                 "$node_(0) set X_ 1 # line OK \n"
-                 "$node_(0) set Y_ 2 # line OK \n"
-                 "$node_(0) set Z_ 3 # line OK \n"
-                 "$ns_ at  \"$node_(0) setdest 4 4 4\" # time not present\n"
-                 "$ns_ at 1 \"$node_(0) setdest 2 2 1   \" # line OK \n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (1, 2, 3), Vector (1, 0, 0));
-    t->AddReferencePoint ("0", 2, Vector (2, 2, 3), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Non possible values
-    t = new Ns2MobilityHelperTest ("non possible values", Seconds (2));
-    t->SetTrace ("$node_(0) set X_ 1 # line OK \n"
-                 "$node_(0) set Y_ 2 # line OK \n"
-                 "$node_(0) set Z_ 3 # line OK \n"
-                 "$node_(-22) set Y_ 3 # node id not correct\n"
-                 "$node_(3.3) set Y_ 1111 # node id not correct\n"
-                 "$ns_ at sss \"$node_(0) setdest 5 5 5\" # time is not a number\n"
-                 "$ns_ at 1 \"$node_(0) setdest 2 2 1\" # line OK \n"
-                 "$ns_ at 1 \"$node_(0) setdest 2 2 -1\" # negative speed is not correct\n"
-                 "$ns_ at 1 \"$node_(0) setdest 2 2 sdfs\"    # speed is not a number\n"
-                 "$ns_ at 1 \"$node_(0) setdest 2 2 s232dfs\" # speed is not a number\n"
-                 "$ns_ at 1 \"$node_(0) setdest 233 2.. s232dfs\"   # more than one non numbers\n"
-                 "$ns_ at -12 \"$node_(0) setdest 11 22 33\" # time should not be negative\n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (1, 2, 3), Vector (1, 0, 0));
-    t->AddReferencePoint ("0", 2, Vector (2, 2, 3), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // More than one node
-    t = new Ns2MobilityHelperTest ("few nodes, combinations of set and setdest", Seconds (10), 3);
-    t->SetTrace ("$node_(0) set X_ 1.0\n"
-                 "$node_(0) set Y_ 2.0\n"
-                 "$node_(0) set Z_ 3.0\n"
-                 "$ns_ at 1.0 \"$node_(1) setdest 25 0 5\"\n"
-                 "$node_(2) set X_ 0.0\n"
-                 "$node_(2) set Y_ 0.0\n"
-                 "$ns_ at 1.0 \"$node_(2) setdest 5  0  5\"\n"
-                 "$ns_ at 2.0 \"$node_(2) setdest 5  5  5\"\n"
-                 "$ns_ at 3.0 \"$node_(2) setdest 0  5  5\"\n"
-                 "$ns_ at 4.0 \"$node_(2) setdest 0  0  5\"\n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
-    t->AddReferencePoint ("1", 0, Vector (0, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("1", 1, Vector (0, 0, 0), Vector (5, 0, 0));
-    t->AddReferencePoint ("1", 6, Vector (25, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("2", 0, Vector (0, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("2", 1, Vector (0, 0, 0), Vector (5,  0, 0));
-    t->AddReferencePoint ("2", 2, Vector (5, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("2", 2, Vector (5, 0, 0), Vector (0,  5, 0));
-    t->AddReferencePoint ("2", 3, Vector (5, 5, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("2", 3, Vector (5, 5, 0), Vector (-5, 0, 0));
-    t->AddReferencePoint ("2", 4, Vector (0, 5, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("2", 4, Vector (0, 5, 0), Vector (0, -5, 0));
-    t->AddReferencePoint ("2", 5, Vector (0, 0, 0), Vector (0,  0, 0));
-    AddTestCase (t);
-
-    // Test for Speed == 0, that acts as stop the node.
-    t = new Ns2MobilityHelperTest ("setdest with speed cero", Seconds (10));
-    t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"\n"
-                 "$ns_ at 7.0 \"$node_(0) setdest 11  22  0\"\n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5, 0, 0));
-    t->AddReferencePoint ("0", 6, Vector (25, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 7, Vector (25, 0, 0), Vector (0, 0, 0));
-    AddTestCase (t);
-
-
-    // Test negative positions
-    t = new Ns2MobilityHelperTest ("test negative positions", Seconds (10));
-    t->SetTrace ("$node_(0) set X_ -1.0\n"
-                 "$node_(0) set Y_ 0\n"
-                 "$ns_ at 1.0 \"$node_(0) setdest 0 0 1\"\n"
-                 "$ns_ at 2.0 \"$node_(0) setdest 0  -1  1\"\n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (-1, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 1, Vector (-1, 0, 0), Vector (1, 0, 0));
-    t->AddReferencePoint ("0", 2, Vector (0, 0, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 2, Vector (0, 0, 0), Vector (0, -1, 0));
-    t->AddReferencePoint ("0", 3, Vector (0, -1, 0), Vector (0, 0, 0));
-    AddTestCase (t);
-
-    // Sqare setdest with values in the form 1.0e+2
-    t = new Ns2MobilityHelperTest ("Foalt numbers in 1.0e+2 format", Seconds (6));
-    t->SetTrace ("$node_(0) set X_ 0.0\n"
-                 "$node_(0) set Y_ 0.0\n"
-                 "$ns_ at 1.0 \"$node_(0) setdest 1.0e+2  0       1.0e+2\"\n"
-                 "$ns_ at 2.0 \"$node_(0) setdest 1.0e+2  1.0e+2  1.0e+2\"\n"
-                 "$ns_ at 3.0 \"$node_(0) setdest 0       1.0e+2  1.0e+2\"\n"
-                 "$ns_ at 4.0 \"$node_(0) setdest 0       0       1.0e+2\"\n");
-    //                     id  t  position         velocity
-    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (100,  0, 0));
-    t->AddReferencePoint ("0", 2, Vector (100, 0, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 2, Vector (100, 0, 0), Vector (0,  100, 0));
-    t->AddReferencePoint ("0", 3, Vector (100, 100, 0), Vector (0,  0, 0));
-    t->AddReferencePoint ("0", 3, Vector (100, 100, 0), Vector (-100, 0, 0));
-    t->AddReferencePoint ("0", 4, Vector (0, 100, 0), Vector (0, 0, 0));
-    t->AddReferencePoint ("0", 4, Vector (0, 100, 0), Vector (0, -100, 0));
-    t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
-    AddTestCase (t);
+    // Every trace is installed as text, then converted to the binary format
+    for (int binary = 0; binary < 2; binary++)
+      {
+        // to be used as temporary variable for test cases.
+        // Note that test suite takes care of deleting all test cases.
+        Ns2MobilityHelperTest * t (0);
+
+        // Initial position
+        t = new Ns2MobilityHelperTest ("initial position", Seconds (1), 1, binary);
+        t->SetTrace ("$node_(0) set X_ 1.0\n"
+                     "$node_(0) set Y_ 2.0\n"
+                     "$node_(0) set Z_ 3.0\n"
+                     );
+        t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Check parsing comments, empty lines and no EOF at the end of file
+        t = new Ns2MobilityHelperTest ("comments", Seconds (1), 1, binary);
+        t->SetTrace ("# comment\n"
+                     "\n\n" // empty lines
+                     "$node_(0) set X_ 1.0 # comment \n"
+                     "$node_(0) set Y_ 2.0 ### \n"
+                     "$node_(0) set Z_ 3.0 # $node_(0) set Z_ 3.0\n"
+                     "#$node_(0) set Z_ 100 #"
+                     );
+        t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Simple setdest. Arguments are interpreted as x, y, speed by default
+        t = new Ns2MobilityHelperTest ("simple setdest", Seconds (10), 1, binary);
+        t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5, 0, 0));
+        t->AddReferencePoint ("0", 6, Vector (25, 0, 0), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Several set and setdest. Arguments are interpreted as x, y, speed by default
+        t = new Ns2MobilityHelperTest ("square setdest", Seconds (6), 1, binary);
+        t->SetTrace ("$node_(0) set X_ 0.0\n"
+                     "$node_(0) set Y_ 0.0\n"
+                     "$ns_ at 1.0 \"$node_(0) setdest 5  0  5\"\n"
+                     "$ns_ at 2.0 \"$node_(0) setdest 5  5  5\"\n"
+                     "$ns_ at 3.0 \"$node_(0) setdest 0  5  5\"\n"
+                     "$ns_ at 4.0 \"$node_(0) setdest 0  0  5\"\n"
+                     );
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5,  0, 0));
+        t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  5, 0));
+        t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (-5, 0, 0));
+        t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, -5, 0));
+        t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
+        AddTestCase (t);
+
+        // Scheduled set position
+        t = new Ns2MobilityHelperTest ("scheduled set position", Seconds (2), 1, binary);
+        t->SetTrace ("$ns_ at 1.0 \"$node_(0) set X_ 10\"\n"
+                     "$ns_ at 1.0 \"$node_(0) set Z_ 10\"\n"
+                     "$ns_ at 1.0 \"$node_(0) set Y_ 10\"");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 1, Vector (10, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (10, 0, 10), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (10, 10, 10), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Malformed lines
+        t = new Ns2MobilityHelperTest ("malformed lines", Seconds (2), 1, binary);
+        t->SetTrace ("$node() set X_ 1 # node id is not present\n"
+                     "$node # incoplete line\"\n"
+                     "$node this line is not correct\n"
+                     "$node_(0) set X_ 1 # line OK \n"
+                     "$node_(0) set Y_ 2 # line OK \n"
+                     "$node_(0) set Z_ 3 # line OK \n"
+                     "$ns_ at  \"$node_(0) setdest 4 4 4\" # time not present\n"
+                     "$ns_ at 1 \"$node_(0) setdest 2 2 1   \" # line OK \n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (1, 2, 3), Vector (1, 0, 0));
+        t->AddReferencePoint ("0", 2, Vector (2, 2, 3), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Non possible values
+        t = new Ns2MobilityHelperTest ("non possible values", Seconds (2), 1, binary);
+        t->SetTrace ("$node_(0) set X_ 1 # line OK \n"
+                     "$node_(0) set Y_ 2 # line OK \n"
+                     "$node_(0) set Z_ 3 # line OK \n"
+                     "$node_(-22) set Y_ 3 # node id not correct\n"
+                     "$node_(3.3) set Y_ 1111 # node id not correct\n"
+                     "$ns_ at sss \"$node_(0) setdest 5 5 5\" # time is not a number\n"
+                     "$ns_ at 1 \"$node_(0) setdest 2 2 1\" # line OK \n"
+                     "$ns_ at 1 \"$node_(0) setdest 2 2 -1\" # negative speed is not correct\n"
+                     "$ns_ at 1 \"$node_(0) setdest 2 2 sdfs\"    # speed is not a number\n"
+                     "$ns_ at 1 \"$node_(0) setdest 2 2 s232dfs\" # speed is not a number\n"
+                     "$ns_ at 1 \"$node_(0) setdest 233 2.. s232dfs\"   # more than one non numbers\n"
+                     "$ns_ at -12 \"$node_(0) setdest 11 22 33\" # time should not be negative\n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (1, 2, 3), Vector (1, 0, 0));
+        t->AddReferencePoint ("0", 2, Vector (2, 2, 3), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // More than one node
+        t = new Ns2MobilityHelperTest ("few nodes, combinations of set and setdest", Seconds (10), 3, binary);
+        t->SetTrace ("$node_(0) set X_ 1.0\n"
+                     "$node_(0) set Y_ 2.0\n"
+                     "$node_(0) set Z_ 3.0\n"
+                     "$ns_ at 1.0 \"$node_(1) setdest 25 0 5\"\n"
+                     "$node_(2) set X_ 0.0\n"
+                     "$node_(2) set Y_ 0.0\n"
+                     "$ns_ at 1.0 \"$node_(2) setdest 5  0  5\"\n"
+                     "$ns_ at 2.0 \"$node_(2) setdest 5  5  5\"\n"
+                     "$ns_ at 3.0 \"$node_(2) setdest 0  5  5\"\n"
+                     "$ns_ at 4.0 \"$node_(2) setdest 0  0  5\"\n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (1, 2, 3), Vector (0, 0, 0));
+        t->AddReferencePoint ("1", 0, Vector (0, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("1", 1, Vector (0, 0, 0), Vector (5, 0, 0));
+        t->AddReferencePoint ("1", 6, Vector (25, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("2", 0, Vector (0, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("2", 1, Vector (0, 0, 0), Vector (5,  0, 0));
+        t->AddReferencePoint ("2", 2, Vector (5, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("2", 2, Vector (5, 0, 0), Vector (0,  5, 0));
+        t->AddReferencePoint ("2", 3, Vector (5, 5, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("2", 3, Vector (5, 5, 0), Vector (-5, 0, 0));
+        t->AddReferencePoint ("2", 4, Vector (0, 5, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("2", 4, Vector (0, 5, 0), Vector (0, -5, 0));
+        t->AddReferencePoint ("2", 5, Vector (0, 0, 0), Vector (0,  0, 0));
+        AddTestCase (t);
+
+        // Test for Speed == 0, that acts as stop the node.
+        t = new Ns2MobilityHelperTest ("setdest with speed cero", Seconds (10), 1, binary);
+        t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"\n"
+                     "$ns_ at 7.0 \"$node_(0) setdest 11  22  0\"\n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5, 0, 0));
+        t->AddReferencePoint ("0", 6, Vector (25, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 7, Vector (25, 0, 0), Vector (0, 0, 0));
+        AddTestCase (t);
+
+
+        // Test negative positions
+        t = new Ns2MobilityHelperTest ("test negative positions", Seconds (10), 1, binary);
+        t->SetTrace ("$node_(0) set X_ -1.0\n"
+                     "$node_(0) set Y_ 0\n"
+                     "$ns_ at 1.0 \"$node_(0) setdest 0 0 1\"\n"
+                     "$ns_ at 2.0 \"$node_(0) setdest 0  -1  1\"\n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (-1, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 1, Vector (-1, 0, 0), Vector (1, 0, 0));
+        t->AddReferencePoint ("0", 2, Vector (0, 0, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 2, Vector (0, 0, 0), Vector (0, -1, 0));
+        t->AddReferencePoint ("0", 3, Vector (0, -1, 0), Vector (0, 0, 0));
+        AddTestCase (t);
+
+        // Sqare setdest with values in the form 1.0e+2
+        t = new Ns2MobilityHelperTest ("Foalt numbers in 1.0e+2 format", Seconds (6), 1, binary);
+        t->SetTrace ("$node_(0) set X_ 0.0\n"
+                     "$node_(0) set Y_ 0.0\n"
+                     "$ns_ at 1.0 \"$node_(0) setdest 1.0e+2  0       1.0e+2\"\n"
+                     "$ns_ at 2.0 \"$node_(0) setdest 1.0e+2  1.0e+2  1.0e+2\"\n"
+                     "$ns_ at 3.0 \"$node_(0) setdest 0       1.0e+2  1.0e+2\"\n"
+                     "$ns_ at 4.0 \"$node_(0) setdest 0       0       1.0e+2\"\n");
+        //                     id  t  position         velocity
+        t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (100,  0, 0));
+        t->AddReferencePoint ("0", 2, Vector (100, 0, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 2, Vector (100, 0, 0), Vector (0,  100, 0));
+        t->AddReferencePoint ("0", 3, Vector (100, 100, 0), Vector (0,  0, 0));
+        t->AddReferencePoint ("0", 3, Vector (100, 100, 0), Vector (-100, 0, 0));
+        t->AddReferencePoint ("0", 4, Vector (0, 100, 0), Vector (0, 0, 0));
+        t->AddReferencePoint ("0", 4, Vector (0, 100, 0), Vector (0, -100, 0));
+        t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
+        AddTestCase (t);
+      }
+
+    AddTestCase (new Ns2MobilityHelperWaypointTest);
 
   }
 } g_ns2TransmobilityHelperTestSuite;
@@ -0,0 +1,903 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/core-config.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <pthread.h>
+
+// __thread and the __sync builtins
+#if defined (__GNUC__) && !defined (__APPLE__)
+#define MULTITHREADED_SIMULATOR_TLS 1
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+static const uint32_t NO_CONTEXT = 0xffffffff;
+static const uint64_t NO_TS = ~static_cast<uint64_t> (0);
+
+/// The threads waiting for the windows
+struct MultithreadedSimulatorImpl::Pool
+{
+  pthread_mutex_t mutex;
+  // signaled when a window is ready, and when the threads must quit
+  pthread_cond_t start;
+  // signaled when the last thread is done with a window
+  pthread_cond_t done;
+  uint32_t generation;
+  uint32_t running;
+  uint32_t nextThread;
+  uint32_t threads;
+  bool quit;
+};
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MinChannelDelay",
+                   "The smallest lookahead, the delay of an event scheduled for a node of another partition. "
+                   "The lookahead is the smallest delay after which the channels which span several partitions "
+                   "reach a remote node, but no less than this. The events scheduled sooner for another "
+                   "partition are delayed to the lookahead.",
+                   TimeValue (NanoSeconds (1)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_minChannelDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("Threads",
+                   "Number of threads running the partitions, including the one calling Simulator::Run. "
+                   "0 means one per partition. Always 1 unless configured with --enable-atomic-refcount.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_nThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_minChannelDelay (NanoSeconds (1)),
+    m_nThreads (0),
+    m_lookahead (0),
+    m_global (0),
+    m_windowEnd (0),
+    m_pool (0),
+    m_nPartitions (0),
+    m_nWindows (0),
+    m_nRemoteEvents (0),
+    m_nDelayedEvents (0)
+{
+  m_stop = false;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = NO_CONTEXT;
+  m_unscheduledEvents = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  StopThreads ();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  StopThreads ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+  m_schedulerFactory = schedulerFactory;
+}
+
+MultithreadedSimulatorImpl::Partition *&
+MultithreadedSimulatorImpl::Current (void)
+{
+#ifdef MULTITHREADED_SIMULATOR_TLS
+  static __thread Partition *partition = 0;
+#else
+  static Partition *partition = 0;
+#endif
+  return partition;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == NO_CONTEXT)
+    {
+      return m_global;
+    }
+  if (context < m_systemIds.size ())
+    {
+      return m_partitions[m_systemIds[context]];
+    }
+  // not a node, or a node created by the simulation
+  return m_partitions[0];
+}
+
+void
+MultithreadedSimulatorImpl::Split (void)
+{
+  m_nPartitions = 1;
+  m_systemIds.resize (NodeList::GetNNodes ());
+  for (uint32_t i = 0; i < m_systemIds.size (); i++)
+    {
+      m_systemIds[i] = NodeList::GetNode (i)->GetSystemId ();
+      m_nPartitions = std::max (m_nPartitions, m_systemIds[i] + 1);
+    }
+  NS_LOG_LOGIC ("split " << m_systemIds.size () << " nodes in " << m_nPartitions << " partitions");
+  for (uint32_t i = 0; i <= m_nPartitions; i++)
+    {
+      Partition *partition = new Partition ();
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      partition->inbox = 0;
+      partition->currentTs = m_currentTs;
+      partition->currentContext = NO_CONTEXT;
+      partition->currentUid = m_currentUid;
+      partition->uid = m_uid + i;
+      partition->packetUids = 0;
+      partition->unscheduledEvents = 0;
+      partition->minSent = NO_TS;
+      partition->systemId = i < m_nPartitions ? i : 0;
+      partition->nRemoteEvents = 0;
+      partition->nDelayedEvents = 0;
+      m_partitions.push_back (partition);
+    }
+  m_global = m_partitions.back ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      Insert (GetPartition (next.key.m_context), next);
+    }
+  m_unscheduledEvents = 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (void)
+{
+  // the smallest delay of the channels which span several partitions,
+  // but no less than MinChannelDelay
+  uint64_t lookahead = NO_TS;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      bool seen = false;
+      bool remote = false;
+      uint32_t systemId = 0;
+      for (uint32_t j = 0; j < channel->GetNDevices () && !remote; j++)
+        {
+          Ptr<NetDevice> device = channel->GetDevice (j);
+          if (device == 0 || device->GetNode () == 0)
+            {
+              continue;
+            }
+          uint32_t id = m_systemIds[device->GetNode ()->GetId ()];
+          remote = seen && id != systemId;
+          systemId = id;
+          seen = true;
+        }
+      if (remote)
+        {
+          uint64_t delay = channel->GetMinRemoteDelay ().GetTimeStep ();
+          NS_LOG_LOGIC ("channel " << channel->GetId () << " reaches another partition after " << delay);
+          lookahead = std::min (lookahead, delay);
+        }
+    }
+  uint64_t minChannelDelay = m_minChannelDelay.GetTimeStep ();
+  m_lookahead = lookahead == NO_TS ? minChannelDelay : std::max (lookahead, minChannelDelay);
+  NS_LOG_LOGIC ("lookahead " << m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::Merge (void)
+{
+  uint64_t currentTs = m_currentTs;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      Receive (partition);
+      while (!partition->events->IsEmpty ())
+        {
+          m_events->Insert (partition->events->RemoveNext ());
+        }
+      m_unscheduledEvents += partition->unscheduledEvents;
+      m_uid = std::max (m_uid, partition->uid);
+      if (partition->currentTs >= currentTs)
+        {
+          currentTs = partition->currentTs;
+          m_currentUid = partition->currentUid;
+        }
+      m_destroyEvents.splice (m_destroyEvents.end (), partition->destroyEvents);
+      m_nRemoteEvents += partition->nRemoteEvents;
+      m_nDelayedEvents += partition->nDelayedEvents;
+      delete partition;
+    }
+  m_partitions.clear ();
+  m_global = 0;
+  m_currentTs = currentTs;
+  m_currentContext = NO_CONTEXT;
+}
+
+void
+MultithreadedSimulatorImpl::StartThreads (uint32_t n)
+{
+#if !defined (MULTITHREADED_SIMULATOR_TLS) || !defined (NS3_ATOMIC_REFCOUNT)
+  // the partitions share the channels and the global objects
+  n = 1;
+#endif
+  if ((m_pool == 0 && n == 1) || (m_pool != 0 && m_pool->threads == n))
+    {
+      return;
+    }
+  StopThreads ();
+  if (n == 1)
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("start " << n << " threads");
+  m_pool = new Pool ();
+  pthread_mutex_init (&m_pool->mutex, 0);
+  pthread_cond_init (&m_pool->start, 0);
+  pthread_cond_init (&m_pool->done, 0);
+  m_pool->generation = 0;
+  m_pool->running = 0;
+  m_pool->nextThread = 1;
+  m_pool->threads = n;
+  m_pool->quit = false;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::RunThread, this));
+      m_threads.push_back (thread);
+      thread->Start ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopThreads (void)
+{
+  if (m_pool == 0)
+    {
+      return;
+    }
+  pthread_mutex_lock (&m_pool->mutex);
+  m_pool->quit = true;
+  pthread_cond_broadcast (&m_pool->start);
+  pthread_mutex_unlock (&m_pool->mutex);
+  for (std::vector<Ptr<SystemThread> >::const_iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+  pthread_cond_destroy (&m_pool->done);
+  pthread_cond_destroy (&m_pool->start);
+  pthread_mutex_destroy (&m_pool->mutex);
+  delete m_pool;
+  m_pool = 0;
+}
+
+void
+MultithreadedSimulatorImpl::RunThread (void)
+{
+  pthread_mutex_lock (&m_pool->mutex);
+  uint32_t first = m_pool->nextThread++;
+  pthread_mutex_unlock (&m_pool->mutex);
+  // the threads are started before the first window
+  uint32_t seen = 0;
+  while (true)
+    {
+      pthread_mutex_lock (&m_pool->mutex);
+      while (m_pool->generation == seen && !m_pool->quit)
+        {
+          pthread_cond_wait (&m_pool->start, &m_pool->mutex);
+        }
+      if (m_pool->quit)
+        {
+          pthread_mutex_unlock (&m_pool->mutex);
+          break;
+        }
+      seen = m_pool->generation;
+      pthread_mutex_unlock (&m_pool->mutex);
+
+      RunPartitions (first);
+
+      pthread_mutex_lock (&m_pool->mutex);
+      if (--m_pool->running == 0)
+        {
+          pthread_cond_signal (&m_pool->done);
+        }
+      pthread_mutex_unlock (&m_pool->mutex);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartitions (uint32_t first)
+{
+  // each thread always runs the same partitions, in the same order
+  uint32_t step = m_pool != 0 ? m_pool->threads : 1;
+  for (uint32_t i = first; i < m_nPartitions; i += step)
+    {
+      RunPartition (m_partitions[i], m_windowEnd);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (Partition *partition, uint64_t end)
+{
+  Current () = partition;
+  Receive (partition);
+  partition->minSent = NO_TS;
+  while (!partition->events->IsEmpty ())
+    {
+      Scheduler::Event next = partition->events->PeekNext ();
+      if (next.key.m_ts >= end)
+        {
+          break;
+        }
+      partition->events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= partition->currentTs);
+      partition->unscheduledEvents--;
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      partition->currentUid = next.key.m_uid;
+      partition->packetUids = 0;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  Current () = 0;
+}
+
+void
+MultithreadedSimulatorImpl::RunGlobalEvents (uint64_t ts)
+{
+  Current () = m_global;
+  while (!m_global->events->IsEmpty () && !m_stop)
+    {
+      Scheduler::Event next = m_global->events->PeekNext ();
+      if (next.key.m_ts != ts)
+        {
+          break;
+        }
+      m_global->events->RemoveNext ();
+      m_global->unscheduledEvents--;
+      NS_LOG_LOGIC ("handle global " << ts);
+      m_global->currentTs = ts;
+      m_global->currentContext = next.key.m_context;
+      m_global->currentUid = next.key.m_uid;
+      m_global->packetUids = 0;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  Current () = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Receive (Partition *partition)
+{
+#ifdef MULTITHREADED_SIMULATOR_TLS
+  Message *message = __sync_lock_test_and_set (&partition->inbox, static_cast<Message *> (0));
+#else
+  Message *message = partition->inbox;
+  partition->inbox = 0;
+#endif
+  while (message != 0)
+    {
+      Insert (partition, message->ev);
+      Message *next = message->next;
+      delete message;
+      message = next;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Send (Partition *from, Partition *to, Scheduler::Event ev)
+{
+  uint64_t earliest = from->currentTs + m_lookahead;
+  if (ev.key.m_ts < earliest)
+    {
+      NS_LOG_LOGIC ("delay remote event from " << ev.key.m_ts << " to " << earliest);
+      ev.key.m_ts = earliest;
+      from->nDelayedEvents++;
+    }
+  from->nRemoteEvents++;
+  from->minSent = std::min (from->minSent, ev.key.m_ts);
+  Message *message = new Message ();
+  message->ev = ev;
+#ifdef MULTITHREADED_SIMULATOR_TLS
+  do
+    {
+      message->next = to->inbox;
+    }
+  while (!__sync_bool_compare_and_swap (&to->inbox, message->next, message));
+#else
+  message->next = to->inbox;
+  to->inbox = message;
+#endif
+}
+
+void
+MultithreadedSimulatorImpl::Insert (Partition *partition, Scheduler::Event ev)
+{
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (void)
+{
+  Scheduler::Event next = m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= m_currentTs);
+  m_unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  m_currentTs = next.key.m_ts;
+  m_currentContext = next.key.m_context;
+  m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  return m_events->IsEmpty () || m_stop;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::NextTs (void) const
+{
+  NS_ASSERT (!m_events->IsEmpty ());
+  Scheduler::Event ev = m_events->PeekNext ();
+  return ev.key.m_ts;
+}
+
+Time
+MultithreadedSimulatorImpl::Next (void) const
+{
+  return TimeStep (NextTs ());
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  if (!m_minChannelDelay.IsStrictlyPositive ())
+    {
+      NS_FATAL_ERROR ("MultithreadedSimulatorImpl needs a positive MinChannelDelay");
+    }
+  m_stop = false;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      (*i)->Start ();
+    }
+  Split ();
+  SetLookahead ();
+  StartThreads (m_nThreads == 0 ? m_nPartitions : std::min (m_nThreads, m_nPartitions));
+
+  while (!m_stop)
+    {
+      Receive (m_global);
+      uint64_t global = m_global->events->IsEmpty () ? NO_TS : m_global->events->PeekNext ().key.m_ts;
+      uint64_t next = NO_TS;
+      for (uint32_t i = 0; i < m_nPartitions; i++)
+        {
+          Partition *partition = m_partitions[i];
+          // the messages sent during the last window are still queued
+          next = std::min (next, partition->minSent);
+          if (!partition->events->IsEmpty ())
+            {
+              next = std::min (next, partition->events->PeekNext ().key.m_ts);
+            }
+        }
+      if (next == NO_TS && global == NO_TS)
+        {
+          break;
+        }
+      if (global <= next)
+        {
+          RunGlobalEvents (global);
+          continue;
+        }
+      m_windowEnd = std::min (next + m_lookahead, global);
+      m_nWindows++;
+      NS_LOG_LOGIC ("window from " << next << " to " << m_windowEnd);
+      if (m_pool != 0)
+        {
+          pthread_mutex_lock (&m_pool->mutex);
+          m_pool->running = m_threads.size ();
+          m_pool->generation++;
+          pthread_cond_broadcast (&m_pool->start);
+          pthread_mutex_unlock (&m_pool->mutex);
+          RunPartitions (0);
+          pthread_mutex_lock (&m_pool->mutex);
+          while (m_pool->running > 0)
+            {
+              pthread_cond_wait (&m_pool->done, &m_pool->mutex);
+            }
+          pthread_mutex_unlock (&m_pool->mutex);
+        }
+      else
+        {
+          RunPartitions (0);
+        }
+    }
+  Merge ();
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+}
+
+void
+MultithreadedSimulatorImpl::RunOneEvent (void)
+{
+  ProcessOneEvent ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  // the partitions finish their window
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  Simulator::Schedule (time, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  Time tAbsolute = time + Now ();
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= Now ());
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = static_cast<uint64_t> (tAbsolute.GetTimeStep ());
+  ev.key.m_context = GetContext ();
+  Partition *partition = Current ();
+  if (partition != 0)
+    {
+      ev.key.m_uid = partition->uid;
+      partition->uid += m_nPartitions + 1;
+      Insert (partition, ev);
+    }
+  else
+    {
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_context = context;
+  Partition *partition = Current ();
+  if (partition != 0)
+    {
+      ev.key.m_ts = partition->currentTs + time.GetTimeStep ();
+      ev.key.m_uid = partition->uid;
+      partition->uid += m_nPartitions + 1;
+      Partition *to = GetPartition (context);
+      if (to == partition || partition == m_global)
+        {
+          // the other partitions wait while the global events run
+          Insert (to, ev);
+        }
+      else
+        {
+          Send (partition, to, ev);
+        }
+    }
+  else
+    {
+      ev.key.m_ts = m_currentTs + time.GetTimeStep ();
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), NO_CONTEXT, 2);
+  Partition *partition = Current ();
+  if (partition != 0)
+    {
+      partition->destroyEvents.push_back (id);
+    }
+  else
+    {
+      m_destroyEvents.push_back (id);
+      m_uid++;
+    }
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  Partition *partition = Current ();
+  return TimeStep (partition != 0 ? partition->currentTs : m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  Partition *partition = Current ();
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      DestroyEvents &destroyEvents = partition != 0 ? partition->destroyEvents : m_destroyEvents;
+      for (DestroyEvents::iterator i = destroyEvents.begin (); i != destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  if (partition != 0)
+    {
+      Partition *owner = GetPartition (id.GetContext ());
+      if (owner != partition && partition != m_global)
+        {
+          NS_FATAL_ERROR ("An event can only be removed by the partition of its context");
+        }
+      owner->events->Remove (event);
+      owner->unscheduledEvents--;
+    }
+  else
+    {
+      m_events->Remove (event);
+      m_unscheduledEvents--;
+    }
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  Partition *partition = Current ();
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0 ||
+          ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      const DestroyEvents &destroyEvents = partition != 0 ? partition->destroyEvents : m_destroyEvents;
+      for (DestroyEvents::const_iterator i = destroyEvents.begin (); i != destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  uint64_t currentTs = m_currentTs;
+  uint32_t currentUid = m_currentUid;
+  if (partition != 0)
+    {
+      // the events of a partition run in the order of their uids
+      Partition *owner = GetPartition (ev.GetContext ());
+      currentTs = owner->currentTs;
+      currentUid = owner->currentUid;
+    }
+  if (ev.PeekEventImpl () == 0 ||
+      ev.GetTs () < currentTs ||
+      (ev.GetTs () == currentTs &&
+       ev.GetUid () <= currentUid) ||
+      ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  // XXX: I am fairly certain other compilers use other non-standard
+  // post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  Partition *partition = Current ();
+  return partition != 0 ? partition->systemId : 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *partition = Current ();
+  return partition != 0 ? partition->currentContext : m_currentContext;
+}
+
+bool
+MultithreadedSimulatorImpl::IsParallel (void) const
+{
+  return true;
+}
+
+bool
+MultithreadedSimulatorImpl::AllocatePacketUid (uint64_t &uid)
+{
+  Partition *partition = Current ();
+  if (partition == 0)
+    {
+      return false;
+    }
+  // above the uids of the packets numbered by ns3::Packet, whose
+  // upper bits hold the system id 0
+  uid = static_cast<uint64_t> (partition->currentUid) << 32 | partition->packetUids;
+  partition->packetUids++;
+  return true;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return m_nPartitions;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNWindows (void) const
+{
+  return m_nWindows;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNRemoteEvents (void) const
+{
+  return m_nRemoteEvents;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNDelayedEvents (void) const
+{
+  return m_nDelayedEvents;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+} // namespace ns3
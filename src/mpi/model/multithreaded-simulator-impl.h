@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-thread.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief conservative parallel simulator running one partition of the
+ * nodes per thread
+ *
+ * The nodes are partitioned by their system id, as with
+ * DistributedSimulatorImpl, but the partitions share the memory of one
+ * process instead of exchanging MPI messages: each partition has its
+ * own event list, and the events scheduled for a node of another
+ * partition are pushed onto a lock-free queue of that partition.
+ *
+ * The partitions advance in windows. A window runs the events due
+ * before the earliest event of all the partitions plus the lookahead,
+ * and ends with a barrier. An event scheduled for another partition
+ * less than the lookahead in the future is delayed to the lookahead, so
+ * that it never falls in the window running. The lookahead is the
+ * smallest delay after which a channel spanning several partitions may
+ * reach a remote node (see Channel::GetMinRemoteDelay), but no less than
+ * the MinChannelDelay attribute. YansWifiChannel derives this delay from
+ * its propagation delay model and the positions of its PHYs when the
+ * simulation starts, and sends one event per remote partition, which
+ * computes the receptions of its PHYs there: they keep their exact
+ * propagation delay. The other channels give no delay, and the
+ * lookahead is then MinChannelDelay.
+ *
+ * It only runs several threads when ns-3 is configured with
+ * --enable-atomic-refcount, which makes the reference counts of
+ * SimpleRefCount atomic.
+ *
+ * The events without a context, such as those scheduled before
+ * Simulator::Run by the main program, run between two windows while the
+ * partitions wait. Before running, the channels of the ChannelList are
+ * started, so that they can find the partition of their devices.
+ *
+ * The results only depend on the partitioning of the nodes: the uids of
+ * the events are drawn from the counter of the partition which
+ * schedules them, the uids of the packets created by an event from its
+ * uid, and the threads claim the partitions in a fixed order. The models of a partition must only touch the state of its
+ * nodes; the EventIds can only be cancelled or removed by the partition
+ * of their context. Note that the trace sinks shared by the nodes, as
+ * well as the random variables and the objects shared by the channels,
+ * such as non-deterministic propagation loss models, are not guarded.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual Time Next (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual void RunOneEvent (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual bool IsParallel (void) const;
+  virtual bool AllocatePacketUid (uint64_t &uid);
+
+  /// \returns the number of partitions of the last call to Run
+  uint32_t GetNPartitions (void) const;
+  /// \returns the number of windows run
+  uint64_t GetNWindows (void) const;
+  /// \returns the number of events sent to another partition
+  uint64_t GetNRemoteEvents (void) const;
+  /// \returns the number of these events delayed to the lookahead
+  uint64_t GetNDelayedEvents (void) const;
+  /// \returns the lookahead of the last call to Run
+  Time GetLookahead (void) const;
+
+private:
+  /// An event sent to another partition
+  struct Message
+  {
+    Scheduler::Event ev;
+    Message *next;
+  };
+  typedef std::list<EventId> DestroyEvents;
+  struct Partition
+  {
+    Ptr<Scheduler> events;
+    // messages pushed by the other partitions, with a compare and swap
+    Message * volatile inbox;
+    DestroyEvents destroyEvents;
+    uint64_t currentTs;
+    uint32_t currentContext;
+    uint32_t currentUid;
+    // next uid: the partitions draw from interleaved sequences
+    uint32_t uid;
+    // the packets created by the event running
+    uint32_t packetUids;
+    int unscheduledEvents;
+    // earliest message sent during the window
+    uint64_t minSent;
+    uint32_t systemId;
+    uint64_t nRemoteEvents;
+    uint64_t nDelayedEvents;
+  };
+  struct Pool;
+
+  virtual void DoDispose (void);
+  void Split (void);
+  void SetLookahead (void);
+  void Merge (void);
+  void ProcessOneEvent (void);
+  void RunPartition (Partition *partition, uint64_t end);
+  void RunPartitions (uint32_t first);
+  void RunGlobalEvents (uint64_t ts);
+  void RunThread (void);
+  void StartThreads (uint32_t n);
+  void StopThreads (void);
+  void Receive (Partition *partition);
+  void Send (Partition *from, Partition *to, Scheduler::Event ev);
+  void Insert (Partition *partition, Scheduler::Event ev);
+  Partition *GetPartition (uint32_t context) const;
+  uint64_t NextTs (void) const;
+  static Partition *&Current (void);
+
+  DestroyEvents m_destroyEvents;
+  volatile bool m_stop;
+  ObjectFactory m_schedulerFactory;
+  // the events outside of Simulator::Run
+  Ptr<Scheduler> m_events;
+  uint32_t m_uid;
+  uint32_t m_currentUid;
+  uint64_t m_currentTs;
+  uint32_t m_currentContext;
+  // number of events that have been inserted but not yet scheduled,
+  // not counting the "destroy" events; this is used for validation
+  int m_unscheduledEvents;
+
+  Time m_minChannelDelay;
+  uint32_t m_nThreads;
+  uint64_t m_lookahead;
+  // the partitions by system id, then the one of the events without context
+  std::vector<Partition *> m_partitions;
+  Partition *m_global;
+  // system id of each node
+  std::vector<uint32_t> m_systemIds;
+  // end of the window running
+  uint64_t m_windowEnd;
+  std::vector<Ptr<SystemThread> > m_threads;
+  Pool *m_pool;
+  uint32_t m_nPartitions;
+  uint64_t m_nWindows;
+  uint64_t m_nRemoteEvents;
+  uint64_t m_nDelayedEvents;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
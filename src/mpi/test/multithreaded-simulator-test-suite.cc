@@ -0,0 +1,350 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/string.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/net-device-container.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-delay-model.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace ns3 {
+
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase ();
+  virtual void DoRun (void);
+private:
+  enum { N_NODES = 12, N_PARTITIONS = 3 };
+  // runs the nodes with DefaultSimulatorImpl if threads is 0
+  Ptr<MultithreadedSimulatorImpl> RunNodes (uint32_t threads);
+  void Tick (uint32_t node, uint32_t n);
+  void Message (uint32_t node, uint32_t from);
+  void Urgent (uint32_t node, uint32_t from);
+  void Timeout (uint32_t node);
+  void Log (uint32_t node, uint32_t kind, uint32_t value);
+  std::vector<std::vector<uint64_t> > m_logs;
+  std::vector<EventId> m_timers;
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase ()
+  : TestCase ("Check that MultithreadedSimulatorImpl runs the partitions in time order")
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Log (uint32_t node, uint32_t kind, uint32_t value)
+{
+  // the context and system id are checked here rather than with
+  // NS_TEST_ASSERT, which is not thread safe
+  uint32_t context = Simulator::GetContext () == node ? 0 : 1;
+  uint32_t systemId = Simulator::GetSystemId () == node % N_PARTITIONS ? 0 : 1;
+  m_logs[node].push_back ((((Simulator::Now ().GetMicroSeconds () * 4) + kind) * 100 + value) * 4 + context * 2 + systemId);
+}
+
+void
+MultithreadedSimulatorTestCase::Tick (uint32_t node, uint32_t n)
+{
+  Log (node, 0, n);
+  if (n < 5 + node % 7)
+    {
+      uint32_t next = (node + 1) % N_NODES;
+      Simulator::Schedule (MilliSeconds (1), &MultithreadedSimulatorTestCase::Tick, this, node, n + 1);
+      Simulator::ScheduleWithContext (next, MicroSeconds (100),
+                                      &MultithreadedSimulatorTestCase::Message, this, next, node);
+    }
+  m_timers[node].Cancel ();
+  m_timers[node] = Simulator::Schedule (MicroSeconds (1500), &MultithreadedSimulatorTestCase::Timeout, this, node);
+}
+
+void
+MultithreadedSimulatorTestCase::Message (uint32_t node, uint32_t from)
+{
+  Log (node, 1, from);
+  if (from % 3 == 0)
+    {
+      // less than the lookahead ahead: delayed to it
+      uint32_t next = (node + 1) % N_NODES;
+      Simulator::ScheduleWithContext (next, Seconds (0), &MultithreadedSimulatorTestCase::Urgent, this, next, node);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Urgent (uint32_t node, uint32_t from)
+{
+  Log (node, 2, from);
+}
+
+void
+MultithreadedSimulatorTestCase::Timeout (uint32_t node)
+{
+  Log (node, 3, 0);
+}
+
+Ptr<MultithreadedSimulatorImpl>
+MultithreadedSimulatorTestCase::RunNodes (uint32_t threads)
+{
+  Simulator::Destroy ();
+  Ptr<MultithreadedSimulatorImpl> impl;
+  if (threads != 0)
+    {
+      impl = CreateObject<MultithreadedSimulatorImpl> ();
+      impl->SetAttribute ("Threads", UintegerValue (threads));
+      impl->SetAttribute ("MinChannelDelay", TimeValue (MicroSeconds (10)));
+      Simulator::SetImplementation (impl);
+    }
+  NodeContainer nodes;
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      nodes.Create (1, node % N_PARTITIONS);
+    }
+  m_logs.assign (N_NODES, std::vector<uint64_t> ());
+  m_timers.assign (N_NODES, EventId ());
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      Simulator::ScheduleWithContext (node, MilliSeconds (1), &MultithreadedSimulatorTestCase::Tick, this, node, 0);
+    }
+  Simulator::Stop (MilliSeconds (9));
+  Simulator::Run ();
+  return impl;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  Ptr<MultithreadedSimulatorImpl> impl = RunNodes (1);
+  NS_TEST_ASSERT_MSG_EQ (impl->GetNPartitions (), N_PARTITIONS, "Nodes not partitioned by system id");
+  NS_TEST_ASSERT_MSG_GT (impl->GetNWindows (), 0, "No window run");
+  NS_TEST_ASSERT_MSG_GT (impl->GetNRemoteEvents (), impl->GetNDelayedEvents (), "No remote event");
+  NS_TEST_ASSERT_MSG_GT (impl->GetNDelayedEvents (), 0, "No remote event delayed to the lookahead");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MilliSeconds (9), "Not stopped by the global event");
+  std::vector<std::vector<uint64_t> > sequential = m_logs;
+
+  impl = RunNodes (N_PARTITIONS);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[node] == sequential[node]), true, "Events of node " << node << " differ");
+    }
+  impl = RunNodes (2);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[node] == sequential[node]), true, "Events of node " << node << " differ");
+    }
+
+  // the same events as DefaultSimulatorImpl, but for the remote events
+  // delayed to the lookahead
+  RunNodes (0);
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      std::vector<uint64_t> expected;
+      for (uint32_t i = 0; i < m_logs[node].size (); i++)
+        {
+          uint64_t log = m_logs[node][i];
+          NS_TEST_ASSERT_MSG_EQ (log % 4, node % N_PARTITIONS == 0 ? 0 : 1, "Wrong context or system id for node " << node);
+          if ((log / 4 / 100) % 4 == 2)
+            {
+              // sent to the next node, always in another partition
+              log += 10 * 4 * 100 * 4;
+            }
+          expected.push_back (log - log % 4);
+        }
+      std::vector<uint64_t> logs;
+      for (uint32_t i = 0; i < sequential[node].size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (sequential[node][i] % 4, 0, "Wrong context or system id for node " << node);
+          logs.push_back (sequential[node][i]);
+        }
+      std::sort (expected.begin (), expected.end ());
+      std::sort (logs.begin (), logs.end ());
+      NS_TEST_ASSERT_MSG_EQ ((logs == expected), true, "Events of node " << node << " differ");
+    }
+  Simulator::Destroy ();
+}
+
+class MultithreadedWifiChannelTestCase : public TestCase
+{
+public:
+  MultithreadedWifiChannelTestCase ();
+  virtual void DoRun (void);
+private:
+  enum { N_NODES = 5, N_PARTITIONS = 2 };
+  struct Reception
+  {
+    Time time;
+    bool byteTag;
+    bool packetTag;
+  };
+  // runs the nodes with DefaultSimulatorImpl if threads is 0
+  Ptr<MultithreadedSimulatorImpl> RunNodes (uint32_t threads, Time minChannelDelay);
+  void Send (Ptr<NetDevice> device);
+  static void PhyTxBegin (Time *start, Ptr<const Packet> packet);
+  static void PhyRxBegin (std::vector<Reception> *log, Ptr<const Packet> packet);
+  Time m_txStart;
+  std::vector<std::vector<Reception> > m_rx;
+  std::vector<Time> m_delays;
+};
+
+MultithreadedWifiChannelTestCase::MultithreadedWifiChannelTestCase ()
+  : TestCase ("Check that a YansWifiChannel delivers the frames of the other partitions after their propagation delay")
+{
+}
+
+void
+MultithreadedWifiChannelTestCase::PhyTxBegin (Time *start, Ptr<const Packet> packet)
+{
+  *start = Simulator::Now ();
+}
+
+void
+MultithreadedWifiChannelTestCase::PhyRxBegin (std::vector<Reception> *log, Ptr<const Packet> packet)
+{
+  Reception reception;
+  reception.time = Simulator::Now ();
+  FlowIdTag tag;
+  reception.byteTag = packet->FindFirstMatchingByteTag (tag) && tag.GetFlowId () == 1;
+  reception.packetTag = packet->PeekPacketTag (tag) && tag.GetFlowId () == 2;
+  log->push_back (reception);
+}
+
+void
+MultithreadedWifiChannelTestCase::Send (Ptr<NetDevice> device)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  packet->AddByteTag (FlowIdTag (1));
+  packet->AddPacketTag (FlowIdTag (2));
+  device->Send (packet, device->GetBroadcast (), 0x0800);
+}
+
+Ptr<MultithreadedSimulatorImpl>
+MultithreadedWifiChannelTestCase::RunNodes (uint32_t threads, Time minChannelDelay)
+{
+  Simulator::Destroy ();
+  Ptr<MultithreadedSimulatorImpl> impl;
+  if (threads != 0)
+    {
+      impl = CreateObject<MultithreadedSimulatorImpl> ();
+      impl->SetAttribute ("Threads", UintegerValue (threads));
+      impl->SetAttribute ("MinChannelDelay", TimeValue (minChannelDelay));
+      Simulator::SetImplementation (impl);
+    }
+  NodeContainer nodes;
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      nodes.Create (1, node % N_PARTITIONS);
+    }
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  // the nodes of the two partitions are 10m apart at least
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  positions->Add (Vector (10, 0, 0));
+  positions->Add (Vector (20, 0, 0));
+  positions->Add (Vector (30, 0, 0));
+  positions->Add (Vector (0, 30, 0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<PropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  m_txStart = Seconds (0);
+  m_rx.assign (N_NODES, std::vector<Reception> ());
+  m_delays.clear ();
+  for (uint32_t node = 0; node < N_NODES; node++)
+    {
+      m_delays.push_back (delay->GetDelay (nodes.Get (0)->GetObject<MobilityModel> (),
+                                           nodes.Get (node)->GetObject<MobilityModel> ()));
+      Ptr<WifiPhy> wifiPhy = DynamicCast<WifiNetDevice> (devices.Get (node))->GetPhy ();
+      wifiPhy->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&PhyRxBegin, &m_rx[node]));
+    }
+  DynamicCast<WifiNetDevice> (devices.Get (0))->GetPhy ()
+  ->TraceConnectWithoutContext ("PhyTxBegin", MakeBoundCallback (&PhyTxBegin, &m_txStart));
+
+  Simulator::ScheduleWithContext (0, MilliSeconds (1), &MultithreadedWifiChannelTestCase::Send, this, devices.Get (0));
+  Simulator::Stop (MilliSeconds (2));
+  Simulator::Run ();
+  return impl;
+}
+
+void
+MultithreadedWifiChannelTestCase::DoRun (void)
+{
+  // the lookahead is the delay between the nodes 0 and 1, the nearest
+  // of two partitions, unless MinChannelDelay is larger
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Time minChannelDelay = i == 0 ? NanoSeconds (1) : NanoSeconds (50);
+      for (uint32_t threads = 0; threads <= N_PARTITIONS; threads++)
+        {
+          Ptr<MultithreadedSimulatorImpl> impl = RunNodes (threads, minChannelDelay);
+          Time lookahead = Max (m_delays[1], minChannelDelay);
+          if (impl != 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (impl->GetLookahead (), lookahead, "Lookahead not derived from the delay model");
+            }
+          NS_TEST_ASSERT_MSG_GT (m_txStart, Seconds (0), "Frame not sent");
+          NS_TEST_ASSERT_MSG_EQ (m_rx[0].size (), 0, "Frame received by its sender");
+          for (uint32_t node = 1; node < N_NODES; node++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (m_rx[node].size (), 1, "Frame not received by node " << node << ", threads=" << threads);
+              Time expected = m_txStart + m_delays[node];
+              if (impl != 0 && node % N_PARTITIONS != 0)
+                {
+                  // from another partition: not before the lookahead
+                  expected = m_txStart + Max (m_delays[node], lookahead);
+                }
+              NS_TEST_ASSERT_MSG_EQ (m_rx[node][0].time, expected, "Wrong reception time at node " << node << ", threads=" << threads);
+              NS_TEST_ASSERT_MSG_EQ (m_rx[node][0].byteTag, true, "Byte tag lost at node " << node << ", threads=" << threads);
+              NS_TEST_ASSERT_MSG_EQ (m_rx[node][0].packetTag, true, "Packet tag lost at node " << node << ", threads=" << threads);
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator", UNIT)
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase ());
+    AddTestCase (new MultithreadedWifiChannelTestCase ());
+  }
+} g_multithreadedSimulatorTestSuite;
+
+} // namespace ns3
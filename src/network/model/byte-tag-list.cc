@@ -25,6 +25,10 @@
 NS_LOG_COMPONENT_DEFINE ("ByteTagList");
 
 #define USE_FREE_LIST 1
+// __thread
+#if defined (__GNUC__) && !defined (__APPLE__)
+#define BYTE_TAG_LIST_TLS 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (2147483647)
 
@@ -38,22 +42,42 @@ struct ByteTagListData {
 };
 
 #ifdef USE_FREE_LIST
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
-{
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList;
+typedef std::vector<struct ByteTagListData *> ByteTagListDataFreeList;
 static uint32_t g_maxSize = 0;
 
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
+/* Each thread has its own free list. The lists of the threads other
+ * than the one which runs the static destructors are kept until the
+ * end of the process.
+ */
+static ByteTagListDataFreeList *
+GetFreeList (void)
 {
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
+#ifdef BYTE_TAG_LIST_TLS
+  static __thread ByteTagListDataFreeList *freeList = 0;
+#else
+  static ByteTagListDataFreeList *freeList = 0;
+#endif
+  if (freeList == 0)
     {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
+      freeList = new ByteTagListDataFreeList ();
     }
+  return freeList;
 }
+
+static struct ByteTagListDataFreeListDestructor
+{
+  ~ByteTagListDataFreeListDestructor ()
+  {
+    ByteTagListDataFreeList *freeList = GetFreeList ();
+    for (ByteTagListDataFreeList::iterator i = freeList->begin ();
+         i != freeList->end (); i++)
+      {
+        uint8_t *buffer = (uint8_t *)(*i);
+        delete [] buffer;
+      }
+    freeList->clear ();
+  }
+} g_freeListDestructor;
 #endif /* USE_FREE_LIST */
 
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
@@ -339,10 +363,11 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  ByteTagListDataFreeList *freeList = GetFreeList ();
+  while (!freeList->empty ())
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
+      struct ByteTagListData *data = freeList->back ();
+      freeList->pop_back ();
       NS_ASSERT (data != 0);
       if (data->size >= size)
         {
@@ -373,7 +398,8 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      ByteTagListDataFreeList *freeList = GetFreeList ();
+      if (freeList->size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -381,7 +407,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
         }
       else
         {
-          g_freeList.push_back (data);
+          freeList->push_back (data);
         }
     }
 }
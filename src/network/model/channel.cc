@@ -60,4 +60,10 @@ Channel::GetId (void) const
   return m_id;
 }
 
+Time
+Channel::GetMinRemoteDelay (void) const
+{
+  return Seconds (0);
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -70,6 +71,16 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const = 0;
 
+  /**
+   * \returns the smallest delay after which a transmission on this
+   *          channel may reach a node of another system id.
+   *
+   * MultithreadedSimulatorImpl takes the smallest of the delays of the
+   * channels which span several system ids as its lookahead. The
+   * default returns zero, that is an unknown delay.
+   */
+  virtual Time GetMinRemoteDelay (void) const;
+
 private:
   uint32_t m_id; // Channel id for this channel
 };
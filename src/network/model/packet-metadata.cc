@@ -27,6 +27,11 @@
 #include "header.h"
 #include "trailer.h"
 
+// __thread
+#if defined (__GNUC__) && !defined (__APPLE__)
+#define PACKET_METADATA_TLS 1
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 namespace ns3 {
@@ -36,17 +41,34 @@ bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+struct PacketMetadata::LocalStaticDestructor PacketMetadata::m_localStaticDestructor;
 
-PacketMetadata::DataFreeList::~DataFreeList ()
+PacketMetadata::LocalStaticDestructor::~LocalStaticDestructor ()
 {
-  for (iterator i = begin (); i != end (); i++)
+  DataFreeList *freeList = PacketMetadata::GetFreeList ();
+  for (DataFreeList::iterator i = freeList->begin (); i != freeList->end (); i++)
     {
       PacketMetadata::Deallocate (*i);
     }
+  freeList->clear ();
   PacketMetadata::m_enable = false;
 }
 
+PacketMetadata::DataFreeList *
+PacketMetadata::GetFreeList (void)
+{
+#ifdef PACKET_METADATA_TLS
+  static __thread DataFreeList *freeList = 0;
+#else
+  static DataFreeList *freeList = 0;
+#endif
+  if (freeList == 0)
+    {
+      freeList = new DataFreeList ();
+    }
+  return freeList;
+}
+
 void 
 PacketMetadata::Enable (void)
 {
@@ -570,10 +592,11 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
-  while (!m_freeList.empty ()) 
+  DataFreeList *freeList = GetFreeList ();
+  while (!freeList->empty ()) 
     {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
+      struct PacketMetadata::Data *data = freeList->back ();
+      freeList->pop_back ();
       if (data->m_size >= size) 
         {
           NS_LOG_LOGIC ("create found size="<<data->m_size);
@@ -595,16 +618,17 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
       PacketMetadata::Deallocate (data);
       return;
     } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
+  DataFreeList *freeList = GetFreeList ();
+  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<freeList->size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
+  if (freeList->size () > 1000 ||
       data->m_size < m_maxSize) 
     {
       PacketMetadata::Deallocate (data);
     } 
   else 
     {
-      m_freeList.push_back (data);
+      freeList->push_back (data);
     }
 }
 
@@ -284,13 +284,13 @@ private:
     uint64_t packetUid;
   };
 
-  class DataFreeList : public std::vector<struct Data *>
+  typedef std::vector<struct Data *> DataFreeList;
+  struct LocalStaticDestructor
   {
-public:
-    ~DataFreeList ();
+    ~LocalStaticDestructor ();
   };
 
-  friend DataFreeList::~DataFreeList ();
+  friend struct LocalStaticDestructor;
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -327,7 +327,14 @@ public:
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList;
+  /**
+   * \returns the free list of the calling thread. The lists of the
+   *          threads other than the one which runs the static
+   *          destructors are kept until the end of the process.
+   */
+  static DataFreeList *GetFreeList (void);
+
+  static struct LocalStaticDestructor m_localStaticDestructor;
   static bool m_enable;
   static bool m_enableChecking;
 
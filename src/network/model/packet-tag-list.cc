@@ -22,110 +22,125 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
-#include <string.h>
+#include <cstring>
+#include <new>
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
 namespace ns3 {
 
-#ifdef USE_FREE_LIST
+// capacity of the array of the first tag of a list
+static const uint32_t INITIAL_CAPACITY = 4;
+// the position of a slot shared by several tags, or of a tag too far
+// in the array
+static const uint8_t SCAN = 0xff;
 
-struct PacketTagList::TagData *PacketTagList::g_free = 0;
-uint32_t PacketTagList::g_nfree = 0;
-
-struct PacketTagList::TagData *
-PacketTagList::AllocData (void) const
+struct PacketTagList::Store *
+PacketTagList::Allocate (uint32_t capacity)
 {
-  NS_LOG_FUNCTION (g_nfree);
-  struct PacketTagList::TagData *retval;
-  if (g_free != 0) 
-    {
-      retval = g_free;
-      g_free = g_free->m_next;
-      g_nfree--;
-    } 
-  else 
+  NS_LOG_FUNCTION (capacity);
+  void *memory = ::operator new (sizeof (struct Store) + (capacity - 1) * sizeof (struct TagData));
+  struct Store *store = new (memory) Store ();
+  for (uint32_t i = 1; i < capacity; i++)
     {
-      retval = new struct PacketTagList::TagData ();
+      new (&store->tags[i]) TagData ();
     }
-  return retval;
+  store->count = 1;
+  store->size = 0;
+  store->capacity = capacity;
+  store->slots = 0;
+  return store;
 }
 
 void
-PacketTagList::FreeData (struct TagData *data) const
+PacketTagList::Index (struct Store *store, uint32_t i)
 {
-  NS_LOG_FUNCTION (g_nfree << data);
-  if (g_nfree > 1000) 
+  uint32_t slot = GetSlot (store->tags[i].tid);
+  if ((store->slots & (1U << slot)) != 0 || i >= SCAN)
     {
-      delete data;
-      return;
+      store->index[slot] = SCAN;
     }
-  g_nfree++;
-  data->next = g_free;
-  data->tid = TypeId ();
-  g_free = data;
+  else
+    {
+      store->index[slot] = i;
+    }
+  store->slots |= 1U << slot;
 }
-#else
-struct PacketTagList::TagData *
-PacketTagList::AllocData (void) const
+
+struct PacketTagList::Store *
+PacketTagList::Clone (uint32_t capacity) const
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  struct PacketTagList::TagData *retval;
-  retval = new struct PacketTagList::TagData ();
-  return retval;
+  struct Store *store = Allocate (capacity);
+  store->size = m_store->size;
+  store->slots = m_store->slots;
+  std::memcpy (store->index, m_store->index, sizeof (store->index));
+  for (uint32_t i = 0; i < m_store->size; i++)
+    {
+      store->tags[i] = m_store->tags[i];
+    }
+  return store;
 }
 
-void
-PacketTagList::FreeData (struct TagData *data) const
+struct PacketTagList::TagData *
+PacketTagList::Find (TypeId tid) const
 {
-  NS_LOG_FUNCTION (data);
-  delete data;
+  if (m_store == 0)
+    {
+      return 0;
+    }
+  uint32_t slot = GetSlot (tid);
+  if ((m_store->slots & (1U << slot)) == 0)
+    {
+      return 0;
+    }
+  uint8_t i = m_store->index[slot];
+  if (i != SCAN)
+    {
+      return m_store->tags[i].tid == tid ? &m_store->tags[i] : 0;
+    }
+  for (uint32_t j = 0; j < m_store->size; j++)
+    {
+      if (m_store->tags[j].tid == tid)
+        {
+          return &m_store->tags[j];
+        }
+    }
+  return 0;
 }
-#endif
 
 bool
 PacketTagList::Remove (Tag &tag)
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  TypeId tid = tag.GetInstanceTypeId ();
-  bool found = false;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  struct TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
-      if (cur->tid == tid) 
-        {
-          found = true;
-          tag.Deserialize (TagBuffer (cur->data, cur->data+PACKET_TAG_MAX_SIZE));
-        }
+      return false;
     }
-  if (!found) 
+  tag.Deserialize (TagBuffer (cur->data, cur->data+PACKET_TAG_MAX_SIZE));
+  uint32_t position = cur - m_store->tags;
+  if (m_store->size == 1)
     {
-      return false;
+      RemoveAll ();
+      return true;
     }
-  struct TagData *start = 0;
-  struct TagData **prevNext = &start;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  if (m_store->count > 1)
     {
-      if (cur->tid == tid) 
-        {
-          /**
-           * XXX
-           * Note: I believe that we could optimize this to
-           * avoid copying each TagData located after the target id
-           * and just link the already-copied list to the next tag.
-           */
-          continue;
-        }
-      struct TagData *copy = AllocData ();
-      copy->tid = cur->tid;
-      copy->count = 1;
-      copy->next = 0;
-      memcpy (copy->data, cur->data, PACKET_TAG_MAX_SIZE);
-      *prevNext = copy;
-      prevNext = &copy->next;
-    }
-  *prevNext = 0;
-  RemoveAll ();
-  m_next = start;
+      struct Store *store = Clone (m_store->capacity);
+      RemoveAll ();
+      m_store = store;
+    }
+  // keep the order of the other tags
+  m_store->size--;
+  for (uint32_t i = position; i < m_store->size; i++)
+    {
+      m_store->tags[i] = m_store->tags[i + 1];
+    }
+  m_store->slots = 0;
+  for (uint32_t i = 0; i < m_store->size; i++)
+    {
+      Index (m_store, i);
+    }
   return true;
 }
 
@@ -134,44 +149,54 @@ PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  NS_ASSERT (Find (tag.GetInstanceTypeId ()) == 0);
+  PacketTagList *list = const_cast<PacketTagList *> (this);
+  if (m_store == 0)
+    {
+      list->m_store = Allocate (INITIAL_CAPACITY);
+    }
+  else if (m_store->count > 1 || m_store->size == m_store->capacity)
     {
-      NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
+      uint32_t capacity = m_store->capacity;
+      if (m_store->size == capacity)
+        {
+          capacity *= 2;
+        }
+      struct Store *store = Clone (capacity);
+      list->RemoveAll ();
+      list->m_store = store;
     }
-  struct TagData *head = AllocData ();
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
+  struct TagData *data = &m_store->tags[m_store->size];
+  data->tid = tag.GetInstanceTypeId ();
   NS_ASSERT (tag.GetSerializedSize () <= PACKET_TAG_MAX_SIZE);
-  tag.Serialize (TagBuffer (head->data, head->data+tag.GetSerializedSize ()));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  tag.Serialize (TagBuffer (data->data, data->data+tag.GetSerializedSize ()));
+  Index (m_store, m_store->size);
+  m_store->size++;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  struct TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
-      if (cur->tid == tid) 
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data+PACKET_TAG_MAX_SIZE));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
+  tag.Deserialize (TagBuffer (cur->data, cur->data+PACKET_TAG_MAX_SIZE));
+  return true;
 }
 
-const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
+PacketTagList
+PacketTagList::DeepCopy (void) const
 {
-  return m_next;
+  PacketTagList copy;
+  if (m_store != 0)
+    {
+      copy.m_store = Clone (m_store->capacity);
+    }
+  return copy;
 }
 
 } // namespace ns3
-
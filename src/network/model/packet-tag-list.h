@@ -36,14 +36,26 @@ class Tag;
  */
 #define PACKET_TAG_MAX_SIZE 20
 
+/**
+ * The packet tags are stored by value in an array shared by the copies
+ * of a packet: a copy only increments the reference count of the array,
+ * and a list copies the array before it adds or removes a tag if other
+ * lists share it.
+ *
+ * Each tag type maps to one of 32 slots by the uid of its TypeId, and
+ * the array keeps the mask of the slots of its tags and the position of
+ * the tag of each slot. Looking a tag up does not scan the tags, unless
+ * several tags of the list share its slot.
+ *
+ * The reference count of the array is not atomic: a packet handed over
+ * to another thread must not share its tags (see DeepCopy).
+ */
 class PacketTagList 
 {
 public:
   struct TagData {
     uint8_t data[PACKET_TAG_MAX_SIZE];
-    struct TagData *next;
     TypeId tid;
-    uint32_t count;
   };
 
   inline PacketTagList ();
@@ -55,19 +67,45 @@ public:
   bool Remove (Tag &tag);
   bool Peek (Tag &tag) const;
   inline void RemoveAll (void);
-
-  const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \returns a list with the tags of this one, which shares no memory
+   *          with it
+   */
+  PacketTagList DeepCopy (void) const;
+
+  /**
+   * \returns the number of tags in the list
+   */
+  inline uint32_t GetNTags (void) const;
+  /**
+   * \param i the index of a tag, in the order in which they were added
+   * \returns the tag
+   */
+  inline const struct PacketTagList::TagData *Get (uint32_t i) const;
 
 private:
+  /// The tags shared by the copies of a list
+  struct Store
+  {
+    // number of lists sharing the tags
+    uint32_t count;
+    uint32_t size;
+    uint32_t capacity;
+    // mask of the slots of the tags
+    uint32_t slots;
+    // position of the tag of each slot
+    uint8_t index[32];
+    // followed by the other capacity - 1 tags
+    struct TagData tags[1];
+  };
 
-  bool Remove (TypeId tid);
-  struct PacketTagList::TagData *AllocData (void) const;
-  void FreeData (struct TagData *data) const;
-
-  static struct PacketTagList::TagData *g_free;
-  static uint32_t g_nfree;
+  inline static uint32_t GetSlot (TypeId tid);
+  static struct Store *Allocate (uint32_t capacity);
+  static void Index (struct Store *store, uint32_t i);
+  struct Store *Clone (uint32_t capacity) const;
+  struct PacketTagList::TagData *Find (TypeId tid) const;
 
-  struct TagData *m_next;
+  struct Store *m_store;
 };
 
 } // namespace ns3
@@ -79,16 +117,16 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_store (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_store (o.m_store)
 {
-  if (m_next != 0)
+  if (m_store != 0)
     {
-      m_next->count++;
+      m_store->count++;
     }
 }
 
@@ -96,15 +134,15 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (m_store == o.m_store) 
     {
       return *this;
     }
   RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  m_store = o.m_store;
+  if (m_store != 0)
     {
-      m_next->count++;
+      m_store->count++;
     }
   return *this;
 }
@@ -117,25 +155,33 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  if (m_store != 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
+      m_store->count--;
+      if (m_store->count == 0)
         {
-          FreeData (prev);
+          ::operator delete (m_store);
         }
-      prev = cur;
+      m_store = 0;
     }
-  if (prev != 0) 
-    {
-      FreeData (prev);
-    }
-  m_next = 0;
+}
+
+uint32_t
+PacketTagList::GetNTags (void) const
+{
+  return m_store != 0 ? m_store->size : 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Get (uint32_t i) const
+{
+  return &m_store->tags[i];
+}
+
+uint32_t
+PacketTagList::GetSlot (TypeId tid)
+{
+  return tid.GetUid () % 32;
 }
 
 } // namespace ns3
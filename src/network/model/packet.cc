@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include <string>
+#include <vector>
 #include <stdarg.h>
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
@@ -81,8 +82,9 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList *list)
+  : m_list (list),
+    m_current (list->GetNTags ())
 {
 }
 bool
@@ -94,9 +96,8 @@ PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
-  const struct PacketTagList::TagData *prev = m_current;
-  m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  m_current--;
+  return PacketTagIterator::Item (m_list->Get (m_current));
 }
 
 PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
@@ -125,6 +126,43 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  // the serialized packet carries the buffer, the metadata and the
+  // nix-vector but not the tags, which are copied one by one.
+  std::vector<uint8_t> data (GetSerializedSize ());
+  uint32_t serialized = Serialize (&data[0], data.size ());
+  NS_ASSERT (serialized);
+  Ptr<Packet> copy = Create<Packet> (&data[0], data.size (), true);
+
+  int32_t delta = copy->m_buffer.GetCurrentStartOffset () - m_buffer.GetCurrentStartOffset ();
+  ByteTagList::Iterator i = m_byteTagList.Begin (m_buffer.GetCurrentStartOffset (),
+                                                 m_buffer.GetCurrentEndOffset ());
+  while (i.HasNext ())
+    {
+      ByteTagList::Iterator::Item item = i.Next ();
+      TagBuffer buf = copy->m_byteTagList.Add (item.tid, item.size,
+                                               item.start + delta, item.end + delta);
+      buf.CopyFrom (item.buf);
+    }
+  copy->m_packetTagList = m_packetTagList.DeepCopy ();
+  return copy;
+}
+
+uint64_t
+Packet::AllocateUid (void)
+{
+  uint64_t uid;
+  if (Simulator::AllocatePacketUid (uid))
+    {
+      return uid;
+    }
+  uid = static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid;
+  m_globalUid++;
+  return uid;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -135,10 +173,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -177,10 +214,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -203,10 +239,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -887,7 +922,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (&m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -147,8 +147,10 @@ private:
   Item Next (void);
 private:
   friend class Packet;
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;
+  PacketTagIterator (const PacketTagList *list);
+  const PacketTagList *m_list;
+  // the tags are iterated from the last one added
+  uint32_t m_current;
 };
 
 /**
@@ -373,6 +375,18 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \returns a copy of the packet which shares no data with
+   *          the original packet.
+   *
+   * Unlike Copy, the returned packet owns its own buffer, metadata,
+   * byte tags and packet tags, so that it can be handed over to
+   * another thread: the reference counts of the datasets which
+   * Copy shares are not atomic. The copy keeps the uid of the
+   * original packet.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * A packet is allocated a new uid when it is created
    * empty or with zero-filled payload.
@@ -566,6 +580,14 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector;
 
+  /**
+   * \returns the uid of a new packet: the system id in the upper 32
+   *          bits and m_globalUid in the lower ones, unless the simulator
+   *          runs events in parallel and numbers the packets itself
+   *          (see Simulator::AllocatePacketUid).
+   */
+  static uint64_t AllocateUid (void);
+
   static uint32_t m_globalUid;
 };
 
@@ -20,6 +20,7 @@
 #include "ns3/packet.h"
 #include "ns3/test.h"
 #include <string>
+#include <vector>
 #include <stdarg.h>
 
 namespace ns3 {
@@ -420,6 +421,61 @@ PacketTest::DoRun (void)
     NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (b), false, "trivial");
   }
 
+  {
+    // the copies share the tags until one of them adds or removes one
+    Packet p;
+    p.AddPacketTag (ATestTag<1> ());
+    Packet copy = p;
+    p.AddPacketTag (ATestTag<2> ());
+    ATestTag<2> b;
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (b), false, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (b), true, "trivial");
+    ATestTag<1> a;
+    NS_TEST_EXPECT_MSG_EQ (p.RemovePacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (a), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (a.m_error, false, "trivial");
+  }
+
+  {
+    // more tags than the first array holds
+    Packet p;
+    p.AddPacketTag (ATestTag<1> ());
+    p.AddPacketTag (ATestTag<2> ());
+    p.AddPacketTag (ATestTag<3> ());
+    p.AddPacketTag (ATestTag<4> ());
+    p.AddPacketTag (ATestTag<5> ());
+    p.AddPacketTag (ATestTag<6> ());
+    Packet copy = p;
+    ATestTag<2> b;
+    NS_TEST_EXPECT_MSG_EQ (copy.RemovePacketTag (b), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (b.m_error, false, "trivial");
+    ATestTag<5> e;
+    NS_TEST_EXPECT_MSG_EQ (copy.RemovePacketTag (e), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (e.m_error, false, "trivial");
+    copy.AddPacketTag (ATestTag<7> ());
+    ATestTag<6> f;
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (f), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (f.m_error, false, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (b), false, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (copy.PeekPacketTag (e), false, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (b), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (e), true, "trivial");
+    ATestTag<7> g;
+    NS_TEST_EXPECT_MSG_EQ (p.PeekPacketTag (g), false, "trivial");
+    // the last tag added comes first
+    uint32_t expected[] = { 7, 6, 4, 3, 1 };
+    uint32_t n = 0;
+    PacketTagIterator i = copy.GetPacketTagIterator ();
+    while (i.HasNext ())
+      {
+        std::ostringstream oss;
+        oss << "anon::ATestTag<" << expected[n] << ">";
+        NS_TEST_EXPECT_MSG_EQ (i.Next ().GetTypeId ().GetName (), oss.str (), "trivial");
+        n++;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 5, "trivial");
+  }
+
   {
     // bug 572
     Ptr<Packet> tmp = Create<Packet> (1000);
@@ -434,6 +490,35 @@ PacketTest::DoRun (void)
     CHECK (tmp, 1, E (20, 1, 1001));
 #endif
   }
+
+  {
+    // deep copies carry the tags of the packet but share nothing with it
+    Ptr<Packet> tmp = Create<Packet> (1000);
+    tmp->AddByteTag (ATestTag<20> ());
+    tmp->AddHeader (ATestHeader<2> ());
+    tmp->AddByteTag (ATestTag<21> ());
+    tmp->RemoveAtStart (1);
+    tmp->AddPacketTag (ATestTag<5> ());
+    Ptr<Packet> deep = tmp->DeepCopy ();
+    NS_TEST_EXPECT_MSG_EQ (deep->GetSize (), tmp->GetSize (), "trivial");
+    NS_TEST_EXPECT_MSG_EQ (deep->GetUid (), tmp->GetUid (), "trivial");
+    std::vector<uint8_t> a (tmp->GetSize ());
+    std::vector<uint8_t> b (deep->GetSize ());
+    tmp->CopyData (&a[0], a.size ());
+    deep->CopyData (&b[0], b.size ());
+    NS_TEST_EXPECT_MSG_EQ ((a == b), true, "trivial");
+    CHECK (deep, 2, E (20, 1, 1001), E (21, 0, 1001));
+    ATestTag<5> tag;
+    NS_TEST_EXPECT_MSG_EQ (deep->PeekPacketTag (tag), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (tag.m_error, false, "trivial");
+
+    deep->AddByteTag (ATestTag<23> ());
+    deep->RemovePacketTag (tag);
+    deep->AddHeader (ATestHeader<3> ());
+    CHECK (tmp, 2, E (20, 1, 1001), E (21, 0, 1001));
+    NS_TEST_EXPECT_MSG_EQ (tmp->PeekPacketTag (tag), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (tmp->GetSize (), 1001, "trivial");
+  }
 }
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
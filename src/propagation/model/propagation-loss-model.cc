@@ -60,6 +60,12 @@ PropagationLossModel::SetNext (Ptr<PropagationLossModel> next)
   m_next = next;
 }
 
+Ptr<PropagationLossModel>
+PropagationLossModel::GetNext (void) const
+{
+  return m_next;
+}
+
 double
 PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
@@ -64,6 +64,11 @@ public:
    */
   void SetNext (Ptr<PropagationLossModel> next);
 
+  /**
+   * \returns the next PropagationLossModel of the chain, if any
+   */
+  Ptr<PropagationLossModel> GetNext (void) const;
+
   /**
    * \param txPowerDbm current transmission power (in dBm)
    * \param a the mobility model of the source
@@ -20,6 +20,7 @@
 
 #include <ns3/log.h>
 #include <ns3/packet.h>
+#include <ns3/simulator.h>
 #include "half-duplex-ideal-phy-signal-parameters.h"
 
 
@@ -36,7 +37,9 @@ HalfDuplexIdealPhySignalParameters::HalfDuplexIdealPhySignalParameters (const Ha
   : SpectrumSignalParameters (p)
 {
   NS_LOG_FUNCTION (this << &p);
-  data = p.data->Copy ();
+  // the receivers share the packet, unless their events may run in
+  // parallel
+  data = Simulator::IsParallel () ? p.data->DeepCopy () : p.data;
 }
 
 Ptr<SpectrumSignalParameters>
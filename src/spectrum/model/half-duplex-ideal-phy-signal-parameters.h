@@ -50,7 +50,9 @@ struct HalfDuplexIdealPhySignalParameters : public SpectrumSignalParameters
   HalfDuplexIdealPhySignalParameters (const HalfDuplexIdealPhySignalParameters& p);
 
   /**
-   * The data packet being transmitted with this signal
+   * The data packet being transmitted with this signal. The copies of
+   * the parameters share it, unless the simulator runs events in
+   * parallel: it must be copied before being modified.
    */
   Ptr<Packet> data;
 };
@@ -271,7 +271,7 @@ HalfDuplexIdealPhy::StartTx (Ptr<Packet> p)
         txParams->duration = Seconds (txTimeSeconds);
         txParams->txPhy = GetObject<SpectrumPhy> ();
         txParams->psd = m_txPsd;
-        txParams->data = m_txPacket;
+        txParams->data = m_txPacket->Copy ();
 
         NS_LOG_LOGIC (this << " tx power: " << 10 * log10 (Integral (*(txParams->psd))) + 30 << " dBm");
         m_channel->StartTx (txParams);
@@ -403,7 +403,8 @@ HalfDuplexIdealPhy::EndRx ()
       if (!m_phyMacRxEndOkCallback.IsNull ())
         {
           NS_LOG_LOGIC (this << " calling m_phyMacRxEndOkCallback");
-          m_phyMacRxEndOkCallback (m_rxPacket);
+          // the receivers of the signal share m_rxPacket
+          m_phyMacRxEndOkCallback (m_rxPacket->Copy ());
         }
       else
         {
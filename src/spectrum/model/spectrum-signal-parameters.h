@@ -74,6 +74,13 @@ struct SpectrumSignalParameters : public SimpleRefCount<SpectrumSignalParameters
    * Each class inheriting from
    * SpectrumSignalParameters should override this method and use it
    * to call the copy constructor of the derived class.
+   * The channels make a copy for each receiver: the packets carried by
+   * the derived classes should be shared by the copies rather than
+   * copied, and copied by the receivers which pass them up. If the
+   * events of several contexts may run in parallel (see
+   * Simulator::IsParallel), the copies should rather own a
+   * Packet::DeepCopy of them, since their reference counts are not
+   * atomic.
    *
    * \return a copy of the (possibly derived) class
    */
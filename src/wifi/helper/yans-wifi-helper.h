@@ -196,6 +196,8 @@ public:
    * \param v7 the value of the attribute to set
    *
    * Set the error rate model and its attributes to use when Install is called.
+   * "ns3::TableErrorRateModel" replaces the per-chunk evaluation of another
+   * model with a table lookup.
    */
   void SetErrorRateModel (std::string name,
                           std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
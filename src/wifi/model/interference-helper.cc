@@ -116,7 +116,14 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_cursor (m_niChanges.end ()),
+    m_cursorPowerW (0.0),
+    m_cursorTime (Seconds (0)),
+    m_energyValid (false),
+    m_energyW (0.0),
+    m_energyBreak (m_niChanges.end ()),
+    m_energyBreakW (0.0)
 {
 }
 InterferenceHelper::~InterferenceHelper ()
@@ -170,44 +177,98 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  AdvanceCursor (now);
+  if (!m_energyValid || energyW != m_energyW
+      || (m_energyBreak != m_niChanges.end () && m_energyBreak->GetTime () < now))
+    {
+      m_energyValid = true;
+      m_energyW = energyW;
+      WalkEnergy (m_cursor, m_cursorPowerW);
+    }
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  if (m_energyBreak != m_niChanges.end ())
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
-      if (noiseInterferenceW < energyW)
+      end = m_energyBreak->GetTime ();
+    }
+  else if (!m_niChanges.empty ())
+    {
+      end = (--m_niChanges.end ())->GetTime ();
+    }
+  return end > now ? end - now : MicroSeconds (0);
+}
+
+void
+InterferenceHelper::WalkEnergy (NiChangeSet::iterator from, double powerW)
+{
+  for (NiChangeSet::iterator i = from; i != m_niChanges.end (); i++)
+    {
+      powerW += i->GetDelta ();
+      if (powerW < m_energyW)
         {
-          break;
+          m_energyBreak = i;
+          m_energyBreakW = powerW;
+          return;
         }
     }
-  return end > now ? end - now : MicroSeconds (0);
+  m_energyBreak = m_niChanges.end ();
+  m_energyBreakW = powerW;
+}
+
+void
+InterferenceHelper::AdvanceCursor (Time now)
+{
+  if (now < m_cursorTime)
+    {
+      m_cursor = m_niChanges.begin ();
+      m_cursorPowerW = m_firstPower;
+      m_energyValid = false;
+    }
+  m_cursorTime = now;
+  while (m_cursor != m_niChanges.end () && m_cursor->GetTime () < now)
+    {
+      m_cursorPowerW += m_cursor->GetDelta ();
+      m_cursor++;
+    }
 }
 
 void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
   Time now = Simulator::Now ();
+  AdvanceCursor (now);
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
+      // nobody needs the past any more: fold it into m_firstPower
+      while (!m_niChanges.empty () && m_niChanges.begin ()->GetTime () <= now)
         {
-          m_firstPower += i->GetDelta ();
+          if (m_energyBreak == m_niChanges.begin ())
+            {
+              m_energyValid = false;
+            }
+          m_firstPower += m_niChanges.begin ()->GetDelta ();
+          m_niChanges.erase (m_niChanges.begin ());
         }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      m_cursor = m_niChanges.begin ();
+      m_cursorPowerW = m_firstPower;
     }
-  else
+  // with the past folded, the start of the event is the first change
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
+
+  // The event raises the energy between its start and its end only.
+  // Changes before the last break were above the threshold and stay so,
+  // and if the event ends before the break, the break does not move.
+  if (m_energyValid && m_energyBreak != m_niChanges.end ()
+      && event->GetStartTime () < m_energyBreak->GetTime ()
+      && event->GetEndTime () >= m_energyBreak->GetTime ())
     {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      m_energyBreakW += event->GetRxPowerW ();
+      if (m_energyBreakW >= m_energyW)
+        {
+          NiChangeSet::iterator next = m_energyBreak;
+          WalkEnergy (++next, m_energyBreakW);
+        }
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
 
 }
 
@@ -231,7 +292,8 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event>
 {
   double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  NiChangeSet::const_iterator i = m_niChanges.begin ();
+  for (i++; i != m_niChanges.end (); i++)
     {
       if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
         {
@@ -371,17 +433,27 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  m_cursor = m_niChanges.end ();
+  m_cursorPowerW = 0.0;
+  m_energyValid = false;
+  m_energyBreak = m_niChanges.end ();
 }
-InterferenceHelper::NiChanges::iterator
+InterferenceHelper::NiChangeSet::iterator
 InterferenceHelper::GetPosition (Time moment)
 {
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
+  return m_niChanges.upper_bound (NiChange (moment, 0));
 
 }
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  NiChangeSet::iterator position = GetPosition (change.GetTime ());
+  NiChangeSet::iterator i = m_niChanges.insert (position, change);
+  if (position == m_cursor)
+    {
+      // changes are never added in the past
+      m_cursor = i;
+    }
 }
 void
 InterferenceHelper::NotifyRxStart ()
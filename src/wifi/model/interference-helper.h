@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <set>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -109,6 +110,12 @@ private:
     double m_delta;
   };
   typedef std::vector <NiChange> NiChanges;
+  /**
+   * Changes sorted by time. On a busy channel a frame may start while
+   * hundreds of others are still to end, so the changes are kept in a
+   * tree rather than a sorted vector.
+   */
+  typedef std::multiset <NiChange> NiChangeSet;
   typedef std::list<Ptr<Event> > Events;
 
   InterferenceHelper (const InterferenceHelper &o);
@@ -122,12 +129,32 @@ private:
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
   ///Experimental: needed for energy duration calculation
-  NiChanges m_niChanges;
+  NiChangeSet m_niChanges;
   double m_firstPower;
   bool m_rxing;
   /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  NiChangeSet::iterator GetPosition (Time moment);
   void AddNiChangeEvent (NiChange change);
+  /// Move m_cursor to the first change not earlier than now
+  void AdvanceCursor (Time now);
+  /// Resume the GetEnergyDuration walk after m_energyBreak
+  void WalkEnergy (NiChangeSet::iterator from, double powerW);
+
+  /// First change not earlier than m_cursorTime
+  NiChangeSet::iterator m_cursor;
+  /// Noise and interference right before m_cursor
+  double m_cursorPowerW;
+  Time m_cursorTime;
+  /**
+   * Last GetEnergyDuration answer: the first change from the cursor on
+   * after which the energy is below m_energyW, and the energy after it.
+   * New frames only push it later, so it is resumed rather than searched
+   * again from the cursor on every call.
+   */
+  bool m_energyValid;
+  double m_energyW;
+  NiChangeSet::iterator m_energyBreak;
+  double m_energyBreakW;
 };
 
 } // namespace ns3
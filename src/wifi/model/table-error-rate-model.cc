@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "table-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
+#include <algorithm>
+#include <sstream>
+#include <math.h>
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+namespace ns3 {
+
+#ifdef HAVE_PTHREAD_H
+/// guards TableErrorRateModel::GetCache
+static SystemMutex g_tableCacheMutex;
+#endif
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The model sampled to build the tables.",
+                   PointerValue (),
+                   MakePointerAccessor (&TableErrorRateModel::m_model),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR of the tables (dB).",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR of the tables (dB).",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The spacing of the SNR grid (dB).",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_stepDb),
+                   MakeDoubleChecker<double> (1e-3))
+    .AddAttribute ("MaxBitsExponent",
+                   "The longest chunk of the tables is 2^MaxBitsExponent bits, "
+                   "longer chunks use the underlying model.",
+                   UintegerValue (15),
+                   MakeUintegerAccessor (&TableErrorRateModel::m_maxBitsExponent),
+                   MakeUintegerChecker<uint32_t> (1, 31))
+    .AddAttribute ("MaxError",
+                   "The largest absolute error on the chunk success rate accepted "
+                   "for an interpolated cell; other cells use the underlying model.",
+                   DoubleValue (1e-3),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxError),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_nSnr (0),
+    m_nBuckets (0),
+    m_exactLookups (0)
+{
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  m_model = 0;
+  m_tables.clear ();
+  m_cacheKey.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+uint64_t
+TableErrorRateModel::GetExactLookups (void) const
+{
+  return m_exactLookups;
+}
+
+void
+TableErrorRateModel::FindBucket (uint32_t nbits, uint32_t maxBucket,
+                                 uint32_t *bucket, double *frac)
+{
+  if (nbits >= (1U << maxBucket))
+    {
+      *bucket = maxBucket - 1;
+      *frac = 1.0;
+      return;
+    }
+  uint32_t b = 0;
+  while ((nbits >> (b + 1)) != 0)
+    {
+      b++;
+    }
+  *bucket = b;
+  *frac = (double)(nbits - (1U << b)) / (1U << b);
+}
+
+double
+TableErrorRateModel::Interpolate (const Table &table, uint32_t i, double snrFrac,
+                                  uint32_t bucket, double bitsFrac, uint32_t nbits) const
+{
+  const double *lo = &table.perBitLog[i * m_nBuckets + bucket];
+  const double *hi = lo + m_nBuckets;
+  double a = lo[0] + bitsFrac * (lo[1] - lo[0]);
+  double b = hi[0] + bitsFrac * (hi[1] - hi[0]);
+  double perBitLog = a + snrFrac * (b - a);
+  return exp (perBitLog * nbits);
+}
+
+TableErrorRateModel::TableCache &
+TableErrorRateModel::GetCache (void)
+{
+  static TableCache cache;
+  return cache;
+}
+
+std::string
+TableErrorRateModel::GetCacheKey (void) const
+{
+  std::ostringstream oss;
+  oss.precision (17);
+  oss << m_minSnrDb << " " << m_maxSnrDb << " " << m_stepDb << " "
+      << m_maxBitsExponent << " " << m_maxError << " ";
+  TypeId tid = m_model->GetInstanceTypeId ();
+  oss << tid.GetName ();
+  while (true)
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          m_model->GetAttribute (info.name, *value);
+          oss << " " << info.name << "=" << value->SerializeToString (info.checker);
+        }
+      if (tid.GetParent () == tid)
+        {
+          break;
+        }
+      tid = tid.GetParent ();
+    }
+  return oss.str ();
+}
+
+void
+TableErrorRateModel::BuildTable (WifiMode mode, Table &table) const
+{
+  NS_LOG_FUNCTION (this << mode);
+  table.perBitLog.resize (m_nSnr * m_nBuckets);
+  table.exact.assign (m_nSnr * m_nBuckets, false);
+  for (uint32_t i = 0; i < m_nSnr; i++)
+    {
+      double snr = pow (10.0, (m_minSnrDb + i * m_stepDb) / 10.0);
+      for (uint32_t b = 0; b < m_nBuckets; b++)
+        {
+          uint32_t nbits = 1U << b;
+          double csr = m_model->GetChunkSuccessRate (mode, snr, nbits);
+          // exp (-700) is still a normal double
+          table.perBitLog[i * m_nBuckets + b] = std::max (log (csr), -700.0) / nbits;
+        }
+    }
+  // check each cell at a few SNRs inside it, on its lower edge, in the
+  // middle and at the upper end of its chunk length range.  Cells where the success rate drops
+  // to zero on one side only are too steep to be interpolated.
+  uint32_t nExact = 0;
+  for (uint32_t i = 0; i + 1 < m_nSnr; i++)
+    {
+      for (uint32_t b = 0; b + 1 < m_nBuckets; b++)
+        {
+          uint32_t cell = i * m_nBuckets + b;
+          bool zeroLo = table.perBitLog[cell] * (1U << b) <= -700.0;
+          bool zeroHi = table.perBitLog[cell + m_nBuckets] * (1U << b) <= -700.0;
+          bool exact = zeroLo != zeroHi;
+          for (uint32_t j = 1; j < 8 && !exact; j++)
+            {
+              double snr = pow (10.0, (m_minSnrDb + (i + j / 8.0) * m_stepDb) / 10.0);
+              uint32_t lengths[3] = { 1U << b, (1U << b) + (1U << b) / 2, (2U << b) - 1 };
+              for (uint32_t k = 0; k < 3 && !exact; k++)
+                {
+                  uint32_t bucket;
+                  double bitsFrac;
+                  FindBucket (lengths[k], m_maxBitsExponent, &bucket, &bitsFrac);
+                  double error = fabs (Interpolate (table, i, j / 8.0, bucket, bitsFrac, lengths[k])
+                                       - m_model->GetChunkSuccessRate (mode, snr, lengths[k]));
+                  exact = error > m_maxError;
+                }
+            }
+          if (exact)
+            {
+              table.exact[cell] = true;
+              nExact++;
+            }
+        }
+    }
+  NS_LOG_DEBUG ("table for " << mode << ": " << m_nSnr << "x" << m_nBuckets
+                             << " cells, " << nExact << " delegated");
+}
+
+const TableErrorRateModel::Table &
+TableErrorRateModel::GetTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid < m_tables.size () && m_tables[uid] != 0)
+    {
+      return *m_tables[uid];
+    }
+  if (m_model == 0)
+    {
+      m_model = CreateObject<NistErrorRateModel> ();
+    }
+  if (m_nSnr == 0)
+    {
+      NS_ASSERT (m_maxSnrDb > m_minSnrDb);
+      m_nSnr = (uint32_t)floor ((m_maxSnrDb - m_minSnrDb) / m_stepDb) + 1;
+      m_nBuckets = m_maxBitsExponent + 1;
+      NS_ASSERT (m_nSnr >= 2);
+      m_cacheKey = GetCacheKey ();
+    }
+  std::ostringstream key;
+  key << uid << " " << m_cacheKey;
+  const Table *table;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection lock (g_tableCacheMutex);
+#endif
+    TableCache &cache = GetCache ();
+    TableCache::iterator i = cache.find (key.str ());
+    if (i == cache.end ())
+      {
+        i = cache.insert (std::make_pair (key.str (), Table ())).first;
+        BuildTable (mode, i->second);
+      }
+    else
+      {
+        NS_LOG_DEBUG ("shared table for " << mode);
+      }
+    // the nodes of a std::map do not move
+    table = &i->second;
+  }
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1, 0);
+    }
+  m_tables[uid] = table;
+  return *table;
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  const Table &table = GetTable (mode);
+  if (snr > 0)
+    {
+      double x = (10.0 * log10 (snr) - m_minSnrDb) / m_stepDb;
+      if (x >= 0 && x < m_nSnr - 1 && nbits <= (1U << m_maxBitsExponent))
+        {
+          uint32_t i = (uint32_t)x;
+          uint32_t bucket;
+          double bitsFrac;
+          FindBucket (nbits, m_maxBitsExponent, &bucket, &bitsFrac);
+          if (!table.exact[i * m_nBuckets + bucket])
+            {
+              return Interpolate (table, i, x - i, bucket, bitsFrac, nbits);
+            }
+        }
+    }
+  m_exactLookups++;
+  return m_model->GetChunkSuccessRate (mode, snr, nbits);
+}
+
+} // namespace ns3
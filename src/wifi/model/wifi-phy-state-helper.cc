@@ -379,7 +379,12 @@ WifiPhyStateHelper::SwitchFromRxEndOk (Ptr<Packet> packet, double snr, WifiMode
 void
 WifiPhyStateHelper::SwitchFromRxEndError (Ptr<const Packet> packet, double snr)
 {
-  m_rxErrorTrace (packet, snr);
+  // the packet is shared by the receivers of its transmission: the
+  // trace sinks get a copy, while the MAC only reads it
+  if (!m_rxErrorTrace.IsEmpty ())
+    {
+      m_rxErrorTrace (WifiPhy::CopyReceived (packet), snr);
+    }
   NotifyRxEndError ();
   DoSwitchFromRx ();
   if (!m_rxErrorCallback.IsNull ())
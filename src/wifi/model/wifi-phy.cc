@@ -301,6 +301,18 @@ WifiPhy::CalculateTxDuration (uint32_t size, WifiMode payloadMode, WifiPreamble
 }
 
 
+Ptr<Packet>
+WifiPhy::CopyReceived (Ptr<const Packet> packet)
+{
+  // the copies of a packet share its buffers, whose reference counts
+  // are not atomic
+  if (Simulator::IsParallel ())
+    {
+      return packet->DeepCopy ();
+    }
+  return packet->Copy ();
+}
+
 void
 WifiPhy::NotifyTxBegin (Ptr<const Packet> packet)
 {
@@ -322,25 +334,37 @@ WifiPhy::NotifyTxDrop (Ptr<const Packet> packet)
 void
 WifiPhy::NotifyRxBegin (Ptr<const Packet> packet)
 {
-  m_phyRxBeginTrace (packet);
+  if (!m_phyRxBeginTrace.IsEmpty ())
+    {
+      m_phyRxBeginTrace (CopyReceived (packet));
+    }
 }
 
 void
 WifiPhy::NotifyRxEnd (Ptr<const Packet> packet)
 {
-  m_phyRxEndTrace (packet);
+  if (!m_phyRxEndTrace.IsEmpty ())
+    {
+      m_phyRxEndTrace (CopyReceived (packet));
+    }
 }
 
 void
 WifiPhy::NotifyRxDrop (Ptr<const Packet> packet)
 {
-  m_phyRxDropTrace (packet);
+  if (!m_phyRxDropTrace.IsEmpty ())
+    {
+      m_phyRxDropTrace (CopyReceived (packet));
+    }
 }
 
 void
 WifiPhy::NotifyMonitorSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber, uint32_t rate, bool isShortPreamble, double signalDbm, double noiseDbm)
 {
-  m_phyMonitorSniffRxTrace (packet, channelFreqMhz, channelNumber, rate, isShortPreamble, signalDbm, noiseDbm);
+  if (!m_phyMonitorSniffRxTrace.IsEmpty ())
+    {
+      m_phyMonitorSniffRxTrace (CopyReceived (packet), channelFreqMhz, channelNumber, rate, isShortPreamble, signalDbm, noiseDbm);
+    }
 }
 
 void
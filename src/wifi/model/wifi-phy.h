@@ -152,7 +152,9 @@ public:
    */
   typedef Callback<void,Ptr<Packet>, double, WifiMode, enum WifiPreamble> RxOkCallback;
   /**
-   * arg1: packet received unsuccessfully
+   * arg1: packet received unsuccessfully, which may be shared by all
+   *       the receivers of its transmission: the callback must not
+   *       modify it, nor tag it
    * arg2: snr of packet
    */
   typedef Callback<void,Ptr<const Packet>, double> RxErrorCallback;
@@ -395,9 +397,21 @@ public:
    */
   void NotifyTxDrop (Ptr<const Packet> packet);
 
+  /**
+   * \param packet a packet received, shared by all the receivers of its
+   *        transmission
+   * \returns a copy of the packet, which its owner may modify
+   *
+   * The copy is a Packet::DeepCopy when the events of the receivers may
+   * run in parallel (see Simulator::IsParallel).
+   */
+  static Ptr<Packet> CopyReceived (Ptr<const Packet> packet);
+
   /**
    * Public method used to fire a PhyRxBegin trace.  Implemented for encapsulation
-   * purposes.
+   * purposes. The trace sinks get a copy of the packet (see CopyReceived),
+   * which is only taken if a sink is connected; so do those of the
+   * PhyRxEnd, PhyRxDrop and MonitorSnifferRx traces.
    */
   void NotifyRxBegin (Ptr<const Packet> packet);
 
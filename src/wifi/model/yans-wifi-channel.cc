@@ -20,15 +20,22 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
@@ -50,16 +57,60 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange", "The maximum distance (m) at which a transmission is delivered to a PHY. "
+                   "When non-zero, candidate receivers are looked up in a spatial grid instead "
+                   "of evaluating the propagation models for every PHY attached to the channel.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("GridRefreshInterval", "The maximum time between two full rebuilds of the spatial grid.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&YansWifiChannel::m_gridRefreshInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("DropBelowEdThreshold", "If true, frames received below the energy detection "
+                   "threshold of the receiving PHY are not delivered to it.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_dropBelowEdThreshold),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CacheRxPower", "If true, the propagation loss between two PHYs is only "
+                   "recomputed when one of them has moved. Only valid with deterministic "
+                   "propagation loss models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cacheRxPower),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RxPowerCacheSize", "The maximum number of links in the cache of CacheRxPower. "
+                   "The cache is emptied when it is full.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&YansWifiChannel::m_rxPowerCacheSize),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0),
+    m_maxSpeed (0.0),
+    m_gridValid (false),
+    m_dropBelowEdThreshold (false),
+    m_cacheRxPower (false),
+    m_rxPowerCacheSize (65536),
+    m_lossChecked (false),
+    m_lossDeterministic (false)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  for (MobilityIndex::iterator i = m_mobilityIndex.begin (); i != m_mobilityIndex.end (); i++)
+    {
+      ConstCast<MobilityModel> (i->first)->TraceDisconnectWithoutContext ("CourseChange",
+                                                                          MakeCallback (&YansWifiChannel::CourseChanged, this));
+    }
+  m_mobilityIndex.clear ();
+  m_grid.clear ();
+  m_lossCache.clear ();
+  m_partitions.clear ();
+  m_senderMobility.clear ();
   m_phyList.clear ();
 }
 
@@ -67,6 +118,8 @@ void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_lossChecked = false;
+  m_lossCache.clear ();
 }
 void
 YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
@@ -80,42 +133,308 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  // the receivers share this copy, which the sender cannot modify. The
+  // receivers of a partition run on its thread, but without partitions
+  // they may run on any thread, and must not share the buffers of the
+  // packet of the sender.
+  bool parallel = m_partitions.empty () && Simulator::IsParallel ();
+  Ptr<const Packet> frozen = parallel ? packet->DeepCopy () : packet->Copy ();
+  Transmission tx;
+  tx.start = Simulator::Now ();
+  tx.txPowerDbm = txPowerDbm;
+  tx.channelNumber = sender->GetChannelNumber ();
+  tx.mode = wifiMode;
+  tx.preamble = preamble;
+  if (!m_partitions.empty ())
     {
-      if (sender != (*i))
+      tx.senderPosition = senderMobility->GetPosition ();
+      uint32_t systemId = Simulator::GetSystemId ();
+      for (uint32_t i = 0; i < m_partitions.size (); i++)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          const Partition &partition = m_partitions[i];
+          if (partition.systemId == systemId)
             {
+              for (std::vector<uint32_t>::const_iterator j = partition.phys.begin (); j != partition.phys.end (); j++)
+                {
+                  SendTo (*j, sender, senderMobility, frozen, tx);
+                }
               continue;
             }
+          // each partition gets a packet of its own, with the tags of
+          // this one, which shares no data with the copies of this one
+          Ptr<Packet> copy = packet->DeepCopy ();
+          Simulator::ScheduleWithContext (partition.node, m_minRemoteDelay,
+                                          &YansWifiChannel::ReceiveRemote, this,
+                                          i, copy, tx);
+        }
+      return;
+    }
+  if (parallel)
+    {
+      // the mobility models of the receivers may be run by their own
+      // events meanwhile: each reception is computed in the context of
+      // its receiver, from the position of the sender taken here.
+      tx.senderPosition = senderMobility->GetPosition ();
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          if (m_phyList[j] != sender)
+            {
+              Simulator::ScheduleWithContext (GetContext (j), Seconds (0),
+                                              &YansWifiChannel::ReceiveParallel, this,
+                                              j, frozen, tx);
+            }
+        }
+      return;
+    }
+  if (m_maxRange > 0)
+    {
+      std::vector<uint32_t> candidates;
+      GetCandidates (senderMobility->GetPosition (), candidates);
+      for (std::vector<uint32_t>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
+        {
+          SendTo (*i, sender, senderMobility, frozen, tx);
+        }
+      return;
+    }
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      SendTo (j, sender, senderMobility, frozen, tx);
+    }
+}
+
+void
+YansWifiChannel::ReceiveRemote (uint32_t i, Ptr<Packet> packet, Transmission tx) const
+{
+  const Partition &partition = m_partitions[i];
+  NS_LOG_DEBUG ("remote transmission started at " << tx.start);
+  partition.senderMobility->SetPosition (tx.senderPosition);
+  for (std::vector<uint32_t>::const_iterator j = partition.phys.begin (); j != partition.phys.end (); j++)
+    {
+      SendTo (*j, 0, partition.senderMobility, packet, tx);
+    }
+}
+
+void
+YansWifiChannel::ReceiveParallel (uint32_t j, Ptr<const Packet> packet, Transmission tx) const
+{
+  // only the events of the context of PHY j use its slot
+  Ptr<MobilityModel> &senderMobility = m_senderMobility[j];
+  if (senderMobility == 0)
+    {
+      senderMobility = CreateObject<ConstantPositionMobilityModel> ();
+    }
+  senderMobility->SetPosition (tx.senderPosition);
+  SendTo (j, 0, senderMobility, packet, tx);
+}
+
+void
+YansWifiChannel::SendTo (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                         Ptr<const Packet> packet, const Transmission &tx) const
+{
+  Ptr<YansWifiPhy> receiver = m_phyList[j];
+  if (sender == receiver)
+    {
+      return;
+    }
+  // For now don't account for inter channel interference
+  if (receiver->GetChannelNumber () != tx.channelNumber)
+    {
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  if (m_maxRange > 0 && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+    {
+      return;
+    }
+  double rxPowerDbm = CalcRxPower (tx.txPowerDbm, senderMobility, receiverMobility);
+  if (m_dropBelowEdThreshold
+      && rxPowerDbm + receiver->GetRxGain () < receiver->GetEdThreshold ())
+    {
+      NS_LOG_DEBUG ("drop below ed threshold: rxPower=" << rxPowerDbm << "dbm");
+      return;
+    }
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << tx.txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  // the transmissions of the other partitions are computed after the
+  // smallest delay to a remote PHY, or after the lookahead of the
+  // simulator if it is larger
+  Time elapsed = Simulator::Now () - tx.start;
+  if (delay < elapsed)
+    {
+      NS_LOG_LOGIC ("remote reception delayed by " << elapsed - delay);
+      delay = elapsed;
+    }
+  delay -= elapsed;
+  Simulator::ScheduleWithContext (GetContext (j),
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, packet, rxPowerDbm, tx.mode, tx.preamble);
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+double
+YansWifiChannel::CalcRxPower (double txPowerDbm, Ptr<MobilityModel> sender, Ptr<MobilityModel> receiver) const
+{
+  if (!m_cacheRxPower || !m_partitions.empty () || Simulator::IsParallel () || !IsLossDeterministic ())
+    {
+      return m_loss->CalcRxPower (txPowerDbm, sender, receiver);
+    }
+  Vector senderPosition = sender->GetPosition ();
+  Vector receiverPosition = receiver->GetPosition ();
+  std::pair<Ptr<MobilityModel>, Ptr<MobilityModel> > key = std::make_pair (sender, receiver);
+  LossCache::iterator link = m_lossCache.find (key);
+  if (link != m_lossCache.end ()
+      && link->second.txPowerDbm == txPowerDbm
+      && link->second.senderPosition.x == senderPosition.x
+      && link->second.senderPosition.y == senderPosition.y
+      && link->second.senderPosition.z == senderPosition.z
+      && link->second.receiverPosition.x == receiverPosition.x
+      && link->second.receiverPosition.y == receiverPosition.y
+      && link->second.receiverPosition.z == receiverPosition.z)
+    {
+      return link->second.rxPowerDbm;
+    }
+  if (link == m_lossCache.end () && m_lossCache.size () >= m_rxPowerCacheSize)
+    {
+      NS_LOG_DEBUG ("rx power cache full, emptied");
+      m_lossCache.clear ();
+    }
+  LinkLoss loss;
+  loss.senderPosition = senderPosition;
+  loss.receiverPosition = receiverPosition;
+  loss.txPowerDbm = txPowerDbm;
+  loss.rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, sender, receiver);
+  m_lossCache[key] = loss;
+  return loss.rxPowerDbm;
+}
+
+bool
+YansWifiChannel::IsLossDeterministic (void) const
+{
+  if (!m_lossChecked)
+    {
+      m_lossDeterministic = true;
+      for (Ptr<PropagationLossModel> loss = m_loss; loss != 0; loss = loss->GetNext ())
+        {
+          if (DynamicCast<RandomPropagationLossModel> (loss) != 0
+              || DynamicCast<NakagamiPropagationLossModel> (loss) != 0
+              || DynamicCast<JakesPropagationLossModel> (loss) != 0)
             {
-              dstNode = 0xffffffff;
+              NS_LOG_WARN ("CacheRxPower ignored: " << loss->GetInstanceTypeId ().GetName () << " is random");
+              m_lossDeterministic = false;
             }
-          else
+        }
+      m_lossChecked = true;
+    }
+  return m_lossDeterministic;
+}
+
+YansWifiChannel::GridCell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return GridCell (static_cast<int32_t> (std::floor (position.x / m_maxRange)),
+                   static_cast<int32_t> (std::floor (position.y / m_maxRange)));
+}
+
+void
+YansWifiChannel::RefreshGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_grid.clear ();
+  m_phyCell.resize (m_phyList.size ());
+  m_maxSpeed = 0.0;
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      MobilityIndex::iterator entry = m_mobilityIndex.find (mobility);
+      if (entry == m_mobilityIndex.end ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&YansWifiChannel::CourseChanged, this));
+          entry = m_mobilityIndex.insert (std::make_pair (mobility, std::vector<uint32_t> ())).first;
+        }
+      if (std::find (entry->second.begin (), entry->second.end (), i) == entry->second.end ())
+        {
+          entry->second.push_back (i);
+        }
+      Vector velocity = mobility->GetVelocity ();
+      m_maxSpeed = std::max (m_maxSpeed, CalculateDistance (velocity, Vector ()));
+      m_phyCell[i] = GetCell (mobility->GetPosition ());
+      m_grid[m_phyCell[i]].push_back (i);
+    }
+  m_lastRefresh = Simulator::Now ();
+  m_gridValid = true;
+}
+
+void
+YansWifiChannel::UpdateGrid (uint32_t i) const
+{
+  Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+  Vector velocity = mobility->GetVelocity ();
+  m_maxSpeed = std::max (m_maxSpeed, CalculateDistance (velocity, Vector ()));
+  GridCell cell = GetCell (mobility->GetPosition ());
+  if (cell == m_phyCell[i])
+    {
+      return;
+    }
+  std::vector<uint32_t> &oldCell = m_grid[m_phyCell[i]];
+  oldCell.erase (std::find (oldCell.begin (), oldCell.end (), i));
+  if (oldCell.empty ())
+    {
+      m_grid.erase (m_phyCell[i]);
+    }
+  m_phyCell[i] = cell;
+  m_grid[cell].push_back (i);
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  if (!m_gridValid)
+    {
+      return;
+    }
+  MobilityIndex::const_iterator entry = m_mobilityIndex.find (mobility);
+  if (entry == m_mobilityIndex.end ())
+    {
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator i = entry->second.begin (); i != entry->second.end (); i++)
+    {
+      UpdateGrid (*i);
+    }
+}
+
+void
+YansWifiChannel::GetCandidates (const Vector &position, std::vector<uint32_t> &candidates) const
+{
+  if (!m_gridValid || Simulator::Now () >= m_lastRefresh + m_gridRefreshInterval)
+    {
+      RefreshGrid ();
+    }
+  // the indexed positions may have drifted by up to m_maxSpeed times the
+  // time elapsed since they were last refreshed.
+  double range = m_maxRange + m_maxSpeed * (Simulator::Now () - m_lastRefresh).GetSeconds ();
+  GridCell min = GetCell (Vector (position.x - range, position.y - range, 0));
+  GridCell max = GetCell (Vector (position.x + range, position.y + range, 0));
+  for (int32_t x = min.first; x <= max.first; x++)
+    {
+      for (int32_t y = min.second; y <= max.second; y++)
+        {
+          Grid::const_iterator cell = m_grid.find (GridCell (x, y));
+          if (cell != m_grid.end ())
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              candidates.insert (candidates.end (), cell->second.begin (), cell->second.end ());
             }
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, wifiMode, preamble);
         }
     }
+  // keep the same delivery order as the linear scan of m_phyList.
+  std::sort (candidates.begin (), candidates.end ());
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiMode txMode, WifiPreamble preamble) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txMode, preamble);
@@ -132,10 +451,90 @@ YansWifiChannel::GetDevice (uint32_t i) const
   return m_phyList[i]->GetDevice ()->GetObject<NetDevice> ();
 }
 
+uint32_t
+YansWifiChannel::GetContext (uint32_t j) const
+{
+  Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+  if (dstNetDevice == 0)
+    {
+      return 0xffffffff;
+    }
+  return dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+}
+
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   m_phyList.push_back (phy);
+  m_senderMobility.push_back (0);
+  m_gridValid = false;
+}
+
+Time
+YansWifiChannel::GetMinRemoteDelay (void) const
+{
+  return m_minRemoteDelay;
+}
+
+void
+YansWifiChannel::DoStart (void)
+{
+  m_partitions.clear ();
+  m_minRemoteDelay = Seconds (0);
+  std::map<uint32_t, Partition> partitions;
+  std::vector<uint32_t> systemIds;
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<Object> device = m_phyList[i]->GetDevice ();
+      uint32_t systemId = 0;
+      uint32_t node = 0xffffffff;
+      if (device != 0)
+        {
+          Ptr<Node> n = device->GetObject<NetDevice> ()->GetNode ();
+          systemId = n->GetSystemId ();
+          node = n->GetId ();
+        }
+      Partition &partition = partitions[systemId];
+      if (partition.phys.empty ())
+        {
+          partition.systemId = systemId;
+          partition.node = node;
+          partition.senderMobility = CreateObject<ConstantPositionMobilityModel> ();
+        }
+      partition.phys.push_back (i);
+      systemIds.push_back (systemId);
+    }
+  if (partitions.size () > 1)
+    {
+      NS_LOG_LOGIC ("PHYs in " << partitions.size () << " partitions");
+      for (std::map<uint32_t, Partition>::const_iterator i = partitions.begin (); i != partitions.end (); ++i)
+        {
+          m_partitions.push_back (i->second);
+        }
+      // the smallest delay between the current positions of two PHYs of
+      // different partitions
+      bool first = true;
+      for (uint32_t i = 0; i < m_phyList.size (); i++)
+        {
+          Ptr<MobilityModel> sender = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+          for (uint32_t j = 0; j < m_phyList.size (); j++)
+            {
+              if (systemIds[i] == systemIds[j])
+                {
+                  continue;
+                }
+              Ptr<MobilityModel> receiver = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+              Time delay = m_delay->GetDelay (sender, receiver);
+              if (first || delay < m_minRemoteDelay)
+                {
+                  m_minRemoteDelay = delay;
+                  first = false;
+                }
+            }
+        }
+      NS_LOG_LOGIC ("smallest remote delay " << m_minRemoteDelay);
+    }
+  WifiChannel::DoStart ();
 }
 
 } // namespace ns3
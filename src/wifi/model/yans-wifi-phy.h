@@ -91,7 +91,17 @@ public:
   /// Return current center channel frequency in MHz, see SetChannelNumber()
   double GetChannelFrequencyMhz () const;
 
-  void StartReceivePacket (Ptr<Packet> packet,
+  /**
+   * \param packet the packet received, shared with the other receivers
+   * of its transmission unless the simulator runs events in parallel
+   * \param rxPowerDbm the received power
+   * \param mode the transmission mode
+   * \param preamble the preamble of the transmission
+   *
+   * The packet is only copied when it is received successfully, before
+   * being forwarded up to the MAC.
+   */
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiMode mode,
                            WifiPreamble preamble);
@@ -158,7 +168,7 @@ private:
   double WToDbm (double w) const;
   double RatioToDb (double ratio) const;
   double GetPowerDbm (uint8_t power) const;
-  void EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event);
 
 private:
   double   m_edThresholdW;
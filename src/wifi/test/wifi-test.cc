@@ -21,15 +21,21 @@
  */
 
 #include "ns3/wifi-net-device.h"
+#include "ns3/simple-net-device.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/arf-wifi-manager.h"
+#include "ns3/constant-rate-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/interference-helper.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
@@ -37,6 +43,17 @@
 #include "ns3/dca-txop.h"
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/core-config.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#ifdef HAVE_PTHREAD_H
+#include "ns3/parallel-simulator-impl.h"
+#endif
 
 namespace ns3 {
 
@@ -284,6 +301,678 @@ InterferenceHelperSequenceTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+//-----------------------------------------------------------------------------
+/// GetEnergyDuration as frames start and end around the threshold crossing
+class InterferenceHelperEnergyDurationTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyDurationTest ();
+
+  virtual void DoRun (void);
+private:
+  void Add (Time duration);
+  void Check (double energyW, Time expected);
+
+  InterferenceHelper m_interference;
+};
+
+InterferenceHelperEnergyDurationTest::InterferenceHelperEnergyDurationTest ()
+  : TestCase ("InterferenceHelper energy duration")
+{
+}
+
+void
+InterferenceHelperEnergyDurationTest::Add (Time duration)
+{
+  m_interference.Add (100, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, duration, 1e-9);
+}
+
+void
+InterferenceHelperEnergyDurationTest::Check (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Energy above " << energyW << " W at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperEnergyDurationTest::DoRun (void)
+{
+  // A [0, 100us] received, B [10us, 210us], C [20us, 40us], D [150us, 250us]
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelper::NotifyRxStart, &m_interference);
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyDurationTest::Add, this, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (1), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (99));
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperEnergyDurationTest::Add, this, MicroSeconds (200));
+  Simulator::Schedule (MicroSeconds (11), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (199));
+  Simulator::Schedule (MicroSeconds (11), &InterferenceHelperEnergyDurationTest::Check, this, 1.5e-9, MicroSeconds (89));
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperEnergyDurationTest::Add, this, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (21), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (189));
+  Simulator::Schedule (MicroSeconds (21), &InterferenceHelperEnergyDurationTest::Check, this, 2.5e-9, MicroSeconds (19));
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (160));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelper::NotifyRxEnd, &m_interference);
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyDurationTest::Add, this, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyDurationTest::Check, this, 1.5e-9, MicroSeconds (60));
+  Simulator::Schedule (MicroSeconds (220), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (30));
+  Simulator::Schedule (MicroSeconds (300), &InterferenceHelperEnergyDurationTest::Check, this, 5e-10, MicroSeconds (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/// TableErrorRateModel against the model it samples
+class TableErrorRateModelTest : public TestCase
+{
+public:
+  TableErrorRateModelTest ();
+
+  virtual void DoRun (void);
+private:
+  void Compare (Ptr<ErrorRateModel> exact);
+};
+
+TableErrorRateModelTest::TableErrorRateModelTest ()
+  : TestCase ("TableErrorRateModel accuracy")
+{
+}
+
+void
+TableErrorRateModelTest::Compare (Ptr<ErrorRateModel> exact)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::TableErrorRateModel");
+  factory.Set ("ErrorRateModel", PointerValue (exact));
+  factory.Set ("MaxError", DoubleValue (1e-3));
+  Ptr<TableErrorRateModel> table = factory.Create<TableErrorRateModel> ();
+
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate18Mbps (),
+                       WifiPhy::GetOfdmRate36Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                       WifiPhy::GetOfdmRate6MbpsBW10MHz (), WifiPhy::GetDsssRate11Mbps () };
+  uint32_t lengths[] = { 1, 7, 100, 1000, 3000, 18432, 32768 };
+  uint32_t lookups = 0;
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      for (double snrDb = -12.0; snrDb < 42.0; snrDb += 0.037)
+        {
+          double snr = pow (10.0, snrDb / 10.0);
+          for (uint32_t l = 0; l < sizeof (lengths) / sizeof (lengths[0]); l++)
+            {
+              double expected = exact->GetChunkSuccessRate (modes[m], snr, lengths[l]);
+              double actual = table->GetChunkSuccessRate (modes[m], snr, lengths[l]);
+              NS_TEST_EXPECT_MSG_EQ_TOL (actual, expected, 1e-3,
+                                         modes[m] << " snr=" << snrDb << "dB nbits=" << lengths[l]);
+              lookups++;
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (table->GetChunkSuccessRate (modes[0], 1.0, 0), 1.0, "Empty chunk");
+  // only the SNRs outside of the table and a few steep cells are delegated
+  NS_TEST_EXPECT_MSG_LT (table->GetExactLookups (), lookups / 10, "Table not used");
+}
+
+void
+TableErrorRateModelTest::DoRun (void)
+{
+  Compare (CreateObject<NistErrorRateModel> ());
+  Compare (CreateObject<YansErrorRateModel> ());
+  // uses the tables built for the first model
+  Compare (CreateObject<NistErrorRateModel> ());
+}
+
+//-----------------------------------------------------------------------------
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+public:
+  YansWifiChannelMaxRangeTest ();
+
+  virtual void DoRun (void);
+protected:
+  YansWifiChannelMaxRangeTest (std::string name);
+  Ptr<Node> CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void Move (Ptr<Node> node, Vector pos);
+  void Receive (std::string context, Ptr<const Packet> p);
+
+  std::map<std::string, uint32_t> m_received;
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest ()
+  : TestCase ("YansWifiChannelMaxRange")
+{
+}
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMaxRangeTest::Move (Ptr<Node> node, Vector pos)
+{
+  node->GetObject<MobilityModel> ()->SetPosition (pos);
+}
+
+void
+YansWifiChannelMaxRangeTest::Receive (std::string context, Ptr<const Packet> p)
+{
+  m_received[context]++;
+}
+
+Ptr<Node>
+YansWifiChannelMaxRangeTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  ObjectFactory mac;
+  mac.SetTypeId ("ns3::AdhocWifiMac");
+  Ptr<WifiMac> wifiMac = mac.Create<WifiMac> ();
+  wifiMac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  wifiMac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (wifiMac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  std::ostringstream oss;
+  oss << node->GetId ();
+  phy->TraceConnect ("PhyRxBegin", oss.str (), MakeCallback (&YansWifiChannelMaxRangeTest::Receive, this));
+  phy->TraceConnect ("PhyRxDrop", oss.str (), MakeCallback (&YansWifiChannelMaxRangeTest::Receive, this));
+
+  return node;
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (1000.0));
+  // no periodic rebuild: the move must be found through CourseChange
+  channel->SetAttribute ("GridRefreshInterval", TimeValue (Seconds (1000.0)));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> near = CreateOne (Vector (100.0, 0.0, 0.0), channel);
+  Ptr<Node> far = CreateOne (Vector (5000.0, 0.0, 0.0), channel);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+  // moving into range must be picked up through the CourseChange notification
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelMaxRangeTest::Move, this,
+                       far, Vector (-200.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (2.5), &YansWifiChannelMaxRangeTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ostringstream nearId, farId;
+  nearId << near->GetId ();
+  farId << far->GetId ();
+  NS_TEST_EXPECT_MSG_EQ (m_received[nearId.str ()], 2, "Node in range receives both packets");
+  NS_TEST_EXPECT_MSG_EQ (m_received[farId.str ()], 1, "Node out of range receives only the packet sent after it moved in range");
+}
+
+//-----------------------------------------------------------------------------
+/*
+ * Counts how many times the channel evaluates the propagation loss, the
+ * loss itself is computed by the next model in the chain.
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+  CountingPropagationLossModel ();
+  uint32_t GetCount (void) const;
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  mutable uint32_t m_count;
+};
+
+TypeId
+CountingPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CountingPropagationLossModel> ()
+  ;
+  return tid;
+}
+
+CountingPropagationLossModel::CountingPropagationLossModel ()
+  : m_count (0)
+{
+}
+
+uint32_t
+CountingPropagationLossModel::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+CountingPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  m_count++;
+  return txPowerDbm;
+}
+
+class YansWifiChannelEdThresholdTest : public YansWifiChannelMaxRangeTest
+{
+public:
+  YansWifiChannelEdThresholdTest ();
+
+  virtual void DoRun (void);
+};
+
+YansWifiChannelEdThresholdTest::YansWifiChannelEdThresholdTest ()
+  : YansWifiChannelMaxRangeTest ("YansWifiChannelEdThreshold")
+{
+}
+
+void
+YansWifiChannelEdThresholdTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("DropBelowEdThreshold", BooleanValue (true));
+  channel->SetAttribute ("CacheRxPower", BooleanValue (true));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  loss->SetNext (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> near = CreateOne (Vector (100.0, 0.0, 0.0), channel);
+  Ptr<Node> far = CreateOne (Vector (5000.0, 0.0, 0.0), channel);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelEdThresholdTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelEdThresholdTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+  Simulator::Schedule (Seconds (2.5), &YansWifiChannelEdThresholdTest::Move, this,
+                       far, Vector (-100.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelEdThresholdTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ostringstream nearId, farId;
+  nearId << near->GetId ();
+  farId << far->GetId ();
+  NS_TEST_EXPECT_MSG_EQ (m_received[nearId.str ()], 3, "Node above the ed threshold receives every packet");
+  NS_TEST_EXPECT_MSG_EQ (m_received[farId.str ()], 1, "Node below the ed threshold receives only the packet sent after it moved closer");
+  NS_TEST_EXPECT_MSG_EQ (loss->GetCount (), 3, "The loss is only recomputed for the link which changed");
+}
+
+//-----------------------------------------------------------------------------
+class YansWifiChannelRxPowerCacheTest : public YansWifiChannelMaxRangeTest
+{
+public:
+  YansWifiChannelRxPowerCacheTest ();
+
+  virtual void DoRun (void);
+private:
+  // sends two packets to two receivers, returns the number of losses computed
+  uint32_t SendTwice (Ptr<PropagationLossModel> next, uint32_t cacheSize);
+};
+
+YansWifiChannelRxPowerCacheTest::YansWifiChannelRxPowerCacheTest ()
+  : YansWifiChannelMaxRangeTest ("YansWifiChannelRxPowerCache")
+{
+}
+
+uint32_t
+YansWifiChannelRxPowerCacheTest::SendTwice (Ptr<PropagationLossModel> next, uint32_t cacheSize)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("CacheRxPower", BooleanValue (true));
+  channel->SetAttribute ("RxPowerCacheSize", UintegerValue (cacheSize));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  loss->SetNext (next);
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  CreateOne (Vector (100.0, 0.0, 0.0), channel);
+  CreateOne (Vector (0.0, 100.0, 0.0), channel);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelRxPowerCacheTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelRxPowerCacheTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return loss->GetCount ();
+}
+
+void
+YansWifiChannelRxPowerCacheTest::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (SendTwice (CreateObject<LogDistancePropagationLossModel> (), 100), 2,
+                         "The loss of each link is computed once");
+  NS_TEST_EXPECT_MSG_EQ (SendTwice (CreateObject<LogDistancePropagationLossModel> (), 1), 4,
+                         "The cache holds a single link");
+  NS_TEST_EXPECT_MSG_EQ (SendTwice (CreateObject<NakagamiPropagationLossModel> (), 100), 4,
+                         "The loss of a random chain is not cached");
+}
+
+//-----------------------------------------------------------------------------
+class YansWifiChannelSharedPacketTest : public YansWifiChannelMaxRangeTest
+{
+public:
+  YansWifiChannelSharedPacketTest ();
+
+  virtual void DoRun (void);
+private:
+  void RunOnce (void);
+  void RxBegin (Ptr<const Packet> p);
+  bool ForwardUp (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::vector<Ptr<const Packet> > m_shared;
+  std::vector<Ptr<const Packet> > m_up;
+};
+
+YansWifiChannelSharedPacketTest::YansWifiChannelSharedPacketTest ()
+  : YansWifiChannelMaxRangeTest ("YansWifiChannelSharedPacket")
+{
+}
+
+void
+YansWifiChannelSharedPacketTest::RxBegin (Ptr<const Packet> p)
+{
+  // a trace sink may tag the packet it gets
+  p->AddPacketTag (FlowIdTag (m_shared.size ()));
+  m_shared.push_back (p);
+}
+
+bool
+YansWifiChannelSharedPacketTest::ForwardUp (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                            uint16_t protocol, const Address &from)
+{
+  m_up.push_back (p);
+  return true;
+}
+
+void
+YansWifiChannelSharedPacketTest::RunOnce (void)
+{
+  // the receivers are at different distances: their events do not run
+  // in parallel, and may record into the same vectors
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> receiver = CreateOne (Vector (100.0, 10.0 * i, 0.0), channel);
+      Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (receiver->GetDevice (0));
+      dev->GetPhy ()->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&YansWifiChannelSharedPacketTest::RxBegin, this));
+      dev->SetReceiveCallback (MakeCallback (&YansWifiChannelSharedPacketTest::ForwardUp, this));
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelSharedPacketTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelSharedPacketTest::DoRun (void)
+{
+  FlowIdTag tag;
+  RunOnce ();
+  // the receivers share the packet, but neither the trace sinks nor
+  // the MACs may see what the others write to it
+  NS_TEST_ASSERT_MSG_EQ (m_shared.size (), 2, "Both receivers start receiving the packet");
+  NS_TEST_EXPECT_MSG_NE (m_shared[0], m_shared[1], "Each trace sink gets a copy of its own");
+  NS_TEST_EXPECT_MSG_EQ (m_shared[0]->GetUid (), m_shared[1]->GetUid (), "The sinks get copies of the same packet");
+  NS_TEST_ASSERT_MSG_EQ (m_up.size (), 2, "Both receivers forward the packet up");
+  NS_TEST_EXPECT_MSG_NE (m_up[0], m_up[1], "Each MAC gets a copy of its own");
+  NS_TEST_EXPECT_MSG_NE (m_up[0], m_shared[0], "Each MAC gets a copy of its own");
+  NS_TEST_EXPECT_MSG_EQ (m_up[0]->GetSize (), 100, "The MAC removes its headers from its copy");
+  NS_TEST_EXPECT_MSG_GT (m_shared[0]->GetSize (), 100, "The copy of the sink keeps the headers");
+  NS_TEST_EXPECT_MSG_EQ (m_up[0]->PeekPacketTag (tag), false, "The tag of a trace sink reaches the MAC");
+  NS_TEST_EXPECT_MSG_EQ (m_up[1]->PeekPacketTag (tag), false, "The tag of a trace sink reaches the MAC");
+  m_shared.clear ();
+  m_up.clear ();
+
+#ifdef HAVE_PTHREAD_H
+  // the reference counts of the buffers of a packet are not atomic: when
+  // the events of the receivers may run in parallel, they share a deep
+  // copy of the packet, and the copies they take are deep copies too
+  Simulator::SetImplementation (CreateObject<ParallelSimulatorImpl> ());
+  RunOnce ();
+  NS_TEST_ASSERT_MSG_EQ (m_shared.size (), 2, "Both receivers start receiving the packet");
+  NS_TEST_EXPECT_MSG_NE (m_shared[0], m_shared[1], "Each trace sink gets a copy of its own");
+  NS_TEST_EXPECT_MSG_EQ (m_shared[0]->GetUid (), m_shared[1]->GetUid (), "The sinks get copies of the same packet");
+  NS_TEST_EXPECT_MSG_EQ (m_shared[0]->GetSize (), m_shared[1]->GetSize (), "The sinks get copies of the same packet");
+  NS_TEST_ASSERT_MSG_EQ (m_up.size (), 2, "Both receivers forward the packet up");
+  NS_TEST_EXPECT_MSG_NE (m_up[0], m_up[1], "Each MAC gets a copy of its own");
+  NS_TEST_EXPECT_MSG_EQ (m_up[0]->GetSize (), 100, "The MAC removes its headers from its copy");
+  NS_TEST_EXPECT_MSG_EQ (m_up[0]->PeekPacketTag (tag), false, "The tag of a trace sink reaches the MAC");
+  NS_TEST_EXPECT_MSG_EQ (m_up[1]->PeekPacketTag (tag), false, "The tag of a trace sink reaches the MAC");
+  m_shared.clear ();
+  m_up.clear ();
+#endif
+}
+
+#ifdef HAVE_PTHREAD_H
+//-----------------------------------------------------------------------------
+/*
+ * Runs the receptions of a YansWifiChannel with ParallelSimulatorImpl: the
+ * receivers of a group are at the same distance of its centre, so that
+ * the receptions of all the groups run in the same batches. The PHYs
+ * sit on a plain device, without a MAC which would draw random backoffs.
+ * They all move along, with a mobility model which updates its position
+ * when it is read.
+ */
+class YansWifiChannelParallelTest : public TestCase
+{
+public:
+  YansWifiChannelParallelTest ();
+
+  virtual void DoRun (void);
+private:
+  enum { N_GROUPS = 4, N_RECEIVERS = 6 };
+  Ptr<ParallelSimulatorImpl> RunGroups (uint32_t threads);
+  Ptr<YansWifiPhy> CreatePhy (Vector pos, Ptr<YansWifiChannel> channel);
+  void Send (Ptr<YansWifiPhy> phy);
+  void Log (uint32_t kind, std::string context, Ptr<const Packet> p);
+  void RxBegin (std::string context, Ptr<const Packet> p);
+  void RxEnd (std::string context, Ptr<const Packet> p);
+  void RxDrop (std::string context, Ptr<const Packet> p);
+  uint32_t Index (uint32_t group, uint32_t receiver) const;
+
+  std::vector<Ptr<YansWifiPhy> > m_phys;
+  std::vector<std::vector<uint64_t> > m_logs;
+};
+
+YansWifiChannelParallelTest::YansWifiChannelParallelTest ()
+  : TestCase ("YansWifiChannelParallel")
+{
+}
+
+uint32_t
+YansWifiChannelParallelTest::Index (uint32_t group, uint32_t receiver) const
+{
+  // the centre of a group comes first
+  return group * (N_RECEIVERS + 1) + receiver + 1;
+}
+
+void
+YansWifiChannelParallelTest::Log (uint32_t kind, std::string context, Ptr<const Packet> p)
+{
+  // each phy only writes its own log
+  uint64_t entry = (Simulator::Now ().GetNanoSeconds () * 4 + kind) * 2000 + p->GetSize ();
+  m_logs[std::atoi (context.c_str ())].push_back (entry);
+}
+
+void
+YansWifiChannelParallelTest::RxBegin (std::string context, Ptr<const Packet> p)
+{
+  Log (0, context, p);
+}
+
+void
+YansWifiChannelParallelTest::RxEnd (std::string context, Ptr<const Packet> p)
+{
+  Log (1, context, p);
+}
+
+void
+YansWifiChannelParallelTest::RxDrop (std::string context, Ptr<const Packet> p)
+{
+  Log (2, context, p);
+}
+
+void
+YansWifiChannelParallelTest::Send (Ptr<YansWifiPhy> phy)
+{
+  phy->SendPacket (Create<Packet> (100), WifiMode ("OfdmRate6Mbps"), WIFI_PREAMBLE_LONG, 0);
+}
+
+Ptr<YansWifiPhy>
+YansWifiChannelParallelTest::CreatePhy (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+  Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  mobility->SetPosition (pos);
+  mobility->SetVelocity (Vector (10.0, 0.0, 0.0));
+  node->AggregateObject (mobility);
+  dev->SetNode (node);
+
+  std::ostringstream oss;
+  oss << m_phys.size ();
+  phy->TraceConnect ("PhyRxBegin", oss.str (), MakeCallback (&YansWifiChannelParallelTest::RxBegin, this));
+  phy->TraceConnect ("PhyRxEnd", oss.str (), MakeCallback (&YansWifiChannelParallelTest::RxEnd, this));
+  phy->TraceConnect ("PhyRxDrop", oss.str (), MakeCallback (&YansWifiChannelParallelTest::RxDrop, this));
+  m_phys.push_back (phy);
+  return phy;
+}
+
+Ptr<ParallelSimulatorImpl>
+YansWifiChannelParallelTest::RunGroups (uint32_t threads)
+{
+  Simulator::Destroy ();
+  Ptr<ParallelSimulatorImpl> impl;
+  if (threads != 0)
+    {
+      impl = CreateObject<ParallelSimulatorImpl> ();
+      impl->SetAttribute ("Threads", UintegerValue (threads));
+      impl->SetAttribute ("MinParallelEvents", UintegerValue (2));
+      Simulator::SetImplementation (impl);
+    }
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  m_phys.clear ();
+  m_logs.assign (N_GROUPS * (N_RECEIVERS + 1), std::vector<uint64_t> ());
+  for (uint32_t group = 0; group < N_GROUPS; group++)
+    {
+      Vector centre (5000.0 * group, 0.0, 0.0);
+      Ptr<YansWifiPhy> phy = CreatePhy (centre, channel);
+      // all the centres send at once, the receivers get their frames at once
+      Simulator::ScheduleWithContext (phy->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetId (),
+                                      Seconds (1.0), &YansWifiChannelParallelTest::Send, this, phy);
+      for (uint32_t receiver = 0; receiver < N_RECEIVERS; receiver++)
+        {
+          double angle = 2 * M_PI * receiver / N_RECEIVERS;
+          Vector pos (centre.x + 20.0 * std::cos (angle), centre.y + 20.0 * std::sin (angle), 0.0);
+          phy = CreatePhy (pos, channel);
+          // then the receivers of the groups answer in turn
+          Simulator::ScheduleWithContext (phy->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetId (),
+                                          Seconds (2.0) + MilliSeconds (receiver), &YansWifiChannelParallelTest::Send, this, phy);
+        }
+    }
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_phys[i]->Dispose ();
+    }
+  m_phys.clear ();
+  return impl;
+}
+
+void
+YansWifiChannelParallelTest::DoRun (void)
+{
+  Ptr<ParallelSimulatorImpl> impl = RunGroups (1);
+  NS_TEST_ASSERT_MSG_GT (impl->GetNBatches (), 0, "No batch run in parallel");
+  std::vector<std::vector<uint64_t> > sequential = m_logs;
+  for (uint32_t group = 0; group < N_GROUPS; group++)
+    {
+      // the frame of the centre, then those of the other receivers
+      for (uint32_t receiver = 0; receiver < N_RECEIVERS; receiver++)
+        {
+          uint32_t n = 0;
+          std::vector<uint64_t> &log = m_logs[Index (group, receiver)];
+          for (uint32_t i = 0; i < log.size (); i++)
+            {
+              n += (log[i] / 2000) % 4 == 1;
+            }
+          NS_TEST_ASSERT_MSG_EQ (n, N_RECEIVERS, "Receiver " << receiver << " of group " << group << " misses frames");
+        }
+    }
+
+  RunGroups (4);
+  for (uint32_t i = 0; i < m_logs.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[i] == sequential[i]), true, "Receptions of phy " << i << " differ");
+    }
+
+  // the same receptions as DefaultSimulatorImpl, maybe in another order
+  // within a timestamp
+  RunGroups (0);
+  for (uint32_t i = 0; i < m_logs.size (); i++)
+    {
+      std::sort (m_logs[i].begin (), m_logs[i].end ());
+      std::sort (sequential[i].begin (), sequential[i].end ());
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[i] == sequential[i]), true, "Receptions of phy " << i << " differ");
+    }
+  Simulator::Destroy ();
+}
+#endif
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -298,6 +987,15 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest);
   AddTestCase (new QosUtilsIsOldPacketTest);
   AddTestCase (new InterferenceHelperSequenceTest); // Bug 991
+  AddTestCase (new InterferenceHelperEnergyDurationTest);
+  AddTestCase (new TableErrorRateModelTest);
+  AddTestCase (new YansWifiChannelMaxRangeTest);
+  AddTestCase (new YansWifiChannelEdThresholdTest);
+  AddTestCase (new YansWifiChannelRxPowerCacheTest);
+  AddTestCase (new YansWifiChannelSharedPacketTest);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new YansWifiChannelParallelTest);
+#endif
 }
 
 static WifiTestSuite g_wifiTestSuite;
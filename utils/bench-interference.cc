@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measures the InterferenceHelper of a single receiver while a growing
+// number of frames overlap on the channel, as on a congested 802.11p
+// control channel full of beacons.
+
+#include "ns3/core-module.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+using namespace ns3;
+
+class InterferenceBench
+{
+public:
+  InterferenceBench (uint32_t overlap, uint32_t total, Ptr<ErrorRateModel> model);
+  void Run (void);
+private:
+  void Arrive (void);
+  void EndRx (Ptr<InterferenceHelper::Event> event);
+
+  InterferenceHelper m_interference;
+  WifiMode m_mode;
+  Time m_duration;
+  Time m_interval;
+  uint32_t m_total;
+  uint32_t m_arrived;
+  bool m_rxing;
+  double m_per;
+};
+
+InterferenceBench::InterferenceBench (uint32_t overlap, uint32_t total, Ptr<ErrorRateModel> model)
+  : m_mode (WifiPhy::GetOfdmRate6MbpsBW10MHz ()),
+    m_duration (MicroSeconds (400)),
+    m_interval (NanoSeconds (400000 / overlap)),
+    m_total (total),
+    m_arrived (0),
+    m_rxing (false),
+    m_per (0)
+{
+  m_interference.SetNoiseFigure (5.01);
+  m_interference.SetErrorRateModel (model);
+}
+
+void
+InterferenceBench::Run (void)
+{
+  Simulator::ScheduleNow (&InterferenceBench::Arrive, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+InterferenceBench::Arrive (void)
+{
+  // the first frame of a burst is strong enough to be received, the
+  // others only add interference
+  double rxPowerW = m_rxing ? 1e-11 : 1e-9;
+  Ptr<InterferenceHelper::Event> event = m_interference.Add (200, m_mode, WIFI_PREAMBLE_LONG,
+                                                             m_duration, rxPowerW);
+  m_interference.GetEnergyDuration (1e-12);
+  if (!m_rxing)
+    {
+      m_rxing = true;
+      m_interference.NotifyRxStart ();
+      Simulator::Schedule (m_duration, &InterferenceBench::EndRx, this, event);
+    }
+  if (++m_arrived < m_total)
+    {
+      Simulator::Schedule (m_interval, &InterferenceBench::Arrive, this);
+    }
+}
+
+void
+InterferenceBench::EndRx (Ptr<InterferenceHelper::Event> event)
+{
+  m_per += m_interference.CalculateSnrPer (event).per;
+  m_interference.NotifyRxEnd ();
+  m_rxing = false;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  bool table = false;
+  while (argc > 0)
+    {
+      if (strncmp ("--n=", argv[0], strlen ("--n=")) == 0)
+        {
+          std::istringstream iss;
+          iss.str (argv[0] + strlen ("--n="));
+          iss >> n;
+        }
+      if (strcmp ("--table", argv[0]) == 0)
+        {
+          table = true;
+        }
+      argc--;
+      argv++;
+    }
+  std::cout << "Running bench-interference with n=" << n
+            << (table ? " and TableErrorRateModel" : "") << std::endl;
+
+  uint32_t overlaps[] = { 1, 10, 100, 1000 };
+  for (uint32_t i = 0; i < sizeof (overlaps) / sizeof (overlaps[0]); i++)
+    {
+      Ptr<ErrorRateModel> model = CreateObject<NistErrorRateModel> ();
+      if (table)
+        {
+          model = CreateObject<TableErrorRateModel> ();
+        }
+      InterferenceBench bench (overlaps[i], n, model);
+      SystemWallClockMs time;
+      time.Start ();
+      bench.Run ();
+      uint64_t deltaMs = time.End ();
+      double fps = n;
+      fps *= 1000;
+      fps /= deltaMs > 0 ? deltaMs : 1;
+      std::cout << "overlap=" << overlaps[i] << " " << fps << " frames/s" << std::endl;
+    }
+  return 0;
+}
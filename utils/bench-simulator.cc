@@ -34,6 +34,7 @@ class Bench
 public:
   Bench ();
   void ReadDistribution (std::istream &istream);
+  void GenerateVanetDistribution (uint32_t n);
   void SetTotal (uint32_t total);
   void RunBench (void);
 private:
@@ -75,11 +76,40 @@ Bench::ReadDistribution (std::istream &input)
     }
 }
 
+void
+Bench::GenerateVanetDistribution (uint32_t n)
+{
+  // The event mix of a dense vehicular network: most events are PHY and
+  // MAC events a few microseconds to a few milliseconds ahead, the others
+  // are the jittered 1s hello timers of the routing protocol.
+  UniformVariable kind;
+  UniformVariable phy (1000, 500000);
+  UniformVariable mac (500000, 5000000);
+  UniformVariable hello (1000000000, 1010000000);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double k = kind.GetValue ();
+      if (k < 0.7)
+        {
+          m_distribution.push_back ((uint64_t)phy.GetValue ());
+        }
+      else if (k < 0.9)
+        {
+          m_distribution.push_back ((uint64_t)mac.GetValue ());
+        }
+      else
+        {
+          m_distribution.push_back ((uint64_t)hello.GetValue ());
+        }
+    }
+}
+
 void
 Bench::RunBench (void) 
 {
   SystemWallClockMs time;
   double init, simu;
+  EventAllocator::Stats before = Simulator::GetEventAllocatorStats ();
   time.Start ();
   for (std::vector<uint64_t>::const_iterator i = m_distribution.begin ();
        i != m_distribution.end (); i++) 
@@ -95,6 +125,9 @@ Bench::RunBench (void)
   Simulator::Run ();
   simu = time.End ();
   simu /= 1000;
+  EventAllocator::Stats after = Simulator::GetEventAllocatorStats ();
+  uint64_t allocations = after.allocations - before.allocations;
+  uint64_t systemAllocations = after.systemAllocations - before.systemAllocations;
 
   std::cout <<
       "init n=" << m_distribution.size () << ", time=" << init << "s" << std::endl <<
@@ -102,7 +135,11 @@ Bench::RunBench (void)
       "init " << ((double)m_distribution.size ()) / init << " insert/s, avg insert=" <<
       init / ((double)m_distribution.size ())<< "s" << std::endl <<
       "simu " << ((double)m_n) / simu<< " hold/s, avg hold=" << 
-      simu / ((double)m_n) << "s" << std::endl
+      simu / ((double)m_n) << "s" << std::endl <<
+      "events " << allocations << " allocated, " << after.reuses - before.reuses << " from free lists, " <<
+      systemAllocations << " system allocations (" << ((double)systemAllocations) / (init + simu) << "/s, " <<
+      ((double)systemAllocations) / allocations << " per event), " <<
+      after.arenaBytes << " arena bytes" << std::endl
       ;
 }
 
@@ -131,10 +168,16 @@ PrintHelp (void)
 {
   std::cout << "bench-simulator filename [options]"<<std::endl;
   std::cout << "  filename: a string which identifies the input distribution. \"-\" represents stdin." << std::endl;
+  std::cout << "            \"vanet\" generates a vehicular network event mix." << std::endl;
   std::cout << "  Options:"<<std::endl;
   std::cout << "      --list: use std::list scheduler"<<std::endl;
   std::cout << "      --map: use std::map cheduler"<<std::endl;
   std::cout << "      --heap: use Binary Heap scheduler"<<std::endl;
+  std::cout << "      --calendar: use Calendar Queue scheduler"<<std::endl;
+  std::cout << "      --ns2calendar: use the ns-2 Calendar Queue scheduler"<<std::endl;
+  std::cout << "      --ladder: use Ladder Queue scheduler"<<std::endl;
+  std::cout << "      --events=N: number of events of the vanet mix"<<std::endl;
+  std::cout << "      --no-pool: allocate the events with the system allocator"<<std::endl;
   std::cout << "      --debug: enable some debugging"<<std::endl;
 }
 
@@ -144,6 +187,7 @@ int main (int argc, char *argv[])
   std::istream *input;
   uint32_t n = 1;
   uint32_t total = 20000;
+  uint32_t events = 100000;
   if (argc == 1)
     {
       PrintHelp ();
@@ -155,6 +199,10 @@ int main (int argc, char *argv[])
     {
       input = &std::cin;
     } 
+  else if (strcmp (filename, "vanet") == 0)
+    {
+      input = 0;
+    }
   else 
     {
       input = new std::ifstream (filename);
@@ -174,7 +222,7 @@ int main (int argc, char *argv[])
         } 
       else if (strcmp ("--map", argv[0]) == 0) 
         {
-          factory.SetTypeId ("ns3::HeapScheduler");
+          factory.SetTypeId ("ns3::MapScheduler");
           Simulator::SetScheduler (factory);
         } 
       else if (strcmp ("--calendar", argv[0]) == 0)
@@ -182,6 +230,20 @@ int main (int argc, char *argv[])
           factory.SetTypeId ("ns3::CalendarScheduler");
           Simulator::SetScheduler (factory);
         }
+      else if (strcmp ("--ns2calendar", argv[0]) == 0)
+        {
+          factory.SetTypeId ("ns3::Ns2CalendarScheduler");
+          Simulator::SetScheduler (factory);
+        }
+      else if (strcmp ("--ladder", argv[0]) == 0)
+        {
+          factory.SetTypeId ("ns3::LadderScheduler");
+          Simulator::SetScheduler (factory);
+        }
+      else if (strcmp ("--no-pool", argv[0]) == 0)
+        {
+          GlobalValue::Bind ("EventPooling", BooleanValue (false));
+        }
       else if (strcmp ("--debug", argv[0]) == 0) 
         {
           g_debug = true;
@@ -194,12 +256,23 @@ int main (int argc, char *argv[])
         {
           n = atoi (argv[0]+strlen ("--n="));
         } 
+      else if (strncmp ("--events=", argv[0], strlen("--events=")) == 0)
+        {
+          events = atoi (argv[0]+strlen ("--events="));
+        }
 
       argc--;
       argv++;
   }
   Bench *bench = new Bench ();
-  bench->ReadDistribution (*input);
+  if (input == 0)
+    {
+      bench->GenerateVanetDistribution (events);
+    }
+  else
+    {
+      bench->ReadDistribution (*input);
+    }
   bench->SetTotal (total);
   for (uint32_t i = 0; i < n; i++)
     {